@@ -4,7 +4,8 @@ out vec4 FragColor;
 in vec3 FragPos;
 in vec2 TexCoords;
 in mat3 TBN;
-in vec4 FragPosLightSpace;
+in vec3 ObjectColor;
+flat in int MaterialIndex;
 
 uniform sampler2D diffuseTexture;
 uniform sampler2D normalMap;
@@ -16,7 +17,6 @@ uniform bool hasNormalMap;
 uniform bool hasRoughnessTexture;
 uniform bool hasMetallicTexture;
 uniform bool hasAOTexture;
-uniform vec3 objectColor;
 
 uniform float metallic;
 uniform float roughness;
@@ -24,44 +24,74 @@ uniform float normalStrength;
 uniform vec2 uvScale;
 uniform bool useWorldUV;
 
-uniform vec3 viewPos;
+// === ТАБЛИЦА МАТЕРИАЛОВ (режим текстурных массивов) ===
+// Строка = 5 texel: (metallic, roughness, normalStrength, useWorldUV),
+// (uvScale, emissionIntensity, флаги слотов), (emissionColor, -), слои 0-3, слой 4
+uniform bool useMaterialTable;
+uniform samplerBuffer materialTable;
+uniform sampler2DArray diffuseArray;
+uniform sampler2DArray normalArray;
+uniform sampler2DArray roughnessArray;
+uniform sampler2DArray metallicArray;
+uniform sampler2DArray aoArray;
+
+// Общие данные кадра (UBO, точка привязки 0)
+layout (std140) uniform FrameConstants {
+    mat4 view;
+    mat4 projection;
+    mat4 invView;
+    mat4 invProjection;
+    mat4 lightSpaceMatrices[4];     // по каскадам теней
+    vec4 cascadeSplits;     // дальняя граница каждого каскада (глубина вида)
+    vec4 viewPos;           // xyz
+    int shadowsEnabled;
+    float shadowBias;
+    float shadowSoftness;
+    int shadowSamples;
+    float ambientStrength;
+    int fogEnabled;
+    int fogType;            // 0 = нет, 1 = linear, 2 = exp, 3 = exp2
+    float fogDensity;
+    vec4 fogColor;          // rgb
+    float fogStart;
+    float fogEnd;
+    int cascadeCount;
+};
 
 // === ТЕНИ ===
-uniform sampler2D shadowMap;
-uniform bool shadowsEnabled;
+uniform sampler2DArray shadowMap;     // слой = каскад
 uniform bool receiveShadows;
-uniform float shadowBias;
-uniform float shadowSoftness;
-uniform int shadowSamples;
 
 // === ЭМИССИЯ ===
 uniform vec3 emissionColor;
 uniform float emissionIntensity;
 
-// === AMBIENT ===
-uniform float ambientStrength;
-
-uniform bool fogEnabled;
-uniform int fogType;      // 0 = нет, 1 = linear, 2 = exp, 3 = exp2
-uniform vec3 fogColor;
-uniform float fogDensity;
-uniform float fogStart;
-uniform float fogEnd;
-
-// === СТРУКТУРА СВЕТА ===
+// === ИСТОЧНИКИ СВЕТА ===
 struct Light {
-    int type;          // 0 = directional, 1 = point, 2 = spot
-    vec3 position;
-    vec3 direction;
-    vec3 color;
-    float intensity;
-    float range;
-    float angle;
+    vec4 positionType;      // xyz = позиция, w = тип (0 = directional, 1 = point, 2 = spot)
+    vec4 directionRange;    // xyz = направление, w = радиус
+    vec4 colorIntensity;    // rgb = цвет, w = интенсивность
+    vec4 spotAngle;         // x = угол конуса (рад)
+};
+// Направленные — в UBO (точка привязки 1), точечные и прожекторы — по кластерам
+layout (std140) uniform Lights {
+    ivec4 clusterGrid;      // xyz = размер сетки кластеров, w = число направленных источников
+    vec4 clusterParams;     // x, y = масштаб/смещение среза по log(глубины), zw = размер тайла (px)
+    Light directionalLights[4];
 };
-uniform Light lights[8];
-uniform int numLights;
+uniform usamplerBuffer clusterGridBuffer;   // (смещение, количество) на кластер
+uniform usamplerBuffer clusterIndexBuffer;  // индексы источников
+uniform samplerBuffer lightDataBuffer;      // 4 texel на источник, как в Light
 
-float ShadowCalculation(vec4 fragPosLightSpace, float NdotL) {
+float ShadowCalculation(float NdotL) {
+    // Каскад по глубине фрагмента в пространстве вида
+    float viewDepth = -(view * vec4(FragPos, 1.0)).z;
+    int cascade = cascadeCount - 1;
+    for (int i = 0; i < cascadeCount; i++) {
+        if (viewDepth < cascadeSplits[i]) { cascade = i; break; }
+    }
+
+    vec4 fragPosLightSpace = lightSpaceMatrices[cascade] * vec4(FragPos, 1.0);
     vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
     projCoords = projCoords * 0.5 + 0.5;
     if (projCoords.z > 1.0) return 0.0;
@@ -69,13 +99,13 @@ float ShadowCalculation(vec4 fragPosLightSpace, float NdotL) {
     float currentDepth = projCoords.z;
     float bias = max(shadowBias, 0.05 * (1.0 - NdotL));
     float shadow = 0.0;
-    vec2 texelSize = 1.0 / textureSize(shadowMap, 0);
+    vec2 texelSize = 1.0 / vec2(textureSize(shadowMap, 0).xy);
 
     if (shadowSamples == 4) {
         for (int x = -1; x <= 1; x += 2) {
             for (int y = -1; y <= 1; y += 2) {
                 vec2 offset = vec2(x, y) * texelSize * shadowSoftness;
-                float pcfDepth = texture(shadowMap, projCoords.xy + offset).r;
+                float pcfDepth = texture(shadowMap, vec3(projCoords.xy + offset, cascade)).r;
                 shadow += (currentDepth - bias) > pcfDepth ? 1.0 : 0.0;
             }
         }
@@ -84,7 +114,7 @@ float ShadowCalculation(vec4 fragPosLightSpace, float NdotL) {
         for (int x = -1; x <= 1; x++) {
             for (int y = -1; y <= 1; y++) {
                 vec2 offset = vec2(x, y) * texelSize * shadowSoftness;
-                float pcfDepth = texture(shadowMap, projCoords.xy + offset).r;
+                float pcfDepth = texture(shadowMap, vec3(projCoords.xy + offset, cascade)).r;
                 shadow += (currentDepth - bias) > pcfDepth ? 1.0 : 0.0;
             }
         }
@@ -93,130 +123,167 @@ float ShadowCalculation(vec4 fragPosLightSpace, float NdotL) {
     return shadow;
 }
 
+vec3 ShadeLight(vec4 positionType, vec4 directionRange, vec4 colorIntensity, vec4 spotAngle,
+                vec3 normal, vec3 viewDir, vec3 albedo, float metallicVal, float roughnessVal) {
+    int lightType = int(positionType.w + 0.5);
+    vec3 lightPos = positionType.xyz;
+    vec3 lightDirection = directionRange.xyz;
+    float lightRange = directionRange.w;
+    vec3 lightColor = colorIntensity.rgb;
+    float lightIntensity = colorIntensity.w;
+    float lightAngle = spotAngle.x;
+    vec3 lightDir;
+    float attenuation = 1.0;
+    float NdotL = 0.0;
+
+    if (lightType == 0) { // directional
+        lightDir = normalize(-lightDirection);
+        NdotL = max(dot(normal, lightDir), 0.0);
+        attenuation = 1.0;
+    } else { // point / spot
+        vec3 delta = lightPos - FragPos;
+        float dist = length(delta);
+        if (dist > lightRange) return vec3(0.0);
+        lightDir = delta / dist;
+        NdotL = max(dot(normal, lightDir), 0.0);
+        attenuation = 1.0 / (1.0 + dist * dist / (lightRange * lightRange));
+        if (lightType == 2) {
+            vec3 spotDir = normalize(lightDirection);
+            float cosTheta = dot(-lightDir, spotDir);
+            float spotEffect = smoothstep(cos(lightAngle), cos(lightAngle * 0.5), cosTheta);
+            attenuation *= spotEffect;
+        }
+    }
+
+    if (NdotL <= 0.0) return vec3(0.0);
+
+    vec3 halfwayDir = normalize(lightDir + viewDir);
+    float NdotH = max(dot(normal, halfwayDir), 0.0);
+    float shininess = 2.0 / (roughnessVal * roughnessVal) - 2.0;
+    shininess = clamp(shininess, 1.0, 512.0);
+    float spec = pow(NdotH, shininess);
+    vec3 specColor = mix(vec3(1.0), albedo, metallicVal);
+
+    vec3 diffuse = NdotL * albedo * lightColor * lightIntensity;
+    vec3 specular = spec * specColor * lightColor * lightIntensity;
+
+    // Френель
+    float fresnel = pow(1.0 - max(dot(viewDir, normal), 0.0), 2.0);
+    specular += fresnel * 0.04 * (1.0 - metallicVal) * lightIntensity;
+
+    // Тени только для directional
+    float shadow = 0.0;
+    if (shadowsEnabled != 0 && receiveShadows && lightType == 0) {
+        shadow = ShadowCalculation(NdotL);
+    }
+
+    return (1.0 - shadow) * attenuation * (diffuse + specular);
+}
+
+// Слот материала: обычная текстура или слой массива (useMaterialTable одинаков для всего вызова)
+vec4 SampleSlot(sampler2D tex, sampler2DArray array, float layer, vec2 uv) {
+    return useMaterialTable ? texture(array, vec3(uv, layer)) : texture(tex, uv);
+}
+
 void main() {
+    // Параметры материала: uniform'ы или строка таблицы
+    float matMetallic = metallic;
+    float matRoughness = roughness;
+    float matNormalStrength = normalStrength;
+    vec2 matUvScale = uvScale;
+    bool matWorldUV = useWorldUV;
+    bool matHasDiffuse = hasDiffuseTexture;
+    bool matHasNormal = hasNormalMap;
+    bool matHasRoughness = hasRoughnessTexture;
+    bool matHasMetallic = hasMetallicTexture;
+    bool matHasAO = hasAOTexture;
+    vec3 matEmission = emissionColor * emissionIntensity;
+    vec4 layers = vec4(0.0);
+    float aoLayer = 0.0;
+    if (useMaterialTable) {
+        int row = MaterialIndex * 5;
+        vec4 t0 = texelFetch(materialTable, row);
+        vec4 t1 = texelFetch(materialTable, row + 1);
+        vec4 t2 = texelFetch(materialTable, row + 2);
+        layers = texelFetch(materialTable, row + 3);
+        aoLayer = texelFetch(materialTable, row + 4).x;
+        int flags = int(t1.w + 0.5);
+        matMetallic = t0.x;
+        matRoughness = t0.y;
+        matNormalStrength = t0.z;
+        matWorldUV = t0.w > 0.5;
+        matUvScale = t1.xy;
+        matEmission = t2.rgb * t1.z;
+        matHasDiffuse = (flags & 1) != 0;
+        matHasNormal = (flags & 2) != 0;
+        matHasRoughness = (flags & 4) != 0;
+        matHasMetallic = (flags & 8) != 0;
+        matHasAO = (flags & 16) != 0;
+    }
+
     // UV и альбедо
-    vec2 uv = TexCoords * uvScale;
+    vec2 uv = TexCoords * matUvScale;
     vec3 albedo;
-    if (useWorldUV) {
+    if (matWorldUV) {
         vec3 worldPos = FragPos;
         vec3 blend = abs(normalize(TBN[2]));
         blend = pow(blend, vec3(2.0));
         blend /= blend.x + blend.y + blend.z;
-        vec3 xaxis = texture(diffuseTexture, worldPos.yz * uvScale).rgb;
-        vec3 yaxis = texture(diffuseTexture, worldPos.xz * uvScale).rgb;
-        vec3 zaxis = texture(diffuseTexture, worldPos.xy * uvScale).rgb;
+        vec3 xaxis = SampleSlot(diffuseTexture, diffuseArray, layers.x, worldPos.yz * matUvScale).rgb;
+        vec3 yaxis = SampleSlot(diffuseTexture, diffuseArray, layers.x, worldPos.xz * matUvScale).rgb;
+        vec3 zaxis = SampleSlot(diffuseTexture, diffuseArray, layers.x, worldPos.xy * matUvScale).rgb;
         albedo = xaxis * blend.x + yaxis * blend.y + zaxis * blend.z;
     } else {
-        if (hasDiffuseTexture)
-            albedo = texture(diffuseTexture, uv).rgb;
+        if (matHasDiffuse)
+            albedo = SampleSlot(diffuseTexture, diffuseArray, layers.x, uv).rgb;
         else
-            albedo = objectColor;
+            albedo = ObjectColor;
     }
 
     // Нормаль
     vec3 geomNormal = normalize(TBN[2]);
     vec3 normal;
-    if (hasNormalMap && !useWorldUV) {
-        vec3 tangentNormal = texture(normalMap, uv).rgb * 2.0 - 1.0;
+    if (matHasNormal && !matWorldUV) {
+        // Z восстанавливается из XY: в BC5 у карты нормалей только два канала
+        vec2 normalXY = SampleSlot(normalMap, normalArray, layers.y, uv).rg * 2.0 - 1.0;
+        vec3 tangentNormal = vec3(normalXY, sqrt(max(1.0 - dot(normalXY, normalXY), 0.0)));
         vec3 worldNormal = normalize(TBN * tangentNormal);
-        normal = normalize(mix(geomNormal, worldNormal, normalStrength));
+        normal = normalize(mix(geomNormal, worldNormal, matNormalStrength));
     } else {
         normal = geomNormal;
     }
 
     // PBR параметры из текстур или uniform
-    float metallicVal = metallic;
-    if (hasMetallicTexture) metallicVal = texture(metallicTexture, uv).r;
-    float roughnessVal = roughness;
-    if (hasRoughnessTexture) roughnessVal = texture(roughnessTexture, uv).r;
+    float metallicVal = matMetallic;
+    if (matHasMetallic) metallicVal = SampleSlot(metallicTexture, metallicArray, layers.w, uv).r;
+    float roughnessVal = matRoughness;
+    if (matHasRoughness) roughnessVal = SampleSlot(roughnessTexture, roughnessArray, layers.z, uv).r;
     float aoVal = 1.0;
-    if (hasAOTexture) aoVal = texture(aoTexture, uv).r;
+    if (matHasAO) aoVal = SampleSlot(aoTexture, aoArray, aoLayer, uv).r;
 
-    vec3 viewDir = normalize(viewPos - FragPos);
+    vec3 viewDir = normalize(viewPos.xyz - FragPos);
     vec3 result = ambientStrength * albedo * aoVal;
 
-    // Перебор всех источников света
-    for (int i = 0; i < numLights; i++) {
-        Light light = lights[i];
-        vec3 lightDir;
-        float attenuation = 1.0;
-        float NdotL = 0.0;
-
-        if (light.type == 0) { // directional
-            lightDir = normalize(-light.direction);
-            NdotL = max(dot(normal, lightDir), 0.0);
-            attenuation = 1.0;
-        } else if (light.type == 1) { // point
-            vec3 delta = light.position - FragPos;
-            float dist = length(delta);
-            if (dist > light.range) continue;
-            lightDir = delta / dist;
-            NdotL = max(dot(normal, lightDir), 0.0);
-            attenuation = 1.0 / (1.0 + dist * dist / (light.range * light.range));
-        } else if (light.type == 2) { // spot
-            vec3 delta = light.position - FragPos;
-            float dist = length(delta);
-            if (dist > light.range) continue;
-            lightDir = delta / dist;
-            NdotL = max(dot(normal, lightDir), 0.0);
-            attenuation = 1.0 / (1.0 + dist * dist / (light.range * light.range));
-            vec3 spotDir = normalize(light.direction);
-            float cosTheta = dot(-lightDir, spotDir);
-            float spotEffect = smoothstep(cos(light.angle), cos(light.angle * 0.5), cosTheta);
-            attenuation *= spotEffect;
-        }
-
-        if (NdotL <= 0.0) continue;
-
-        vec3 halfwayDir = normalize(lightDir + viewDir);
-        float NdotH = max(dot(normal, halfwayDir), 0.0);
-        float shininess = 2.0 / (roughnessVal * roughnessVal) - 2.0;
-        shininess = clamp(shininess, 1.0, 512.0);
-        float spec = pow(NdotH, shininess);
-        vec3 specColor = mix(vec3(1.0), albedo, metallicVal);
-
-        vec3 diffuse = NdotL * albedo * light.color * light.intensity;
-        vec3 specular = spec * specColor * light.color * light.intensity;
-
-        // Френель
-        float fresnel = pow(1.0 - max(dot(viewDir, normal), 0.0), 2.0);
-        specular += fresnel * 0.04 * (1.0 - metallicVal) * light.intensity;
-
-        // Тени только для directional
-        float shadow = 0.0;
-        if (shadowsEnabled && receiveShadows && light.type == 0 && NdotL > 0.0) {
-            shadow = ShadowCalculation(FragPosLightSpace, NdotL);
-        }
-
-        result += (1.0 - shadow) * attenuation * (diffuse + specular);
+    // Направленные источники
+    for (int i = 0; i < clusterGrid.w; i++) {
+        result += ShadeLight(directionalLights[i].positionType, directionalLights[i].directionRange,
+                             directionalLights[i].colorIntensity, directionalLights[i].spotAngle,
+                             normal, viewDir, albedo, metallicVal, roughnessVal);
     }
 
-    // === ТУМАН ===
-if (fogEnabled) {
-    float dist = length(viewPos - FragPos);
-    float fogFactor = 0.0;
-    
-    if (fogType == 1) { // Linear
-        fogFactor = (dist - fogStart) / (fogEnd - fogStart);
-        fogFactor = clamp(fogFactor, 0.0, 1.0);
-    } 
-    else if (fogType == 2) { // Exponential
-        fogFactor = 1.0 - exp(-fogDensity * dist);
-    } 
-    else if (fogType == 3) { // Exponential Squared (самый красивый)
-        fogFactor = 1.0 - exp(-pow(fogDensity * dist, 2.0));
+    // Точечные и прожекторы — только из кластера этого фрагмента
+    float viewDepth = -(view * vec4(FragPos, 1.0)).z;
+    int slice = clamp(int(log(max(viewDepth, 1e-4)) * clusterParams.x - clusterParams.y), 0, clusterGrid.z - 1);
+    ivec2 tile = clamp(ivec2(gl_FragCoord.xy / clusterParams.zw), ivec2(0), clusterGrid.xy - 1);
+    int cluster = (slice * clusterGrid.y + tile.y) * clusterGrid.x + tile.x;
+    uvec2 clusterRange = texelFetch(clusterGridBuffer, cluster).xy;
+    for (uint i = 0u; i < clusterRange.y; i++) {
+        int index = int(texelFetch(clusterIndexBuffer, int(clusterRange.x + i)).r) * 4;
+        result += ShadeLight(texelFetch(lightDataBuffer, index), texelFetch(lightDataBuffer, index + 1),
+                             texelFetch(lightDataBuffer, index + 2), texelFetch(lightDataBuffer, index + 3),
+                             normal, viewDir, albedo, metallicVal, roughnessVal);
     }
-    
-    // Плавное смешивание с сохранением контраста
-    result = mix(result, fogColor, fogFactor);
-    
-    // Дополнительно: уменьшаем насыщенность дальних объектов (эффект глубины)
-    if (fogFactor > 0.3) {
-        float desat = mix(1.0, 0.5, (fogFactor - 0.3) / 0.7);
-        result = vec3(desat) * result + (1.0 - desat) * fogColor;
-    }
-}
 
-    result += emissionColor * emissionIntensity;
+    result += matEmission;
     FragColor = vec4(result, 1.0);
 }
@@ -2,28 +2,84 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoords;
-layout (location = 3) in vec3 aTangent;
+layout (location = 3) in vec4 aTangent;     // w — знак битангенса
+// Инстансинг: матрица модели (4..7) и цвет (8) на экземпляр
+layout (location = 4) in mat4 aInstanceModel;
+layout (location = 8) in vec3 aInstanceColor;
+// Строка таблицы материалов (режим текстурных массивов)
+layout (location = 9) in int aInstanceMaterial;
+// Распаковка вершин меша (постоянные атрибуты, выставляет Mesh::Bind):
+// позиция = aPos * scale + bias, 1 — нормаль и касательная в октаэдре
+layout (location = 10) in vec3 aPositionScale;
+layout (location = 11) in vec3 aPositionBias;
+layout (location = 12) in float aOctahedralNormals;
 
 out vec3 FragPos;
 out vec2 TexCoords;
 out mat3 TBN;
-out vec4 FragPosLightSpace;
+out vec3 ObjectColor;
+flat out int MaterialIndex;
+
+// Общие данные кадра (UBO, точка привязки 0)
+layout (std140) uniform FrameConstants {
+    mat4 view;
+    mat4 projection;
+    mat4 invView;
+    mat4 invProjection;
+    mat4 lightSpaceMatrices[4];     // по каскадам теней
+    vec4 cascadeSplits;     // дальняя граница каждого каскада (глубина вида)
+    vec4 viewPos;           // xyz
+    int shadowsEnabled;
+    float shadowBias;
+    float shadowSoftness;
+    int shadowSamples;
+    float ambientStrength;
+    int fogEnabled;
+    int fogType;            // 0 = нет, 1 = linear, 2 = exp, 3 = exp2
+    float fogDensity;
+    vec4 fogColor;          // rgb
+    float fogStart;
+    float fogEnd;
+    int cascadeCount;
+};
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
-uniform mat4 lightSpaceMatrix;
+uniform vec3 objectColor;
+uniform bool useInstancing;
+uniform int materialIndex;
+
+vec3 DecodeOctahedral(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
 
 void main() {
-    FragPos = vec3(model * vec4(aPos, 1.0));
+    mat4 modelMatrix = useInstancing ? aInstanceModel : model;
+    ObjectColor = useInstancing ? aInstanceColor : objectColor;
+    MaterialIndex = useInstancing ? aInstanceMaterial : materialIndex;
+
+    vec3 position = aPos * aPositionScale + aPositionBias;
+    vec3 normal = aNormal;
+    vec3 tangent = aTangent.xyz;
+    float handedness = aTangent.w < 0.0 ? -1.0 : 1.0;
+    if (aOctahedralNormals > 0.5) {
+        // Знак битангенса — в знаке y касательной, сама y — в |y| из [0.5, 1]
+        normal = DecodeOctahedral(aNormal.xy);
+        handedness = aTangent.y < 0.0 ? -1.0 : 1.0;
+        tangent = DecodeOctahedral(vec2(aTangent.x, abs(aTangent.y) * 4.0 - 3.0));
+    }
+
+    FragPos = vec3(modelMatrix * vec4(position, 1.0));
     TexCoords = aTexCoords;
-    FragPosLightSpace = lightSpaceMatrix * vec4(FragPos, 1.0);
 
     // Правильная матрица для нормалей и касательных
-    mat3 normalMatrix = transpose(inverse(mat3(model)));
-    vec3 N = normalize(normalMatrix * aNormal);
-    vec3 T = normalize(normalMatrix * aTangent);
-    vec3 B = cross(N, T);
+    mat3 normalMatrix = transpose(inverse(mat3(modelMatrix)));
+    vec3 N = normalize(normalMatrix * normal);
+    vec3 T = normalize(normalMatrix * tangent);
+    vec3 B = cross(N, T) * handedness;
     TBN = mat3(T, B, N);
 
     gl_Position = projection * view * vec4(FragPos, 1.0);
@@ -1,6 +1,9 @@
 #version 330 core
 layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec3 aColor;
+// Распаковка позиции меша (постоянные атрибуты, выставляет Mesh::Bind)
+layout(location = 10) in vec3 aPositionScale;
+layout(location = 11) in vec3 aPositionBias;
 
 out vec3 Color;
 
@@ -10,11 +13,12 @@ uniform mat4 projection;
 uniform bool useColor;
 
 void main() {
+    vec3 position = aPos * aPositionScale + aPositionBias;
     if (useColor) {
         Color = aColor;
-        gl_Position = projection * view * model * vec4(aPos, 1.0);
+        gl_Position = projection * view * model * vec4(position, 1.0);
     } else {
         Color = aColor;
-        gl_Position = projection * view * model * vec4(aPos, 1.0);
+        gl_Position = projection * view * model * vec4(position, 1.0);
     }
 }
\ No newline at end of file
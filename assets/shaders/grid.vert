@@ -1,13 +1,38 @@
 #version 330 core
 layout(location = 0) in vec3 aPos;
+// Распаковка позиции меша (постоянные атрибуты, выставляет Mesh::Bind)
+layout (location = 10) in vec3 aPositionScale;
+layout (location = 11) in vec3 aPositionBias;
 
 out vec3 WorldPos;
 
+// Общие данные кадра (UBO, точка привязки 0)
+layout (std140) uniform FrameConstants {
+    mat4 view;
+    mat4 projection;
+    mat4 invView;
+    mat4 invProjection;
+    mat4 lightSpaceMatrices[4];     // по каскадам теней
+    vec4 cascadeSplits;     // дальняя граница каждого каскада (глубина вида)
+    vec4 viewPos;           // xyz
+    int shadowsEnabled;
+    float shadowBias;
+    float shadowSoftness;
+    int shadowSamples;
+    float ambientStrength;
+    int fogEnabled;
+    int fogType;            // 0 = нет, 1 = linear, 2 = exp, 3 = exp2
+    float fogDensity;
+    vec4 fogColor;          // rgb
+    float fogStart;
+    float fogEnd;
+    int cascadeCount;
+};
+
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
 
 void main() {
-    WorldPos = aPos;
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    vec3 position = aPos * aPositionScale + aPositionBias;
+    WorldPos = position;
+    gl_Position = projection * view * model * vec4(position, 1.0);
 }
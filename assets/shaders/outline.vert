@@ -1,10 +1,13 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
+// Распаковка позиции меша (постоянные атрибуты, выставляет Mesh::Bind)
+layout (location = 10) in vec3 aPositionScale;
+layout (location = 11) in vec3 aPositionBias;
 
 uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 
 void main() {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    gl_Position = projection * view * model * vec4(aPos * aPositionScale + aPositionBias, 1.0);
 }
\ No newline at end of file
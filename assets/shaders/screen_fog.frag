@@ -5,15 +5,29 @@ in vec2 TexCoords;
 
 uniform sampler2D sceneTexture;
 uniform sampler2D depthTexture;
-uniform mat4 invProjection;
-uniform mat4 invView;
-uniform vec3 viewPos;
-uniform vec3 fogColor;
-uniform int fogType;
-uniform float fogDensity;
-uniform float fogStart;
-uniform float fogEnd;
-uniform bool fogEnabled;
+
+// Общие данные кадра (UBO, точка привязки 0)
+layout (std140) uniform FrameConstants {
+    mat4 view;
+    mat4 projection;
+    mat4 invView;
+    mat4 invProjection;
+    mat4 lightSpaceMatrices[4];     // по каскадам теней
+    vec4 cascadeSplits;     // дальняя граница каждого каскада (глубина вида)
+    vec4 viewPos;           // xyz
+    int shadowsEnabled;
+    float shadowBias;
+    float shadowSoftness;
+    int shadowSamples;
+    float ambientStrength;
+    int fogEnabled;
+    int fogType;            // 0 = нет, 1 = linear, 2 = exp, 3 = exp2
+    float fogDensity;
+    vec4 fogColor;          // rgb
+    float fogStart;
+    float fogEnd;
+    int cascadeCount;
+};
 
 // Восстановление мировых координат по глубине
 vec3 WorldPosFromDepth(float depth, vec2 texCoord) {
@@ -30,11 +44,11 @@ void main() {
     
     // Восстанавливаем мировые координаты пикселя
     vec3 worldPos = WorldPosFromDepth(depth, TexCoords);
-    float dist = length(viewPos - worldPos);
+    float dist = length(viewPos.xyz - worldPos);
     
     vec3 result = color;
-if (fogEnabled) {
-    float dist = length(viewPos - worldPos);
+if (fogEnabled != 0) {
+    float dist = length(viewPos.xyz - worldPos);
     float fogFactor = 0.0;
     if (fogType == 1) { // Linear
         fogFactor = (dist - fogStart) / (fogEnd - fogStart);
@@ -44,7 +58,7 @@ if (fogEnabled) {
     } else if (fogType == 3) { // Exponential Squared
         fogFactor = 1.0 - exp(-pow(fogDensity * dist, 2.0));
     }
-    result = mix(color, fogColor, fogFactor);
+    result = mix(color, fogColor.rgb, fogFactor);
 }
 FragColor = vec4(result, 1.0);
 }
\ No newline at end of file
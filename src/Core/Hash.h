@@ -0,0 +1,34 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+// 64-битный некриптографический хэш (MurmurHash64A) — для ключей кэшей:
+// содержимое исходного файла плюс параметры обработки через seed
+inline uint64_t HashBytes(const void* data, size_t size, uint64_t seed = 0) {
+    const uint64_t m = 0xc6a4a7935bd1e995ULL;
+    const int r = 47;
+    uint64_t h = seed ^ ((uint64_t)size * m);
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    const size_t blocks = size / 8;
+    for (size_t i = 0; i < blocks; ++i) {
+        uint64_t k;
+        memcpy(&k, bytes + i * 8, sizeof(k));
+        k *= m;
+        k ^= k >> r;
+        k *= m;
+        h ^= k;
+        h *= m;
+    }
+    const uint8_t* tail = bytes + blocks * 8;
+    const size_t rest = size & 7;
+    if (rest) {
+        for (size_t i = rest; i-- > 0;) h ^= (uint64_t)tail[i] << (8 * i);
+        h *= m;
+    }
+    h ^= h >> r;
+    h *= m;
+    h ^= h >> r;
+    return h;
+}
@@ -0,0 +1,59 @@
+#include "Core/MappedFile.h"
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool MappedFile::Open(const std::string& filename) {
+    Close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    m_File = file;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) { Close(); return false; }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) { Close(); return false; }
+    m_Mapping = mapping;
+    m_Data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!m_Data) { Close(); return false; }
+    m_Size = (size_t)size.QuadPart;
+#else
+    m_File = open(filename.c_str(), O_RDONLY);
+    if (m_File < 0) return false;
+    struct stat info;
+    if (fstat(m_File, &info) != 0 || info.st_size == 0) { Close(); return false; }
+    void* data = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, m_File, 0);
+    if (data == MAP_FAILED) { Close(); return false; }
+    m_Data = static_cast<const uint8_t*>(data);
+    m_Size = (size_t)info.st_size;
+#endif
+    return true;
+}
+
+void MappedFile::Close() {
+#ifdef _WIN32
+    if (m_Data) UnmapViewOfFile(m_Data);
+    if (m_Mapping) CloseHandle(m_Mapping);
+    if (m_File) CloseHandle(m_File);
+    m_Mapping = nullptr;
+    m_File = nullptr;
+#else
+    if (m_Data) munmap(const_cast<uint8_t*>(m_Data), m_Size);
+    if (m_File >= 0) close(m_File);
+    m_File = -1;
+#endif
+    m_Data = nullptr;
+    m_Size = 0;
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+// Файл, отображённый в память только для чтения (MapViewOfFile / mmap).
+// Данные действительны, пока объект открыт; пустой файл не открывается.
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { Close(); }
+
+    bool Open(const std::string& filename);
+    void Close();
+    bool IsOpen() const { return m_Data != nullptr; }
+
+    const uint8_t* GetData() const { return m_Data; }
+    size_t GetSize() const { return m_Size; }
+
+private:
+#ifdef _WIN32
+    void* m_File = nullptr;         // HANDLE; windows.h в заголовок не тащим
+    void* m_Mapping = nullptr;
+#else
+    int m_File = -1;
+#endif
+    const uint8_t* m_Data = nullptr;
+    size_t m_Size = 0;
+};
@@ -0,0 +1,29 @@
+#pragma once
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+// Вызывает fn(i) для i в [0, count) на нескольких потоках. Задания раздаются
+// по одному через атомарный счётчик, поэтому разные по объёму задания (меши,
+// текстуры) распределяются сами. Вызывающий поток работает наравне с остальными.
+template <typename Fn>
+void ParallelFor(size_t count, Fn&& fn, unsigned maxThreads = 0) {
+    unsigned threadCount = (std::max)(1u, std::thread::hardware_concurrency());
+    if (maxThreads) threadCount = (std::min)(threadCount, maxThreads);
+    threadCount = (unsigned)(std::min)((size_t)threadCount, count);
+    if (threadCount <= 1) {
+        for (size_t i = 0; i < count; ++i) fn(i);
+        return;
+    }
+
+    std::atomic<size_t> next(0);
+    auto work = [&]() {
+        for (size_t i = next++; i < count; i = next++) fn(i);
+    };
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threadCount; ++t) workers.emplace_back(work);
+    work();
+    for (auto& worker : workers) worker.join();
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+
+// Постоянные рабочие потоки с общей очередью заданий (FIFO). Для фоновой
+// работы, которая приходит понемногу весь сеанс (декодирование текстур);
+// разовые пачки проще отдать ParallelFor.
+class ThreadPool {
+public:
+    // 0 — по числу ядер минус основной поток
+    explicit ThreadPool(unsigned threadCount = 0);
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    // Дожидается текущих заданий; оставшиеся в очереди отбрасываются
+    ~ThreadPool();
+
+    void Submit(std::function<void()> task);
+    size_t GetThreadCount() const { return m_Workers.size(); }
+
+private:
+    void WorkerLoop();
+
+    std::vector<std::thread> m_Workers;
+    std::deque<std::function<void()>> m_Tasks;
+    std::mutex m_Mutex;
+    std::condition_variable m_Condition;
+    bool m_Stopping = false;
+};
@@ -6,15 +6,21 @@
 #include "Scene/SceneManager.h"
 #include "Scene/GameObject.h"
 #include "Graphics/Primitives.h"
+#include "Graphics/MeshRegistry.h"
+#include "Graphics/MeshOptimizer.h"
+#include "Graphics/TangentGenerator.h"
 #include "Graphics/Material.h"
+#include "Graphics/TextureManager.h"
 #include "Graphics/Skybox.h"
-#include "Graphics/Model.h"
+#include "Graphics/LightClusters.h"
+#include "Graphics/ModelImportJob.h"
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_opengl3.h"
 #include "ImGuizmo.h"
 #include <iostream>
 #include <glm/gtc/type_ptr.hpp>
+#include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/matrix_access.hpp>
 #include <glm/gtx/matrix_decompose.hpp>
 #include <fstream>
@@ -22,6 +28,10 @@
 #include <commdlg.h>
 #include <filesystem>
 #include <unordered_map>  // для snap-настроек
+#include <cmath>
+#include <chrono>
+#include <cstring>
+#include <thread>
 #define GLFW_EXPOSE_NATIVE_WIN32
 #include <GLFW/glfw3native.h>
 #include <filesystem>
@@ -119,6 +129,8 @@ bool EditorUI::Initialize(GLFWwindow* window, SceneManager* sceneManager) {
 }
 
 void EditorUI::Shutdown() {
+    // Задания держат GL-объекты и рабочие потоки — до уничтожения контекста
+    m_Imports.clear();
     if (m_ImGuiContext) {
         ImGui_ImplOpenGL3_Shutdown();
         ImGui_ImplGlfw_Shutdown();
@@ -179,6 +191,9 @@ void EditorUI::Render() {
         m_FirstLaunch = false;
     }
 
+    UpdateStressMotion();
+    UpdateModelImports();
+
     DrawMainMenuBar();
     DrawHierarchy();
     DrawInspector();
@@ -188,6 +203,7 @@ void EditorUI::Render() {
     DrawThemeEditor();
     DrawSkyboxSettings();
     DrawShadowsSettings();  // <-- новое окно
+    DrawImportProgress();
 
     if (m_ShowAboutPopup) {
         ImGui::OpenPopup("About");
@@ -212,29 +228,7 @@ void EditorUI::DrawMainMenuBar() {
 
     if (ImGui::MenuItem("Import Model...")) {
     std::string path = OpenFileDialog("*.obj;*.fbx;*.dae;*.blend;*.3ds;*.stl");
-    if (!path.empty()) {
-        auto model = std::make_shared<Model>(path);
-        if (model->IsLoaded()) {
-            const auto& meshes = model->GetMeshes();
-            if (meshes.size() == 1) {
-                // Один меш: создаём объект с именем файла
-                auto obj = m_SceneManager->CreateGameObject(GetFileNameWithoutExt(path));
-                obj->SetMesh(meshes[0]);
-                if (meshes[0]->GetMaterial()) obj->SetMaterial(meshes[0]->GetMaterial());
-            } else {
-                // Несколько мешей: создаём корневой объект и дочерние
-                auto root = m_SceneManager->CreateGameObject(GetFileNameWithoutExt(path));
-                for (const auto& mesh : meshes) {
-                    auto child = m_SceneManager->CreateGameObject(mesh->GetName());
-                    child->SetMesh(mesh);
-                    if (mesh->GetMaterial()) child->SetMaterial(mesh->GetMaterial());
-                    root->AddChild(child);
-                }
-            }
-        } else {
-            std::cerr << "Failed to load model: " << path << std::endl;
-        }
-    }
+    if (!path.empty()) StartModelImport(path);
 }
 
 if (ImGui::BeginMenu("Physics")) {
@@ -252,6 +246,9 @@ if (ImGui::BeginMenu("Physics")) {
         m_MenuBarHeight = ImGui::GetWindowHeight();
 
         if (ImGui::BeginMenu("File")) {
+            if (ImGui::MenuItem("Open Scene", "Ctrl+O")) {
+                if (m_SceneManager) m_SceneManager->LoadScene("scene.binax");
+            }
             if (ImGui::MenuItem("Save Scene", "Ctrl+S")) {
                 if (m_SceneManager) m_SceneManager->SaveScene("scene.binax");
             }
@@ -296,6 +293,8 @@ if (ImGui::BeginMenu("View")) {
     ImGui::EndMenu();
 }
 
+        DrawStressTestMenu();
+
         ImGui::SameLine(ImGui::GetWindowWidth() - 350);
         DrawGizmoToolbar();
         ImGui::SameLine();
@@ -415,10 +414,12 @@ void EditorUI::DrawHierarchy() {
     if (ImGui::MenuItem("Directional Light")) {
     if (m_SceneManager && !m_SceneManager->HasDirectionalLight()) {
         auto light = m_SceneManager->CreateGameObject("DirectionalLight");
+        light->SetLightType(LT_DIRECTIONAL);
+        light->SetLightDirection(glm::normalize(glm::vec3(-1.0f, -2.0f, -1.0f)));
         light->SetPosition(glm::vec3(2.0f, 4.0f, 2.0f));
         light->SetColor(glm::vec3(1.0f, 1.0f, 1.0f));
         light->SetScale(glm::vec3(0.3f));
-        light->SetMesh(Primitives::CreateCube());
+        light->SetMesh(MeshRegistry::Get().GetPrimitive(PRIMITIVE_CUBE));
         m_Settings.light_pos = light->GetPosition();
         m_Settings.light_color = glm::vec3(1.0f);
         m_Settings.light_intensity = 1.0f;
@@ -436,7 +437,7 @@ if (ImGui::MenuItem("Point Light")) {
         light->SetLightIntensity(2.0f);
         light->SetLightRange(8.0f);
         // Для визуализации можно добавить меш-сферу (опционально)
-        light->SetMesh(Primitives::CreateSphere(16));
+        light->SetMesh(MeshRegistry::Get().GetPrimitive(PRIMITIVE_SPHERE, 16));
         light->SetScale(glm::vec3(0.2f));
     }
 }
@@ -450,7 +451,7 @@ if (ImGui::MenuItem("Spot Light")) {
         light->SetLightIntensity(3.0f);
         light->SetLightRange(12.0f);
         light->SetLightAngle(30.0f); // градусов
-        light->SetMesh(Primitives::CreateCone(16));
+        light->SetMesh(MeshRegistry::Get().GetPrimitive(PRIMITIVE_CONE, 16));
         light->SetScale(glm::vec3(0.3f));
     }
 }
@@ -477,12 +478,12 @@ if (ImGui::MenuItem("Camera")) {
     ImGui::Separator();
 if (ImGui::MenuItem("Cube")) {
     auto cube = m_SceneManager->CreateGameObject("Cube");
-    cube->SetMesh(Primitives::CreateCube());
+    cube->SetMesh(MeshRegistry::Get().GetPrimitive(PRIMITIVE_CUBE));
     cube->SetColor(glm::vec3(0.8f, 0.3f, 0.2f));
 }
 if (ImGui::MenuItem("Sphere")) {
     auto sphere = m_SceneManager->CreateGameObject("Sphere");
-    sphere->SetMesh(Primitives::CreateSphere());
+    sphere->SetMesh(MeshRegistry::Get().GetPrimitive(PRIMITIVE_SPHERE));
     sphere->SetColor(glm::vec3(0.3f, 0.8f, 0.2f));
 }
     ImGui::EndPopup();
@@ -721,15 +722,24 @@ if (ImGui::Checkbox("Enable Fog", &enabled)) {
                     if (ImGui::Combo("Mesh Type", &currentMesh, meshNames, IM_ARRAYSIZE(meshNames))) {
                         std::shared_ptr<Mesh> newMesh;
                         switch (currentMesh) {
-                            case 0: newMesh = Primitives::CreateCube(); break;
-                            case 1: newMesh = Primitives::CreateSphere(); break;
-                            case 2: newMesh = Primitives::CreateCylinder(); break;
-                            case 3: newMesh = Primitives::CreateCone(); break;
-                            case 4: newMesh = Primitives::CreatePyramid(); break;
-                            case 5: newMesh = Primitives::CreatePlane(); break;
+                            case 0: newMesh = MeshRegistry::Get().GetPrimitive(PRIMITIVE_CUBE); break;
+                            case 1: newMesh = MeshRegistry::Get().GetPrimitive(PRIMITIVE_SPHERE); break;
+                            case 2: newMesh = MeshRegistry::Get().GetPrimitive(PRIMITIVE_CYLINDER); break;
+                            case 3: newMesh = MeshRegistry::Get().GetPrimitive(PRIMITIVE_CONE); break;
+                            case 4: newMesh = MeshRegistry::Get().GetPrimitive(PRIMITIVE_PYRAMID); break;
+                            case 5: newMesh = MeshRegistry::Get().GetPrimitive(PRIMITIVE_PLANE); break;
                         }
                         if (newMesh) selected->SetMesh(newMesh);
                     }
+                    if (Mesh* mesh = selected->GetMeshPtr()) {
+                        // Треугольники каждого уровня; ">" — выбранный рендером в прошлом кадре
+                        for (int lod = 0; lod < mesh->GetLodCount(); ++lod) {
+                            const MeshLod& range = mesh->GetLod(lod);
+                            ImGui::Text("%s LOD %d: %u triangles, error %.4f", lod == selected->GetLod() ? ">" : " ",
+                                        lod, range.indexCount / 3, range.error);
+                        }
+                        if (!mesh->GetMeshlets().empty()) ImGui::Text("Meshlets: %zu", mesh->GetMeshlets().size());
+                    }
                 }
 
                 // Rendering (тени)
@@ -999,6 +1009,12 @@ void EditorUI::DrawSceneView() {
             }
         } // <-- закрываем if (selected && ...)
 
+        // Выбор объекта кликом (луч через AABB-дерево сцены)
+        if (m_ViewportHovered && ImGui::IsMouseClicked(0) && !m_GizmoActive &&
+            !(selected && m_Settings.show_gizmo && ImGuizmo::IsOver())) {
+            PickObjectAt(ImGui::GetMousePos());
+        }
+
         // Текст в углу...
         ImGui::SetCursorPos(ImVec2(10,10));
         ImGui::TextColored(ImVec4(1,1,1,0.7f), "Scene View");
@@ -1028,10 +1044,765 @@ void EditorUI::DrawSceneSettings() {
 
         ImGui::Separator();
         ImGui::Text("FPS: %.1f", ImGui::GetIO().Framerate);
+
+        if (m_SceneManager && ImGui::CollapsingHeader("Render Stats", ImGuiTreeNodeFlags_DefaultOpen)) {
+            const auto& stats = m_SceneManager->GetRenderStats();
+            ImGui::Text("Frame: %.2f ms", 1000.0f / (std::max)(ImGui::GetIO().Framerate, 0.001f));
+            ImGui::Text("Objects: %d", (int)m_SceneManager->GetObjects().size());
+            ImGui::Text("Draw calls: %d (shadow: %d)", stats.drawCalls, stats.shadowDrawCalls);
+            bool culling = m_SceneManager->IsFrustumCullingEnabled();
+            if (ImGui::Checkbox("Frustum Culling", &culling)) m_SceneManager->SetFrustumCullingEnabled(culling);
+            bool lods = m_SceneManager->IsLodEnabled();
+            if (ImGui::Checkbox("LOD", &lods)) m_SceneManager->SetLodEnabled(lods);
+            int shadowLodBias = m_SceneManager->GetShadowLodBias();
+            if (ImGui::SliderInt("Shadow LOD Bias", &shadowLodBias, 0, Mesh::kMaxLods - 1)) {
+                m_SceneManager->SetShadowLodBias(shadowLodBias);
+            }
+            ImGui::Text("Triangles: %.2f M (shadow: %.2f M)", stats.triangles / 1e6f, stats.shadowTriangles / 1e6f);
+            bool meshlets = m_SceneManager->IsMeshletCullingEnabled();
+            if (ImGui::Checkbox("Meshlet Culling", &meshlets)) m_SceneManager->SetMeshletCullingEnabled(meshlets);
+            ImGui::SameLine();
+            bool backface = m_SceneManager->IsMeshletBackfaceCullingEnabled();
+            if (ImGui::Checkbox("Backface Cones", &backface)) m_SceneManager->SetMeshletBackfaceCullingEnabled(backface);
+            ImGui::Text("Meshlets: %d tested, %d outside, %d backfacing, %d ranges, %.2f ms", stats.meshletsTested,
+                        stats.meshletsFrustumCulled, stats.meshletsBackfaceCulled, stats.meshletRanges,
+                        stats.meshletCullMs);
+            ImGui::Text("Camera: %d drawn, %d culled", stats.visibleObjects, stats.culledObjects);
+            ImGui::Text("Shadow: %d drawn, %d culled", stats.shadowCasters, stats.shadowCulled);
+            ImGui::Text("Transforms: %.2f ms, %d updated", stats.transformUpdateMs, stats.transformsUpdated);
+            ImGui::Text("Scene changes: %d entities, %.2f ms", stats.changedEntities, stats.changesMs);
+            ImGui::Text("Spatial: %.2f ms, %d moved, height %d", stats.spatialUpdateMs, stats.spatialMoved, stats.spatialHeight);
+            if (m_LightClusters) {
+                const auto& lights = m_LightClusters->GetStats();
+                ImGui::Text("Lights: %d (%d in view), max %d per cluster", lights.lights, lights.visibleLights, lights.maxPerCluster);
+                ImGui::Text("Clusters: %.2f ms on %d threads, %d indices", lights.buildMs, lights.threads, lights.indices);
+            }
+            ImGui::Text("Instanced: %d batches, %d objects", stats.instancedBatches, stats.instancedObjects);
+            // Неподвижные объекты с общим материалом -> мировые меши; сдвинутый объект выпадает из пакета сам
+            if (ImGui::Button("Bake Static Batches")) m_SceneManager->BakeStaticBatches();
+            ImGui::SameLine();
+            if (ImGui::Button("Clear Static Batches")) m_SceneManager->ClearStaticBatches();
+            StaticBatcher::Stats batches = m_SceneManager->GetStaticBatchStats();
+            ImGui::Text("Static: %zu batches, %zu objects, %.1fk triangles (baked in %.1f ms)", batches.chunks,
+                        batches.objects, batches.triangles / 1000.0f, batches.bakeMs);
+            ImGui::Text("Static drawn: %d batches, %d objects", stats.staticBatches, stats.staticObjects);
+            bool arrays = m_SceneManager->IsTextureArraysEnabled();
+            if (ImGui::Checkbox("Texture Arrays", &arrays)) m_SceneManager->SetTextureArraysEnabled(arrays);
+            if (arrays) {
+                auto table = m_SceneManager->GetMaterialTableStats();
+                ImGui::Text("Materials: %d in %d pools, %d layers, %.1f MB", table.materials, table.pools,
+                            table.layers, table.bytes / (1024.0f * 1024.0f));
+            }
+            ImGui::Text("Binds: %d issued, %d skipped (shadow: %d / %d)", stats.bindsIssued, stats.bindsSkipped,
+                        stats.shadowBindsIssued, stats.shadowBindsSkipped);
+            ImGui::Text("Render queue: %.2f ms", stats.sortMs);
+            ImGui::Text("CPU Render: %.2f ms, Depth: %.2f ms", stats.renderCpuMs, stats.depthCpuMs);
+            TextureManager::Stats textures = TextureManager::Get().GetStats();
+            ImGui::Text("Textures: %u live, %u pending, %u failed", textures.liveTextures, textures.pending, textures.failed);
+            ImGui::Text("Texture requests: %u, dedup hits: %u", textures.requests, textures.dedupHits);
+            ImGui::Text("Decode: %.1f ms (%u images), upload: %.1f ms", textures.decodeMs, textures.decoded, textures.uploadMs);
+            MeshRegistry::Stats meshes = MeshRegistry::Get().GetStats();
+            ImGui::Text("Shared meshes: %u live, %u references", meshes.liveMeshes, meshes.references);
+            ImGui::Text("Mesh requests: %u, reused: %u, primitives built: %u", meshes.requests, meshes.hits, meshes.created);
+            const float mb = 1.0f / (1024.0f * 1024.0f);
+            // Раскладка применяется к мешам, созданным после переключения
+            const char* vertexFormats[] = { "Float (48 B)", "Packed, octahedral (20 B)", "Packed, 10-10-10-2 (20 B)" };
+            const VertexFormat& current = Mesh::GetDefaultVertexFormat();
+            int formatIndex = current.IsFloat() ? 0 : (current.normal == VERTEX_NORMAL_OCTAHEDRAL ? 1 : 2);
+            if (ImGui::Combo("Vertex Format", &formatIndex, vertexFormats, IM_ARRAYSIZE(vertexFormats))) {
+                if (formatIndex == 0) Mesh::SetDefaultVertexFormat(VertexFormat::Float());
+                else if (formatIndex == 1) Mesh::SetDefaultVertexFormat(VertexFormat::Packed(VERTEX_NORMAL_OCTAHEDRAL));
+                else Mesh::SetDefaultVertexFormat(VertexFormat::Packed(VERTEX_NORMAL_INT_2_10_10_10));
+            }
+            ImGui::Text("Vertex memory: %.1f MB (%.1f MB as float)", meshes.vertexBytes * mb, meshes.floatVertexBytes * mb);
+            ImGui::Text("Index memory: %.1f MB, 16-bit in %u of %u meshes", meshes.indexBytes * mb,
+                        meshes.shortIndexMeshes, meshes.liveMeshes);
+            ImGui::Text("Compressed: %u (%u from cache), encode: %.1f ms", textures.compressedTextures,
+                        textures.cacheHits, textures.compressMs);
+            ImGui::Text("Texture memory: %.1f MB, saved %.1f MB (%.1f -> %.1f MB compressed)", textures.gpuBytes * mb,
+                        (textures.compressedSourceBytes - textures.compressedBytes) * mb,
+                        textures.compressedSourceBytes * mb, textures.compressedBytes * mb);
+        }
     }
     ImGui::End();
 }
 
+void EditorUI::DrawStressTestMenu() {
+    if (ImGui::BeginMenu("Stress Test")) {
+        if (ImGui::MenuItem("Spawn 10k Cubes")) SpawnStressCubes(10000);
+        if (ImGui::MenuItem("Spawn 100k Cubes")) SpawnStressCubes(100000);
+        if (ImGui::MenuItem("Spawn 1000 Point Lights")) SpawnStressLights(1000);
+        if (ImGui::MenuItem("Spawn 50k Hierarchy (10 levels)")) SpawnStressHierarchy(50000, 10);
+        ImGui::Separator();
+        ImGui::MenuItem("Move 5% Per Frame", nullptr, &m_StressMoving);
+        // Пакетное удаление всего поддерева; время — в консоли
+        if (ImGui::MenuItem("Delete Stress Objects", nullptr, false, !m_StressRoot.expired() && m_SceneManager)) {
+            m_SceneManager->DeleteGameObject(m_StressRoot.lock().get());
+        }
+        ImGui::Separator();
+        if (ImGui::MenuItem("Benchmark Component Iteration")) RunIterationBenchmark();
+        if (ImGui::MenuItem("Benchmark Scene Save/Load")) RunSceneRoundTripBenchmark();
+        if (ImGui::MenuItem("Benchmark Primitive Spawn")) RunPrimitiveSpawnBenchmark();
+        if (ImGui::MenuItem("Benchmark Vertex Packing")) RunVertexPackingBenchmark();
+        if (ImGui::MenuItem("Benchmark Mesh Optimizer")) RunMeshOptimizerBenchmark();
+        if (ImGui::MenuItem("Benchmark Tangent Generation")) RunTangentBenchmark();
+        if (ImGui::MenuItem("Benchmark Fly-Through (LOD, Meshlets)")) RunFlythroughBenchmark();
+        if (ImGui::MenuItem("Benchmark Static Batching")) RunStaticBatchBenchmark();
+        ImGui::EndMenu();
+    }
+}
+
+void EditorUI::SpawnStressCubes(int count) {
+    if (!m_SceneManager) return;
+    // Все кубы делят один меш и материал — как после Duplicate
+    auto mesh = MeshRegistry::Get().GetPrimitive(PRIMITIVE_CUBE);
+    auto material = std::make_shared<Material>();
+    auto root = m_SceneManager->CreateGameObject("Stress Test (" + std::to_string(count) + ")");
+
+    int side = (int)std::ceil(std::sqrt((float)count));
+    for (int i = 0; i < count; ++i) {
+        auto cube = m_SceneManager->CreateGameObject("Cube");
+        cube->SetMesh(mesh);
+        cube->SetMaterial(material);
+        cube->SetPosition(glm::vec3((i % side - side * 0.5f) * 1.5f, 0.5f, (i / side - side * 0.5f) * 1.5f));
+        cube->SetColor(glm::vec3((i % 7) / 7.0f, (i % 5) / 5.0f, (i % 3) / 3.0f));
+        root->AddChild(cube);
+    }
+    m_StressRoot = root;
+    m_StressMoveOffset = 0;
+    std::cout << "Stress test: spawned " << count << " cubes" << std::endl;
+}
+
+void EditorUI::SpawnStressLights(int count) {
+    if (!m_SceneManager) return;
+    auto root = m_SceneManager->CreateGameObject("Stress Lights (" + std::to_string(count) + ")");
+
+    // Раскладываем по той же площади, что и кубы из Spawn 100k
+    int side = (int)std::ceil(std::sqrt((float)count));
+    float spacing = 450.0f / side;
+    for (int i = 0; i < count; ++i) {
+        auto light = m_SceneManager->CreateGameObject("Point Light");
+        light->SetLightType(LT_POINT);
+        light->SetPosition(glm::vec3((i % side - side * 0.5f) * spacing, 1.5f, (i / side - side * 0.5f) * spacing));
+        light->SetLightColor(glm::vec3(0.3f + 0.7f * ((i * 37) % 11) / 10.0f,
+                                       0.3f + 0.7f * ((i * 53) % 13) / 12.0f,
+                                       0.3f + 0.7f * ((i * 71) % 17) / 16.0f));
+        light->SetLightIntensity(2.0f);
+        light->SetLightRange(spacing * 1.5f);
+        root->AddChild(light);
+    }
+    std::cout << "Stress test: spawned " << count << " point lights" << std::endl;
+}
+
+void EditorUI::SpawnStressHierarchy(int count, int depth) {
+    if (!m_SceneManager) return;
+    auto mesh = MeshRegistry::Get().GetPrimitive(PRIMITIVE_CUBE);
+    auto material = std::make_shared<Material>();
+    auto root = m_SceneManager->CreateGameObject("Stress Hierarchy (" + std::to_string(count) + ")");
+
+    // Цепочки "рука": каждый уровень сдвинут, повёрнут и уменьшен относительно родителя
+    int chains = (std::max)(count / depth, 1);
+    int side = (int)std::ceil(std::sqrt((float)chains));
+    for (int c = 0; c < chains; ++c) {
+        std::shared_ptr<GameObject> parent = root;
+        for (int level = 0; level < depth; ++level) {
+            auto node = m_SceneManager->CreateGameObject("Node");
+            node->SetMesh(mesh);
+            node->SetMaterial(material);
+            if (level == 0) {
+                node->SetPosition(glm::vec3((c % side - side * 0.5f) * 3.0f, 0.5f, (c / side - side * 0.5f) * 3.0f));
+            } else {
+                node->SetPosition(glm::vec3(0.0f, 1.2f, 0.0f));
+                node->SetRotation(glm::vec3(0.0f, 20.0f, 10.0f));
+                node->SetScale(glm::vec3(0.9f));
+            }
+            node->SetColor(glm::vec3(level / (float)depth, (c % 5) / 5.0f, 1.0f - level / (float)depth));
+            parent->AddChild(node);
+            parent = node;
+        }
+    }
+    // "Move 5% Per Frame" двигает корни цепочек — пересчитывается вся цепочка
+    m_StressRoot = root;
+    m_StressMoveOffset = 0;
+    std::cout << "Stress test: spawned " << chains * depth << " nodes in " << chains
+              << " chains of depth " << depth << std::endl;
+}
+
+void EditorUI::RunIterationBenchmark() {
+    if (!m_SceneManager) return;
+    // Одна и та же работа двумя способами: сбор видимых мешей (позиция) и
+    // источников света. Матрицы уже актуальны — меряется только обход данных.
+    const int kRuns = 10;
+    const auto& objects = m_SceneManager->GetObjects();
+    glm::vec3 sum(0.0f);
+    size_t renderables = 0, lights = 0;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int run = 0; run < kRuns; ++run) {
+        for (const auto& obj : objects) {
+            if (obj->IsVisible() && obj->GetMeshPtr()) {
+                sum += glm::vec3(obj->GetTransformMatrix()[3]);
+                renderables++;
+            }
+            if (obj->GetLightType() != LT_NONE) {
+                sum += obj->GetLightColor() * obj->GetLightIntensity();
+                lights++;
+            }
+        }
+    }
+    auto facadeEnd = std::chrono::high_resolution_clock::now();
+
+    SceneRegistry& registry = SceneRegistry::Get();
+    for (int run = 0; run < kRuns; ++run) {
+        const std::vector<Entity>& rendererEntities = registry.renderers.GetEntities();
+        const std::vector<MeshRendererComponent>& renderers = registry.renderers.GetData();
+        for (size_t i = 0; i < renderers.size(); ++i) {
+            if (!renderers[i].visible || !renderers[i].mesh || !registry.IsInScene(rendererEntities[i])) continue;
+            sum += glm::vec3(registry.transforms.worlds[registry.transforms.Index(rendererEntities[i])][3]);
+            renderables++;
+        }
+        const std::vector<Entity>& lightEntities = registry.lights.GetEntities();
+        const std::vector<LightComponent>& lightData = registry.lights.GetData();
+        for (size_t i = 0; i < lightData.size(); ++i) {
+            if (!registry.IsInScene(lightEntities[i])) continue;
+            sum += lightData[i].color * lightData[i].intensity;
+            lights++;
+        }
+    }
+    auto poolEnd = std::chrono::high_resolution_clock::now();
+
+    float facadeMs = std::chrono::duration<float, std::milli>(facadeEnd - start).count() / kRuns;
+    float poolMs = std::chrono::duration<float, std::milli>(poolEnd - facadeEnd).count() / kRuns;
+    std::cout << "[Benchmark] " << objects.size() << " entities, " << renderables / (2 * kRuns)
+              << " renderables, " << lights / (2 * kRuns) << " lights: GameObject " << facadeMs
+              << " ms, component pools " << poolMs << " ms (checksum " << sum.x + sum.y + sum.z << ")" << std::endl;
+}
+
+void EditorUI::RunPrimitiveSpawnBenchmark() {
+    // Сфера точечного источника, как в меню Create: 1000 раз
+    const int kCount = 1000;
+    auto start = std::chrono::high_resolution_clock::now();
+    {
+        std::vector<std::shared_ptr<Mesh>> meshes;
+        meshes.reserve(kCount);
+        for (int i = 0; i < kCount; ++i) meshes.push_back(Primitives::CreateSphere(16));
+    }
+    auto directEnd = std::chrono::high_resolution_clock::now();
+    std::vector<std::shared_ptr<Mesh>> shared;
+    shared.reserve(kCount);
+    for (int i = 0; i < kCount; ++i) shared.push_back(MeshRegistry::Get().GetPrimitive(PRIMITIVE_SPHERE, 16));
+    auto sharedEnd = std::chrono::high_resolution_clock::now();
+
+    float directMs = std::chrono::duration<float, std::milli>(directEnd - start).count();
+    float sharedMs = std::chrono::duration<float, std::milli>(sharedEnd - directEnd).count();
+    std::cout << "[Benchmark] " << kCount << " light spheres: new mesh each " << directMs << " ms ("
+              << kCount << " VAOs), MeshRegistry " << sharedMs << " ms (1 VAO)" << std::endl;
+}
+
+void EditorUI::RunVertexPackingBenchmark() {
+    // Миллион вершин на сфере радиусом 50 с зеркальной половиной развёртки
+    const size_t kCount = 1000000;
+    std::vector<Vertex> vertices(kCount);
+    AABB bounds;
+    for (size_t i = 0; i < kCount; ++i) {
+        float theta = (float)i * 2.399963f;     // золотой угол
+        float z = 1.0f - 2.0f * (i + 0.5f) / kCount;
+        float r = std::sqrt(1.0f - z * z);
+        glm::vec3 n(r * std::cos(theta), r * std::sin(theta), z);
+        glm::vec3 t = glm::normalize(glm::vec3(-n.y, n.x, 0.0f) + glm::vec3(1e-4f, 0.0f, 0.0f));
+        Vertex& v = vertices[i];
+        for (int k = 0; k < 3; ++k) {
+            v.Position[k] = n[k] * 50.0f;
+            v.Normal[k] = n[k];
+            v.Tangent[k] = t[k];
+        }
+        v.TexCoords[0] = theta / 6.2831853f;
+        v.TexCoords[1] = z * 0.5f + 0.5f;
+        v.TangentSign = (i & 1) ? -1.0f : 1.0f;
+        if (i == 0) bounds.min = bounds.max = n * 50.0f;
+        bounds.Expand(n * 50.0f);
+    }
+
+    const VertexFormat formats[] = {
+        VertexFormat::Float(),
+        VertexFormat::Packed(VERTEX_NORMAL_OCTAHEDRAL),
+        VertexFormat::Packed(VERTEX_NORMAL_INT_2_10_10_10)
+    };
+    const char* names[] = { "float", "octahedral", "10-10-10-2" };
+    for (int f = 0; f < 3; ++f) {
+        const VertexFormat& format = formats[f];
+        VertexQuantization quantization;
+        if (format.position == VERTEX_POSITION_UNORM16) quantization = VertexQuantization::FromBounds(bounds);
+        std::vector<uint8_t> packed(kCount * format.GetStride());
+        auto start = std::chrono::high_resolution_clock::now();
+        VertexPacker::Pack(vertices.data(), kCount, format, quantization, packed.data());
+        auto end = std::chrono::high_resolution_clock::now();
+        std::cout << "[Benchmark] Vertex packing, " << names[f] << ": " << format.GetStride() << " B/vertex, "
+                  << packed.size() / (1024 * 1024) << " MB, "
+                  << std::chrono::duration<float, std::milli>(end - start).count() << " ms per 1M vertices" << std::endl;
+    }
+}
+
+void EditorUI::RunMeshOptimizerBenchmark() {
+    // Сетка 512x512 квадов с перемешанными треугольниками — так выглядит
+    // выгрузка из CAD без оптимизации
+    const int kSize = 512;
+    std::vector<Vertex> vertices((kSize + 1) * (kSize + 1));
+    for (int z = 0; z <= kSize; ++z) {
+        for (int x = 0; x <= kSize; ++x) {
+            Vertex& v = vertices[z * (kSize + 1) + x];
+            v.Position[0] = (float)x;
+            v.Position[1] = std::sin(x * 0.05f) * std::cos(z * 0.05f) * 4.0f;
+            v.Position[2] = (float)z;
+            v.Normal[0] = v.Normal[2] = 0.0f;
+            v.Normal[1] = 1.0f;
+            v.TexCoords[0] = (float)x / kSize;
+            v.TexCoords[1] = (float)z / kSize;
+            v.Tangent[0] = 1.0f;
+            v.Tangent[1] = v.Tangent[2] = 0.0f;
+        }
+    }
+    std::vector<unsigned int> triangles;
+    triangles.reserve(kSize * kSize * 6);
+    for (int z = 0; z < kSize; ++z) {
+        for (int x = 0; x < kSize; ++x) {
+            unsigned int i = z * (kSize + 1) + x;
+            unsigned int quad[6] = { i, i + kSize + 1, i + 1, i + 1, i + kSize + 1, i + kSize + 2 };
+            triangles.insert(triangles.end(), quad, quad + 6);
+        }
+    }
+    srand(12345);
+    size_t triangleCount = triangles.size() / 3;
+    for (size_t t = triangleCount - 1; t > 0; --t) {
+        size_t other = ((size_t)rand() * (RAND_MAX + 1u) + rand()) % (t + 1);
+        for (int k = 0; k < 3; ++k) std::swap(triangles[t * 3 + k], triangles[other * 3 + k]);
+    }
+
+    VertexCacheStats before, after;
+    auto start = std::chrono::high_resolution_clock::now();
+    MeshOptimizer::Optimize(vertices.data(), vertices.size(), triangles.data(), triangles.size(), &before, &after);
+    float ms = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    std::cout << "[Benchmark] Mesh optimizer, " << triangleCount << " shuffled triangles: ACMR " << before.GetACMR()
+              << " -> " << after.GetACMR() << ", ATVR " << before.GetATVR() << " -> " << after.GetATVR()
+              << ", " << ms << " ms" << std::endl;
+}
+
+// Прежний расчёт касательных примитивов (сумма по треугольникам без весов,
+// знак — по сумме битангенсов): точка отсчёта для RunTangentBenchmark
+static void ComputeTangentsLegacy(std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices) {
+    std::vector<glm::vec3> tan1(vertices.size(), glm::vec3(0.0f));
+    std::vector<glm::vec3> tan2(vertices.size(), glm::vec3(0.0f));
+    for (size_t i = 0; i + 3 <= indices.size(); i += 3) {
+        unsigned int t[3] = { indices[i], indices[i + 1], indices[i + 2] };
+        glm::vec3 p[3];
+        glm::vec2 uv[3];
+        for (int k = 0; k < 3; ++k) {
+            p[k] = glm::vec3(vertices[t[k]].Position[0], vertices[t[k]].Position[1], vertices[t[k]].Position[2]);
+            uv[k] = glm::vec2(vertices[t[k]].TexCoords[0], vertices[t[k]].TexCoords[1]);
+        }
+        glm::vec3 edge1 = p[1] - p[0], edge2 = p[2] - p[0];
+        glm::vec2 duv1 = uv[1] - uv[0], duv2 = uv[2] - uv[0];
+        float det = duv1.x * duv2.y - duv2.x * duv1.y;
+        if (std::fabs(det) < 1e-6f) continue;
+        glm::vec3 tangent = (edge1 * duv2.y - edge2 * duv1.y) / det;
+        glm::vec3 bitangent = (edge2 * duv1.x - edge1 * duv2.x) / det;
+        for (int k = 0; k < 3; ++k) {
+            tan1[t[k]] += tangent;
+            tan2[t[k]] += bitangent;
+        }
+    }
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        glm::vec3 n(vertices[i].Normal[0], vertices[i].Normal[1], vertices[i].Normal[2]);
+        glm::vec3 tangent = glm::normalize(tan1[i] - n * glm::dot(n, tan1[i]));
+        for (int k = 0; k < 3; ++k) vertices[i].Tangent[k] = tangent[k];
+        vertices[i].TangentSign = glm::dot(glm::cross(n, tan1[i]), tan2[i]) < 0.0f ? -1.0f : 1.0f;
+    }
+}
+
+void EditorUI::RunTangentBenchmark() {
+    // Холмистая сетка 1000x1000 квадов (2M треугольников), развёртка повторяется
+    // 16 раз — у прежнего расчёта порог по площади UV не срабатывает
+    const int kSize = 1000;
+    std::vector<Vertex> vertices((kSize + 1) * (kSize + 1));
+    for (int z = 0; z <= kSize; ++z) {
+        for (int x = 0; x <= kSize; ++x) {
+            Vertex& v = vertices[z * (kSize + 1) + x];
+            float dx = 0.2f * std::cos(x * 0.05f) * std::cos(z * 0.05f);
+            float dz = -0.2f * std::sin(x * 0.05f) * std::sin(z * 0.05f);
+            glm::vec3 n = glm::normalize(glm::vec3(-dx, 1.0f, -dz));
+            v.Position[0] = (float)x;
+            v.Position[1] = std::sin(x * 0.05f) * std::cos(z * 0.05f) * 4.0f;
+            v.Position[2] = (float)z;
+            v.Normal[0] = n.x;
+            v.Normal[1] = n.y;
+            v.Normal[2] = n.z;
+            v.TexCoords[0] = (float)x / kSize * 16.0f;
+            v.TexCoords[1] = (float)z / kSize * 16.0f;
+        }
+    }
+    std::vector<unsigned int> triangles;
+    triangles.reserve(kSize * kSize * 6);
+    for (int z = 0; z < kSize; ++z) {
+        for (int x = 0; x < kSize; ++x) {
+            unsigned int i = z * (kSize + 1) + x;
+            unsigned int quad[6] = { i, i + kSize + 1, i + 1, i + 1, i + kSize + 1, i + kSize + 2 };
+            triangles.insert(triangles.end(), quad, quad + 6);
+        }
+    }
+
+    std::vector<Vertex> legacy = vertices, single = vertices, parallel = vertices;
+    auto start = std::chrono::high_resolution_clock::now();
+    ComputeTangentsLegacy(legacy, triangles);
+    auto legacyEnd = std::chrono::high_resolution_clock::now();
+    TangentGenerator::Generate(single.data(), single.size(), triangles.data(), triangles.size(), 1);
+    auto singleEnd = std::chrono::high_resolution_clock::now();
+    TangentGenerator::Generate(parallel.data(), parallel.size(), triangles.data(), triangles.size());
+    auto parallelEnd = std::chrono::high_resolution_clock::now();
+
+    // Расхождение с прежним расчётом: тот взвешивает площадью, MikkTSpace — углом
+    float maxAngle = 0.0f;
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        glm::vec3 a(legacy[i].Tangent[0], legacy[i].Tangent[1], legacy[i].Tangent[2]);
+        glm::vec3 b(parallel[i].Tangent[0], parallel[i].Tangent[1], parallel[i].Tangent[2]);
+        maxAngle = (std::max)(maxAngle, std::acos(glm::clamp(glm::dot(a, b), -1.0f, 1.0f)));
+    }
+    bool identical = memcmp(single.data(), parallel.data(), single.size() * sizeof(Vertex)) == 0;
+    auto ms = [](std::chrono::high_resolution_clock::time_point a, std::chrono::high_resolution_clock::time_point b) {
+        return std::chrono::duration<float, std::milli>(b - a).count();
+    };
+    std::cout << "[Benchmark] Tangents, " << triangles.size() / 3 << " triangles: legacy " << ms(start, legacyEnd)
+              << " ms, generator 1 thread " << ms(legacyEnd, singleEnd) << " ms, "
+              << std::thread::hardware_concurrency() << " threads " << ms(singleEnd, parallelEnd)
+              << " ms; bit-identical: " << (identical ? "yes" : "NO")
+              << ", max difference from legacy " << glm::degrees(maxAngle) << " deg" << std::endl;
+}
+
+void EditorUI::RunFlythroughBenchmark() {
+    if (!m_SceneManager) return;
+    // Камера облетает сцену по спирали: издалека к центру и обратно. Одна и та же
+    // траектория в каждом режиме; считаются треугольники, которые ушли бы в GPU
+    AABB bounds = m_SceneManager->GetSceneBounds();
+    glm::vec3 center = bounds.GetCenter();
+    float radius = (std::max)(glm::length(bounds.GetExtents()), 1.0f);
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, radius * 8.0f);
+    const int kFrames = 240;
+    const bool lodEnabled = m_SceneManager->IsLodEnabled();
+    const bool meshletsEnabled = m_SceneManager->IsMeshletCullingEnabled();
+
+    struct Mode {
+        const char* name;
+        bool lod;
+        bool meshlets;
+    };
+    const Mode modes[] = { { "LOD + meshlets", true, true }, { "LOD", true, false },
+                           { "meshlets", false, true }, { "none", false, false } };
+    const int kModes = IM_ARRAYSIZE(modes);
+    size_t triangles[kModes] = {};
+    float ms[kModes] = {};
+    for (int pass = 0; pass < kModes; ++pass) {
+        m_SceneManager->SetLodEnabled(modes[pass].lod);
+        m_SceneManager->SetMeshletCullingEnabled(modes[pass].meshlets);
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int frame = 0; frame < kFrames; ++frame) {
+            float t = (float)frame / (kFrames - 1);
+            float angle = t * 4.0f * 3.14159265f;
+            float distance = radius * (0.1f + 2.9f * std::fabs(1.0f - 2.0f * t));
+            glm::vec3 eye = center + glm::vec3(std::cos(angle) * distance, radius * 0.25f, std::sin(angle) * distance);
+            glm::mat4 view = glm::lookAt(eye, center, glm::vec3(0.0f, 1.0f, 0.0f));
+            triangles[pass] += m_SceneManager->CountSubmittedTriangles(view, projection);
+        }
+        ms[pass] = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+    m_SceneManager->SetLodEnabled(lodEnabled);
+    m_SceneManager->SetMeshletCullingEnabled(meshletsEnabled);
+
+    const size_t baseline = triangles[kModes - 1];
+    for (int pass = 0; pass < kModes; ++pass) {
+        float saved = baseline ? 100.0f * (1.0f - (float)triangles[pass] / (float)baseline) : 0.0f;
+        std::cout << "[Benchmark] Fly-through, " << kFrames << " frames, " << modes[pass].name << ": "
+                  << triangles[pass] / kFrames << " triangles/frame (-" << saved << "%), "
+                  << ms[pass] << " ms in queue and culling" << std::endl;
+    }
+}
+
+void EditorUI::RunStaticBatchBenchmark() {
+    if (!m_SceneManager) return;
+    // Неподвижный уровень: плиты пола со статическим коллайдером (масса 0) и
+    // реквизит без тела, 4 материала. После запекания кадры гоняются через
+    // UpdatePhysics/Update: статические тела не должны выпадать из пакетов.
+    // Симуляция не включается — иначе сдвинулись бы динамические тела сцены
+    const int kSide = 24;
+    const int kMaterials = 4;
+    const int kFrames = 60;
+    // Запекание берёт всю сцену — пакеты пользователя потом пересобираются
+    bool hadBatches = m_SceneManager->GetStaticBatchStats().objects > 0;
+    std::vector<std::shared_ptr<Material>> materials;
+    for (int m = 0; m < kMaterials; ++m) {
+        auto material = std::make_shared<Material>();
+        material->roughness = 0.2f + 0.2f * m;
+        materials.push_back(material);
+    }
+    auto cube = MeshRegistry::Get().GetPrimitive(PRIMITIVE_CUBE);
+    auto sphere = MeshRegistry::Get().GetPrimitive(PRIMITIVE_SPHERE);
+    std::vector<GameObject*> created;
+    for (int i = 0; i < kSide * kSide; ++i) {
+        glm::vec3 cell((i % kSide - kSide * 0.5f) * 4.0f, 0.0f, (i / kSide - kSide * 0.5f) * 4.0f);
+        auto tile = m_SceneManager->CreateGameObject("Batch Floor");
+        tile->SetMesh(cube);
+        tile->SetMaterial(materials[i % kMaterials]);
+        tile->SetPosition(cell + glm::vec3(0.0f, -0.25f, 0.0f));
+        tile->SetScale(glm::vec3(4.0f, 0.5f, 4.0f));
+        tile->SetColliderType(COLLIDER_BOX);
+        auto prop = m_SceneManager->CreateGameObject("Batch Prop");
+        prop->SetMesh(sphere);
+        prop->SetMaterial(materials[(i / kSide) % kMaterials]);
+        prop->SetPosition(cell + glm::vec3(1.0f, 0.5f, 1.0f));
+        created.push_back(tile.get());
+        created.push_back(prop.get());
+    }
+    m_SceneManager->Update(0.0f);
+
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 500.0f);
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 40.0f, 70.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    int before = m_SceneManager->CountSubmittedDraws(view, projection);
+    m_SceneManager->BakeStaticBatches();
+    StaticBatcher::Stats baked = m_SceneManager->GetStaticBatchStats();
+    int after = m_SceneManager->CountSubmittedDraws(view, projection);
+    for (int frame = 0; frame < kFrames; ++frame) {
+        m_SceneManager->UpdatePhysics(1.0f / 60.0f);
+        m_SceneManager->Update(1.0f / 60.0f);
+    }
+    StaticBatcher::Stats settled = m_SceneManager->GetStaticBatchStats();
+    int afterFrames = m_SceneManager->CountSubmittedDraws(view, projection);
+
+    std::cout << "[Benchmark] Static batching, " << created.size() << " objects (" << kSide * kSide
+              << " with static colliders): " << before << " draws -> " << after << " after bake ("
+              << baked.objects << " objects in " << baked.chunks << " batches, " << baked.bakeMs << " ms); after "
+              << kFrames << " frames: " << afterFrames << " draws, " << settled.objects << " still batched"
+              << std::endl;
+    m_SceneManager->DeleteGameObjects(created);
+    if (hadBatches) {
+        m_SceneManager->BakeStaticBatches();
+    } else {
+        m_SceneManager->ClearStaticBatches();
+    }
+}
+
+void EditorUI::RunSceneRoundTripBenchmark() {
+    if (!m_SceneManager) return;
+    // Текущая сцена временно откладывается в файл и возвращается после замера.
+    // Меш без пути ассета при этом потерялся бы — тогда не запускаемся
+    size_t unsaved = 0;
+    for (const auto& object : m_SceneManager->GetObjects()) {
+        if (object->GetMesh() && object->GetMesh()->GetAssetPath().empty()) unsaved++;
+    }
+    if (unsaved > 0 || !m_Imports.empty()) {
+        std::cerr << "[Benchmark] Scene round trip skipped: " << unsaved
+                  << " objects use meshes without an asset path, " << m_Imports.size()
+                  << " imports in progress; the open scene could not be restored" << std::endl;
+        return;
+    }
+    const std::filesystem::path dir = std::filesystem::temp_directory_path();
+    const std::string backup = (dir / "binax_benchmark_backup.binax").string();
+    const std::string first = (dir / "binax_benchmark.binax").string();
+    const std::string second = (dir / "binax_benchmark_roundtrip.binax").string();
+    bool hadBatches = m_SceneManager->GetStaticBatchStats().objects > 0;
+    if (!m_SceneManager->SaveScene(backup)) {
+        std::cerr << "[Benchmark] Scene round trip skipped: cannot save the open scene" << std::endl;
+        return;
+    }
+
+    // Синтетическая сцена на 100k объектов: группы из корня со статическим
+    // коллайдером и 99 детей, два примитива, 8 материалов, каждый 50-й — свет
+    const int kGroups = 1000;
+    const int kChildren = 99;
+    const int kMaterials = 8;
+    m_SceneManager->ClearScene();
+    auto cube = MeshRegistry::Get().GetPrimitive(PRIMITIVE_CUBE);
+    auto sphere = MeshRegistry::Get().GetPrimitive(PRIMITIVE_SPHERE);
+    std::vector<std::shared_ptr<Material>> materials;
+    for (int m = 0; m < kMaterials; ++m) {
+        auto material = std::make_shared<Material>();
+        material->roughness = (m + 1) / (float)kMaterials;
+        material->metallic = (m % 2) ? 1.0f : 0.0f;
+        materials.push_back(material);
+    }
+    int side = (int)std::ceil(std::sqrt((float)kGroups));
+    for (int g = 0; g < kGroups; ++g) {
+        auto root = m_SceneManager->CreateGameObject("Group " + std::to_string(g));
+        root->SetMesh(cube);
+        root->SetMaterial(materials[g % kMaterials]);
+        root->SetPosition(glm::vec3((g % side - side * 0.5f) * 12.0f, 0.5f, (g / side - side * 0.5f) * 12.0f));
+        for (int c = 0; c < kChildren; ++c) {
+            auto child = m_SceneManager->CreateGameObject("Item");
+            child->SetPosition(glm::vec3((c % 10) - 4.5f, 1.0f + c / 10, 0.0f));
+            child->SetRotation(glm::vec3(0.0f, (float)(c * 7 % 360), 0.0f));
+            if (c % 50 == 49) {
+                child->SetLightType(LT_POINT);
+                child->SetLightRange(6.0f);
+            } else {
+                child->SetMesh(c % 2 ? sphere : cube);
+                child->SetMaterial(materials[(g + c) % kMaterials]);
+                child->SetColor(glm::vec3((c % 7) / 7.0f, (c % 5) / 5.0f, (c % 3) / 3.0f));
+            }
+            root->AddChild(child);
+        }
+        // Тело только у корня: объекты с физикой не бывают в иерархии
+        root->SetColliderType(COLLIDER_BOX);
+    }
+    size_t objectCount = m_SceneManager->GetObjects().size();
+
+    auto start = std::chrono::high_resolution_clock::now();
+    bool ok = m_SceneManager->SaveScene(first);
+    auto saved = std::chrono::high_resolution_clock::now();
+    ok = ok && m_SceneManager->LoadScene(first);
+    auto loaded = std::chrono::high_resolution_clock::now();
+    ok = ok && m_SceneManager->SaveScene(second);
+
+    // Повторное сохранение загруженной сцены должно дать тот же файл
+    auto readAll = [](const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::vector<char>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    };
+    if (ok) {
+        bool identical = readAll(first) == readAll(second);
+        std::cout << "[Benchmark] Scene round trip, " << objectCount << " objects: save "
+                  << std::chrono::duration<float, std::milli>(saved - start).count() << " ms, load "
+                  << std::chrono::duration<float, std::milli>(loaded - saved).count() << " ms, re-saved file "
+                  << (identical ? "identical" : "DIFFERS") << std::endl;
+    } else {
+        std::cerr << "[Benchmark] Scene round trip failed" << std::endl;
+    }
+
+    // Возвращаем открытую сцену (и её пакеты, если были)
+    if (m_SceneManager->LoadScene(backup)) {
+        if (hadBatches) m_SceneManager->BakeStaticBatches();
+    } else {
+        std::cerr << "[Benchmark] Cannot restore the open scene, it stays in " << backup << std::endl;
+        return;
+    }
+    std::error_code error;
+    for (const std::string& path : { backup, first, second }) std::filesystem::remove(path, error);
+}
+
+void EditorUI::UpdateStressMotion() {
+    auto root = m_StressRoot.lock();
+    if (!m_StressMoving || !root) return;
+    const auto& cubes = root->GetChildren();
+    if (cubes.empty()) return;
+
+    // Каждый кадр двигается своё окно из 5% кубов
+    size_t moveCount = (std::max)(cubes.size() / 20, (size_t)1);
+    float time = (float)ImGui::GetTime();
+    for (size_t n = 0; n < moveCount; ++n) {
+        size_t i = (m_StressMoveOffset + n) % cubes.size();
+        glm::vec3 pos = cubes[i]->GetPosition();
+        pos.y = 0.5f + 2.0f * std::abs(std::sin(time + (float)i));
+        cubes[i]->SetPosition(pos);
+    }
+    m_StressMoveOffset = (m_StressMoveOffset + moveCount) % cubes.size();
+}
+
+void EditorUI::StartModelImport(const std::string& path) {
+    if (!m_SceneManager) return;
+    PendingImport import;
+    import.job = std::make_unique<ModelImportJob>(path);
+    import.root = m_SceneManager->CreateGameObject(GetFileNameWithoutExt(path) + " (importing)");
+    m_Imports.push_back(std::move(import));
+}
+
+void EditorUI::UpdateModelImports() {
+    // Бюджет загрузки в GPU на кадр (на все задания вместе)
+    const float kImportBudgetMs = 4.0f;
+    float budget = m_Imports.empty() ? 0.0f : kImportBudgetMs / (float)m_Imports.size();
+
+    for (size_t i = 0; i < m_Imports.size();) {
+        PendingImport& import = m_Imports[i];
+        ModelImportJob& job = *import.job;
+        job.Update(budget);
+        auto root = import.root.lock();
+
+        if (job.GetState() == ModelImportJob::IMPORT_FAILED) {
+            std::cerr << "Failed to load model: " << job.GetPath() << std::endl;
+            if (root) m_SceneManager->DeleteGameObject(root.get());
+            m_Imports.erase(m_Imports.begin() + i);
+            continue;
+        }
+
+        // Список мешей известен — заглушки для каждого
+        size_t meshCount = job.GetMeshCount();
+        if (meshCount && import.parts.empty()) {
+            if (meshCount == 1) {
+                import.parts.push_back(root);
+            } else if (root) {
+                for (size_t m = 0; m < meshCount; ++m) {
+                    auto child = m_SceneManager->CreateGameObject(job.GetMeshName(m));
+                    root->AddChild(child);
+                    import.parts.push_back(child);
+                }
+            } else {
+                import.parts.resize(meshCount);
+            }
+        }
+        // Меши догружаются по порядку; заглушку могли удалить — тогда меш просто не нужен
+        while (import.attached < import.parts.size() && job.GetMesh(import.attached)) {
+            auto mesh = job.GetMesh(import.attached);
+            if (auto part = import.parts[import.attached].lock()) {
+                part->SetMesh(mesh);
+                part->SetMaterial(mesh->GetMaterial());
+            }
+            import.attached++;
+        }
+
+        if (job.GetState() == ModelImportJob::IMPORT_DONE) {
+            if (root) root->SetName(GetFileNameWithoutExt(job.GetPath()));
+            m_Imports.erase(m_Imports.begin() + i);
+            continue;
+        }
+        ++i;
+    }
+}
+
+void EditorUI::DrawImportProgress() {
+    if (m_Imports.empty()) return;
+    ImGuiViewport* viewport = ImGui::GetMainViewport();
+    ImGui::SetNextWindowPos(ImVec2(viewport->WorkPos.x + viewport->WorkSize.x - 10.0f, viewport->WorkPos.y + viewport->WorkSize.y - 10.0f),
+                            ImGuiCond_Always, ImVec2(1.0f, 1.0f));
+    ImGui::SetNextWindowBgAlpha(0.85f);
+    ImGuiWindowFlags flags = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize |
+                             ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav;
+    if (ImGui::Begin("##ImportProgress", nullptr, flags)) {
+        for (const PendingImport& import : m_Imports) {
+            const ModelImportJob& job = *import.job;
+            ImGui::Text("Importing %s", GetFileNameWithoutExt(job.GetPath()).c_str());
+            char overlay[64];
+            snprintf(overlay, sizeof(overlay), "%s %d%%", job.GetStageName(), (int)(job.GetProgress() * 100.0f));
+            ImGui::ProgressBar(job.GetProgress(), ImVec2(240.0f, 0.0f), overlay);
+        }
+    }
+    ImGui::End();
+}
+
+void EditorUI::PickObjectAt(const ImVec2& mousePos) {
+    if (!m_SceneManager || m_ViewportSize.x <= 0.0f || m_ViewportSize.y <= 0.0f) return;
+
+    // Экранные координаты -> NDC -> луч в мировых координатах
+    float x = (mousePos.x - m_ViewportPos.x) / m_ViewportSize.x * 2.0f - 1.0f;
+    float y = 1.0f - (mousePos.y - m_ViewportPos.y) / m_ViewportSize.y * 2.0f;
+    glm::mat4 invViewProj = glm::inverse(m_ProjectionMatrix * m_ViewMatrix);
+    glm::vec4 nearPoint = invViewProj * glm::vec4(x, y, -1.0f, 1.0f);
+    glm::vec4 farPoint = invViewProj * glm::vec4(x, y, 1.0f, 1.0f);
+    glm::vec3 origin = glm::vec3(nearPoint) / nearPoint.w;
+    glm::vec3 end = glm::vec3(farPoint) / farPoint.w;
+    float length = glm::length(end - origin);
+    if (length <= 0.0f) return;
+
+    GameObject* hit = m_SceneManager->Raycast(origin, (end - origin) / length, length);
+    if (hit) {
+        SetSelectedObject(m_SceneManager->FindGameObjectByPtr(hit));
+    }
+}
+
 void EditorUI::DrawContentBrowser() {
     if (ImGui::Begin("Content Browser")) {
         ImGui::Text("Project Files");
@@ -1056,6 +1827,9 @@ void EditorUI::HandleShortcuts() {
     if (io.KeyCtrl && ImGui::IsKeyPressed(ImGuiKey_S, false)) {
         if (m_SceneManager) m_SceneManager->SaveScene("scene.binax");
     }
+    if (io.KeyCtrl && ImGui::IsKeyPressed(ImGuiKey_O, false)) {
+        if (m_SceneManager) m_SceneManager->LoadScene("scene.binax");
+    }
 
     // Shift + A — фокус на окне Hierarchy
 if (ImGui::IsKeyPressed(ImGuiKey_A) && ImGui::GetIO().KeyShift) {
@@ -1156,6 +1930,8 @@ void EditorUI::DrawShadowsSettings() {
     ImGui::Text("Quality");
     // Для размера карты пока не будем менять динамически, просто показываем
     ImGui::SliderInt("Shadow Map Size", &m_Settings.shadowMapSize, 512, 4096, "%d");
+    ImGui::SliderInt("Cascades", &m_Settings.shadowCascades, 1, 4);
+    ImGui::SliderFloat("Split Lambda", &m_Settings.cascadeSplitLambda, 0.0f, 1.0f, "%.2f");
     // Увеличиваем диапазон softness до 5
     ImGui::SliderFloat("Softness", &m_Settings.shadowSoftness, 0.0f, 5.0f, "%.2f");
     const char* sampleModes[] = { "4 samples", "9 samples" };
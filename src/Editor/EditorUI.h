@@ -10,6 +10,8 @@
 class SceneManager;
 class GameObject;
 class Skybox;
+class LightClusters;
+class ModelImportJob;
 
 struct EditorSettings {
     bool show_gizmo = true;
@@ -42,6 +44,8 @@ struct EditorSettings {
     float outlineFillAlpha = 0.3f;
 
     int shadowMapSize = 2048;
+    int shadowCascades = 4;
+    float cascadeSplitLambda = 0.75f;   // 0 — равномерное разбиение, 1 — логарифмическое
     float shadowSoftness = 2.0f;
     int shadowSamples = 4;
     float ambientStrength = 0.05f;
@@ -72,6 +76,7 @@ public:
 
     void DrawThemeEditor();
     void SetSkybox(Skybox* skybox) { m_Skybox = skybox; }
+    void SetLightClusters(LightClusters* clusters) { m_LightClusters = clusters; }
     bool IsGizmoActive() const { return m_GizmoActive; }
     
 
@@ -91,6 +96,32 @@ private:
     void DrawSkyboxSettings();
     void DrawShadowsSettings();
     void DrawPhysicsComponents(std::shared_ptr<GameObject> obj);
+    void DrawStressTestMenu();
+    void SpawnStressCubes(int count);
+    void SpawnStressLights(int count);
+    // count узлов цепочками глубины depth (для проверки кэша трансформаций)
+    void SpawnStressHierarchy(int count, int depth);
+    // Обход сцены через фасад GameObject и через пулы SceneRegistry (вывод в консоль)
+    void RunIterationBenchmark();
+    // Сохранение -> загрузка -> повторное сохранение текущей сцены: время и побайтовое сравнение файлов
+    void RunSceneRoundTripBenchmark();
+    // Меши источников света: новый на каждый объект против общего из MeshRegistry
+    void RunPrimitiveSpawnBenchmark();
+    // Кодирование миллиона вершин во все раскладки: время и размер
+    void RunVertexPackingBenchmark();
+    // ACMR/ATVR сетки в случайном порядке треугольников до и после MeshOptimizer
+    void RunMeshOptimizerBenchmark();
+    // Касательные сетки в 2M треугольников: прежний расчёт против TangentGenerator в 1 и N потоках
+    void RunTangentBenchmark();
+    // Треугольники, отправленные за пролёт камеры по сцене: с LOD и кластерами и без них
+    void RunFlythroughBenchmark();
+    void RunStaticBatchBenchmark();
+    void UpdateStressMotion();
+    // Фоновый импорт: объект-заглушка сразу, меши подставляются по мере загрузки в GPU
+    void StartModelImport(const std::string& path);
+    void UpdateModelImports();
+    void DrawImportProgress();
+    void PickObjectAt(const ImVec2& mousePos);
     std::string OpenFileDialog(const char* filter);
 
     GLFWwindow* m_Window = nullptr;
@@ -107,6 +138,19 @@ private:
     bool m_FirstLaunch = false;
     bool m_GizmoActive = false;
 
+    // Стресс-тест: последние заспавненные кубы, 5% из них двигаются каждый кадр
+    std::weak_ptr<GameObject> m_StressRoot;
+    bool m_StressMoving = false;
+    size_t m_StressMoveOffset = 0;
+
+    struct PendingImport {
+        std::unique_ptr<ModelImportJob> job;
+        std::weak_ptr<GameObject> root;
+        std::vector<std::weak_ptr<GameObject>> parts;   // объект на каждый меш (один меш — сам root)
+        size_t attached = 0;
+    };
+    std::vector<PendingImport> m_Imports;
+
     float m_MenuBarHeight = 0.0f;
     ImVec2 m_ViewportSize;
     ImVec2 m_ViewportPos;
@@ -123,6 +167,7 @@ private:
 
     EditorTheme m_Theme;
     Skybox* m_Skybox = nullptr;
+    LightClusters* m_LightClusters = nullptr;
     std::string m_SkyboxPaths[6] = {
     "resources/embedded_assets/skybox/right.png",
     "resources/embedded_assets/skybox/left.png",
@@ -0,0 +1,107 @@
+#include "Graphics/Bounds.h"
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define BINAX_SSE 1
+#include <xmmintrin.h>
+#endif
+
+AABB AABB::Transformed(const glm::mat4& m) const {
+    glm::vec3 center = GetCenter();
+    glm::vec3 extents = GetExtents();
+    glm::vec3 worldCenter = glm::vec3(m * glm::vec4(center, 1.0f));
+    glm::vec3 worldExtents(0.0f);
+    for (int i = 0; i < 3; ++i) {
+        // Строка i матрицы 3x3 (glm хранит по столбцам)
+        worldExtents[i] = std::fabs(m[0][i]) * extents.x +
+                          std::fabs(m[1][i]) * extents.y +
+                          std::fabs(m[2][i]) * extents.z;
+    }
+    AABB result;
+    result.min = worldCenter - worldExtents;
+    result.max = worldCenter + worldExtents;
+    return result;
+}
+
+void Frustum::Extract(const glm::mat4& vp) {
+    // Строки матрицы вида-проекции
+    glm::vec4 r0(vp[0][0], vp[1][0], vp[2][0], vp[3][0]);
+    glm::vec4 r1(vp[0][1], vp[1][1], vp[2][1], vp[3][1]);
+    glm::vec4 r2(vp[0][2], vp[1][2], vp[2][2], vp[3][2]);
+    glm::vec4 r3(vp[0][3], vp[1][3], vp[2][3], vp[3][3]);
+
+    glm::vec4 planes[6] = {
+        r3 + r0,    // left
+        r3 - r0,    // right
+        r3 + r1,    // bottom
+        r3 - r1,    // top
+        r3 + r2,    // near
+        r3 - r2     // far
+    };
+    for (int i = 0; i < 6; ++i) {
+        float len = glm::length(glm::vec3(planes[i]));
+        if (len > 0.0f) planes[i] /= len;
+        m_NX[i] = planes[i].x;
+        m_NY[i] = planes[i].y;
+        m_NZ[i] = planes[i].z;
+        m_D[i] = planes[i].w;
+    }
+}
+
+bool Frustum::IntersectsAABB(const AABB& box) const {
+    uint8_t visible = 0;
+    CullAABBs(&box, 1, &visible);
+    return visible != 0;
+}
+
+bool Frustum::IntersectsSphere(const BoundingSphere& sphere) const {
+    for (int i = 0; i < 6; ++i) {
+        float dist = m_NX[i] * sphere.center.x + m_NY[i] * sphere.center.y +
+                     m_NZ[i] * sphere.center.z + m_D[i];
+        if (dist < -sphere.radius) return false;
+    }
+    return true;
+}
+
+void Frustum::CullAABBs(const AABB* boxes, size_t count, uint8_t* visible) const {
+#ifdef BINAX_SSE
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 nx[2] = { _mm_load_ps(m_NX), _mm_load_ps(m_NX + 4) };
+    const __m128 ny[2] = { _mm_load_ps(m_NY), _mm_load_ps(m_NY + 4) };
+    const __m128 nz[2] = { _mm_load_ps(m_NZ), _mm_load_ps(m_NZ + 4) };
+    const __m128 d[2] = { _mm_load_ps(m_D), _mm_load_ps(m_D + 4) };
+    const __m128 ax[2] = { _mm_andnot_ps(signMask, nx[0]), _mm_andnot_ps(signMask, nx[1]) };
+    const __m128 ay[2] = { _mm_andnot_ps(signMask, ny[0]), _mm_andnot_ps(signMask, ny[1]) };
+    const __m128 az[2] = { _mm_andnot_ps(signMask, nz[0]), _mm_andnot_ps(signMask, nz[1]) };
+
+    for (size_t i = 0; i < count; ++i) {
+        glm::vec3 c = boxes[i].GetCenter();
+        glm::vec3 e = boxes[i].GetExtents();
+        __m128 cx = _mm_set1_ps(c.x), cy = _mm_set1_ps(c.y), cz = _mm_set1_ps(c.z);
+        __m128 ex = _mm_set1_ps(e.x), ey = _mm_set1_ps(e.y), ez = _mm_set1_ps(e.z);
+
+        int outside = 0;
+        for (int k = 0; k < 2; ++k) {
+            // dist = n·c + d, radius = |n|·e; снаружи, если dist + radius < 0
+            __m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx[k], cx), _mm_mul_ps(ny[k], cy)),
+                                     _mm_add_ps(_mm_mul_ps(nz[k], cz), d[k]));
+            __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax[k], ex), _mm_mul_ps(ay[k], ey)),
+                                       _mm_mul_ps(az[k], ez));
+            outside |= _mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(dist, radius), _mm_setzero_ps()));
+        }
+        visible[i] = outside ? 0 : 1;
+    }
+#else
+    for (size_t i = 0; i < count; ++i) {
+        glm::vec3 c = boxes[i].GetCenter();
+        glm::vec3 e = boxes[i].GetExtents();
+        uint8_t inside = 1;
+        for (int p = 0; p < 6; ++p) {
+            float dist = m_NX[p] * c.x + m_NY[p] * c.y + m_NZ[p] * c.z + m_D[p];
+            float radius = std::fabs(m_NX[p]) * e.x + std::fabs(m_NY[p]) * e.y + std::fabs(m_NZ[p]) * e.z;
+            if (dist + radius < 0.0f) { inside = 0; break; }
+        }
+        visible[i] = inside;
+    }
+#endif
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+// Осевой ограничивающий параллелепипед
+struct AABB {
+    glm::vec3 min = glm::vec3(0.0f);
+    glm::vec3 max = glm::vec3(0.0f);
+
+    glm::vec3 GetCenter() const { return (min + max) * 0.5f; }
+    glm::vec3 GetExtents() const { return (max - min) * 0.5f; }
+
+    void Expand(const glm::vec3& p) {
+        min = glm::min(min, p);
+        max = glm::max(max, p);
+    }
+    void Expand(const AABB& other) {
+        min = glm::min(min, other.min);
+        max = glm::max(max, other.max);
+    }
+    bool Overlaps(const AABB& other) const {
+        return min.x <= other.max.x && max.x >= other.min.x &&
+               min.y <= other.max.y && max.y >= other.min.y &&
+               min.z <= other.max.z && max.z >= other.min.z;
+    }
+
+    // Преобразование в мировые координаты (метод Арво: центр + |M| * extents)
+    AABB Transformed(const glm::mat4& m) const;
+};
+
+struct BoundingSphere {
+    glm::vec3 center = glm::vec3(0.0f);
+    float radius = 0.0f;
+};
+
+// Пирамида видимости из матрицы вида-проекции (плоскости Gribb/Hartmann).
+// Плоскости хранятся как SoA по 4 штуки — проверка одного AABB идёт
+// двумя SSE-итерациями вместо шести скалярных.
+class Frustum {
+public:
+    Frustum() = default;
+    explicit Frustum(const glm::mat4& viewProjection) { Extract(viewProjection); }
+
+    void Extract(const glm::mat4& viewProjection);
+
+    bool IntersectsAABB(const AABB& box) const;
+    bool IntersectsSphere(const BoundingSphere& sphere) const;
+    // Расстояние от ближней плоскости (глубина для сортировки)
+    float DistanceToNear(const glm::vec3& p) const {
+        return m_NX[4] * p.x + m_NY[4] * p.y + m_NZ[4] * p.z + m_D[4];
+    }
+
+    // Пакетная проверка: visible[i] = 1, если boxes[i] пересекает пирамиду
+    void CullAABBs(const AABB* boxes, size_t count, uint8_t* visible) const;
+
+private:
+    // 8 слотов: 6 плоскостей + 2 "пустые" (n = 0, d = 1), никогда не отсекают
+    alignas(16) float m_NX[8] = {};
+    alignas(16) float m_NY[8] = {};
+    alignas(16) float m_NZ[8] = {};
+    alignas(16) float m_D[8] = { 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+};
@@ -0,0 +1,209 @@
+#include "Graphics/LightClusters.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+LightClusters::~LightClusters() {
+    if (m_GridTexture) glDeleteTextures(1, &m_GridTexture);
+    if (m_IndexTexture) glDeleteTextures(1, &m_IndexTexture);
+    if (m_LightTexture) glDeleteTextures(1, &m_LightTexture);
+    if (m_GridBuffer) glDeleteBuffers(1, &m_GridBuffer);
+    if (m_IndexBuffer) glDeleteBuffers(1, &m_IndexBuffer);
+    if (m_LightBuffer) glDeleteBuffers(1, &m_LightBuffer);
+}
+
+void LightClusters::Initialize() {
+    auto createBuffer = [](GLuint& buffer, GLuint& texture, GLenum format) {
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+        glBufferData(GL_TEXTURE_BUFFER, 16, NULL, GL_STREAM_DRAW);
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_BUFFER, texture);
+        glTexBuffer(GL_TEXTURE_BUFFER, format, buffer);
+    };
+    createBuffer(m_GridBuffer, m_GridTexture, GL_RG32UI);
+    createBuffer(m_IndexBuffer, m_IndexTexture, GL_R32UI);
+    createBuffer(m_LightBuffer, m_LightTexture, GL_RGBA32F);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+    m_Grid.assign(kClusterCount * 2, 0);
+    m_SliceIndices.resize(kGridZ);
+    m_TileLists.resize(kGridZ);
+    for (auto& slice : m_TileLists) slice.resize(kGridX * kGridY);
+}
+
+void LightClusters::Build(const std::vector<LightData>& lights, const glm::mat4& view,
+                          float fovYRadians, float aspect, float zNear, float zFar,
+                          int screenWidth, int screenHeight) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    m_TanHalfFovY = std::tan(fovYRadians * 0.5f);
+    m_TanHalfFovX = m_TanHalfFovY * aspect;
+    m_Near = zNear;
+    m_Far = zFar;
+    // slice = log(depth) * scale - bias  =>  depth_k = near * (far/near)^(k/Z)
+    float logRatio = std::log(zFar / zNear);
+    m_Params.x = kGridZ / logRatio;
+    m_Params.y = kGridZ * std::log(zNear) / logRatio;
+    m_Params.z = (float)screenWidth / kGridX;
+    m_Params.w = (float)screenHeight / kGridY;
+
+    // Сферы источников в пространстве вида; невидимые отбрасываются сразу
+    m_Lights = lights;
+    m_Spheres.clear();
+    for (uint32_t i = 0; i < (uint32_t)lights.size(); ++i) {
+        const LightData& light = lights[i];
+        glm::vec3 position = glm::vec3(light.positionType);
+        float range = light.directionRange.w;
+        LightSphere sphere;
+        sphere.index = i;
+        sphere.center = position;
+        sphere.radius = range;
+        if ((int)(light.positionType.w + 0.5f) == 2) {
+            // Сфера вокруг конуса прожектора (угол — половина раскрыва)
+            float angle = light.spotAngle.x;
+            glm::vec3 dir = glm::normalize(glm::vec3(light.directionRange));
+            if (angle > 0.785398f) {
+                sphere.center = position + dir * (std::cos(angle) * range);
+                sphere.radius = std::sin(angle) * range;
+            } else {
+                float r = range / (2.0f * std::cos(angle));
+                sphere.center = position + dir * r;
+                sphere.radius = r;
+            }
+        }
+        sphere.center = glm::vec3(view * glm::vec4(sphere.center, 1.0f));
+
+        float depth = -sphere.center.z;
+        if (depth + sphere.radius < zNear || depth - sphere.radius > zFar) continue;
+        // Боковые плоскости пирамиды (нормали в пространстве вида)
+        float nx = 1.0f / std::sqrt(1.0f + m_TanHalfFovX * m_TanHalfFovX);
+        float ny = 1.0f / std::sqrt(1.0f + m_TanHalfFovY * m_TanHalfFovY);
+        if ((std::fabs(sphere.center.x) - m_TanHalfFovX * depth) * nx > sphere.radius) continue;
+        if ((std::fabs(sphere.center.y) - m_TanHalfFovY * depth) * ny > sphere.radius) continue;
+        m_Spheres.push_back(sphere);
+    }
+
+    // Раскладка по срезам глубины — каждый поток пишет только в свои срезы
+    int threadCount = (int)(std::min)((unsigned)kGridZ, (std::max)(1u, std::thread::hardware_concurrency()));
+    if (m_Spheres.size() < 64) threadCount = 1;    // мало работы — без потоков
+    std::vector<std::thread> workers;
+    int slicesPerThread = (kGridZ + threadCount - 1) / threadCount;
+    for (int t = 1; t < threadCount; ++t) {
+        int first = t * slicesPerThread;
+        int last = (std::min)(first + slicesPerThread, (int)kGridZ);
+        if (first < last) workers.emplace_back(&LightClusters::BinSlices, this, first, last);
+    }
+    BinSlices(0, (std::min)(slicesPerThread, (int)kGridZ));
+    for (auto& worker : workers) worker.join();
+
+    // Склейка срезов: локальные смещения -> глобальные
+    m_Indices.clear();
+    int maxPerCluster = 0;
+    for (int z = 0; z < kGridZ; ++z) {
+        uint32_t base = (uint32_t)m_Indices.size();
+        for (int tile = 0; tile < kGridX * kGridY; ++tile) {
+            size_t cluster = (size_t)z * kGridX * kGridY + tile;
+            m_Grid[cluster * 2] += base;
+            maxPerCluster = (std::max)(maxPerCluster, (int)m_Grid[cluster * 2 + 1]);
+        }
+        m_Indices.insert(m_Indices.end(), m_SliceIndices[z].begin(), m_SliceIndices[z].end());
+    }
+
+    Upload();
+
+    auto end = std::chrono::high_resolution_clock::now();
+    m_Stats.lights = (int)lights.size();
+    m_Stats.visibleLights = (int)m_Spheres.size();
+    m_Stats.indices = (int)m_Indices.size();
+    m_Stats.maxPerCluster = maxPerCluster;
+    m_Stats.threads = (int)workers.size() + 1;
+    m_Stats.buildMs = std::chrono::duration<float, std::milli>(end - start).count();
+}
+
+void LightClusters::BinSlices(int firstSlice, int lastSlice) {
+    const int tileCount = kGridX * kGridY;
+    for (int z = firstSlice; z < lastSlice; ++z) {
+        float sliceNear = m_Near * std::pow(m_Far / m_Near, (float)z / kGridZ);
+        float sliceFar = m_Near * std::pow(m_Far / m_Near, (float)(z + 1) / kGridZ);
+        auto& tiles = m_TileLists[z];
+        for (auto& list : tiles) list.clear();
+
+        for (const LightSphere& sphere : m_Spheres) {
+            float depth = -sphere.center.z;
+            if (depth + sphere.radius < sliceNear || depth - sphere.radius > sliceFar) continue;
+
+            // Консервативный диапазон тайлов: проекция сферы на краях среза
+            float dMin = (std::max)(sliceNear, depth - sphere.radius);
+            float dMax = (std::min)(sliceFar, depth + sphere.radius);
+            float x0 = (std::min)((sphere.center.x - sphere.radius) / (dMin * m_TanHalfFovX),
+                                  (sphere.center.x - sphere.radius) / (dMax * m_TanHalfFovX));
+            float x1 = (std::max)((sphere.center.x + sphere.radius) / (dMin * m_TanHalfFovX),
+                                  (sphere.center.x + sphere.radius) / (dMax * m_TanHalfFovX));
+            float y0 = (std::min)((sphere.center.y - sphere.radius) / (dMin * m_TanHalfFovY),
+                                  (sphere.center.y - sphere.radius) / (dMax * m_TanHalfFovY));
+            float y1 = (std::max)((sphere.center.y + sphere.radius) / (dMin * m_TanHalfFovY),
+                                  (sphere.center.y + sphere.radius) / (dMax * m_TanHalfFovY));
+            int tx0 = (std::max)(0, (int)std::floor((x0 * 0.5f + 0.5f) * kGridX));
+            int tx1 = (std::min)(kGridX - 1, (int)std::floor((x1 * 0.5f + 0.5f) * kGridX));
+            int ty0 = (std::max)(0, (int)std::floor((y0 * 0.5f + 0.5f) * kGridY));
+            int ty1 = (std::min)(kGridY - 1, (int)std::floor((y1 * 0.5f + 0.5f) * kGridY));
+
+            for (int ty = ty0; ty <= ty1; ++ty) {
+                float ndcY0 = -1.0f + 2.0f * ty / kGridY;
+                float ndcY1 = -1.0f + 2.0f * (ty + 1) / kGridY;
+                for (int tx = tx0; tx <= tx1; ++tx) {
+                    float ndcX0 = -1.0f + 2.0f * tx / kGridX;
+                    float ndcX1 = -1.0f + 2.0f * (tx + 1) / kGridX;
+                    // AABB кластера в пространстве вида и точная проверка сферы
+                    glm::vec3 bmin(
+                        (std::min)(ndcX0 * sliceNear, ndcX0 * sliceFar) * m_TanHalfFovX,
+                        (std::min)(ndcY0 * sliceNear, ndcY0 * sliceFar) * m_TanHalfFovY,
+                        -sliceFar);
+                    glm::vec3 bmax(
+                        (std::max)(ndcX1 * sliceNear, ndcX1 * sliceFar) * m_TanHalfFovX,
+                        (std::max)(ndcY1 * sliceNear, ndcY1 * sliceFar) * m_TanHalfFovY,
+                        -sliceNear);
+                    glm::vec3 d = glm::clamp(sphere.center, bmin, bmax) - sphere.center;
+                    if (glm::dot(d, d) > sphere.radius * sphere.radius) continue;
+                    tiles[ty * kGridX + tx].push_back(sphere.index);
+                }
+            }
+        }
+
+        // Локальные смещения внутри среза
+        auto& indices = m_SliceIndices[z];
+        indices.clear();
+        for (int tile = 0; tile < tileCount; ++tile) {
+            size_t cluster = (size_t)z * tileCount + tile;
+            m_Grid[cluster * 2] = (uint32_t)indices.size();
+            m_Grid[cluster * 2 + 1] = (uint32_t)tiles[tile].size();
+            indices.insert(indices.end(), tiles[tile].begin(), tiles[tile].end());
+        }
+    }
+}
+
+void LightClusters::Upload() {
+    auto upload = [](GLuint buffer, const void* data, size_t size) {
+        glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+        // Пустой буфер недопустим для TBO — оставляем минимум 16 байт
+        glBufferData(GL_TEXTURE_BUFFER, (std::max)(size, (size_t)16), NULL, GL_STREAM_DRAW);
+        if (size) glBufferSubData(GL_TEXTURE_BUFFER, 0, size, data);
+    };
+    upload(m_GridBuffer, m_Grid.data(), m_Grid.size() * sizeof(uint32_t));
+    upload(m_IndexBuffer, m_Indices.data(), m_Indices.size() * sizeof(uint32_t));
+    upload(m_LightBuffer, m_Lights.data(), m_Lights.size() * sizeof(LightData));
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void LightClusters::Bind() const {
+    glActiveTexture(GL_TEXTURE0 + kGridUnit);
+    glBindTexture(GL_TEXTURE_BUFFER, m_GridTexture);
+    glActiveTexture(GL_TEXTURE0 + kIndexUnit);
+    glBindTexture(GL_TEXTURE_BUFFER, m_IndexTexture);
+    glActiveTexture(GL_TEXTURE0 + kLightUnit);
+    glBindTexture(GL_TEXTURE_BUFFER, m_LightTexture);
+    glActiveTexture(GL_TEXTURE0);
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "Graphics/UniformBuffer.h"
+
+// Кластерное прямое освещение: пирамида камеры делится на сетку
+// фрустумов-кластеров (тайлы экрана x срезы по глубине, экспоненциально).
+// Точечные источники и прожекторы раскладываются по кластерам на CPU
+// (по потокам на срезы глубины), списки уходят в texture buffer'ы,
+// и фрагментный шейдер перебирает только источники своего кластера.
+class LightClusters {
+public:
+    static const int kGridX = 16;
+    static const int kGridY = 9;
+    static const int kGridZ = 24;
+    static const int kClusterCount = kGridX * kGridY * kGridZ;
+
+    // Текстурные юниты, на которых basic.frag ждёт буферы (0-5 заняты материалом)
+    static const int kGridUnit = 6;
+    static const int kIndexUnit = 7;
+    static const int kLightUnit = 8;
+
+    LightClusters() = default;
+    ~LightClusters();
+
+    void Initialize();
+    // lights — только LT_POINT и LT_SPOT в мировых координатах
+    void Build(const std::vector<LightData>& lights, const glm::mat4& view,
+               float fovYRadians, float aspect, float zNear, float zFar,
+               int screenWidth, int screenHeight);
+    void Bind() const;
+
+    // Параметры для блока Lights
+    glm::ivec4 GetGridSize() const { return glm::ivec4(kGridX, kGridY, kGridZ, 0); }
+    glm::vec4 GetClusterParams() const { return m_Params; }
+
+    struct Stats {
+        int lights = 0;             // всего точечных/прожекторов
+        int visibleLights = 0;      // попали в пирамиду камеры
+        int indices = 0;            // суммарная длина списков
+        int maxPerCluster = 0;
+        int threads = 0;
+        float buildMs = 0.0f;
+    };
+    const Stats& GetStats() const { return m_Stats; }
+
+private:
+    // Ограничивающая сфера источника в пространстве вида
+    struct LightSphere {
+        glm::vec3 center;
+        float radius;
+        uint32_t index;
+    };
+
+    void BinSlices(int firstSlice, int lastSlice);
+    void Upload();
+
+    GLuint m_GridBuffer = 0, m_GridTexture = 0;     // RG32UI: смещение, количество
+    GLuint m_IndexBuffer = 0, m_IndexTexture = 0;   // R32UI: индексы источников
+    GLuint m_LightBuffer = 0, m_LightTexture = 0;   // RGBA32F: 4 texel на источник
+
+    float m_TanHalfFovX = 1.0f, m_TanHalfFovY = 1.0f;
+    float m_Near = 0.1f, m_Far = 100.0f;
+    glm::vec4 m_Params = glm::vec4(0.0f);
+
+    std::vector<LightData> m_Lights;
+    std::vector<LightSphere> m_Spheres;
+    std::vector<uint32_t> m_Grid;                       // пары (offset, count)
+    std::vector<uint32_t> m_Indices;
+    std::vector<std::vector<uint32_t>> m_SliceIndices;  // локальные списки среза
+    std::vector<std::vector<std::vector<uint32_t>>> m_TileLists;  // [срез][тайл]
+    Stats m_Stats;
+};
@@ -1,68 +1,112 @@
 #include "Graphics/Material.h"
+#include "Graphics/Shader.h"
 #include <iostream>
+#include <mutex>
+#include <atomic>
+#include <unordered_set>
 #define STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
+#include <stb_image.h>     // реализация stb_image живёт здесь; декодирует TextureManager
 
-Material::Material() {}
+namespace {
+    // Имена uniform резолвятся один раз на всё приложение
+    const Shader::UniformID u_HasDiffuseTexture = Shader::Uniform("hasDiffuseTexture");
+    const Shader::UniformID u_HasNormalMap = Shader::Uniform("hasNormalMap");
+    const Shader::UniformID u_Metallic = Shader::Uniform("metallic");
+    const Shader::UniformID u_Roughness = Shader::Uniform("roughness");
+    const Shader::UniformID u_UvScale = Shader::Uniform("uvScale");
+    const Shader::UniformID u_NormalStrength = Shader::Uniform("normalStrength");
+    const Shader::UniformID u_UseWorldUV = Shader::Uniform("useWorldUV");
+    const Shader::UniformID u_EmissionColor = Shader::Uniform("emissionColor");
+    const Shader::UniformID u_EmissionIntensity = Shader::Uniform("emissionIntensity");
+    const Shader::UniformID u_DiffuseTexture = Shader::Uniform("diffuseTexture");
+    const Shader::UniformID u_NormalMap = Shader::Uniform("normalMap");
+    const Shader::UniformID u_HasRoughnessTexture = Shader::Uniform("hasRoughnessTexture");
+    const Shader::UniformID u_HasMetallicTexture = Shader::Uniform("hasMetallicTexture");
+    const Shader::UniformID u_HasAOTexture = Shader::Uniform("hasAOTexture");
+    const Shader::UniformID u_RoughnessTexture = Shader::Uniform("roughnessTexture");
+    const Shader::UniformID u_MetallicTexture = Shader::Uniform("metallicTexture");
+    const Shader::UniformID u_AoTexture = Shader::Uniform("aoTexture");
+
+    // Живые id: материалы создаются и в потоках импорта
+    std::mutex s_LiveMutex;
+    std::unordered_set<uint32_t> s_LiveIds;
+    uint32_t s_NextId = 1;
+    std::atomic<uint32_t> s_DestroyedCount(0);
+}
+
+Material::Material() {
+    std::lock_guard<std::mutex> lock(s_LiveMutex);
+    m_UniqueId = s_NextId++;
+    s_LiveIds.insert(m_UniqueId);
+}
 
 Material::~Material() {
-    if (m_DiffuseTexture) glDeleteTextures(1, &m_DiffuseTexture);
-    if (m_NormalTexture) glDeleteTextures(1, &m_NormalTexture);
-    if (m_RoughnessTexture) glDeleteTextures(1, &m_RoughnessTexture);
-    if (m_MetallicTexture) glDeleteTextures(1, &m_MetallicTexture);
-    if (m_AOTexture) glDeleteTextures(1, &m_AOTexture);
+    {
+        std::lock_guard<std::mutex> lock(s_LiveMutex);
+        s_LiveIds.erase(m_UniqueId);
+    }
+    s_DestroyedCount.fetch_add(1, std::memory_order_release);
+}
+
+uint32_t Material::GetDestroyedCount() {
+    return s_DestroyedCount.load(std::memory_order_acquire);
+}
+
+bool Material::IsAlive(uint32_t uniqueId) {
+    std::lock_guard<std::mutex> lock(s_LiveMutex);
+    return s_LiveIds.count(uniqueId) != 0;
 }
 
 bool Material::LoadDiffuseTexture(const std::string& path) {
-    if (m_DiffuseTexture) glDeleteTextures(1, &m_DiffuseTexture);
-    m_DiffuseTexture = LoadTexture(path);
-    return m_DiffuseTexture != 0;
+    return LoadTextureSlot(0, path);
 }
 
 bool Material::LoadNormalTexture(const std::string& path) {
-    if (m_NormalTexture) glDeleteTextures(1, &m_NormalTexture);
-    m_NormalTexture = LoadTexture(path);
-    return m_NormalTexture != 0;
+    return LoadTextureSlot(1, path);
 }
 
 bool Material::LoadRoughnessTexture(const std::string& path) {
-    if (m_RoughnessTexture) glDeleteTextures(1, &m_RoughnessTexture);
-    m_RoughnessTexture = LoadTexture(path);
-    return m_RoughnessTexture != 0;
+    return LoadTextureSlot(2, path);
 }
 
 bool Material::LoadMetallicTexture(const std::string& path) {
-    if (m_MetallicTexture) glDeleteTextures(1, &m_MetallicTexture);
-    m_MetallicTexture = LoadTexture(path);
-    return m_MetallicTexture != 0;
+    return LoadTextureSlot(3, path);
 }
 
 bool Material::LoadAOTexture(const std::string& path) {
-    if (m_AOTexture) glDeleteTextures(1, &m_AOTexture);
-    m_AOTexture = LoadTexture(path);
-    return m_AOTexture != 0;
+    return LoadTextureSlot(4, path);
 }
 
-void Material::BindTextures() const {
-    if (m_DiffuseTexture) {
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, m_DiffuseTexture);
-    }
-    if (m_NormalTexture) {
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, m_NormalTexture);
-    }
-    if (m_RoughnessTexture) {
-        glActiveTexture(GL_TEXTURE3);
-        glBindTexture(GL_TEXTURE_2D, m_RoughnessTexture);
-    }
-    if (m_MetallicTexture) {
-        glActiveTexture(GL_TEXTURE4);
-        glBindTexture(GL_TEXTURE_2D, m_MetallicTexture);
+bool Material::LoadTextureSlot(int slot, const std::string& path) {
+    if (slot < 0 || slot >= kTextureSlotCount) return false;
+    return SetTexture(slot, TextureManager::Get().Load(path, GetTextureOptions(slot)), path);
+}
+
+void Material::ClearTextureSlot(int slot) {
+    if (slot < 0 || slot >= kTextureSlotCount) return;
+    if (m_Textures[slot]) {
+        m_Textures[slot].reset();
+        m_TextureVersion++;
     }
-    if (m_AOTexture) {
-        glActiveTexture(GL_TEXTURE5);
-        glBindTexture(GL_TEXTURE_2D, m_AOTexture);
+    m_TexturePaths[slot].clear();
+}
+
+bool Material::SetTexture(int slot, const TextureHandle& texture, const std::string& path) {
+    if (slot < 0 || slot >= kTextureSlotCount) return false;
+    // Пустая или неудачная текстура слот очищает, как и раньше при ошибке загрузки
+    bool valid = texture && texture->GetID() != 0;
+    m_Textures[slot] = valid ? texture : TextureHandle();
+    m_TexturePaths[slot] = valid ? path : std::string();
+    m_TextureVersion++;
+    return valid;
+}
+
+void Material::BindTextures() const {
+    for (int slot = 0; slot < kTextureSlotCount; ++slot) {
+        GLuint texture = GetTexture(slot);
+        if (!texture) continue;
+        glActiveTexture(GetTextureUnit(slot));
+        glBindTexture(GL_TEXTURE_2D, texture);
     }
 }
 
@@ -74,31 +118,54 @@ void Material::UnbindTextures() const {
     glActiveTexture(GL_TEXTURE5); glBindTexture(GL_TEXTURE_2D, 0);
 }
 
-GLuint Material::LoadTexture(const std::string& path) {
-    GLuint textureID;
-    glGenTextures(1, &textureID);
-    if (textureID == 0) {
-        std::cerr << "[Material] Failed to generate texture ID" << std::endl;
-        return 0;
-    }
+void Material::Apply(Shader& shader) const {
+    ApplyParameters(shader);
+    BindTextures();
+}
 
-    int width, height, nrChannels;
-    stbi_set_flip_vertically_on_load(true);
-    unsigned char* data = stbi_load(path.c_str(), &width, &height, &nrChannels, 0);
-    if (data) {
-        GLenum format = (nrChannels == 3) ? GL_RGB : GL_RGBA;
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        stbi_image_free(data);
-        return textureID;
-    } else {
-        std::cerr << "[Material] Failed to load texture: " << path << " - " << stbi_failure_reason() << std::endl;
-        glDeleteTextures(1, &textureID);
-        return 0;
-    }
+void Material::ApplyParameters(Shader& shader) const {
+    shader.SetBool(u_HasDiffuseTexture, HasDiffuse());
+    shader.SetBool(u_HasNormalMap, HasNormal());
+    shader.SetFloat(u_Metallic, metallic);
+    shader.SetFloat(u_Roughness, roughness);
+    shader.SetVec2(u_UvScale, uvScale.x, uvScale.y);
+    shader.SetFloat(u_NormalStrength, normalStrength);
+    shader.SetBool(u_UseWorldUV, useWorldUV);
+    shader.SetVec3(u_EmissionColor, emissionColor.x, emissionColor.y, emissionColor.z);
+    shader.SetFloat(u_EmissionIntensity, emissionIntensity);
+
+    shader.SetInt(u_DiffuseTexture, 0);
+    shader.SetInt(u_NormalMap, 1);
+    shader.SetBool(u_HasRoughnessTexture, HasRoughness());
+    shader.SetBool(u_HasMetallicTexture, HasMetallic());
+    shader.SetBool(u_HasAOTexture, HasAO());
+    shader.SetInt(u_RoughnessTexture, 3);
+    shader.SetInt(u_MetallicTexture, 4);
+    shader.SetInt(u_AoTexture, 5);
+}
+
+GLenum Material::GetTextureUnit(int slot) {
+    static const GLenum units[kTextureSlotCount] = { GL_TEXTURE0, GL_TEXTURE1, GL_TEXTURE3, GL_TEXTURE4, GL_TEXTURE5 };
+    return units[slot];
+}
+
+TextureOptions Material::GetTextureOptions(int slot) {
+    static const TextureCompression compression[kTextureSlotCount] = {
+        TEXTURE_COMPRESS_COLOR, TEXTURE_COMPRESS_NORMAL_MAP,
+        TEXTURE_COMPRESS_GRAYSCALE, TEXTURE_COMPRESS_GRAYSCALE, TEXTURE_COMPRESS_GRAYSCALE
+    };
+    TextureOptions options;
+    options.compression = compression[slot];
+    return options;
+}
+
+void Material::ApplyDefaults(Shader& shader) {
+    shader.SetBool(u_HasDiffuseTexture, false);
+    shader.SetBool(u_HasNormalMap, false);
+    // Текстуры предыдущего материала могут остаться привязанными
+    shader.SetBool(u_HasRoughnessTexture, false);
+    shader.SetBool(u_HasMetallicTexture, false);
+    shader.SetBool(u_HasAOTexture, false);
+    shader.SetVec3(u_EmissionColor, 0.0f, 0.0f, 0.0f);
+    shader.SetFloat(u_EmissionIntensity, 0.0f);
 }
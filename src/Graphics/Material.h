@@ -1,12 +1,19 @@
 #pragma once
 #include <string>
+#include <cstdint>
 #include <GL/glew.h>
 #include <glm/glm.hpp>
+#include "Graphics/TextureManager.h"
+
+class Shader;
 
 class Material {
 public:
     Material();
     ~Material();
+    // Копия получила бы тот же GetUniqueId — его удаление "убило" бы и оригинал
+    Material(const Material&) = delete;
+    Material& operator=(const Material&) = delete;
 
     bool LoadDiffuseTexture(const std::string& path);
     bool LoadNormalTexture(const std::string& path);
@@ -15,20 +22,51 @@ public:
     bool LoadAOTexture(const std::string& path);
    
     // Очистка текстур
-void ClearDiffuse()   { if (m_DiffuseTexture)   { glDeleteTextures(1, &m_DiffuseTexture);   m_DiffuseTexture = 0; } }
-void ClearNormal()    { if (m_NormalTexture)    { glDeleteTextures(1, &m_NormalTexture);     m_NormalTexture = 0; } }
-void ClearRoughness() { if (m_RoughnessTexture) { glDeleteTextures(1, &m_RoughnessTexture); m_RoughnessTexture = 0; } }
-void ClearMetallic()  { if (m_MetallicTexture)  { glDeleteTextures(1, &m_MetallicTexture);   m_MetallicTexture = 0; } }
-void ClearAO()        { if (m_AOTexture)        { glDeleteTextures(1, &m_AOTexture);         m_AOTexture = 0; } }
+    void ClearDiffuse()   { ClearTextureSlot(0); }
+    void ClearNormal()    { ClearTextureSlot(1); }
+    void ClearRoughness() { ClearTextureSlot(2); }
+    void ClearMetallic()  { ClearTextureSlot(3); }
+    void ClearAO()        { ClearTextureSlot(4); }
 
     void BindTextures() const;
     void UnbindTextures() const;
 
-    bool HasDiffuse() const { return m_DiffuseTexture != 0; }
-    bool HasNormal() const  { return m_NormalTexture != 0; }
-    bool HasRoughness() const { return m_RoughnessTexture != 0; }
-    bool HasMetallic() const { return m_MetallicTexture != 0; }
-    bool HasAO() const { return m_AOTexture != 0; }
+    // Передаёт параметры материала в шейдер и привязывает текстуры
+    void Apply(Shader& shader) const;
+    // Только параметры, без привязки текстур (текстуры привязывает RenderStateCache)
+    void ApplyParameters(Shader& shader) const;
+    // Значения по умолчанию для объектов без материала
+    static void ApplyDefaults(Shader& shader);
+
+    bool HasDiffuse() const { return GetTexture(0) != 0; }
+    bool HasNormal() const  { return GetTexture(1) != 0; }
+    bool HasRoughness() const { return GetTexture(2) != 0; }
+    bool HasMetallic() const { return GetTexture(3) != 0; }
+    bool HasAO() const { return GetTexture(4) != 0; }
+
+    // Слоты текстур: диффуз, нормали, roughness, metallic, AO
+    static const int kTextureSlotCount = 5;
+    static GLenum GetTextureUnit(int slot);
+    // Параметры загрузки слота: сжатие по назначению (цвет, нормали, один канал)
+    static TextureOptions GetTextureOptions(int slot);
+    GLuint GetTexture(int slot) const { return m_Textures[slot] ? m_Textures[slot]->GetID() : 0; }
+    const TextureHandle& GetTextureHandle(int slot) const { return m_Textures[slot]; }
+    // Файл, из которого загружена текстура слота (пусто — слот пуст); для сохранения сцены
+    const std::string& GetTexturePath(int slot) const { return m_TexturePaths[slot]; }
+    // Load*Texture по номеру слота (через TextureManager: один файл — одна текстура)
+    bool LoadTextureSlot(int slot, const std::string& path);
+    void ClearTextureSlot(int slot);
+    // Готовая текстура из TextureManager (path — для сохранения сцены)
+    bool SetTexture(int slot, const TextureHandle& texture, const std::string& path);
+
+    // Уникален за время работы (адрес может переиспользоваться после удаления)
+    uint32_t GetUniqueId() const { return m_UniqueId; }
+    // Растёт при каждой смене текстур (для кэшей вроде MaterialTable)
+    uint32_t GetTextureVersion() const { return m_TextureVersion; }
+    // Для кэшей по сырому указателю: счётчик растёт с каждым удалённым
+    // материалом, и только после его смены есть смысл проверять IsAlive
+    static uint32_t GetDestroyedCount();
+    static bool IsAlive(uint32_t uniqueId);
 
     glm::vec3 albedo = glm::vec3(1.0f);
     float metallic = 0.0f;
@@ -48,11 +86,9 @@ void ClearAO()        { if (m_AOTexture)        { glDeleteTextures(1, &m_AOTextu
     }
 
 private:
-    GLuint m_DiffuseTexture = 0;
-    GLuint m_NormalTexture = 0;
-    GLuint m_RoughnessTexture = 0;
-    GLuint m_MetallicTexture = 0;
-    GLuint m_AOTexture = 0;
+    TextureHandle m_Textures[kTextureSlotCount];
+    std::string m_TexturePaths[kTextureSlotCount];
+    uint32_t m_UniqueId = 0;
+    uint32_t m_TextureVersion = 0;
 
-    GLuint LoadTexture(const std::string& path);
 };
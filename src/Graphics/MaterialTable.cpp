@@ -0,0 +1,339 @@
+#include "Graphics/MaterialTable.h"
+#include "Graphics/Material.h"
+#include <iostream>
+#include <algorithm>
+
+static_assert(MaterialTable::kSlotCount == Material::kTextureSlotCount, "MaterialTable slots out of sync with Material");
+
+MaterialTable::~MaterialTable() {
+    Clear();
+    if (m_TableTexture) glDeleteTextures(1, &m_TableTexture);
+    if (m_TableBuffer) glDeleteBuffers(1, &m_TableBuffer);
+    if (m_CopyFramebuffer) glDeleteFramebuffers(1, &m_CopyFramebuffer);
+}
+
+void MaterialTable::Initialize() {
+    glGenBuffers(1, &m_TableBuffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, m_TableBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, sizeof(glm::vec4) * kTexelsPerMaterial, NULL, GL_DYNAMIC_DRAW);
+    glGenTextures(1, &m_TableTexture);
+    glBindTexture(GL_TEXTURE_BUFFER, m_TableTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, m_TableBuffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+    glGenFramebuffers(1, &m_CopyFramebuffer);
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &m_MaxLayers);
+    std::cout << "[MaterialTable] Initialized, max " << m_MaxLayers << " layers per pool" << std::endl;
+}
+
+void MaterialTable::Clear() {
+    for (Pool& pool : m_Pools) {
+        if (pool.texture) glDeleteTextures(1, &pool.texture);
+    }
+    m_Pools.clear();
+    m_Entries.clear();
+    m_FreeEntries.clear();
+    m_Index.clear();
+    m_PoolSetIds.clear();
+    m_PoolSets.clear();
+    m_Table.clear();
+    m_TableDirty = false;
+}
+
+bool MaterialTable::GrowPool(Pool& pool) {
+    if (pool.capacity >= m_MaxLayers) return false;
+    int capacity = (std::min)((std::max)(pool.capacity * 2, 4), (int)m_MaxLayers);
+
+    GLuint texture;
+    glGenTextures(1, &texture);
+    const bool compressed = IsCompressedFormat(pool.format);
+    glActiveTexture(GL_TEXTURE0 + kTableUnit);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    if (compressed) {
+        for (int level = 0; level < pool.levels; ++level) {
+            int width = (std::max)(1, pool.width >> level), height = (std::max)(1, pool.height >> level);
+            glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, level, pool.format, width, height, capacity, 0,
+                                   (GLsizei)(GetLevelBytes(pool.format, width, height) * capacity), NULL);
+        }
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, pool.levels - 1);
+    } else {
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, pool.width, pool.height, capacity, 0,
+                     GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    }
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    // Копия R/RG в RGBA8 даёт (r, g, 0, 1) — swizzle исходной текстуры
+    // (TextureManager) при копировании теряется, повторяем его на пуле
+    if (pool.layout == GL_RED) {
+        GLint swizzle[4] = { GL_RED, GL_RED, GL_RED, GL_ONE };
+        glTexParameteriv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+    } else if (pool.layout == GL_RG) {
+        GLint swizzle[4] = { GL_RED, GL_RED, GL_RED, GL_GREEN };
+        glTexParameteriv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+    }
+
+    // Старые слои переносятся на GPU, без чтения в память
+    if (pool.texture && compressed) {
+        for (int level = 0; level < pool.levels; ++level) {
+            int width = (std::max)(1, pool.width >> level), height = (std::max)(1, pool.height >> level);
+            glCopyImageSubData(pool.texture, GL_TEXTURE_2D_ARRAY, level, 0, 0, 0,
+                               texture, GL_TEXTURE_2D_ARRAY, level, 0, 0, 0, width, height, pool.used);
+        }
+        glDeleteTextures(1, &pool.texture);
+    } else if (pool.texture) {
+        GLint previousRead = 0;
+        glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousRead);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, m_CopyFramebuffer);
+        for (int layer = 0; layer < pool.used; ++layer) {
+            glFramebufferTextureLayer(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, pool.texture, 0, layer);
+            glCopyTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, 0, 0, pool.width, pool.height);
+        }
+        glFramebufferTextureLayer(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, 0, 0, 0);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, previousRead);
+        glDeleteTextures(1, &pool.texture);
+    }
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    pool.texture = texture;
+    pool.capacity = capacity;
+    pool.mipsDirty = !compressed;
+    return true;
+}
+
+int MaterialTable::AllocateLayer(int width, int height, GLenum format, int levels, GLenum layout, int& layer) {
+    for (size_t i = 0; i < m_Pools.size(); ++i) {
+        Pool& pool = m_Pools[i];
+        if (pool.width != width || pool.height != height || pool.format != format || pool.levels != levels ||
+            pool.layout != layout) continue;
+        if (!pool.freeLayers.empty()) {
+            layer = pool.freeLayers.back();
+            pool.freeLayers.pop_back();
+            return (int)i;
+        }
+        if (pool.used < pool.capacity || GrowPool(pool)) {
+            layer = pool.used++;
+            return (int)i;
+        }
+    }
+    // Новый класс размера (или предыдущий пул упёрся в лимит слоёв)
+    Pool pool;
+    pool.width = width;
+    pool.height = height;
+    pool.format = format;
+    pool.levels = levels;
+    pool.layout = layout;
+    if (!GrowPool(pool)) return -1;
+    layer = pool.used++;
+    m_Pools.push_back(pool);
+    return (int)m_Pools.size() - 1;
+}
+
+void MaterialTable::CopyToLayer(GLuint source, int width, int height, const Pool& pool, int layer) {
+    if (IsCompressedFormat(pool.format)) {
+        // Блоки копируются как есть, все уровни
+        for (int level = 0; level < pool.levels; ++level) {
+            glCopyImageSubData(source, GL_TEXTURE_2D, level, 0, 0, 0, pool.texture, GL_TEXTURE_2D_ARRAY, level, 0, 0, layer,
+                               (std::max)(1, width >> level), (std::max)(1, height >> level), 1);
+        }
+        return;
+    }
+    GLint previousRead = 0;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousRead);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_CopyFramebuffer);
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, source, 0);
+
+    glActiveTexture(GL_TEXTURE0 + kTableUnit);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, pool.texture);
+    glCopyTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, 0, 0, width, height);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, previousRead);
+}
+
+void MaterialTable::ReleaseLayers(Entry& entry) {
+    for (int slot = 0; slot < kSlotCount; ++slot) {
+        if (entry.pools[slot] >= 0) m_Pools[entry.pools[slot]].freeLayers.push_back(entry.layers[slot]);
+        entry.pools[slot] = -1;
+        entry.layers[slot] = 0;
+    }
+}
+
+int MaterialTable::Acquire(const Material* material) {
+    if (!material || m_TableBuffer == 0) return -1;
+
+    int index;
+    auto it = m_Index.find(material);
+    if (it != m_Index.end()) {
+        Entry& entry = m_Entries[it->second];
+        if (entry.materialId == material->GetUniqueId() &&
+            entry.textureVersion == material->GetTextureVersion()) {
+            return entry.poolSet == UINT32_MAX ? -1 : it->second;
+        }
+        // Другой материал по тому же адресу или новые текстуры: слои перезаписываются
+        ReleaseLayers(entry);
+        index = it->second;
+    } else if (!m_FreeEntries.empty()) {
+        index = m_FreeEntries.back();
+        m_FreeEntries.pop_back();
+        m_Index[material] = index;
+    } else {
+        index = (int)m_Entries.size();
+        m_Entries.push_back(Entry());
+        m_Index[material] = index;
+        m_Table.resize(m_Entries.size() * kTexelsPerMaterial, glm::vec4(0.0f));
+    }
+
+    Entry& entry = m_Entries[index];
+    entry.material = material;
+    entry.materialId = material->GetUniqueId();
+    entry.textureVersion = material->GetTextureVersion();
+    for (int slot = 0; slot < kSlotCount; ++slot) {
+        entry.pools[slot] = -1;
+        entry.layers[slot] = 0;
+    }
+
+    std::array<int, kSlotCount> poolSet;
+    bool ok = true;
+    for (int slot = 0; slot < kSlotCount; ++slot) {
+        poolSet[slot] = -1;
+        GLuint texture = material->GetTexture(slot);
+        if (texture == 0) continue;
+
+        const TextureHandle& handle = material->GetTextureHandle(slot);
+        int width = handle->GetWidth(), height = handle->GetHeight();
+        if (width <= 0 || height <= 0) { ok = false; break; }
+        // Несжатые копируются через framebuffer в RGBA8, сжатые — в пул своего формата
+        GLenum format = GL_RGBA8;
+        int levels = 1;
+        // Серые картинки и BC4 у TextureManager со swizzle — пул нужен такой же
+        GLenum layout = handle->GetFormat() == GL_R8 ? GL_RED : handle->GetFormat() == GL_RG8 ? GL_RG : GL_RGBA;
+        if (handle->IsCompressed()) {
+            if (!GLEW_ARB_copy_image) { ok = false; break; }
+            format = handle->GetFormat();
+            levels = handle->GetLevelCount();
+            layout = format == GL_COMPRESSED_RED_RGTC1 ? GL_RED : GL_RGBA;
+        }
+
+        int layer = 0;
+        int pool = AllocateLayer(width, height, format, levels, layout, layer);
+        if (pool < 0) { ok = false; break; }
+        CopyToLayer(texture, width, height, m_Pools[pool], layer);
+        if (!IsCompressedFormat(format)) m_Pools[pool].mipsDirty = true;
+        entry.pools[slot] = pool;
+        entry.layers[slot] = layer;
+        poolSet[slot] = pool;
+    }
+
+    if (!ok) {
+        ReleaseLayers(entry);
+        entry.poolSet = UINT32_MAX;     // остаётся на обычном пути до смены текстур
+        std::cerr << "[MaterialTable] Material " << entry.materialId << " kept on the 2D texture path" << std::endl;
+        return -1;
+    }
+
+    auto setIt = m_PoolSetIds.find(poolSet);
+    if (setIt == m_PoolSetIds.end()) {
+        setIt = m_PoolSetIds.emplace(poolSet, (uint32_t)m_PoolSets.size()).first;
+        m_PoolSets.push_back(poolSet);
+    }
+    entry.poolSet = setIt->second;
+    UpdateParameters(index, material);
+    return index;
+}
+
+void MaterialTable::UpdateParameters(int index, const Material* material) {
+    const Entry& entry = m_Entries[index];
+    int flags = 0;
+    for (int slot = 0; slot < kSlotCount; ++slot) {
+        if (entry.pools[slot] >= 0) flags |= 1 << slot;
+    }
+    // Раскладка строки — как читает basic.frag
+    glm::vec4* row = &m_Table[(size_t)index * kTexelsPerMaterial];
+    row[0] = glm::vec4(material->metallic, material->roughness, material->normalStrength,
+                       material->useWorldUV ? 1.0f : 0.0f);
+    row[1] = glm::vec4(material->uvScale.x, material->uvScale.y, material->emissionIntensity, (float)flags);
+    row[2] = glm::vec4(material->emissionColor, 0.0f);
+    row[3] = glm::vec4((float)entry.layers[0], (float)entry.layers[1], (float)entry.layers[2], (float)entry.layers[3]);
+    row[4] = glm::vec4((float)entry.layers[4], 0.0f, 0.0f, 0.0f);
+    m_TableDirty = true;
+}
+
+void MaterialTable::ReleaseDestroyed() {
+    uint32_t destroyed = Material::GetDestroyedCount();
+    if (destroyed == m_DestroyedSeen) return;
+    m_DestroyedSeen = destroyed;
+    for (auto it = m_Index.begin(); it != m_Index.end();) {
+        Entry& entry = m_Entries[it->second];
+        if (Material::IsAlive(entry.materialId)) {
+            ++it;
+            continue;
+        }
+        ReleaseLayers(entry);
+        entry.material = nullptr;
+        entry.materialId = 0;
+        entry.poolSet = UINT32_MAX;
+        m_FreeEntries.push_back(it->second);
+        it = m_Index.erase(it);
+    }
+}
+
+void MaterialTable::Upload() {
+    ReleaseDestroyed();
+    for (Pool& pool : m_Pools) {
+        if (!pool.mipsDirty) continue;
+        glActiveTexture(GL_TEXTURE0 + kTableUnit);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, pool.texture);
+        glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+        pool.mipsDirty = false;
+    }
+    if (!m_TableDirty || m_Table.empty()) return;
+    glBindBuffer(GL_TEXTURE_BUFFER, m_TableBuffer);
+    // Orphaning, как и у остальных потоковых буферов
+    glBufferData(GL_TEXTURE_BUFFER, m_Table.size() * sizeof(glm::vec4), m_Table.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    m_TableDirty = false;
+}
+
+void MaterialTable::BindTable() const {
+    glActiveTexture(GL_TEXTURE0 + kTableUnit);
+    glBindTexture(GL_TEXTURE_BUFFER, m_TableTexture);
+}
+
+void MaterialTable::BindPoolSet(uint32_t poolSet) const {
+    const std::array<int, kSlotCount>& pools = m_PoolSets[poolSet];
+    for (int slot = 0; slot < kSlotCount; ++slot) {
+        // Пустой слот: шейдер не читает массив (флаг в таблице), оставляем как есть
+        if (pools[slot] < 0) continue;
+        glActiveTexture(GL_TEXTURE0 + kArrayUnitBase + slot);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, m_Pools[pools[slot]].texture);
+    }
+}
+
+MaterialTable::Stats MaterialTable::GetStats() const {
+    Stats stats;
+    stats.pools = (int)m_Pools.size();
+    for (const Entry& entry : m_Entries) {
+        if (entry.poolSet != UINT32_MAX) stats.materials++;
+    }
+    for (const Pool& pool : m_Pools) {
+        stats.layers += pool.used - (int)pool.freeLayers.size();
+        stats.bytes += GetLevelBytes(pool.format, pool.width, pool.height) * pool.capacity;
+    }
+    return stats;
+}
+
+bool MaterialTable::IsCompressedFormat(GLenum format) {
+    return format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT || format == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT ||
+           format == GL_COMPRESSED_RED_RGTC1 || format == GL_COMPRESSED_RG_RGTC2;
+}
+
+size_t MaterialTable::GetLevelBytes(GLenum format, int width, int height) {
+    if (!IsCompressedFormat(format)) return (size_t)width * height * 4;
+    size_t blockBytes = (format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT || format == GL_COMPRESSED_RED_RGTC1) ? 8 : 16;
+    return (size_t)((width + 3) / 4) * (size_t)((height + 3) / 4) * blockBytes;
+}
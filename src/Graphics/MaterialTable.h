@@ -0,0 +1,102 @@
+#pragma once
+#include <vector>
+#include <map>
+#include <array>
+#include <unordered_map>
+#include <cstdint>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+class Material;
+
+// Режим текстурных массивов: текстуры материалов копируются в пулы
+// GL_TEXTURE_2D_ARRAY (один пул на размер и раскладку каналов), а параметры материалов — в
+// таблицу (texture buffer). Шейдер берёт строку таблицы по индексу материала
+// из атрибута экземпляра, поэтому объекты с разными материалами, чьи текстуры
+// лежат в одних и тех же пулах, рисуются одним инстансированным вызовом.
+// Исходные GL_TEXTURE_2D материала не трогаются — обычный путь остаётся рабочим.
+// Сжатые текстуры идут в отдельные пулы своего формата вместе с мипами
+// (glCopyImageSubData); без ARB_copy_image материал остаётся на обычном пути.
+class MaterialTable {
+public:
+    // Юниты basic.frag (0-5 — материал, 6-8 — кластеры света)
+    static const int kTableUnit = 9;
+    static const int kArrayUnitBase = 10;   // 10..14 — по слоту материала
+    static const int kSlotCount = 5;        // = Material::kTextureSlotCount
+    static const int kTexelsPerMaterial = 5;
+
+    MaterialTable() = default;
+    ~MaterialTable();
+
+    void Initialize();
+    // Освобождает пулы и все записи (следующий Acquire всё пересоздаст)
+    void Clear();
+
+    // Индекс материала в таблице; при первом обращении (или после смены
+    // текстур материала) копирует его текстуры в пулы. -1 — не получилось.
+    int Acquire(const Material* material);
+    // Набор пулов по слотам: материалы с одинаковым набором можно рисовать вместе
+    uint32_t GetPoolSet(int index) const { return m_Entries[index].poolSet; }
+    // Переписывает параметры материала в строку таблицы
+    void UpdateParameters(int index, const Material* material);
+    // Загружает таблицу на GPU и достраивает мипмапы изменённых пулов;
+    // заодно возвращает в пулы слои удалённых материалов (ReleaseDestroyed)
+    void Upload();
+    // Записи удалённых материалов освобождаются, их слои — снова свободны.
+    // Дёшево, пока с прошлого вызова ни один материал не удалялся
+    void ReleaseDestroyed();
+    void BindTable() const;
+    void BindPoolSet(uint32_t poolSet) const;
+
+    struct Stats {
+        int materials = 0;
+        int pools = 0;
+        int layers = 0;
+        size_t bytes = 0;       // уровень 0 всех пулов
+    };
+    Stats GetStats() const;
+
+private:
+    struct Pool {
+        int width = 0, height = 0;
+        GLenum format = GL_RGBA8;       // сжатый формат — мипы копируются, а не строятся
+        int levels = 1;
+        // Каналы исходных текстур: GL_RED/GL_RG разворачиваются в серый тем же
+        // swizzle, что у исходной 2D, иначе пул без swizzle
+        GLenum layout = GL_RGBA;
+        GLuint texture = 0;
+        int capacity = 0;
+        int used = 0;
+        std::vector<int> freeLayers;
+        bool mipsDirty = false;
+    };
+    struct Entry {
+        const Material* material = nullptr;
+        uint32_t materialId = 0;        // Material::GetUniqueId — защита от переиспользования адреса
+        uint32_t textureVersion = 0;
+        int pools[kSlotCount];
+        int layers[kSlotCount];
+        uint32_t poolSet = 0;
+    };
+
+    int AllocateLayer(int width, int height, GLenum format, int levels, GLenum layout, int& layer);
+    void ReleaseLayers(Entry& entry);
+    bool GrowPool(Pool& pool);
+    void CopyToLayer(GLuint source, int width, int height, const Pool& pool, int layer);
+    static bool IsCompressedFormat(GLenum format);
+    static size_t GetLevelBytes(GLenum format, int width, int height);
+
+    std::vector<Pool> m_Pools;
+    std::vector<Entry> m_Entries;
+    std::vector<int> m_FreeEntries;
+    std::unordered_map<const Material*, int> m_Index;
+    uint32_t m_DestroyedSeen = 0;
+    std::map<std::array<int, kSlotCount>, uint32_t> m_PoolSetIds;
+    std::vector<std::array<int, kSlotCount>> m_PoolSets;
+    std::vector<glm::vec4> m_Table;
+    bool m_TableDirty = false;
+
+    GLuint m_TableBuffer = 0, m_TableTexture = 0;
+    GLuint m_CopyFramebuffer = 0;
+    GLint m_MaxLayers = 256;
+};
@@ -1,26 +1,46 @@
 #include "Graphics/Mesh.h"
+#include "Graphics/Material.h"
 #include <iostream>
-#include <stb_image.h>
+#include <algorithm>
+#include <cmath>
+
+VertexFormat Mesh::s_DefaultFormat = VertexFormat::Packed();
 
 Mesh::Mesh(const std::vector<Vertex>& vertices,
            const std::vector<unsigned int>& indices,
            const std::string& diffusePath,
            const std::string& normalPath)
-    : m_IndexCount(indices.size()) {
-    SetupMesh(vertices, indices);
-    if (!diffusePath.empty()) m_DiffuseTexture = LoadTexture(diffusePath);
-    if (!normalPath.empty()) m_NormalTexture = LoadTexture(normalPath);
+    : m_VertexCount(vertices.size()), m_IndexCount(indices.size()) {
+    ComputeBounds(vertices.data(), vertices.size(), m_Bounds, m_Sphere);
+    SetupMesh(vertices.data(), vertices.size(), indices.data(), indices.size());
+    if (!diffusePath.empty()) m_DiffuseTexture = TextureManager::Get().Load(diffusePath, Material::GetTextureOptions(0));
+    if (!normalPath.empty()) m_NormalTexture = TextureManager::Get().Load(normalPath, Material::GetTextureOptions(1));
+}
+
+Mesh::Mesh(const Vertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount)
+    : m_VertexCount(vertexCount), m_IndexCount(indexCount) {
+    ComputeBounds(vertices, vertexCount, m_Bounds, m_Sphere);
+    SetupMesh(vertices, vertexCount, indices, indexCount);
+}
+
+Mesh::Mesh(size_t vertexCount, size_t indexCount, const AABB& bounds, const BoundingSphere& sphere)
+    : m_VertexCount(vertexCount), m_IndexCount(indexCount), m_Bounds(bounds), m_Sphere(sphere) {
+    SetupMesh(nullptr, vertexCount, nullptr, indexCount);
 }
 
 Mesh::~Mesh() {
     if (VAO) glDeleteVertexArrays(1, &VAO);
     if (VBO) glDeleteBuffers(1, &VBO);
     if (EBO) glDeleteBuffers(1, &EBO);
-    if (m_DiffuseTexture) glDeleteTextures(1, &m_DiffuseTexture);
-    if (m_NormalTexture) glDeleteTextures(1, &m_NormalTexture);
+    if (m_InstanceVBO) glDeleteBuffers(1, &m_InstanceVBO);
 }
 
-void Mesh::SetupMesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices) {
+void Mesh::SetupMesh(const Vertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount) {
+    m_Lods[0].indexCount = (uint32_t)indexCount;
+    // Границы уже посчитаны: по ним — решётка квантования позиций
+    if (m_Format.position == VERTEX_POSITION_UNORM16) m_Quantization = VertexQuantization::FromBounds(m_Bounds);
+    const size_t stride = m_Format.GetStride();
+
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
     glGenBuffers(1, &EBO);
@@ -28,61 +48,211 @@ void Mesh::SetupMesh(const std::vector<Vertex>& vertices, const std::vector<unsi
     glBindVertexArray(VAO);
 
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
+    if (vertices && !m_Format.IsFloat()) {
+        std::vector<uint8_t> packed(vertexCount * stride);
+        VertexPacker::Pack(vertices, vertexCount, m_Format, m_Quantization, packed.data());
+        glBufferData(GL_ARRAY_BUFFER, packed.size(), packed.data(), GL_STATIC_DRAW);
+    } else {
+        glBufferData(GL_ARRAY_BUFFER, vertexCount * stride, vertices, GL_STATIC_DRAW);
+    }
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+    if (vertexCount < 65536) m_IndexType = GL_UNSIGNED_SHORT;
+    if (indices && m_IndexType == GL_UNSIGNED_SHORT) {
+        std::vector<uint16_t> narrow(indices, indices + indexCount);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * sizeof(uint16_t), narrow.data(), GL_STATIC_DRAW);
+    } else {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, GetIndexBytes(), indices, GL_STATIC_DRAW);
+    }
 
-    // Позиция (location = 0)
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+    // Позиция (location = 0); квантованная распаковывается в шейдере
+    if (m_Format.position == VERTEX_POSITION_FLOAT) {
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, (GLsizei)stride, (void*)0);
+    } else {
+        glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, (GLsizei)stride, (void*)0);
+    }
     glEnableVertexAttribArray(0);
-    // Нормаль (location = 1)
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Normal));
+    // Нормаль (location = 1) и касательная со знаком битангенса в w (location = 3)
+    void* normalOffset = (void*)m_Format.GetNormalOffset();
+    void* tangentOffset = (void*)m_Format.GetTangentOffset();
+    if (m_Format.normal == VERTEX_NORMAL_FLOAT) {
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, (GLsizei)stride, normalOffset);
+        glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, (GLsizei)stride, tangentOffset);
+    } else if (m_Format.normal == VERTEX_NORMAL_OCTAHEDRAL) {
+        glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, (GLsizei)stride, normalOffset);
+        glVertexAttribPointer(3, 2, GL_SHORT, GL_TRUE, (GLsizei)stride, tangentOffset);
+    } else {
+        glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, (GLsizei)stride, normalOffset);
+        glVertexAttribPointer(3, 4, GL_INT_2_10_10_10_REV, GL_TRUE, (GLsizei)stride, tangentOffset);
+    }
     glEnableVertexAttribArray(1);
+    glEnableVertexAttribArray(3);
     // Текстурные координаты (location = 2)
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords));
+    GLenum texCoordType = m_Format.texCoords == VERTEX_TEXCOORD_FLOAT ? GL_FLOAT : GL_HALF_FLOAT;
+    glVertexAttribPointer(2, 2, texCoordType, GL_FALSE, (GLsizei)stride, (void*)m_Format.GetTexCoordOffset());
     glEnableVertexAttribArray(2);
-    // Касательная (location = 3)
-    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Tangent));
-    glEnableVertexAttribArray(3);
 
     glBindVertexArray(0);
 }
 
-GLuint Mesh::LoadTexture(const std::string& path) {
-    GLuint textureID;
-    glGenTextures(1, &textureID);
-    if (textureID == 0) {
-        std::cerr << "Failed to generate texture ID" << std::endl;
-        return 0;
+void Mesh::UploadVertices(size_t first, const Vertex* vertices, size_t count) {
+    const size_t stride = m_Format.GetStride();
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    if (m_Format.IsFloat()) {
+        glBufferSubData(GL_ARRAY_BUFFER, first * stride, count * stride, vertices);
+    } else {
+        std::vector<uint8_t> packed(count * stride);
+        VertexPacker::Pack(vertices, count, m_Format, m_Quantization, packed.data());
+        glBufferSubData(GL_ARRAY_BUFFER, first * stride, packed.size(), packed.data());
     }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
 
-    int width, height, nrChannels;
-    unsigned char* data = stbi_load(path.c_str(), &width, &height, &nrChannels, 0);
-    if (data) {
-        GLenum format = (nrChannels == 3) ? GL_RGB : GL_RGBA;
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        stbi_image_free(data);
-        std::cout << "Texture loaded: " << path << std::endl;
-        return textureID;
+void Mesh::UploadIndices(size_t first, const unsigned int* indices, size_t count) {
+    // EBO — состояние VAO: без привязанного VAO можно сбить чужой
+    glBindVertexArray(VAO);
+    if (m_IndexType == GL_UNSIGNED_SHORT) {
+        std::vector<uint16_t> narrow(indices, indices + count);
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, first * sizeof(uint16_t), count * sizeof(uint16_t), narrow.data());
     } else {
-        std::cerr << "Failed to load texture: " << path << " - " << stbi_failure_reason() << std::endl;
-        glDeleteTextures(1, &textureID);
-        return 0;
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, first * sizeof(unsigned int), count * sizeof(unsigned int), indices);
+    }
+    glBindVertexArray(0);
+}
+
+void Mesh::ComputeBounds(const Vertex* vertices, size_t vertexCount, AABB& bounds, BoundingSphere& sphere) {
+    if (vertexCount == 0) return;
+    glm::vec3 first(vertices[0].Position[0], vertices[0].Position[1], vertices[0].Position[2]);
+    bounds.min = bounds.max = first;
+    for (size_t i = 0; i < vertexCount; ++i) {
+        const Vertex& v = vertices[i];
+        bounds.Expand(glm::vec3(v.Position[0], v.Position[1], v.Position[2]));
     }
+    // Сфера вокруг центра AABB — плотнее, чем половина диагонали
+    sphere.center = bounds.GetCenter();
+    float maxDist2 = 0.0f;
+    for (size_t i = 0; i < vertexCount; ++i) {
+        const Vertex& v = vertices[i];
+        glm::vec3 d = glm::vec3(v.Position[0], v.Position[1], v.Position[2]) - sphere.center;
+        maxDist2 = (std::max)(maxDist2, glm::dot(d, d));
+    }
+    sphere.radius = std::sqrt(maxDist2);
+}
+
+void Mesh::Bind() const {
+    glBindVertexArray(VAO);
+    // Постоянные атрибуты — не состояние VAO, их выставляет каждая привязка
+    glVertexAttrib3f(10, m_Quantization.scale.x, m_Quantization.scale.y, m_Quantization.scale.z);
+    glVertexAttrib3f(11, m_Quantization.bias.x, m_Quantization.bias.y, m_Quantization.bias.z);
+    glVertexAttrib1f(12, m_Format.normal == VERTEX_NORMAL_OCTAHEDRAL ? 1.0f : 0.0f);
 }
 
 void Mesh::Draw() const {
     if (VAO == 0 || m_IndexCount == 0) return;
+    Bind();
+    DrawBound();
+    glBindVertexArray(0);
+}
+
+void Mesh::SetLods(const MeshLod* lods, int count) {
+    m_LodCount = 0;
+    for (int i = 0; i < count && m_LodCount < kMaxLods; ++i) {
+        // Уровень за пределами буфера — битые данные, дальше не идём
+        if ((size_t)lods[i].firstIndex + lods[i].indexCount > m_IndexCount) break;
+        m_Lods[m_LodCount++] = lods[i];
+    }
+    if (m_LodCount == 0) {
+        m_Lods[0] = MeshLod();
+        m_Lods[0].indexCount = (uint32_t)m_IndexCount;
+        m_LodCount = 1;
+    }
+}
+
+void Mesh::DrawBound(int lod) const {
+    if (VAO == 0 || m_IndexCount == 0) return;
+    const MeshLod& range = GetLod(lod);
+    size_t offset = range.firstIndex * GetIndexSize();
+    glDrawElements(GL_TRIANGLES, (GLsizei)range.indexCount, m_IndexType, (void*)offset);
+}
+
+void Mesh::DrawRangesBound(const GLsizei* counts, const void* const* offsets, size_t rangeCount) const {
+    if (VAO == 0 || rangeCount == 0) return;
+    glMultiDrawElements(GL_TRIANGLES, counts, m_IndexType, offsets, (GLsizei)rangeCount);
+}
+
+bool Mesh::ReadBack(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) const {
+    vertices.clear();
+    indices.clear();
+    if (VAO == 0 || m_VertexCount == 0 || m_IndexCount == 0) return false;
+    const MeshLod& range = m_Lods[0];
+
+    std::vector<uint8_t> packed(GetVertexBytes());
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glGetBufferSubData(GL_ARRAY_BUFFER, 0, packed.size(), packed.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    vertices.resize(m_VertexCount);
+    VertexPacker::Unpack(packed.data(), m_VertexCount, m_Format, m_Quantization, vertices.data());
+
+    // EBO — состояние VAO, читаем через него
     glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, (GLsizei)m_IndexCount, GL_UNSIGNED_INT, 0);
+    indices.resize(range.indexCount);
+    if (m_IndexType == GL_UNSIGNED_SHORT) {
+        std::vector<uint16_t> narrow(range.indexCount);
+        glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, range.firstIndex * sizeof(uint16_t),
+                           narrow.size() * sizeof(uint16_t), narrow.data());
+        std::copy(narrow.begin(), narrow.end(), indices.begin());
+    } else {
+        glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, range.firstIndex * sizeof(unsigned int),
+                           indices.size() * sizeof(unsigned int), indices.data());
+    }
+    glBindVertexArray(0);
+    return true;
+}
+
+void Mesh::SetupInstanceBuffer() const {
+    // VAO уже привязан: атрибуты экземпляров запоминаются в нём
+    glGenBuffers(1, &m_InstanceVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_InstanceVBO);
+
+    // Матрица модели занимает 4 слота (location 4..7)
+    for (int i = 0; i < 4; ++i) {
+        GLuint loc = 4 + i;
+        glVertexAttribPointer(loc, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                              (void*)(offsetof(InstanceData, Model) + sizeof(float) * 4 * i));
+        glEnableVertexAttribArray(loc);
+        glVertexAttribDivisor(loc, 1);
+    }
+    // Цвет объекта (location = 8)
+    glVertexAttribPointer(8, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*)offsetof(InstanceData, Color));
+    glEnableVertexAttribArray(8);
+    glVertexAttribDivisor(8, 1);
+    // Индекс материала — целочисленный атрибут (location = 9)
+    glVertexAttribIPointer(9, 1, GL_INT, sizeof(InstanceData), (void*)offsetof(InstanceData, MaterialIndex));
+    glEnableVertexAttribArray(9);
+    glVertexAttribDivisor(9, 1);
+}
+
+void Mesh::DrawInstanced(const std::vector<InstanceData>& instances) const {
+    if (VAO == 0 || m_IndexCount == 0 || instances.empty()) return;
+    Bind();
+    DrawInstancedBound(instances);
     glBindVertexArray(0);
 }
+
+void Mesh::DrawInstancedBound(const std::vector<InstanceData>& instances, int lod) const {
+    if (VAO == 0 || m_IndexCount == 0 || instances.empty()) return;
+    if (m_InstanceVBO == 0) SetupInstanceBuffer();
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_InstanceVBO);
+    if (instances.size() > m_InstanceCapacity) {
+        m_InstanceCapacity = instances.size() + instances.size() / 2;
+    }
+    // Orphaning: драйвер выдаёт новый блок памяти, не дожидаясь предыдущего кадра
+    glBufferData(GL_ARRAY_BUFFER, m_InstanceCapacity * sizeof(InstanceData), NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, instances.size() * sizeof(InstanceData), instances.data());
+
+    const MeshLod& range = GetLod(lod);
+    size_t offset = range.firstIndex * GetIndexSize();
+    glDrawElementsInstanced(GL_TRIANGLES, (GLsizei)range.indexCount, m_IndexType, (void*)offset,
+                            (GLsizei)instances.size());
+}
@@ -3,25 +3,79 @@
 #include <string>
 #include <memory>
 #include <GL/glew.h>
+#include "Graphics/Bounds.h"
+#include "Graphics/VertexFormat.h"
+#include "Graphics/MeshletBuilder.h"
+#include "Graphics/TextureManager.h"
 
 class Material;
 
-struct Vertex {
-    float Position[3];
-    float Normal[3];
-    float TexCoords[2];
-    float Tangent[3];
+// Данные одного экземпляра для инстансинга (location 4-7 = model, 8 = цвет,
+// 9 = строка таблицы материалов в режиме текстурных массивов)
+struct InstanceData {
+    float Model[16];
+    float Color[3];
+    int MaterialIndex;
+};
+
+// Уровень детализации — диапазон общего буфера индексов меша: уровни делят
+// вершины, отличаются только набором треугольников
+struct MeshLod {
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    float error = 0.0f;         // отклонение от исходной поверхности, единицы модели
 };
 
 class Mesh {
 public:
+    static const int kMaxLods = 4;
+
     Mesh(const std::vector<Vertex>& vertices,
          const std::vector<unsigned int>& indices,
          const std::string& diffusePath = "",
          const std::string& normalPath = "");
+    // Прямо из готовых массивов (например, из отображённого в память кэша модели)
+    Mesh(const Vertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount);
+    // Буферы нужного размера без данных: фоновый импорт докачивает их частями
+    // через UploadVertices/UploadIndices, границы считает заранее в своём потоке
+    Mesh(size_t vertexCount, size_t indexCount, const AABB& bounds, const BoundingSphere& sphere);
     ~Mesh();
 
+    // Вершины кодируются в раскладку меша на лету, индексы при меньше чем
+    // 65536 вершинах сужаются до 16 бит
+    void UploadVertices(size_t first, const Vertex* vertices, size_t count);
+    void UploadIndices(size_t first, const unsigned int* indices, size_t count);
+
+    // Границы по вершинам (без GL — можно звать из любого потока)
+    static void ComputeBounds(const Vertex* vertices, size_t vertexCount, AABB& bounds, BoundingSphere& sphere);
+
     void Draw() const;
+    // Один glDrawElementsInstanced на все экземпляры
+    void DrawInstanced(const std::vector<InstanceData>& instances) const;
+    // Те же вызовы без привязки/отвязки VAO: исполнитель очереди привязывает
+    // меш через Bind() один раз на серию одинаковых вызовов. Bind() заодно
+    // выставляет постоянные атрибуты распаковки вершин (location 10-12)
+    void Bind() const;
+    void DrawBound(int lod = 0) const;
+    void DrawInstancedBound(const std::vector<InstanceData>& instances, int lod = 0) const;
+
+    // Уровень 0 — весь буфер индексов, пока не заданы уровни; их индексы
+    // лежат в том же EBO после исходных. Лишние уровни отбрасываются
+    void SetLods(const MeshLod* lods, int count);
+    int GetLodCount() const { return m_LodCount; }
+    const MeshLod& GetLod(int lod) const { return m_Lods[ClampLod(lod)]; }
+    int ClampLod(int lod) const { return lod < 0 ? 0 : (lod >= m_LodCount ? m_LodCount - 1 : lod); }
+
+    // Кластеры уровня 0 для отсечения на CPU; пусто — меш рисуется целиком
+    void SetMeshlets(std::vector<Meshlet> meshlets) { m_Meshlets = std::move(meshlets); }
+    const std::vector<Meshlet>& GetMeshlets() const { return m_Meshlets; }
+    // Несколько диапазонов EBO одним glMultiDrawElements (меш привязан через Bind);
+    // offsets — смещения в байтах, см. GetIndexSize()
+    void DrawRangesBound(const GLsizei* counts, const void* const* offsets, size_t rangeCount) const;
+
+    // Вершины и индексы уровня 0 обратно из GPU (декодированные из раскладки меша,
+    // индексы расширены до 32 бит). Медленно — только для запекания в редакторе
+    bool ReadBack(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) const;
 
     void SetMaterial(std::shared_ptr<Material> material) { m_Material = material; }
     std::shared_ptr<Material> GetMaterial() const { return m_Material; }
@@ -29,15 +83,53 @@ public:
     void SetName(const std::string& name) { m_Name = name; }
     std::string GetName() const { return m_Name; }
 
+    // Источник меша для сохранения сцены: "builtin:cube", "builtin:sphere:32",
+    // "<файл модели>#<номер меша>". Пусто — меш создан кодом и не сохраняется
+    void SetAssetPath(const std::string& path) { m_AssetPath = path; }
+    const std::string& GetAssetPath() const { return m_AssetPath; }
+
+    // Границы в локальных координатах (считаются при создании)
+    const AABB& GetBoundingBox() const { return m_Bounds; }
+    const BoundingSphere& GetBoundingSphere() const { return m_Sphere; }
+
+    // Раскладка вершин выбирается при создании меша
+    const VertexFormat& GetVertexFormat() const { return m_Format; }
+    size_t GetVertexBytes() const { return m_VertexCount * m_Format.GetStride(); }
+    size_t GetVertexCount() const { return m_VertexCount; }
+    // GL_UNSIGNED_SHORT или GL_UNSIGNED_INT
+    GLenum GetIndexType() const { return m_IndexType; }
+    size_t GetIndexSize() const { return m_IndexType == GL_UNSIGNED_SHORT ? 2 : 4; }
+    size_t GetIndexBytes() const { return m_IndexCount * GetIndexSize(); }
+
+    // Раскладка для новых мешей (примитивы, импорт моделей); по умолчанию — Packed()
+    static void SetDefaultVertexFormat(const VertexFormat& format) { s_DefaultFormat = format; }
+    static const VertexFormat& GetDefaultVertexFormat() { return s_DefaultFormat; }
+
 private:
     GLuint VAO = 0, VBO = 0, EBO = 0;
+    size_t m_VertexCount = 0;
     size_t m_IndexCount = 0;
-    GLuint m_DiffuseTexture = 0;
-    GLuint m_NormalTexture = 0;
+    GLenum m_IndexType = GL_UNSIGNED_INT;
+    MeshLod m_Lods[kMaxLods];
+    int m_LodCount = 1;
+    std::vector<Meshlet> m_Meshlets;
+    VertexFormat m_Format = s_DefaultFormat;
+    VertexQuantization m_Quantization;
+    TextureHandle m_DiffuseTexture;
+    TextureHandle m_NormalTexture;
     std::shared_ptr<Material> m_Material;
     std::string m_Name;
+    std::string m_AssetPath;
+    AABB m_Bounds;
+    BoundingSphere m_Sphere;
+
+    // Буфер экземпляров создаётся лениво при первом инстансированном вызове
+    mutable GLuint m_InstanceVBO = 0;
+    mutable size_t m_InstanceCapacity = 0;
+
+    static VertexFormat s_DefaultFormat;
 
-    void SetupMesh(const std::vector<Vertex>& vertices,
-                   const std::vector<unsigned int>& indices);
-    GLuint LoadTexture(const std::string& path);
+    void SetupInstanceBuffer() const;
+    void SetupMesh(const Vertex* vertices, size_t vertexCount,
+                   const unsigned int* indices, size_t indexCount);
 };
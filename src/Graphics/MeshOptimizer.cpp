@@ -0,0 +1,232 @@
+#include "Graphics/MeshOptimizer.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+    // FIFO-кэш на метках времени: вершина в кэше, пока после неё было не больше
+    // kCacheSize промахов. Сброс кэша — сдвиг метки на kCacheSize + 1
+    struct CacheSimulator {
+        std::vector<unsigned int> times;
+        unsigned int timestamp = MeshOptimizer::kCacheSize + 1;
+
+        explicit CacheSimulator(size_t vertexCount) : times(vertexCount, 0) {}
+
+        bool InCache(unsigned int v) const { return timestamp - times[v] <= MeshOptimizer::kCacheSize; }
+        unsigned int Touch(unsigned int v) {
+            if (InCache(v)) return 0;
+            times[v] = timestamp++;
+            return 1;
+        }
+        unsigned int TouchTriangle(const unsigned int* triangle) {
+            return Touch(triangle[0]) + Touch(triangle[1]) + Touch(triangle[2]);
+        }
+        void Flush() { timestamp += MeshOptimizer::kCacheSize + 1; }
+    };
+
+    glm::vec3 GetPosition(const Vertex* vertices, unsigned int v) {
+        return glm::vec3(vertices[v].Position[0], vertices[v].Position[1], vertices[v].Position[2]);
+    }
+}
+
+void MeshOptimizer::Optimize(Vertex* vertices, size_t vertexCount, unsigned int* indices, size_t indexCount,
+                             VertexCacheStats* before, VertexCacheStats* after) {
+    // Не треугольники (точки, линии) и битые индексы остаются как есть
+    bool valid = indexCount >= 3 && indexCount % 3 == 0;
+    for (size_t i = 0; valid && i < indexCount; ++i) valid = indices[i] < vertexCount;
+    if (before) *before = AnalyzeVertexCache(indices, valid ? indexCount : 0, vertexCount);
+    if (valid) {
+        std::vector<unsigned int> clusters;
+        OptimizeVertexCache(indices, indexCount, vertexCount, &clusters);
+        OptimizeOverdraw(vertices, indices, indexCount, vertexCount, clusters);
+        OptimizeVertexFetch(vertices, vertexCount, indices, indexCount);
+    }
+    if (after) *after = AnalyzeVertexCache(indices, valid ? indexCount : 0, vertexCount);
+}
+
+void MeshOptimizer::OptimizeVertexCache(unsigned int* indices, size_t indexCount, size_t vertexCount,
+                                        std::vector<unsigned int>* clusters) {
+    if (clusters) clusters->clear();
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0 || vertexCount == 0) return;
+
+    // Треугольники каждой вершины: offsets[v]..offsets[v + 1] в adjacency
+    std::vector<unsigned int> offsets(vertexCount + 1, 0);
+    for (size_t i = 0; i < triangleCount * 3; ++i) offsets[indices[i] + 1]++;
+    for (size_t v = 0; v < vertexCount; ++v) offsets[v + 1] += offsets[v];
+    std::vector<unsigned int> adjacency(triangleCount * 3);
+    std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < triangleCount * 3; ++i) adjacency[fill[indices[i]]++] = (unsigned int)(i / 3);
+
+    // Сколько ещё не выведенных треугольников у вершины
+    std::vector<unsigned int> live(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) live[v] = offsets[v + 1] - offsets[v];
+
+    std::vector<uint8_t> emitted(triangleCount, 0);
+    std::vector<unsigned int> deadEnd;
+    deadEnd.reserve(triangleCount * 3);
+    std::vector<unsigned int> candidates;
+    std::vector<unsigned int> result;
+    result.reserve(triangleCount * 3);
+    CacheSimulator cache(vertexCount);
+    size_t cursor = 0;
+    int fan = (int)indices[0];
+
+    while (fan >= 0) {
+        // Веер не из кэша — кэш фактически пуст, начинается новый кластер
+        if (clusters && !cache.InCache((unsigned int)fan)) clusters->push_back((unsigned int)(result.size() / 3));
+
+        candidates.clear();
+        for (unsigned int a = offsets[fan]; a < offsets[fan + 1]; ++a) {
+            unsigned int t = adjacency[a];
+            if (emitted[t]) continue;
+            emitted[t] = 1;
+            for (int k = 0; k < 3; ++k) {
+                unsigned int v = indices[t * 3 + k];
+                result.push_back(v);
+                deadEnd.push_back(v);
+                candidates.push_back(v);
+                live[v]--;
+                cache.Touch(v);
+            }
+        }
+
+        // Следующий веер — вершина, которая останется в кэше дольше всех,
+        // но успеет отдать все свои треугольники
+        int best = -1;
+        int bestPriority = -1;
+        for (unsigned int v : candidates) {
+            if (live[v] == 0) continue;
+            int age = (int)(cache.timestamp - cache.times[v]);
+            int priority = age + 2 * (int)live[v] <= (int)kCacheSize ? age : 0;
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                best = (int)v;
+            }
+        }
+        if (best < 0) {
+            // Тупик: сначала недавно выведенные вершины, затем — по порядку номеров
+            while (!deadEnd.empty() && best < 0) {
+                unsigned int v = deadEnd.back();
+                deadEnd.pop_back();
+                if (live[v] > 0) best = (int)v;
+            }
+            while (best < 0 && cursor < vertexCount) {
+                if (live[cursor] > 0) best = (int)cursor;
+                else ++cursor;
+            }
+        }
+        fan = best;
+    }
+
+    std::copy(result.begin(), result.end(), indices);
+}
+
+void MeshOptimizer::OptimizeOverdraw(const Vertex* vertices, unsigned int* indices, size_t indexCount,
+                                     size_t vertexCount, const std::vector<unsigned int>& clusters, float threshold) {
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0 || clusters.empty()) return;
+
+    // Кластеры Tipsify дробятся дальше, пока их ACMR не хуже threshold от
+    // целого: мелкие кластеры сортируются точнее, а кэш почти не страдает
+    std::vector<unsigned int> soft;
+    CacheSimulator cache(vertexCount);
+    for (size_t c = 0; c < clusters.size(); ++c) {
+        size_t start = clusters[c];
+        size_t end = c + 1 < clusters.size() ? clusters[c + 1] : triangleCount;
+        if (start >= end) continue;
+
+        cache.Flush();
+        size_t clusterMisses = 0;
+        for (size_t t = start; t < end; ++t) clusterMisses += cache.TouchTriangle(indices + t * 3);
+        float target = threshold * (float)clusterMisses / (float)(end - start);
+
+        cache.Flush();
+        soft.push_back((unsigned int)start);
+        size_t misses = 0, size = 0;
+        for (size_t t = start; t < end; ++t) {
+            misses += cache.TouchTriangle(indices + t * 3);
+            size++;
+            if (t + 1 < end && (float)misses / (float)size <= target) {
+                soft.push_back((unsigned int)(t + 1));
+                cache.Flush();
+                misses = size = 0;
+            }
+        }
+    }
+
+    // Центр меша — среднее по вершинам треугольников
+    glm::vec3 meshCenter(0.0f);
+    for (size_t i = 0; i < indexCount; ++i) meshCenter += GetPosition(vertices, indices[i]);
+    meshCenter /= (float)indexCount;
+
+    // Кластер, смотрящий наружу от центра, рисуется раньше: он скорее
+    // закрывает остальные, и их фрагменты отсекаются ранним тестом глубины
+    struct ClusterKey {
+        float key;
+        unsigned int start;
+        unsigned int end;
+    };
+    std::vector<ClusterKey> keys(soft.size());
+    for (size_t c = 0; c < soft.size(); ++c) {
+        ClusterKey& cluster = keys[c];
+        cluster.start = soft[c];
+        cluster.end = c + 1 < soft.size() ? soft[c + 1] : (unsigned int)triangleCount;
+
+        glm::vec3 center(0.0f), normal(0.0f);
+        float area = 0.0f;
+        for (unsigned int t = cluster.start; t < cluster.end; ++t) {
+            glm::vec3 p0 = GetPosition(vertices, indices[t * 3 + 0]);
+            glm::vec3 p1 = GetPosition(vertices, indices[t * 3 + 1]);
+            glm::vec3 p2 = GetPosition(vertices, indices[t * 3 + 2]);
+            glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+            float a = glm::length(n);
+            center += (p0 + p1 + p2) * (a / 3.0f);
+            normal += n;
+            area += a;
+        }
+        float normalLength = glm::length(normal);
+        if (area > 0.0f) center /= area;
+        cluster.key = normalLength > 0.0f ? glm::dot(center - meshCenter, normal / normalLength) : 0.0f;
+    }
+    std::stable_sort(keys.begin(), keys.end(), [](const ClusterKey& a, const ClusterKey& b) { return a.key > b.key; });
+
+    std::vector<unsigned int> result;
+    result.reserve(triangleCount * 3);
+    for (const ClusterKey& cluster : keys) {
+        result.insert(result.end(), indices + cluster.start * 3, indices + cluster.end * 3);
+    }
+    std::copy(result.begin(), result.end(), indices);
+}
+
+void MeshOptimizer::OptimizeVertexFetch(Vertex* vertices, size_t vertexCount, unsigned int* indices, size_t indexCount) {
+    const unsigned int kUnused = ~0u;
+    std::vector<unsigned int> remap(vertexCount, kUnused);
+    unsigned int next = 0;
+    for (size_t i = 0; i < indexCount; ++i) {
+        unsigned int& slot = remap[indices[i]];
+        if (slot == kUnused) slot = next++;
+        indices[i] = slot;
+    }
+    for (size_t v = 0; v < vertexCount; ++v) {
+        if (remap[v] == kUnused) remap[v] = next++;
+    }
+
+    std::vector<Vertex> source(vertices, vertices + vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) vertices[remap[v]] = source[v];
+}
+
+VertexCacheStats MeshOptimizer::AnalyzeVertexCache(const unsigned int* indices, size_t indexCount, size_t vertexCount) {
+    VertexCacheStats stats;
+    stats.triangles = indexCount / 3;
+    CacheSimulator cache(vertexCount);
+    std::vector<uint8_t> used(vertexCount, 0);
+    for (size_t i = 0; i < stats.triangles * 3; ++i) {
+        unsigned int v = indices[i];
+        stats.misses += cache.Touch(v);
+        if (!used[v]) {
+            used[v] = 1;
+            stats.vertices++;
+        }
+    }
+    return stats;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include "Graphics/VertexFormat.h"
+
+// Трансформации вершин при FIFO-кэше на MeshOptimizer::kCacheSize вершин
+struct VertexCacheStats {
+    size_t triangles = 0;
+    size_t vertices = 0;        // вершины, на которые ссылаются индексы
+    size_t misses = 0;          // вызовы вершинного шейдера
+
+    // Average Cache Miss Ratio: трансформаций на треугольник (идеал — 0.5)
+    float GetACMR() const { return triangles ? (float)misses / (float)triangles : 0.0f; }
+    // Average Transformed Vertex Ratio: трансформаций на вершину (идеал — 1.0)
+    float GetATVR() const { return vertices ? (float)misses / (float)vertices : 0.0f; }
+
+    void Add(const VertexCacheStats& other) {
+        triangles += other.triangles;
+        vertices += other.vertices;
+        misses += other.misses;
+    }
+};
+
+// Оптимизация индексированного треугольного меша после импорта (без GL, любой поток):
+// 1. Tipsify (Sander, Nehab, Barczak 2007) — порядок треугольников под кэш вершин;
+// 2. кластеры того же прохода сортируются «снаружи внутрь» — меньше overdraw;
+// 3. вершины переставляются в порядке первого использования — выборка идёт подряд.
+class MeshOptimizer {
+public:
+    static const unsigned int kCacheSize = 16;
+
+    // Все три шага на месте; before/after — статистика кэша (можно nullptr)
+    static void Optimize(Vertex* vertices, size_t vertexCount, unsigned int* indices, size_t indexCount,
+                         VertexCacheStats* before = nullptr, VertexCacheStats* after = nullptr);
+
+    // clusters — начала кластеров (в треугольниках) для OptimizeOverdraw; можно nullptr
+    static void OptimizeVertexCache(unsigned int* indices, size_t indexCount, size_t vertexCount,
+                                    std::vector<unsigned int>* clusters);
+    // threshold — насколько кластер может ухудшить ACMR ради более мелкого деления
+    static void OptimizeOverdraw(const Vertex* vertices, unsigned int* indices, size_t indexCount,
+                                 size_t vertexCount, const std::vector<unsigned int>& clusters, float threshold = 1.05f);
+    // Неиспользуемые вершины уходят в конец
+    static void OptimizeVertexFetch(Vertex* vertices, size_t vertexCount, unsigned int* indices, size_t indexCount);
+
+    static VertexCacheStats AnalyzeVertexCache(const unsigned int* indices, size_t indexCount, size_t vertexCount);
+};
@@ -0,0 +1,68 @@
+#include "Graphics/MeshRegistry.h"
+#include "Graphics/Primitives.h"
+#include <algorithm>
+
+std::shared_ptr<Mesh> MeshRegistry::GetPrimitive(PrimitiveType type, int segments) {
+    // Ключи — те же, что Primitives пишет в Mesh::GetAssetPath
+    const std::string count = std::to_string(segments);
+    switch (type) {
+        case PRIMITIVE_CUBE: return Find("builtin:cube");
+        case PRIMITIVE_SPHERE: return Find("builtin:sphere:" + count);
+        case PRIMITIVE_CYLINDER: return Find("builtin:cylinder:" + count);
+        case PRIMITIVE_CONE: return Find("builtin:cone:" + count);
+        case PRIMITIVE_PYRAMID: return Find("builtin:pyramid");
+        case PRIMITIVE_PLANE: return Find("builtin:grid:1");
+    }
+    return nullptr;
+}
+
+std::shared_ptr<Mesh> MeshRegistry::Find(const std::string& assetPath) {
+    m_Stats.requests++;
+    auto it = m_Meshes.find(assetPath);
+    if (it != m_Meshes.end()) {
+        if (std::shared_ptr<Mesh> mesh = it->second.lock()) {
+            m_Stats.hits++;
+            return mesh;
+        }
+    }
+
+    std::shared_ptr<Mesh> mesh = Primitives::CreateFromAssetPath(assetPath);
+    if (!mesh) return nullptr;
+    m_Stats.created++;
+    Store(assetPath, mesh);
+    // "builtin:sphere" и "builtin:sphere:32" — один и тот же меш
+    if (mesh->GetAssetPath() != assetPath) Store(mesh->GetAssetPath(), mesh);
+    return mesh;
+}
+
+void MeshRegistry::Register(const std::shared_ptr<Mesh>& mesh) {
+    if (mesh && !mesh->GetAssetPath().empty()) Store(mesh->GetAssetPath(), mesh);
+}
+
+void MeshRegistry::Store(const std::string& assetPath, const std::shared_ptr<Mesh>& mesh) {
+    // Записи удалённых мешей вычищаются, когда таблица вырастает вдвое
+    if (m_Meshes.size() >= m_PurgeThreshold) {
+        for (auto it = m_Meshes.begin(); it != m_Meshes.end();) {
+            if (it->second.expired()) it = m_Meshes.erase(it);
+            else ++it;
+        }
+        m_PurgeThreshold = (std::max)((size_t)64, m_Meshes.size() * 2);
+    }
+    m_Meshes[assetPath] = mesh;
+}
+
+MeshRegistry::Stats MeshRegistry::GetStats() const {
+    Stats stats = m_Stats;
+    for (const auto& entry : m_Meshes) {
+        std::shared_ptr<Mesh> mesh = entry.second.lock();
+        // Меш под вторым ключом ("builtin:sphere") считается один раз — по своему
+        if (!mesh || mesh->GetAssetPath() != entry.first) continue;
+        stats.liveMeshes++;
+        stats.references += (uint32_t)mesh.use_count() - 1;
+        stats.vertexBytes += mesh->GetVertexBytes();
+        stats.floatVertexBytes += mesh->GetVertexCount() * sizeof(Vertex);
+        stats.indexBytes += mesh->GetIndexBytes();
+        if (mesh->GetIndexType() == GL_UNSIGNED_SHORT) stats.shortIndexMeshes++;
+    }
+    return stats;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <string>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+
+class Mesh;
+
+// Встроенные примитивы, которые можно запросить у реестра
+enum PrimitiveType {
+    PRIMITIVE_CUBE,
+    PRIMITIVE_SPHERE,
+    PRIMITIVE_CYLINDER,
+    PRIMITIVE_CONE,
+    PRIMITIVE_PYRAMID,
+    PRIMITIVE_PLANE
+};
+
+// Общие меши по ключу ассета (Mesh::GetAssetPath). Примитив создаётся один раз
+// на (тип, сегменты), и все объекты с ним делят один VAO/VBO/EBO. Меши моделей
+// регистрирует загрузчик: повторная загрузка сцены берёт их отсюда, не читая
+// модель заново. Владеют мешами объекты (shared_ptr), реестр хранит слабые
+// ссылки — меш удаляется вместе с последним владельцем.
+class MeshRegistry {
+public:
+    static MeshRegistry& Get() {
+        // Не разрушается при выходе, как и TextureManager
+        static MeshRegistry* registry = new MeshRegistry();
+        return *registry;
+    }
+
+    // segments — для сферы, цилиндра и конуса
+    std::shared_ptr<Mesh> GetPrimitive(PrimitiveType type, int segments = 32);
+    // "builtin:..." — примитив (создаётся при промахе); иначе — зарегистрированный
+    // меш модели. nullptr — такого меша нет
+    std::shared_ptr<Mesh> Find(const std::string& assetPath);
+    // Меш модели с ключом "<файл>#<номер>"; прежняя запись с тем же ключом заменяется
+    void Register(const std::shared_ptr<Mesh>& mesh);
+
+    struct Stats {
+        uint32_t requests = 0;
+        uint32_t hits = 0;              // отдан уже существующий меш
+        uint32_t created = 0;           // примитивов построено
+        uint32_t liveMeshes = 0;
+        uint32_t references = 0;        // владельцев у всех живых мешей
+        size_t vertexBytes = 0;         // VBO живых мешей
+        size_t floatVertexBytes = 0;    // те же вершины в раскладке float (Vertex)
+        size_t indexBytes = 0;
+        uint32_t shortIndexMeshes = 0;  // меши с 16-битными индексами
+    };
+    Stats GetStats() const;
+
+private:
+    MeshRegistry() = default;
+
+    void Store(const std::string& assetPath, const std::shared_ptr<Mesh>& mesh);
+
+    std::unordered_map<std::string, std::weak_ptr<Mesh>> m_Meshes;
+    size_t m_PurgeThreshold = 64;
+    Stats m_Stats;
+};
@@ -0,0 +1,369 @@
+#include "Graphics/MeshSimplifier.h"
+#include "Graphics/MeshOptimizer.h"
+#include <algorithm>
+#include <unordered_map>
+#include <cstring>
+#include <cmath>
+
+namespace {
+    // Симметричная матрица 3x3, вектор и свободный член: Q(x) = x^T A x + 2 b^T x + c.
+    // w — суммарный вес плоскостей; Q(x) / w — средний квадрат расстояния до них
+    struct Quadric {
+        double a00 = 0, a11 = 0, a22 = 0, a01 = 0, a02 = 0, a12 = 0;
+        double b0 = 0, b1 = 0, b2 = 0, c = 0;
+        double w = 0;
+
+        void AddPlane(const glm::dvec3& n, double d, double weight) {
+            a00 += weight * n.x * n.x; a11 += weight * n.y * n.y; a22 += weight * n.z * n.z;
+            a01 += weight * n.x * n.y; a02 += weight * n.x * n.z; a12 += weight * n.y * n.z;
+            b0 += weight * n.x * d; b1 += weight * n.y * d; b2 += weight * n.z * d;
+            c += weight * d * d;
+            w += weight;
+        }
+
+        void Add(const Quadric& q) {
+            a00 += q.a00; a11 += q.a11; a22 += q.a22; a01 += q.a01; a02 += q.a02; a12 += q.a12;
+            b0 += q.b0; b1 += q.b1; b2 += q.b2; c += q.c; w += q.w;
+        }
+
+        float Evaluate(const glm::vec3& p) const {
+            double x = p.x, y = p.y, z = p.z;
+            double r = a00 * x * x + a11 * y * y + a22 * z * z + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z) +
+                       2.0 * (b0 * x + b1 * y + b2 * z) + c;
+            // Округление может дать слегка отрицательное значение
+            return w > 0.0 ? (float)(std::fabs(r) / w) : 0.0f;
+        }
+    };
+
+    enum VertexKind : uint8_t {
+        KIND_MANIFOLD,      // внутри гладкой поверхности: схлопывается куда угодно
+        KIND_LINE,          // на краю или шве: только к соседу по этой линии
+        KIND_LOCKED         // угол линии, стык швов: не двигается
+    };
+
+    struct Collapse {
+        unsigned int from;
+        unsigned int to;
+        float error;
+    };
+
+    struct PositionKey {
+        float x, y, z;
+        bool operator==(const PositionKey& other) const {
+            return memcmp(this, &other, sizeof(PositionKey)) == 0;
+        }
+    };
+
+    struct PositionKeyHash {
+        size_t operator()(const PositionKey& key) const {
+            uint32_t bits[3];
+            memcpy(bits, &key, sizeof(bits));
+            uint32_t h = bits[0] * 73856093u ^ bits[1] * 19349663u ^ bits[2] * 83492791u;
+            return (size_t)(h ^ (h >> 16));
+        }
+    };
+
+    // Список «что -> куда» на CSR: offsets[i]..offsets[i + 1] в items
+    void BuildAdjacency(const std::vector<unsigned int>& keys, size_t keyCount,
+                        std::vector<unsigned int>& offsets, std::vector<unsigned int>& items) {
+        offsets.assign(keyCount + 1, 0);
+        for (unsigned int key : keys) offsets[key + 1]++;
+        for (size_t i = 0; i < keyCount; ++i) offsets[i + 1] += offsets[i];
+        items.resize(keys.size());
+        std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < keys.size(); ++i) items[fill[keys[i]]++] = (unsigned int)i;
+    }
+}
+
+size_t MeshSimplifier::Simplify(const Vertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount,
+                                size_t targetIndexCount, float targetError, unsigned int* destination, float* resultError) {
+    if (resultError) *resultError = 0.0f;
+    bool valid = indexCount >= 3 && indexCount % 3 == 0;
+    for (size_t i = 0; valid && i < indexCount; ++i) valid = indices[i] < vertexCount;
+    if (!valid || targetIndexCount >= indexCount) {
+        std::copy(indices, indices + indexCount, destination);
+        return indexCount;
+    }
+
+    // 1. Вершины с одной позицией (разные UV/нормали на шве) — «клинья» одной точки
+    std::vector<unsigned int> positionOf(vertexCount);
+    std::vector<glm::vec3> points;
+    {
+        std::unordered_map<PositionKey, unsigned int, PositionKeyHash> lookup;
+        lookup.reserve(vertexCount);
+        for (size_t v = 0; v < vertexCount; ++v) {
+            PositionKey key = { vertices[v].Position[0], vertices[v].Position[1], vertices[v].Position[2] };
+            auto it = lookup.emplace(key, (unsigned int)points.size());
+            if (it.second) points.push_back(glm::vec3(key.x, key.y, key.z));
+            positionOf[v] = it.first->second;
+        }
+    }
+    const size_t positionCount = points.size();
+    std::vector<unsigned int> wedgeOffsets, wedges;
+    BuildAdjacency(positionOf, positionCount, wedgeOffsets, wedges);
+
+    AABB bounds;
+    bounds.min = bounds.max = points[0];
+    for (const glm::vec3& p : points) bounds.Expand(p);
+    glm::vec3 size = bounds.max - bounds.min;
+    float extent = (std::max)((std::max)(size.x, size.y), size.z);
+    float errorLimit = targetError * extent;
+    float errorLimitSq = errorLimit * errorLimit;
+
+    std::vector<unsigned int> current(indices, indices + indexCount);
+    const size_t triangleCount = indexCount / 3;
+
+    // 2. Открытые рёбра: у клина-ребра a->b нет парного b->a. Это и край меша,
+    // и шов, где соседние треугольники ссылаются на разные клинья
+    std::vector<unsigned int> wedgeTriOffsets, wedgeTris;
+    BuildAdjacency(current, vertexCount, wedgeTriOffsets, wedgeTris);
+
+    const unsigned int kNone = ~0u;
+    const unsigned int kMany = ~0u - 1;
+    std::vector<unsigned int> openNeighbors(positionCount * 2, kNone);
+    std::vector<Quadric> quadrics(positionCount);
+
+    auto addOpenNeighbor = [&](unsigned int p, unsigned int q) {
+        unsigned int* slots = &openNeighbors[p * 2];
+        if (slots[0] == kMany || slots[0] == q || slots[1] == q) return;
+        if (slots[0] == kNone) slots[0] = q;
+        else if (slots[1] == kNone) slots[1] = q;
+        else slots[0] = slots[1] = kMany;
+    };
+
+    for (size_t t = 0; t < triangleCount; ++t) {
+        const unsigned int* tri = &current[t * 3];
+        glm::vec3 p0 = points[positionOf[tri[0]]], p1 = points[positionOf[tri[1]]], p2 = points[positionOf[tri[2]]];
+        glm::dvec3 n = glm::cross(glm::dvec3(p1 - p0), glm::dvec3(p2 - p0));
+        double length = glm::length(n);
+        if (length <= 0.0) continue;
+        n /= length;
+        // Плоскость треугольника с весом площади — во все три угла
+        double d = -glm::dot(n, glm::dvec3(p0));
+        for (int k = 0; k < 3; ++k) quadrics[positionOf[tri[k]]].AddPlane(n, d, length * 0.5);
+
+        for (int k = 0; k < 3; ++k) {
+            unsigned int a = tri[k], b = tri[(k + 1) % 3];
+            bool paired = false;
+            for (unsigned int i = wedgeTriOffsets[b]; i < wedgeTriOffsets[b + 1] && !paired; ++i) {
+                const unsigned int* other = &current[wedgeTris[i] / 3 * 3];
+                for (int j = 0; j < 3; ++j) {
+                    if (other[j] == b && other[(j + 1) % 3] == a) paired = true;
+                }
+            }
+            if (paired) continue;
+            unsigned int pa = positionOf[a], pb = positionOf[b];
+            if (pa == pb) continue;
+            addOpenNeighbor(pa, pb);
+            addOpenNeighbor(pb, pa);
+            // Перпендикулярная плоскость вдоль ребра держит край на месте
+            glm::dvec3 edge = glm::dvec3(points[pb] - points[pa]);
+            glm::dvec3 m = glm::cross(edge, n);
+            double edgeLength = glm::length(m);
+            if (edgeLength <= 0.0) continue;
+            m /= edgeLength;
+            double md = -glm::dot(m, glm::dvec3(points[pa]));
+            double weight = glm::dot(edge, edge) * 4.0;
+            quadrics[pa].AddPlane(m, md, weight);
+            quadrics[pb].AddPlane(m, md, weight);
+        }
+    }
+
+    std::vector<uint8_t> kind(positionCount, KIND_MANIFOLD);
+    for (size_t p = 0; p < positionCount; ++p) {
+        unsigned int* slots = &openNeighbors[p * 2];
+        bool wedged = wedgeOffsets[p + 1] - wedgeOffsets[p] > 1;
+        if (slots[0] == kNone && !wedged) kind[p] = KIND_MANIFOLD;
+        else if (slots[0] != kMany && slots[0] != kNone && slots[1] != kNone) kind[p] = KIND_LINE;
+        else kind[p] = KIND_LOCKED;
+    }
+
+    auto allowed = [&](unsigned int from, unsigned int to) {
+        if (kind[from] == KIND_MANIFOLD) return true;
+        if (kind[from] == KIND_LINE) return openNeighbors[from * 2] == to || openNeighbors[from * 2 + 1] == to;
+        return false;
+    };
+
+    // 3. Жадные проходы: кандидаты по возрастанию ошибки, в одном проходе
+    // окрестности схлопываний не пересекаются
+    const size_t targetTriangles = targetIndexCount / 3;
+    std::vector<unsigned int> positionTriOffsets, positionTris, cornerPositions;
+    std::vector<Collapse> candidates;
+    std::vector<uint8_t> locked;
+    std::vector<unsigned int> wedgeRemap(vertexCount);
+    std::vector<std::pair<unsigned int, unsigned int>> mapping;
+    std::vector<unsigned int> stamps(positionCount, 0);
+    unsigned int stamp = 0;
+    float maxError = 0.0f;
+
+    for (int pass = 0; pass < 64; ++pass) {
+        const size_t liveTriangles = current.size() / 3;
+        if (liveTriangles <= targetTriangles) break;
+
+        cornerPositions.resize(current.size());
+        for (size_t i = 0; i < current.size(); ++i) cornerPositions[i] = positionOf[current[i]];
+        BuildAdjacency(cornerPositions, positionCount, positionTriOffsets, positionTris);
+
+        candidates.clear();
+        for (size_t i = 0; i < current.size(); ++i) {
+            unsigned int a = cornerPositions[i];
+            unsigned int b = cornerPositions[i / 3 * 3 + (i + 1) % 3];
+            if (a == b) continue;
+            // Каждое внутреннее ребро встречается дважды — берём одно направление
+            if (a < b || kind[a] != KIND_MANIFOLD || kind[b] != KIND_MANIFOLD) {
+                if (allowed(a, b)) candidates.push_back({ a, b, quadrics[a].Evaluate(points[b]) });
+                if (allowed(b, a)) candidates.push_back({ b, a, quadrics[b].Evaluate(points[a]) });
+            }
+        }
+        if (candidates.empty()) break;
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const Collapse& x, const Collapse& y) { return x.error < y.error; });
+
+        locked.assign(positionCount, 0);
+        for (size_t v = 0; v < vertexCount; ++v) wedgeRemap[v] = (unsigned int)v;
+        const size_t goal = liveTriangles - targetTriangles;
+        size_t removed = 0, collapses = 0;
+
+        for (const Collapse& c : candidates) {
+            if (c.error > errorLimitSq) break;
+            if (locked[c.from] || locked[c.to]) continue;
+
+            // Треугольники вокруг from: с ребром from-to исчезают, их клинья задают
+            // соответствие клиньев; остальные не должны перевернуться или выродиться
+            mapping.clear();
+            size_t dying = 0;
+            bool ok = true;
+            for (unsigned int i = positionTriOffsets[c.from]; i < positionTriOffsets[c.from + 1] && ok; ++i) {
+                size_t t = positionTris[i] / 3;
+                const unsigned int* tri = &current[t * 3];
+                const unsigned int* pos = &cornerPositions[t * 3];
+                int k = pos[0] == c.from ? 0 : (pos[1] == c.from ? 1 : 2);
+                int to = pos[0] == c.to ? 0 : (pos[1] == c.to ? 1 : (pos[2] == c.to ? 2 : -1));
+                if (to >= 0) {
+                    dying++;
+                    for (const auto& m : mapping) {
+                        if (m.first == tri[k] && m.second != tri[to]) ok = false;
+                    }
+                    mapping.push_back(std::make_pair(tri[k], tri[to]));
+                    continue;
+                }
+                glm::vec3 a = points[pos[0]], b = points[pos[1]], d = points[pos[2]];
+                glm::vec3 n0 = glm::cross(b - a, d - a);
+                glm::vec3 moved[3] = { a, b, d };
+                moved[k] = points[c.to];
+                glm::vec3 n1 = glm::cross(moved[1] - moved[0], moved[2] - moved[0]);
+                float l0 = glm::length(n0), l1 = glm::length(n1);
+                if (l0 > 0.0f && (l1 <= 0.0f || glm::dot(n0, n1) < 0.25f * l0 * l1)) ok = false;
+            }
+            if (!ok || dying == 0) continue;
+            // Общие соседи from и to — только вершины исчезающих треугольников,
+            // иначе схлопывание склеит поверхность саму с собой
+            stamp++;
+            for (unsigned int i = positionTriOffsets[c.to]; i < positionTriOffsets[c.to + 1]; ++i) {
+                const unsigned int* pos = &cornerPositions[positionTris[i] / 3 * 3];
+                for (int k = 0; k < 3; ++k) stamps[pos[k]] = stamp;
+            }
+            size_t shared = 0;
+            for (unsigned int i = positionTriOffsets[c.from]; i < positionTriOffsets[c.from + 1]; ++i) {
+                const unsigned int* pos = &cornerPositions[positionTris[i] / 3 * 3];
+                for (int k = 0; k < 3; ++k) {
+                    if (pos[k] == c.from || pos[k] == c.to || stamps[pos[k]] != stamp) continue;
+                    stamps[pos[k]] = 0;
+                    shared++;
+                }
+            }
+            if (shared > dying) continue;
+            // Каждый живой клин from должен найти клин to — иначе шов порвётся
+            for (unsigned int i = positionTriOffsets[c.from]; i < positionTriOffsets[c.from + 1] && ok; ++i) {
+                unsigned int wedge = current[positionTris[i]];
+                bool found = false;
+                for (const auto& m : mapping) found = found || m.first == wedge;
+                ok = found;
+            }
+            if (!ok) continue;
+
+            for (const auto& m : mapping) wedgeRemap[m.first] = m.second;
+            quadrics[c.to].Add(quadrics[c.from]);
+            maxError = (std::max)(maxError, c.error);
+
+            if (kind[c.from] == KIND_LINE) {
+                // Линия from: соседи (other, to) -> у to сосед from заменяется на other
+                unsigned int other = openNeighbors[c.from * 2] == c.to ? openNeighbors[c.from * 2 + 1]
+                                                                       : openNeighbors[c.from * 2];
+                unsigned int touched[2] = { c.to, other };
+                for (unsigned int p : touched) {
+                    if (kind[p] != KIND_LINE) continue;
+                    unsigned int* slots = &openNeighbors[p * 2];
+                    for (int s = 0; s < 2; ++s) {
+                        if (slots[s] == c.from) slots[s] = p == c.to ? other : c.to;
+                    }
+                    // Замкнутая линия выродилась в пару точек
+                    if (slots[0] == slots[1] || slots[0] == p || slots[1] == p) kind[p] = KIND_LOCKED;
+                }
+            }
+            kind[c.from] = KIND_LOCKED;
+
+            locked[c.from] = locked[c.to] = 1;
+            for (unsigned int i = positionTriOffsets[c.from]; i < positionTriOffsets[c.from + 1]; ++i) {
+                const unsigned int* pos = &cornerPositions[positionTris[i] / 3 * 3];
+                locked[pos[0]] = locked[pos[1]] = locked[pos[2]] = 1;
+            }
+            collapses++;
+            removed += dying;
+            if (removed >= goal) break;
+        }
+        if (collapses == 0) break;
+
+        // Перенумерация клиньев и выброс вырожденных треугольников
+        size_t write = 0;
+        for (size_t t = 0; t < liveTriangles; ++t) {
+            unsigned int a = wedgeRemap[current[t * 3 + 0]];
+            unsigned int b = wedgeRemap[current[t * 3 + 1]];
+            unsigned int d = wedgeRemap[current[t * 3 + 2]];
+            unsigned int pa = positionOf[a], pb = positionOf[b], pd = positionOf[d];
+            if (pa == pb || pb == pd || pa == pd) continue;
+            current[write++] = a;
+            current[write++] = b;
+            current[write++] = d;
+        }
+        current.resize(write);
+    }
+
+    std::copy(current.begin(), current.end(), destination);
+    if (resultError) *resultError = std::sqrt(maxError);
+    return current.size();
+}
+
+int MeshSimplifier::GenerateLods(const Vertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount,
+                                 std::vector<unsigned int>& lodIndices, MeshLod* lods) {
+    lods[0] = MeshLod();
+    lods[0].indexCount = (uint32_t)indexCount;
+    if (indexCount / 3 < kMinLodTriangles) return 1;
+
+    // Допустимое отклонение каждого уровня — в долях размера меша
+    static const float kLodErrors[Mesh::kMaxLods] = { 0.0f, 0.01f, 0.025f, 0.05f };
+
+    std::vector<unsigned int> source(indices, indices + indexCount);
+    std::vector<unsigned int> simplified(indexCount);
+    int count = 1;
+    float error = 0.0f;
+    while (count < Mesh::kMaxLods) {
+        size_t target = source.size() / 6 * 3;
+        float levelError = 0.0f;
+        size_t result = Simplify(vertices, vertexCount, source.data(), source.size(), target, kLodErrors[count],
+                                 simplified.data(), &levelError);
+        // Уровень почти не легче предыдущего — дальше только швы и углы
+        if (result == 0 || result > source.size() * 4 / 5) break;
+
+        MeshOptimizer::OptimizeVertexCache(simplified.data(), result, vertexCount, nullptr);
+        // Уровень строится из предыдущего, отклонения складываются
+        error += levelError;
+        lods[count].firstIndex = (uint32_t)(indexCount + lodIndices.size());
+        lods[count].indexCount = (uint32_t)result;
+        lods[count].error = error;
+        lodIndices.insert(lodIndices.end(), simplified.begin(), simplified.begin() + result);
+        source.assign(simplified.begin(), simplified.begin() + result);
+        count++;
+    }
+    return count;
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include "Graphics/Mesh.h"
+
+// Упрощение меша по квадрикам ошибок (Garland, Heckbert 1997). Ребро
+// схлопывается в одну из своих вершин, поэтому LOD — это только новые индексы
+// к тому же буферу вершин. Открытые края и швы (разрыв UV или нормалей)
+// сохраняются: вершина на такой линии сдвигается только вдоль неё, а углы
+// линий не двигаются вовсе. Без GL — можно звать из потоков импорта.
+class MeshSimplifier {
+public:
+    // Меньше треугольников — LOD не строятся
+    static const size_t kMinLodTriangles = 128;
+
+    // Индексы упрощённого меша пишутся в destination (места — на indexCount),
+    // возвращается их число. targetError — предел отклонения в долях размера
+    // меша; resultError — достигнутое отклонение в единицах модели (можно nullptr)
+    static size_t Simplify(const Vertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount,
+                           size_t targetIndexCount, float targetError, unsigned int* destination, float* resultError);
+
+    // Цепочка до Mesh::kMaxLods уровней: lods[0] — сами indices, каждый следующий
+    // примерно вдвое меньше предыдущего. Индексы уровней дописываются в lodIndices;
+    // их firstIndex отсчитан так, будто lodIndices идут сразу за indices.
+    // Возвращает число уровней (1 — упрощать нечего)
+    static int GenerateLods(const Vertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount,
+                            std::vector<unsigned int>& lodIndices, MeshLod* lods);
+};
@@ -0,0 +1,101 @@
+#include "Graphics/MeshletBuilder.h"
+#include <algorithm>
+
+namespace {
+    glm::vec3 GetPosition(const Vertex* vertices, unsigned int v) {
+        return glm::vec3(vertices[v].Position[0], vertices[v].Position[1], vertices[v].Position[2]);
+    }
+
+    glm::vec3 TriangleNormal(const Vertex* vertices, const unsigned int* triangle) {
+        glm::vec3 p0 = GetPosition(vertices, triangle[0]);
+        glm::vec3 n = glm::cross(GetPosition(vertices, triangle[1]) - p0, GetPosition(vertices, triangle[2]) - p0);
+        float length = glm::length(n);
+        return length > 0.0f ? n / length : glm::vec3(0.0f);
+    }
+
+    // Сфера и конус нормалей по треугольникам диапазона
+    void ComputeMeshletBounds(const Vertex* vertices, const unsigned int* indices, Meshlet& meshlet) {
+        const unsigned int* first = indices + meshlet.firstIndex;
+        AABB box;
+        box.min = box.max = GetPosition(vertices, first[0]);
+        glm::vec3 normalSum(0.0f);
+        for (uint32_t i = 0; i < meshlet.indexCount; ++i) box.Expand(GetPosition(vertices, first[i]));
+        for (uint32_t t = 0; t < meshlet.indexCount; t += 3) normalSum += TriangleNormal(vertices, first + t);
+
+        meshlet.sphere.center = box.GetCenter();
+        float radius2 = 0.0f;
+        for (uint32_t i = 0; i < meshlet.indexCount; ++i) {
+            glm::vec3 d = GetPosition(vertices, first[i]) - meshlet.sphere.center;
+            radius2 = (std::max)(radius2, glm::dot(d, d));
+        }
+        meshlet.sphere.radius = std::sqrt(radius2);
+
+        meshlet.coneAxis = glm::vec3(0.0f);
+        meshlet.coneCutoff = 1.0f;
+        float axisLength = glm::length(normalSum);
+        if (axisLength <= 0.0f) return;
+        glm::vec3 axis = normalSum / axisLength;
+        float minDot = 1.0f;
+        for (uint32_t t = 0; t < meshlet.indexCount; t += 3) {
+            glm::vec3 n = TriangleNormal(vertices, first + t);
+            if (n != glm::vec3(0.0f)) minDot = (std::min)(minDot, glm::dot(n, axis));
+        }
+        // Раствор почти в полусферу — такой кластер виден почти отовсюду
+        if (minDot <= 0.1f) return;
+        meshlet.coneAxis = axis;
+        meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+    }
+}
+
+void MeshletBuilder::Build(const Vertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount,
+                           std::vector<Meshlet>& meshlets) {
+    meshlets.clear();
+    if (indexCount / 3 < kMinMeshTriangles) return;
+
+    // Кластер закрывается по лимиту вершин или треугольников, а также когда
+    // нормаль уходит далеко от средней: узкий конус чаще отсекается
+    const size_t kMinConeTriangles = 16;
+    const float kConeSplit = 0.5f;
+    const unsigned int kNone = ~0u;
+    std::vector<unsigned int> owner(vertexCount, kNone);
+    unsigned int id = 0;
+    size_t vertexTotal = 0;
+    glm::vec3 normalSum(0.0f);
+
+    Meshlet current;
+    for (size_t t = 0; t + 3 <= indexCount; t += 3) {
+        const unsigned int* triangle = indices + t;
+        unsigned int a = triangle[0], b = triangle[1], c = triangle[2];
+        size_t added = (owner[a] != id) + (owner[b] != id && b != a) + (owner[c] != id && c != a && c != b);
+        glm::vec3 normal = TriangleNormal(vertices, triangle);
+        size_t triangles = current.indexCount / 3;
+
+        bool split = triangles >= kMaxTriangles || vertexTotal + added > kMaxVertices;
+        if (!split && triangles >= kMinConeTriangles && normal != glm::vec3(0.0f)) {
+            float length = glm::length(normalSum);
+            split = length > 0.0f && glm::dot(normal, normalSum / length) < kConeSplit;
+        }
+        if (split && triangles > 0) {
+            ComputeMeshletBounds(vertices, indices, current);
+            meshlets.push_back(current);
+            current = Meshlet();
+            current.firstIndex = (uint32_t)t;
+            id++;
+            vertexTotal = 0;
+            normalSum = glm::vec3(0.0f);
+        }
+
+        for (int k = 0; k < 3; ++k) {
+            if (owner[triangle[k]] != id) {
+                owner[triangle[k]] = id;
+                vertexTotal++;
+            }
+        }
+        normalSum += normal;
+        current.indexCount += 3;
+    }
+    if (current.indexCount > 0) {
+        ComputeMeshletBounds(vertices, indices, current);
+        meshlets.push_back(current);
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include "Graphics/VertexFormat.h"
+
+// Кластер треугольников большого меша: непрерывный диапазон его буфера
+// индексов с границами для отсечения на CPU. Всё — в координатах меша
+struct Meshlet {
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    BoundingSphere sphere;
+    // Конус нормалей: все нормали кластера в пределах угла от оси,
+    // coneCutoff — синус этого угла; 1 — конус не отсекает никогда
+    glm::vec3 coneAxis = glm::vec3(0.0f);
+    float coneCutoff = 1.0f;
+};
+
+// Нарезка уже оптимизированного порядка треугольников на кластеры подряд:
+// треугольники не переставляются, кластер — смещение в том же EBO.
+// Без GL — можно звать из потоков импорта
+class MeshletBuilder {
+public:
+    static const size_t kMaxVertices = 64;
+    static const size_t kMaxTriangles = 124;
+    // Меньше треугольников — меш рисуется целиком, кластеры не нужны
+    static const size_t kMinMeshTriangles = 4096;
+
+    static void Build(const Vertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount,
+                      std::vector<Meshlet>& meshlets);
+
+    // Все треугольники кластера смотрят от камеры (camera — в координатах меша)
+    static bool IsBackfacing(const Meshlet& meshlet, const glm::vec3& camera) {
+        glm::vec3 toCluster = meshlet.sphere.center - camera;
+        float distance = std::sqrt(glm::dot(toCluster, toCluster));
+        return glm::dot(toCluster, meshlet.coneAxis) >= meshlet.coneCutoff * distance + meshlet.sphere.radius;
+    }
+};
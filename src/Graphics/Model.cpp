@@ -1,52 +1,175 @@
 #include "Graphics/Model.h"
+#include "Graphics/MeshRegistry.h"
+#include "Graphics/MeshOptimizer.h"
+#include "Graphics/MeshSimplifier.h"
+#include "Graphics/TangentGenerator.h"
+#include "Core/Parallel.h"
 #include <iostream>
 #include <filesystem>
+#include <chrono>
+
+namespace {
+    // Декодирование всех текстур модели сразу уходит в пул TextureManager;
+    // синхронные Load в createMesh забирают уже готовые картинки
+    void PrefetchTextures(const MaterialDesc& desc) {
+        for (int slot = 0; slot < Material::kTextureSlotCount; ++slot) {
+            if (!desc.textures[slot].empty()) TextureManager::Get().LoadAsync(desc.textures[slot], Material::GetTextureOptions(slot));
+        }
+    }
+}
 
 Model::Model(const std::string& path) {
     loadModel(path);
 }
 
 void Model::loadModel(const std::string& path) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    // Определяем директорию модели для поиска текстур
+    std::filesystem::path fsPath(path);
+    m_Directory = fsPath.parent_path().string();
+    m_Path = path;
+
+    uint64_t key = 0;
+    if (!ModelCache::MakeKey(path, kImportFlags, key)) {
+        std::cerr << "Model error: cannot read " << path << std::endl;
+        return;
+    }
+    const std::string cachePath = ModelCache::GetCachePath(key);
+
+    // Запечённая копия: меши грузятся прямо из отображённого файла, без Assimp
+    CookedModel cooked;
+    bool fromCache = cooked.Open(cachePath, key);
+    if (fromCache) {
+        std::vector<MaterialDesc> descs(cooked.GetMeshCount());
+        std::vector<bool> hasMaterial(descs.size());
+        for (size_t i = 0; i < descs.size(); ++i) {
+            hasMaterial[i] = cooked.GetMaterial(i, descs[i]);
+            if (hasMaterial[i]) PrefetchTextures(descs[i]);
+        }
+        for (size_t i = 0; i < descs.size(); ++i) {
+            MeshLod lods[Mesh::kMaxLods];
+            int lodCount = cooked.GetLods(i, lods);
+            createMesh(cooked.GetMeshName(i), cooked.GetVertices(i), cooked.GetVertexCount(i),
+                       cooked.GetIndices(i), cooked.GetIndexCount(i), lods, lodCount,
+                       hasMaterial[i] ? &descs[i] : nullptr);
+        }
+    } else {
+        ModelData data;
+        if (!ImportData(path, data)) return;
+        if (!ModelCache::Write(cachePath, key, data)) {
+            std::cerr << "Model cache: failed to write " << cachePath << std::endl;
+        }
+        for (const MaterialDesc& desc : data.materials) PrefetchTextures(desc);
+        for (const ModelData::MeshRange& range : data.meshes) {
+            createMesh(range.name, data.vertices.data() + range.firstVertex, range.vertexCount,
+                       data.indices.data() + range.firstIndex, range.indexCount, range.lods, (int)range.lodCount,
+                       range.material >= 0 ? &data.materials[range.material] : nullptr);
+        }
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "Model loaded: " << path << ", meshes: " << m_Meshes.size()
+              << (fromCache ? " (cooked cache), " : " (imported), ")
+              << std::chrono::duration<float, std::milli>(end - start).count() << " ms" << std::endl;
+}
+
+bool Model::ImportData(const std::string& path, ModelData& data) {
     Assimp::Importer importer;
-    const aiScene* scene = importer.ReadFile(path,
-    aiProcess_Triangulate |
-    aiProcess_GenNormals |
-    aiProcess_CalcTangentSpace |
-    aiProcess_JoinIdenticalVertices |
-    aiProcess_OptimizeMeshes
-);
+    const aiScene* scene = importer.ReadFile(path, kImportFlags);
 
     if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
         std::cerr << "Assimp error: " << importer.GetErrorString() << std::endl;
-        return;
+        return false;
     }
 
-    // Определяем директорию модели для поиска текстур
-    std::filesystem::path fsPath(path);
-    m_Directory = fsPath.parent_path().string();
+    std::string directory = std::filesystem::path(path).parent_path().string();
+    data.materials.resize(scene->mNumMaterials);
+    for (unsigned int i = 0; i < scene->mNumMaterials; ++i) {
+        processMaterial(scene->mMaterials[i], directory, data.materials[i]);
+    }
+
+    std::vector<const aiMesh*> order;
+    collectMeshes(scene->mRootNode, scene, order);
+
+    // Диапазоны считаются заранее: каждый поток пишет в свой кусок общих массивов
+    data.meshes.resize(order.size());
+    size_t vertexCount = 0, indexCount = 0;
+    for (size_t i = 0; i < order.size(); ++i) {
+        const aiMesh* mesh = order[i];
+        ModelData::MeshRange& range = data.meshes[i];
+        range.firstVertex = (uint32_t)vertexCount;
+        range.vertexCount = mesh->mNumVertices;
+        range.firstIndex = (uint32_t)indexCount;
+        for (unsigned int f = 0; f < mesh->mNumFaces; ++f) range.indexCount += mesh->mFaces[f].mNumIndices;
+        range.material = mesh->mMaterialIndex < data.materials.size() ? (int32_t)mesh->mMaterialIndex : -1;
+        // Имя меша; пустое заменяется номером в порядке обхода
+        range.name = mesh->mName.C_Str();
+        if (range.name.empty()) range.name = "Mesh_" + std::to_string(i);
+        vertexCount += range.vertexCount;
+        indexCount += range.indexCount;
+    }
+    data.vertices.resize(vertexCount);
+    data.indices.resize(indexCount);
+
+    // Перевод в Vertex, касательные, оптимизация порядка и цепочка LOD — до записи в кэш:
+    // запечённая модель уже оптимизирована и упрощена
+    auto optimizeStart = std::chrono::high_resolution_clock::now();
+    std::vector<VertexCacheStats> before(order.size()), after(order.size());
+    std::vector<std::vector<unsigned int>> lodIndices(order.size());
+    ParallelFor(order.size(), [&](size_t i) {
+        ModelData::MeshRange& range = data.meshes[i];
+        Vertex* vertices = data.vertices.data() + range.firstVertex;
+        unsigned int* indices = data.indices.data() + range.firstIndex;
+        processMesh(order[i], vertices, indices);
+        TangentGenerator::Generate(vertices, range.vertexCount, indices, range.indexCount);
+        MeshOptimizer::Optimize(vertices, range.vertexCount, indices, range.indexCount, &before[i], &after[i]);
+        range.lodCount = (uint32_t)MeshSimplifier::GenerateLods(vertices, range.vertexCount, indices, range.indexCount,
+                                                                lodIndices[i], range.lods);
+    });
+    VertexCacheStats totalBefore, totalAfter;
+    size_t lodTriangles = 0;
+    for (size_t i = 0; i < order.size(); ++i) {
+        totalBefore.Add(before[i]);
+        totalAfter.Add(after[i]);
+        lodTriangles += lodIndices[i].size() / 3;
+    }
 
-    processNode(scene->mRootNode, scene);
-    std::cout << "Model loaded: " << path << ", meshes: " << m_Meshes.size() << std::endl;
+    // Индексы LOD встают сразу за исходными индексами своего меша
+    if (lodTriangles > 0) {
+        std::vector<unsigned int> indices;
+        indices.reserve(data.indices.size() + lodTriangles * 3);
+        for (size_t i = 0; i < order.size(); ++i) {
+            ModelData::MeshRange& range = data.meshes[i];
+            const unsigned int* base = data.indices.data() + range.firstIndex;
+            range.firstIndex = (uint32_t)indices.size();
+            indices.insert(indices.end(), base, base + range.indexCount);
+            indices.insert(indices.end(), lodIndices[i].begin(), lodIndices[i].end());
+            range.indexCount += (uint32_t)lodIndices[i].size();
+        }
+        data.indices.swap(indices);
+    }
+    std::cout << "[MeshOptimizer] " << path << ": " << totalBefore.triangles << " triangles, ACMR "
+              << totalBefore.GetACMR() << " -> " << totalAfter.GetACMR() << ", ATVR " << totalBefore.GetATVR()
+              << " -> " << totalAfter.GetATVR() << " (cache " << MeshOptimizer::kCacheSize << "), "
+              << std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - optimizeStart).count()
+              << " ms with conversion and LOD (" << lodTriangles << " LOD triangles)" << std::endl;
+    return true;
 }
 
-void Model::processNode(aiNode* node, const aiScene* scene) {
+void Model::collectMeshes(aiNode* node, const aiScene* scene, std::vector<const aiMesh*>& order) {
     for (unsigned int i = 0; i < node->mNumMeshes; ++i) {
-        aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-        m_Meshes.push_back(processMesh(mesh, scene));
+        order.push_back(scene->mMeshes[node->mMeshes[i]]);
     }
     for (unsigned int i = 0; i < node->mNumChildren; ++i) {
-        processNode(node->mChildren[i], scene);
+        collectMeshes(node->mChildren[i], scene, order);
     }
 }
 
-std::shared_ptr<Mesh> Model::processMesh(aiMesh* mesh, const aiScene* scene) {
-    std::vector<Vertex> vertices;
-    std::vector<unsigned int> indices;
-    auto material = std::make_shared<Material>();
-
+void Model::processMesh(const aiMesh* mesh, Vertex* vertices, unsigned int* indices) {
     // Вершины
     for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
-        Vertex vertex;
+        Vertex& vertex = vertices[i];
         vertex.Position[0] = mesh->mVertices[i].x;
         vertex.Position[1] = mesh->mVertices[i].y;
         vertex.Position[2] = mesh->mVertices[i].z;
@@ -54,6 +177,8 @@ std::shared_ptr<Mesh> Model::processMesh(aiMesh* mesh, const aiScene* scene) {
             vertex.Normal[0] = mesh->mNormals[i].x;
             vertex.Normal[1] = mesh->mNormals[i].y;
             vertex.Normal[2] = mesh->mNormals[i].z;
+        } else {
+            vertex.Normal[0] = vertex.Normal[1] = vertex.Normal[2] = 0.0f;
         }
         if (mesh->mTextureCoords[0]) {
             vertex.TexCoords[0] = mesh->mTextureCoords[0][i].x;
@@ -61,73 +186,71 @@ std::shared_ptr<Mesh> Model::processMesh(aiMesh* mesh, const aiScene* scene) {
         } else {
             vertex.TexCoords[0] = vertex.TexCoords[1] = 0.0f;
         }
-        if (mesh->HasTangentsAndBitangents()) {
-            vertex.Tangent[0] = mesh->mTangents[i].x;
-            vertex.Tangent[1] = mesh->mTangents[i].y;
-            vertex.Tangent[2] = mesh->mTangents[i].z;
-        } else {
-            vertex.Tangent[0] = vertex.Tangent[1] = vertex.Tangent[2] = 0.0f;
-        }
-        vertices.push_back(vertex);
     }
 
     // Индексы
     for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
-        aiFace face = mesh->mFaces[i];
+        const aiFace& face = mesh->mFaces[i];
         for (unsigned int j = 0; j < face.mNumIndices; ++j)
-            indices.push_back(face.mIndices[j]);
+            *indices++ = face.mIndices[j];
     }
-
-    // Материал
-    if (mesh->mMaterialIndex >= 0) {
-        aiMaterial* aiMat = scene->mMaterials[mesh->mMaterialIndex];
-        processMaterial(aiMat, m_Directory, material);
-    }
-
-    auto newMesh = std::make_shared<Mesh>(vertices, indices);
-    newMesh->SetMaterial(material);
-
-    // Устанавливаем имя меша (исправлено)
-    std::string meshName = mesh->mName.C_Str();
-    if (meshName.empty()) {
-        meshName = "Mesh_" + std::to_string(m_Meshes.size());
-    }
-    newMesh->SetName(meshName);
-
-    return newMesh;
 }
 
-void Model::processMaterial(aiMaterial* aiMat, const std::string& directory, std::shared_ptr<Material> material) {
+void Model::processMaterial(aiMaterial* aiMat, const std::string& directory, MaterialDesc& desc) {
+    // Порядок — как слоты Material: диффуз, нормали, roughness, metallic, AO
+    static const aiTextureType kSlotTypes[Material::kTextureSlotCount] = {
+        aiTextureType_DIFFUSE,
+        aiTextureType_NORMALS,
+        aiTextureType_DIFFUSE_ROUGHNESS,
+        aiTextureType_METALNESS,
+        aiTextureType_AMBIENT_OCCLUSION
+    };
     aiString path;
-
-    if (aiMat->GetTexture(aiTextureType_DIFFUSE, 0, &path) == AI_SUCCESS) {
-        material->LoadDiffuseTexture(directory + "/" + path.C_Str());
-    }
-    if (aiMat->GetTexture(aiTextureType_NORMALS, 0, &path) == AI_SUCCESS) {
-        material->LoadNormalTexture(directory + "/" + path.C_Str());
-    }
-    if (aiMat->GetTexture(aiTextureType_DIFFUSE_ROUGHNESS, 0, &path) == AI_SUCCESS) {
-        material->LoadRoughnessTexture(directory + "/" + path.C_Str());
-    }
-    if (aiMat->GetTexture(aiTextureType_METALNESS, 0, &path) == AI_SUCCESS) {
-        material->LoadMetallicTexture(directory + "/" + path.C_Str());
-    }
-    if (aiMat->GetTexture(aiTextureType_AMBIENT_OCCLUSION, 0, &path) == AI_SUCCESS) {
-        material->LoadAOTexture(directory + "/" + path.C_Str());
+    for (int slot = 0; slot < Material::kTextureSlotCount; ++slot) {
+        if (aiMat->GetTexture(kSlotTypes[slot], 0, &path) == AI_SUCCESS) {
+            desc.textures[slot] = directory + "/" + path.C_Str();
+        }
     }
 
     aiColor3D color;
     if (aiMat->Get(AI_MATKEY_COLOR_DIFFUSE, color) == AI_SUCCESS) {
-        material->albedo = glm::vec3(color.r, color.g, color.b);
+        desc.albedo = glm::vec3(color.r, color.g, color.b);
     }
     float shininess, metallic, roughness;
     if (aiMat->Get(AI_MATKEY_SHININESS, shininess) == AI_SUCCESS) {
-        material->roughness = 1.0f - (shininess / 100.0f);
+        desc.roughness = 1.0f - (shininess / 100.0f);
     }
     if (aiMat->Get(AI_MATKEY_METALLIC_FACTOR, metallic) == AI_SUCCESS) {
-        material->metallic = metallic;
+        desc.metallic = metallic;
     }
     if (aiMat->Get(AI_MATKEY_ROUGHNESS_FACTOR, roughness) == AI_SUCCESS) {
-        material->roughness = roughness;
+        desc.roughness = roughness;
+    }
+}
+
+void Model::createMesh(const std::string& name, const Vertex* vertices, size_t vertexCount,
+                       const unsigned int* indices, size_t indexCount, const MeshLod* lods, int lodCount,
+                       const MaterialDesc* desc) {
+    auto material = std::make_shared<Material>();
+    if (desc) {
+        for (int slot = 0; slot < Material::kTextureSlotCount; ++slot) {
+            if (!desc->textures[slot].empty()) material->LoadTextureSlot(slot, desc->textures[slot]);
+        }
+        material->albedo = desc->albedo;
+        material->metallic = desc->metallic;
+        material->roughness = desc->roughness;
     }
-}
\ No newline at end of file
+
+    auto newMesh = std::make_shared<Mesh>(vertices, vertexCount, indices, indexCount);
+    newMesh->SetLods(lods, lodCount);
+    // Кластеры для отсечения — по уровню 0: вблизи большой меш всегда на нём
+    std::vector<Meshlet> meshlets;
+    MeshletBuilder::Build(vertices, vertexCount, indices, newMesh->GetLod(0).indexCount, meshlets);
+    newMesh->SetMeshlets(std::move(meshlets));
+    newMesh->SetMaterial(material);
+    newMesh->SetName(name);
+    // Номер меша в порядке обхода узлов — по нему сцена находит меш при загрузке
+    newMesh->SetAssetPath(m_Path + "#" + std::to_string(m_Meshes.size()));
+    MeshRegistry::Get().Register(newMesh);
+    m_Meshes.push_back(newMesh);
+}
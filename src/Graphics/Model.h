@@ -7,6 +7,7 @@
 #include <assimp/postprocess.h>
 #include "Mesh.h"
 #include "Material.h"
+#include "ModelCache.h"
 
 class Model {
 public:
@@ -16,12 +17,28 @@ public:
     const std::vector<std::shared_ptr<Mesh>>& GetMeshes() const { return m_Meshes; }
     bool IsLoaded() const { return !m_Meshes.empty(); }
 
+    // Флаги постобработки Assimp; входят в ключ кэша запечённых моделей.
+    // Касательные Assimp не считает — их строит TangentGenerator
+    static const unsigned int kImportFlags =
+        aiProcess_Triangulate |
+        aiProcess_GenNormals |
+        aiProcess_JoinIdenticalVertices |
+        aiProcess_OptimizeMeshes;
+
+    // Разбор файла через Assimp в ModelData, без GL. Меши переводятся в Vertex
+    // параллельно; используется и фоновым импортом (ModelImportJob)
+    static bool ImportData(const std::string& path, ModelData& data);
+
 private:
     void loadModel(const std::string& path);
-    void processNode(aiNode* node, const aiScene* scene);
-    std::shared_ptr<Mesh> processMesh(aiMesh* mesh, const aiScene* scene);
-    void processMaterial(aiMaterial* aiMat, const std::string& directory, std::shared_ptr<Material> material);
+    static void collectMeshes(aiNode* node, const aiScene* scene, std::vector<const aiMesh*>& order);
+    static void processMesh(const aiMesh* mesh, Vertex* vertices, unsigned int* indices);
+    static void processMaterial(aiMaterial* aiMat, const std::string& directory, MaterialDesc& desc);
+    void createMesh(const std::string& name, const Vertex* vertices, size_t vertexCount,
+                    const unsigned int* indices, size_t indexCount, const MeshLod* lods, int lodCount,
+                    const MaterialDesc* desc);
 
     std::vector<std::shared_ptr<Mesh>> m_Meshes;
     std::string m_Directory;
+    std::string m_Path;
 };
\ No newline at end of file
@@ -0,0 +1,261 @@
+#include "Graphics/ModelCache.h"
+#include "Core/Hash.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+#include <cstdio>
+#include <system_error>
+
+namespace {
+    const uint32_t kMagic = 0x434D5842;     // "BXMC"
+    const uint32_t kVersion = 4;
+    const size_t kSectionAlignment = 16;
+
+    // Header | MeshRecord[] | MaterialRecord[] | строки | вершины | индексы
+    struct Header {
+        uint32_t magic = kMagic;
+        uint32_t version = kVersion;
+        uint64_t key = 0;
+        uint32_t meshCount = 0;
+        uint32_t materialCount = 0;
+        uint32_t vertexCount = 0;
+        uint32_t indexCount = 0;
+        uint32_t stringBytes = 0;
+        uint32_t reserved = 0;
+        uint64_t meshOffset = 0;
+        uint64_t materialOffset = 0;
+        uint64_t stringOffset = 0;
+        uint64_t vertexOffset = 0;
+        uint64_t indexOffset = 0;
+    };
+
+    struct MeshRecord {
+        uint32_t nameOffset = 0;
+        uint32_t nameLength = 0;
+        uint32_t firstVertex = 0;
+        uint32_t vertexCount = 0;
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+        int32_t material = -1;
+        uint32_t lodCount = 1;
+        MeshLod lods[Mesh::kMaxLods];
+    };
+
+    struct MaterialRecord {
+        glm::vec3 albedo = glm::vec3(1.0f);
+        float metallic = 0.0f;
+        float roughness = 0.5f;
+        uint32_t textureOffsets[Material::kTextureSlotCount] = {};
+        uint32_t textureLengths[Material::kTextureSlotCount] = {};
+    };
+
+    static_assert(sizeof(Header) == 80 && sizeof(MeshRecord) == 80 && sizeof(MaterialRecord) == 60 &&
+                  sizeof(Vertex) == 48,
+                  ".bxmodel layout changed: bump kVersion");
+
+    size_t AlignUp(size_t value) {
+        return (value + kSectionAlignment - 1) & ~(kSectionAlignment - 1);
+    }
+
+    bool InRange(uint64_t offset, uint64_t size, size_t fileSize) {
+        return offset <= fileSize && size <= fileSize - offset;
+    }
+}
+
+const char* ModelCache::kDirectory = "cache/models";
+
+bool ModelCache::MakeKey(const std::string& sourcePath, uint32_t importFlags, uint64_t& key) {
+    MappedFile source;
+    if (!source.Open(sourcePath)) return false;
+    // Версия формата и флаги — в seed: смена любого из них даёт новый ключ
+    key = HashBytes(source.GetData(), source.GetSize(), ((uint64_t)kVersion << 32) | importFlags);
+    return true;
+}
+
+std::string ModelCache::GetCachePath(uint64_t key) {
+    char name[17];
+    snprintf(name, sizeof(name), "%016llx", (unsigned long long)key);
+    return std::string(kDirectory) + "/" + name + ".bxmodel";
+}
+
+bool ModelCache::Write(const std::string& cachePath, uint64_t key, const ModelData& data) {
+    std::vector<char> strings;
+    auto addString = [&strings](const std::string& text, uint32_t& offset, uint32_t& length) {
+        offset = (uint32_t)strings.size();
+        length = (uint32_t)text.size();
+        strings.insert(strings.end(), text.begin(), text.end());
+    };
+
+    std::vector<MeshRecord> meshes(data.meshes.size());
+    for (size_t i = 0; i < data.meshes.size(); ++i) {
+        const ModelData::MeshRange& range = data.meshes[i];
+        MeshRecord& record = meshes[i];
+        addString(range.name, record.nameOffset, record.nameLength);
+        record.firstVertex = range.firstVertex;
+        record.vertexCount = range.vertexCount;
+        record.firstIndex = range.firstIndex;
+        record.indexCount = range.indexCount;
+        record.material = range.material;
+        record.lodCount = range.lodCount;
+        for (uint32_t lod = 0; lod < range.lodCount && lod < (uint32_t)Mesh::kMaxLods; ++lod) record.lods[lod] = range.lods[lod];
+    }
+    std::vector<MaterialRecord> materials(data.materials.size());
+    for (size_t i = 0; i < data.materials.size(); ++i) {
+        const MaterialDesc& desc = data.materials[i];
+        MaterialRecord& record = materials[i];
+        record.albedo = desc.albedo;
+        record.metallic = desc.metallic;
+        record.roughness = desc.roughness;
+        for (int slot = 0; slot < Material::kTextureSlotCount; ++slot) {
+            addString(desc.textures[slot], record.textureOffsets[slot], record.textureLengths[slot]);
+        }
+    }
+
+    Header header;
+    header.key = key;
+    header.meshCount = (uint32_t)meshes.size();
+    header.materialCount = (uint32_t)materials.size();
+    header.vertexCount = (uint32_t)data.vertices.size();
+    header.indexCount = (uint32_t)data.indices.size();
+    header.stringBytes = (uint32_t)strings.size();
+    header.meshOffset = AlignUp(sizeof(Header));
+    header.materialOffset = AlignUp(header.meshOffset + sizeof(MeshRecord) * meshes.size());
+    header.stringOffset = AlignUp(header.materialOffset + sizeof(MaterialRecord) * materials.size());
+    header.vertexOffset = AlignUp(header.stringOffset + strings.size());
+    header.indexOffset = AlignUp(header.vertexOffset + sizeof(Vertex) * data.vertices.size());
+    size_t fileSize = header.indexOffset + sizeof(unsigned int) * data.indices.size();
+
+    std::vector<char> buffer(fileSize, 0);
+    auto put = [&buffer](uint64_t offset, const void* source, size_t size) {
+        if (size) memcpy(buffer.data() + offset, source, size);
+    };
+    put(0, &header, sizeof(header));
+    put(header.meshOffset, meshes.data(), sizeof(MeshRecord) * meshes.size());
+    put(header.materialOffset, materials.data(), sizeof(MaterialRecord) * materials.size());
+    put(header.stringOffset, strings.data(), strings.size());
+    put(header.vertexOffset, data.vertices.data(), sizeof(Vertex) * data.vertices.size());
+    put(header.indexOffset, data.indices.data(), sizeof(unsigned int) * data.indices.size());
+
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path(), error);
+    const std::string tempPath = cachePath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file) return false;
+        file.write(buffer.data(), (std::streamsize)buffer.size());
+        if (!file) return false;
+    }
+    std::filesystem::rename(tempPath, cachePath, error);
+    if (error) {
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
+
+bool CookedModel::Open(const std::string& cachePath, uint64_t key) {
+    if (!m_File.Open(cachePath)) return false;
+    const uint8_t* data = m_File.GetData();
+    const size_t size = m_File.GetSize();
+    Header header;
+    if (size < sizeof(Header)) { m_File.Close(); return false; }
+    memcpy(&header, data, sizeof(header));
+
+    bool valid = header.magic == kMagic && header.version == kVersion && header.key == key &&
+                 InRange(header.meshOffset, (uint64_t)sizeof(MeshRecord) * header.meshCount, size) &&
+                 InRange(header.materialOffset, (uint64_t)sizeof(MaterialRecord) * header.materialCount, size) &&
+                 InRange(header.stringOffset, header.stringBytes, size) &&
+                 InRange(header.vertexOffset, (uint64_t)sizeof(Vertex) * header.vertexCount, size) &&
+                 InRange(header.indexOffset, (uint64_t)sizeof(unsigned int) * header.indexCount, size) &&
+                 header.meshOffset % alignof(MeshRecord) == 0 && header.materialOffset % alignof(MaterialRecord) == 0 &&
+                 header.vertexOffset % alignof(Vertex) == 0 && header.indexOffset % alignof(unsigned int) == 0;
+    if (!valid) { m_File.Close(); return false; }
+
+    m_Meshes = data + header.meshOffset;
+    m_Materials = data + header.materialOffset;
+    m_Strings = reinterpret_cast<const char*>(data + header.stringOffset);
+    m_Vertices = reinterpret_cast<const Vertex*>(data + header.vertexOffset);
+    m_Indices = reinterpret_cast<const unsigned int*>(data + header.indexOffset);
+    m_MeshCount = header.meshCount;
+    m_MaterialCount = header.materialCount;
+
+    // Диапазоны и сами индексы проверяются один раз здесь: дальше границы, LOD и
+    // кластеры читают вершины по индексам без проверок. Битый или устаревший
+    // файл отвергается — модель импортируется заново и кэш перезаписывается
+    auto stringOk = [&header](uint32_t offset, uint32_t length) {
+        return offset <= header.stringBytes && length <= header.stringBytes - offset;
+    };
+    const MeshRecord* meshes = reinterpret_cast<const MeshRecord*>(m_Meshes);
+    for (size_t i = 0; valid && i < m_MeshCount; ++i) {
+        const MeshRecord& mesh = meshes[i];
+        valid = stringOk(mesh.nameOffset, mesh.nameLength) &&
+                mesh.firstVertex <= header.vertexCount && mesh.vertexCount <= header.vertexCount - mesh.firstVertex &&
+                mesh.firstIndex <= header.indexCount && mesh.indexCount <= header.indexCount - mesh.firstIndex &&
+                mesh.material < (int32_t)header.materialCount &&
+                mesh.lodCount >= 1 && mesh.lodCount <= (uint32_t)Mesh::kMaxLods;
+        for (uint32_t lod = 0; valid && lod < mesh.lodCount; ++lod) {
+            valid = mesh.lods[lod].firstIndex <= mesh.indexCount &&
+                    mesh.lods[lod].indexCount <= mesh.indexCount - mesh.lods[lod].firstIndex;
+        }
+        const unsigned int* indices = m_Indices + mesh.firstIndex;
+        for (uint32_t k = 0; valid && k < mesh.indexCount; ++k) valid = indices[k] < mesh.vertexCount;
+    }
+    const MaterialRecord* materials = reinterpret_cast<const MaterialRecord*>(m_Materials);
+    for (size_t i = 0; valid && i < m_MaterialCount; ++i) {
+        for (int slot = 0; valid && slot < Material::kTextureSlotCount; ++slot) {
+            valid = stringOk(materials[i].textureOffsets[slot], materials[i].textureLengths[slot]);
+        }
+    }
+    if (!valid) {
+        std::cerr << "[ModelCache] " << cachePath << " is corrupted, re-importing" << std::endl;
+        m_File.Close();
+        m_MeshCount = m_MaterialCount = 0;
+        return false;
+    }
+    return true;
+}
+
+std::string CookedModel::GetString(uint32_t offset, uint32_t length) const {
+    return length ? std::string(m_Strings + offset, length) : std::string();
+}
+
+std::string CookedModel::GetMeshName(size_t mesh) const {
+    const MeshRecord& record = reinterpret_cast<const MeshRecord*>(m_Meshes)[mesh];
+    return GetString(record.nameOffset, record.nameLength);
+}
+
+const Vertex* CookedModel::GetVertices(size_t mesh) const {
+    return m_Vertices + reinterpret_cast<const MeshRecord*>(m_Meshes)[mesh].firstVertex;
+}
+
+size_t CookedModel::GetVertexCount(size_t mesh) const {
+    return reinterpret_cast<const MeshRecord*>(m_Meshes)[mesh].vertexCount;
+}
+
+const unsigned int* CookedModel::GetIndices(size_t mesh) const {
+    return m_Indices + reinterpret_cast<const MeshRecord*>(m_Meshes)[mesh].firstIndex;
+}
+
+size_t CookedModel::GetIndexCount(size_t mesh) const {
+    return reinterpret_cast<const MeshRecord*>(m_Meshes)[mesh].indexCount;
+}
+
+int CookedModel::GetLods(size_t mesh, MeshLod* out) const {
+    const MeshRecord& record = reinterpret_cast<const MeshRecord*>(m_Meshes)[mesh];
+    for (uint32_t lod = 0; lod < record.lodCount; ++lod) out[lod] = record.lods[lod];
+    return (int)record.lodCount;
+}
+
+bool CookedModel::GetMaterial(size_t mesh, MaterialDesc& desc) const {
+    int32_t index = reinterpret_cast<const MeshRecord*>(m_Meshes)[mesh].material;
+    if (index < 0) return false;
+    const MaterialRecord& record = reinterpret_cast<const MaterialRecord*>(m_Materials)[index];
+    desc.albedo = record.albedo;
+    desc.metallic = record.metallic;
+    desc.roughness = record.roughness;
+    for (int slot = 0; slot < Material::kTextureSlotCount; ++slot) {
+        desc.textures[slot] = GetString(record.textureOffsets[slot], record.textureLengths[slot]);
+    }
+    return true;
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "Graphics/Mesh.h"
+#include "Graphics/Material.h"
+#include "Core/MappedFile.h"
+
+// Материал меша в том виде, в каком его прочитал импорт (текстуры ещё не загружены)
+struct MaterialDesc {
+    glm::vec3 albedo = glm::vec3(1.0f);
+    float metallic = 0.0f;
+    float roughness = 0.5f;
+    std::string textures[Material::kTextureSlotCount];     // полные пути по слотам; пусто — нет
+};
+
+// Результат импорта модели в раскладке Mesh: вершины и индексы всех мешей
+// подряд, меш — диапазон в них (индексы — от начала своего диапазона).
+// Диапазон индексов меша — исходные треугольники и за ними его LOD.
+// Меши идут в порядке обхода узлов, как Model::GetMeshes().
+struct ModelData {
+    struct MeshRange {
+        std::string name;
+        uint32_t firstVertex = 0;
+        uint32_t vertexCount = 0;
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+        int32_t material = -1;      // индекс в materials
+        uint32_t lodCount = 1;
+        MeshLod lods[Mesh::kMaxLods];   // firstIndex — от начала диапазона индексов
+    };
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    std::vector<MeshRange> meshes;
+    std::vector<MaterialDesc> materials;
+};
+
+// Кэш запечённых моделей: cache/models/<ключ>.bxmodel. Ключ — хэш содержимого
+// исходного файла вместе с флагами импорта и версией формата, поэтому
+// изменённый файл или другой набор флагов просто не находит старую запись.
+class ModelCache {
+public:
+    static const char* kDirectory;
+
+    // false — исходный файл не прочитать
+    static bool MakeKey(const std::string& sourcePath, uint32_t importFlags, uint64_t& key);
+    static std::string GetCachePath(uint64_t key);
+    // Пишет во временный файл и переименовывает: недописанная запись не читается
+    static bool Write(const std::string& cachePath, uint64_t key, const ModelData& data);
+};
+
+// Запечённая модель, отображённая в память. Указатели на вершины и индексы
+// смотрят прямо в файл и действительны, пока объект открыт.
+class CookedModel {
+public:
+    // false — файла нет, он от другого ключа/версии или повреждён
+    bool Open(const std::string& cachePath, uint64_t key);
+    void Close() { m_File.Close(); m_MeshCount = m_MaterialCount = 0; }
+
+    size_t GetMeshCount() const { return m_MeshCount; }
+    std::string GetMeshName(size_t mesh) const;
+    const Vertex* GetVertices(size_t mesh) const;
+    size_t GetVertexCount(size_t mesh) const;
+    const unsigned int* GetIndices(size_t mesh) const;
+    size_t GetIndexCount(size_t mesh) const;
+    // Уровни детализации меша (out — Mesh::kMaxLods элементов), возвращает их число
+    int GetLods(size_t mesh, MeshLod* out) const;
+    // false — у меша нет материала
+    bool GetMaterial(size_t mesh, MaterialDesc& desc) const;
+
+private:
+    std::string GetString(uint32_t offset, uint32_t length) const;
+
+    MappedFile m_File;
+    const uint8_t* m_Meshes = nullptr;
+    const uint8_t* m_Materials = nullptr;
+    const char* m_Strings = nullptr;
+    const Vertex* m_Vertices = nullptr;
+    const unsigned int* m_Indices = nullptr;
+    size_t m_MeshCount = 0;
+    size_t m_MaterialCount = 0;
+};
@@ -0,0 +1,205 @@
+#include "Graphics/ModelImportJob.h"
+#include "Graphics/Model.h"
+#include "Graphics/MeshRegistry.h"
+#include "Core/Parallel.h"
+#include <iostream>
+#include <algorithm>
+
+namespace {
+    // Кусок буфера за один шаг: ~4 МБ — доли миллисекунды на glBufferSubData
+    const size_t kUploadChunkBytes = 4 * 1024 * 1024;
+    const size_t kVertexChunk = kUploadChunkBytes / sizeof(Vertex);
+    const size_t kIndexChunk = kUploadChunkBytes / sizeof(unsigned int);
+}
+
+ModelImportJob::ModelImportJob(const std::string& path)
+    : m_Path(path) {
+    m_StartTime = std::chrono::high_resolution_clock::now();
+    m_Worker = std::thread(&ModelImportJob::Load, this);
+}
+
+ModelImportJob::~ModelImportJob() {
+    if (m_Worker.joinable()) m_Worker.join();
+}
+
+void ModelImportJob::Load() {
+    uint64_t key = 0;
+    if (!ModelCache::MakeKey(m_Path, Model::kImportFlags, key)) {
+        std::cerr << "[Import] Cannot read " << m_Path << std::endl;
+        m_Stage = STAGE_FAILED;
+        return;
+    }
+    const std::string cachePath = ModelCache::GetCachePath(key);
+
+    m_FromCache = m_Cooked.Open(cachePath, key);
+    if (m_FromCache) {
+        m_Meshes.resize(m_Cooked.GetMeshCount());
+        for (size_t i = 0; i < m_Meshes.size(); ++i) {
+            PendingMesh& pending = m_Meshes[i];
+            pending.name = m_Cooked.GetMeshName(i);
+            pending.vertices = m_Cooked.GetVertices(i);
+            pending.vertexCount = m_Cooked.GetVertexCount(i);
+            pending.indices = m_Cooked.GetIndices(i);
+            pending.indexCount = m_Cooked.GetIndexCount(i);
+            pending.lodCount = m_Cooked.GetLods(i, pending.lods);
+            pending.hasMaterial = m_Cooked.GetMaterial(i, pending.material);
+        }
+    } else {
+        if (!Model::ImportData(m_Path, m_Data)) {
+            m_Stage = STAGE_FAILED;
+            return;
+        }
+        if (!ModelCache::Write(cachePath, key, m_Data)) {
+            std::cerr << "[Import] Failed to write cache " << cachePath << std::endl;
+        }
+        m_Meshes.resize(m_Data.meshes.size());
+        for (size_t i = 0; i < m_Meshes.size(); ++i) {
+            const ModelData::MeshRange& range = m_Data.meshes[i];
+            PendingMesh& pending = m_Meshes[i];
+            pending.name = range.name;
+            pending.vertices = m_Data.vertices.data() + range.firstVertex;
+            pending.vertexCount = range.vertexCount;
+            pending.indices = m_Data.indices.data() + range.firstIndex;
+            pending.indexCount = range.indexCount;
+            pending.lodCount = (int)range.lodCount;
+            std::copy(range.lods, range.lods + range.lodCount, pending.lods);
+            pending.hasMaterial = range.material >= 0;
+            if (pending.hasMaterial) pending.material = m_Data.materials[range.material];
+        }
+    }
+
+    ParallelFor(m_Meshes.size(), [this](size_t i) {
+        PendingMesh& pending = m_Meshes[i];
+        Mesh::ComputeBounds(pending.vertices, pending.vertexCount, pending.bounds, pending.sphere);
+        MeshletBuilder::Build(pending.vertices, pending.vertexCount, pending.indices, pending.lods[0].indexCount,
+                              pending.meshlets);
+    });
+
+    for (const PendingMesh& pending : m_Meshes) {
+        m_TotalBytes += pending.vertexCount * sizeof(Vertex) + pending.indexCount * sizeof(unsigned int);
+    }
+    m_Stage = STAGE_READY;
+}
+
+void ModelImportJob::RequestTextures() {
+    m_Materials.resize(m_Meshes.size());
+    for (size_t i = 0; i < m_Meshes.size(); ++i) {
+        const PendingMesh& pending = m_Meshes[i];
+        auto material = std::make_shared<Material>();
+        m_Materials[i] = material;
+        if (!pending.hasMaterial) continue;
+        material->albedo = pending.material.albedo;
+        material->metallic = pending.material.metallic;
+        material->roughness = pending.material.roughness;
+
+        // Один файл у нескольких материалов TextureManager декодирует один раз
+        std::weak_ptr<Material> weakMaterial = material;
+        std::shared_ptr<size_t> done = m_TexturesDone;
+        for (int slot = 0; slot < Material::kTextureSlotCount; ++slot) {
+            const std::string& path = pending.material.textures[slot];
+            if (path.empty()) continue;
+            m_TextureCount++;
+            TextureManager::Get().LoadAsync(path, Material::GetTextureOptions(slot), [weakMaterial, done, slot, path](const TextureHandle& texture) {
+                if (auto target = weakMaterial.lock()) target->SetTexture(slot, texture, path);
+                (*done)++;
+            });
+        }
+    }
+}
+
+void ModelImportJob::Update(float budgetMs) {
+    if (m_State == IMPORT_LOADING) {
+        int stage = m_Stage;
+        if (stage != STAGE_READY && stage != STAGE_FAILED) return;
+        m_Worker.join();
+        m_LoadMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - m_StartTime).count();
+        if (stage == STAGE_FAILED) {
+            m_State = IMPORT_FAILED;
+            std::cerr << "[Import] Failed to load model: " << m_Path << std::endl;
+            return;
+        }
+        m_State = IMPORT_UPLOADING;
+        RequestTextures();
+    }
+    if (m_State != IMPORT_UPLOADING) return;
+
+    // Хотя бы один шаг за кадр, дальше — пока укладываемся в бюджет
+    auto start = std::chrono::high_resolution_clock::now();
+    do {
+        UploadStep();
+    } while (m_State == IMPORT_UPLOADING &&
+             std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count() < budgetMs);
+}
+
+void ModelImportJob::UploadStep() {
+    if (m_UploadMesh == m_Meshes.size()) {
+        // Буферы в GPU: вершины больше не нужны; задание ждёт только текстуры
+        if (m_Cooked.GetMeshCount() || !m_Data.vertices.empty()) {
+            for (PendingMesh& pending : m_Meshes) {
+                pending.vertices = nullptr;
+                pending.indices = nullptr;
+            }
+            m_Data = ModelData();
+            m_Cooked.Close();
+        }
+        if (*m_TexturesDone < m_TextureCount) return;
+        m_State = IMPORT_DONE;
+
+        float totalMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - m_StartTime).count();
+        std::cout << "[Import] Model loaded: " << m_Path << ", meshes: " << m_Meshes.size()
+                  << ", textures: " << m_TextureCount << (m_FromCache ? " (cooked cache), " : " (imported), ")
+                  << m_LoadMs << " ms in background, " << totalMs << " ms total" << std::endl;
+        return;
+    }
+
+    PendingMesh& pending = m_Meshes[m_UploadMesh];
+    if (!m_CurrentMesh) {
+        m_CurrentMesh = std::make_shared<Mesh>(pending.vertexCount, pending.indexCount, pending.bounds, pending.sphere);
+        m_UploadedVertices = m_UploadedIndices = 0;
+    } else if (m_UploadedVertices < pending.vertexCount) {
+        size_t count = (std::min)(kVertexChunk, pending.vertexCount - m_UploadedVertices);
+        m_CurrentMesh->UploadVertices(m_UploadedVertices, pending.vertices + m_UploadedVertices, count);
+        m_UploadedVertices += count;
+        m_UploadedBytes += count * sizeof(Vertex);
+    } else if (m_UploadedIndices < pending.indexCount) {
+        size_t count = (std::min)(kIndexChunk, pending.indexCount - m_UploadedIndices);
+        m_CurrentMesh->UploadIndices(m_UploadedIndices, pending.indices + m_UploadedIndices, count);
+        m_UploadedIndices += count;
+        m_UploadedBytes += count * sizeof(unsigned int);
+    } else {
+        m_CurrentMesh->SetLods(pending.lods, pending.lodCount);
+        m_CurrentMesh->SetMeshlets(std::move(pending.meshlets));
+        m_CurrentMesh->SetMaterial(m_Materials[m_UploadMesh]);
+        m_CurrentMesh->SetName(pending.name);
+        // Тот же путь ассета, что даёт Model: сцена находит меш при загрузке
+        m_CurrentMesh->SetAssetPath(m_Path + "#" + std::to_string(m_UploadMesh));
+        MeshRegistry::Get().Register(m_CurrentMesh);
+        pending.mesh = m_CurrentMesh;
+        m_CurrentMesh.reset();
+        m_UploadMesh++;
+    }
+}
+
+float ModelImportJob::GetProgress() const {
+    // Половина шкалы — разбор в фоне, остальное — буферы и текстуры поровну
+    switch (m_State) {
+        case IMPORT_LOADING:
+            return 0.0f;
+        case IMPORT_UPLOADING: {
+            float buffers = m_TotalBytes ? (float)m_UploadedBytes / (float)m_TotalBytes : 1.0f;
+            float textures = m_TextureCount ? (float)*m_TexturesDone / (float)m_TextureCount : 1.0f;
+            return 0.5f + 0.25f * buffers + 0.25f * textures;
+        }
+        default:
+            return 1.0f;
+    }
+}
+
+const char* ModelImportJob::GetStageName() const {
+    switch (m_State) {
+        case IMPORT_LOADING: return "Reading";
+        case IMPORT_UPLOADING: return m_UploadMesh < m_Meshes.size() ? "Uploading" : "Loading textures";
+        case IMPORT_DONE: return "Done";
+        default: return "Failed";
+    }
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include "Graphics/ModelCache.h"
+#include "Graphics/Bounds.h"
+
+// Фоновый импорт модели для редактора. Рабочий поток открывает кэш или
+// разбирает файл через Assimp (меши — параллельно) и считает границы.
+// Буферы создаёт основной поток в Update() порциями, не дольше бюджета кадра:
+// большие буферы докачиваются кусками. Текстуры грузит TextureManager
+// (LoadAsync) и подставляет в материалы по готовности.
+// Меши те же, что у Model: имена, порядок, пути ассетов "<файл>#<номер>".
+class ModelImportJob {
+public:
+    enum State {
+        IMPORT_LOADING,     // рабочий поток: кэш или Assimp, текстуры
+        IMPORT_UPLOADING,   // основной поток: буферы и текстуры в GL
+        IMPORT_DONE,
+        IMPORT_FAILED
+    };
+
+    explicit ModelImportJob(const std::string& path);
+    ModelImportJob(const ModelImportJob&) = delete;
+    ModelImportJob& operator=(const ModelImportJob&) = delete;
+    ~ModelImportJob();
+
+    // Раз в кадр из основного (GL) потока
+    void Update(float budgetMs);
+
+    State GetState() const { return m_State; }
+    const std::string& GetPath() const { return m_Path; }
+    float GetProgress() const;
+    const char* GetStageName() const;
+
+    // Список мешей известен начиная с IMPORT_UPLOADING
+    size_t GetMeshCount() const { return m_State == IMPORT_LOADING ? 0 : m_Meshes.size(); }
+    const std::string& GetMeshName(size_t mesh) const { return m_Meshes[mesh].name; }
+    // nullptr, пока буферы меша не загружены в GPU (текстуры могут прийти позже)
+    std::shared_ptr<Mesh> GetMesh(size_t mesh) const { return m_Meshes[mesh].mesh; }
+
+private:
+    struct PendingMesh {
+        std::string name;
+        const Vertex* vertices = nullptr;
+        size_t vertexCount = 0;
+        const unsigned int* indices = nullptr;
+        size_t indexCount = 0;
+        MeshLod lods[Mesh::kMaxLods];
+        int lodCount = 1;
+        std::vector<Meshlet> meshlets;
+        bool hasMaterial = false;
+        MaterialDesc material;
+        AABB bounds;
+        BoundingSphere sphere;
+        std::shared_ptr<Mesh> mesh;
+    };
+
+    enum Stage { STAGE_READING, STAGE_READY, STAGE_FAILED };
+
+    // Рабочий поток
+    void Load();
+    // Основной поток: материалы и запросы текстур в TextureManager
+    void RequestTextures();
+    // Основной поток: один кусок работы (создание меша, часть буфера)
+    void UploadStep();
+
+    std::string m_Path;
+    State m_State = IMPORT_LOADING;
+    std::thread m_Worker;
+    std::atomic<int> m_Stage{ STAGE_READING };
+    bool m_FromCache = false;
+
+    // Источник вершин: либо отображённый кэш, либо результат импорта
+    CookedModel m_Cooked;
+    ModelData m_Data;
+    std::vector<PendingMesh> m_Meshes;
+    std::vector<std::shared_ptr<Material>> m_Materials;     // по мешу
+    // Колбэки текстур могут пережить задание — счётчик общий
+    std::shared_ptr<size_t> m_TexturesDone = std::make_shared<size_t>(0);
+    size_t m_TextureCount = 0;
+
+    // Состояние загрузки в GL
+    size_t m_UploadMesh = 0;
+    size_t m_UploadedVertices = 0;
+    size_t m_UploadedIndices = 0;
+    std::shared_ptr<Mesh> m_CurrentMesh;
+    size_t m_TotalBytes = 0;
+    size_t m_UploadedBytes = 0;
+    std::chrono::high_resolution_clock::time_point m_StartTime;
+    float m_LoadMs = 0.0f;
+};
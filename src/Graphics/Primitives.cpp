@@ -1,63 +1,50 @@
 #include "Graphics/Primitives.h"
+#include "Graphics/MeshOptimizer.h"
+#include "Graphics/MeshSimplifier.h"
+#include "Graphics/TangentGenerator.h"
 #include <vector>
+#include <string>
+#include <cstdlib>
 #include <cmath>
 #include <glm/glm.hpp>
 #include <glm/gtc/epsilon.hpp>
 
-// ��������������� ������� ��� ���������� ����������� �� ������ ������ ������������
-static void ComputeTangents(std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices) {
-    const size_t vertexCount = vertices.size();
-    std::vector<glm::vec3> tan1(vertexCount, glm::vec3(0.0f));
-    std::vector<glm::vec3> tan2(vertexCount, glm::vec3(0.0f));
-
-    for (size_t i = 0; i < indices.size(); i += 3) {
-        unsigned int i1 = indices[i];
-        unsigned int i2 = indices[i + 1];
-        unsigned int i3 = indices[i + 2];
-
-        const Vertex& v1 = vertices[i1];
-        const Vertex& v2 = vertices[i2];
-        const Vertex& v3 = vertices[i3];
-
-        glm::vec3 p1(v1.Position[0], v1.Position[1], v1.Position[2]);
-        glm::vec3 p2(v2.Position[0], v2.Position[1], v2.Position[2]);
-        glm::vec3 p3(v3.Position[0], v3.Position[1], v3.Position[2]);
-
-        glm::vec2 uv1(v1.TexCoords[0], v1.TexCoords[1]);
-        glm::vec2 uv2(v2.TexCoords[0], v2.TexCoords[1]);
-        glm::vec2 uv3(v3.TexCoords[0], v3.TexCoords[1]);
-
-        glm::vec3 edge1 = p2 - p1;
-        glm::vec3 edge2 = p3 - p1;
-        glm::vec2 duv1 = uv2 - uv1;
-        glm::vec2 duv2 = uv3 - uv1;
-
-        float det = duv1.x * duv2.y - duv2.x * duv1.y;
-        if (fabs(det) < 1e-6) continue;
-
-        float invDet = 1.0f / det;
-        glm::vec3 t = (edge1 * duv2.y - edge2 * duv1.y) * invDet;
-        glm::vec3 b = (edge2 * duv1.x - edge1 * duv2.x) * invDet; // ��������� (���� �� ���������)
-
-        tan1[i1] += t;
-        tan1[i2] += t;
-        tan1[i3] += t;
-
-        tan2[i1] += b;
-        tan2[i2] += b;
-        tan2[i3] += b;
-    }
-
-    for (size_t i = 0; i < vertexCount; ++i) {
-        const glm::vec3 n(vertices[i].Normal[0], vertices[i].Normal[1], vertices[i].Normal[2]);
-        const glm::vec3 t = tan1[i];
+// Касательные — через TangentGenerator, порядок треугольников и вершин — через
+// MeshOptimizer, цепочка LOD — через MeshSimplifier, как у импортированных
+// моделей. path — ключ встроенного меша, по нему сцена пересоздаёт меш при загрузке
+static std::shared_ptr<Mesh> BuildMesh(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices,
+                                       const std::string& path) {
+    TangentGenerator::Generate(vertices.data(), vertices.size(), indices.data(), indices.size());
+    MeshOptimizer::Optimize(vertices.data(), vertices.size(), indices.data(), indices.size());
+    std::vector<unsigned int> lodIndices;
+    MeshLod lods[Mesh::kMaxLods];
+    int lodCount = MeshSimplifier::GenerateLods(vertices.data(), vertices.size(), indices.data(), indices.size(),
+                                                lodIndices, lods);
+    indices.insert(indices.end(), lodIndices.begin(), lodIndices.end());
+    auto mesh = std::make_shared<Mesh>(vertices, indices);
+    mesh->SetLods(lods, lodCount);
+    mesh->SetAssetPath(path);
+    return mesh;
+}
 
-        // ��������������� �����-������
-        glm::vec3 tangent = glm::normalize(t - n * glm::dot(n, t));
-        vertices[i].Tangent[0] = tangent.x;
-        vertices[i].Tangent[1] = tangent.y;
-        vertices[i].Tangent[2] = tangent.z;
+std::shared_ptr<Mesh> Primitives::CreateFromAssetPath(const std::string& path) {
+    const std::string prefix = "builtin:";
+    if (path.compare(0, prefix.size(), prefix) != 0) return nullptr;
+    std::string name = path.substr(prefix.size());
+    int param = 32;
+    size_t colon = name.find(':');
+    if (colon != std::string::npos) {
+        param = std::atoi(name.c_str() + colon + 1);
+        name.resize(colon);
     }
+    if (name == "cube") return CreateCube();
+    if (name == "pyramid") return CreatePyramid();
+    if (param <= 0) return nullptr;
+    if (name == "grid") return CreateGrid(param);
+    if (name == "sphere") return CreateSphere(param);
+    if (name == "cylinder") return CreateCylinder(param);
+    if (name == "cone") return CreateCone(param);
+    return nullptr;
 }
 
 // ========== ��� ==========
@@ -117,7 +104,6 @@ std::shared_ptr<Mesh> Primitives::CreateCube() {
         vertex.Normal[2] = cubeVertices[i + 5];
         vertex.TexCoords[0] = cubeVertices[i + 6];
         vertex.TexCoords[1] = cubeVertices[i + 7];
-        vertex.Tangent[0] = 0.0f; vertex.Tangent[1] = 0.0f; vertex.Tangent[2] = 0.0f;
         vertices.push_back(vertex);
     }
 
@@ -125,8 +111,7 @@ std::shared_ptr<Mesh> Primitives::CreateCube() {
         indices.push_back(cubeIndices[i]);
     }
 
-    ComputeTangents(vertices, indices);
-    return std::make_shared<Mesh>(vertices, indices);
+    return BuildMesh(vertices, indices, "builtin:cube");
 }
 
 // ========== ����� (Grid) ==========
@@ -155,7 +140,6 @@ std::shared_ptr<Mesh> Primitives::CreateGrid(int size) {
         vertex.Normal[2] = gridVertices[i + 5];
         vertex.TexCoords[0] = gridVertices[i + 6];
         vertex.TexCoords[1] = gridVertices[i + 7];
-        vertex.Tangent[0] = 0.0f; vertex.Tangent[1] = 0.0f; vertex.Tangent[2] = 0.0f;
         vertices.push_back(vertex);
     }
 
@@ -163,8 +147,7 @@ std::shared_ptr<Mesh> Primitives::CreateGrid(int size) {
         indices.push_back(gridIndices[i]);
     }
 
-    ComputeTangents(vertices, indices);
-    return std::make_shared<Mesh>(vertices, indices);
+    return BuildMesh(vertices, indices, "builtin:grid:" + std::to_string(size));
 }
 
 // ========== ����� (���������, ��� �����������) ==========
@@ -196,8 +179,6 @@ std::shared_ptr<Mesh> Primitives::CreateSphere(int segments) {
             vertex.TexCoords[0] = xSegment;
             vertex.TexCoords[1] = ySegment;
 
-            vertex.Tangent[0] = 1.0f; vertex.Tangent[1] = 0.0f; vertex.Tangent[2] = 0.0f; // ��������
-
             vertices.push_back(vertex);
         }
     }
@@ -217,8 +198,7 @@ std::shared_ptr<Mesh> Primitives::CreateSphere(int segments) {
         }
     }
 
-    // ��� ����� ����������� �� ��������� (����� �������� �����)
-    return std::make_shared<Mesh>(vertices, indices);
+    return BuildMesh(vertices, indices, "builtin:sphere:" + std::to_string(segments));
 }
 
 // ========== ������� (���������, ��� �����������) ==========
@@ -246,7 +226,6 @@ std::shared_ptr<Mesh> Primitives::CreateCylinder(int segments) {
         topVertex.Normal[2] = sin(theta);
         topVertex.TexCoords[0] = (float)i / (float)segments;
         topVertex.TexCoords[1] = 1.0f;
-        topVertex.Tangent[0] = -sin(theta); topVertex.Tangent[1] = 0.0f; topVertex.Tangent[2] = cos(theta); // ����������
         vertices.push_back(topVertex);
 
         Vertex bottomVertex;
@@ -258,7 +237,6 @@ std::shared_ptr<Mesh> Primitives::CreateCylinder(int segments) {
         bottomVertex.Normal[2] = sin(theta);
         bottomVertex.TexCoords[0] = (float)i / (float)segments;
         bottomVertex.TexCoords[1] = 0.0f;
-        bottomVertex.Tangent[0] = -sin(theta); bottomVertex.Tangent[1] = 0.0f; bottomVertex.Tangent[2] = cos(theta);
         vertices.push_back(bottomVertex);
     }
 
@@ -288,7 +266,6 @@ std::shared_ptr<Mesh> Primitives::CreateCylinder(int segments) {
     centerTopVertex.Normal[2] = 0.0f;
     centerTopVertex.TexCoords[0] = 0.5f;
     centerTopVertex.TexCoords[1] = 0.5f;
-    centerTopVertex.Tangent[0] = 1.0f; centerTopVertex.Tangent[1] = 0.0f; centerTopVertex.Tangent[2] = 0.0f;
     vertices.push_back(centerTopVertex);
 
     int centerBottom = (int)vertices.size();
@@ -301,7 +278,6 @@ std::shared_ptr<Mesh> Primitives::CreateCylinder(int segments) {
     centerBottomVertex.Normal[2] = 0.0f;
     centerBottomVertex.TexCoords[0] = 0.5f;
     centerBottomVertex.TexCoords[1] = 0.5f;
-    centerBottomVertex.Tangent[0] = 1.0f; centerBottomVertex.Tangent[1] = 0.0f; centerBottomVertex.Tangent[2] = 0.0f;
     vertices.push_back(centerBottomVertex);
 
     // ������� ��� ������
@@ -319,7 +295,6 @@ std::shared_ptr<Mesh> Primitives::CreateCylinder(int segments) {
         topCap.Normal[2] = 0.0f;
         topCap.TexCoords[0] = (cos(theta) + 1.0f) * 0.5f;
         topCap.TexCoords[1] = (sin(theta) + 1.0f) * 0.5f;
-        topCap.Tangent[0] = 1.0f; topCap.Tangent[1] = 0.0f; topCap.Tangent[2] = 0.0f;
         vertices.push_back(topCap);
 
         Vertex bottomCap;
@@ -331,7 +306,6 @@ std::shared_ptr<Mesh> Primitives::CreateCylinder(int segments) {
         bottomCap.Normal[2] = 0.0f;
         bottomCap.TexCoords[0] = (cos(theta) + 1.0f) * 0.5f;
         bottomCap.TexCoords[1] = (sin(theta) + 1.0f) * 0.5f;
-        bottomCap.Tangent[0] = 1.0f; bottomCap.Tangent[1] = 0.0f; bottomCap.Tangent[2] = 0.0f;
         vertices.push_back(bottomCap);
     }
 
@@ -349,7 +323,7 @@ std::shared_ptr<Mesh> Primitives::CreateCylinder(int segments) {
         indices.push_back(bottomStart + i + 1);
     }
 
-    return std::make_shared<Mesh>(vertices, indices);
+    return BuildMesh(vertices, indices, "builtin:cylinder:" + std::to_string(segments));
 }
 
 // ========== ����� (���� ��� �������) ==========
@@ -367,7 +341,6 @@ std::shared_ptr<Mesh> Primitives::CreateCone(int segments) {
     tip.Position[0] = 0.0f; tip.Position[1] = halfHeight; tip.Position[2] = 0.0f;
     tip.Normal[0] = 0.0f; tip.Normal[1] = 1.0f; tip.Normal[2] = 0.0f;
     tip.TexCoords[0] = 0.5f; tip.TexCoords[1] = 1.0f;
-    tip.Tangent[0] = 1.0f; tip.Tangent[1] = 0.0f; tip.Tangent[2] = 0.0f;
     vertices.push_back(tip);
     
     // Боковая поверхность (кольцо основания)
@@ -383,7 +356,6 @@ std::shared_ptr<Mesh> Primitives::CreateCone(int segments) {
         glm::vec3 normal = glm::normalize(glm::vec3(x, radius, z));
         v.Normal[0] = normal.x; v.Normal[1] = normal.y; v.Normal[2] = normal.z;
         v.TexCoords[0] = u; v.TexCoords[1] = 0.0f;
-        v.Tangent[0] = -sin(angle); v.Tangent[1] = 0.0f; v.Tangent[2] = cos(angle);
         vertices.push_back(v);
     }
     
@@ -400,7 +372,6 @@ std::shared_ptr<Mesh> Primitives::CreateCone(int segments) {
     center.Position[0] = 0.0f; center.Position[1] = -halfHeight; center.Position[2] = 0.0f;
     center.Normal[0] = 0.0f; center.Normal[1] = -1.0f; center.Normal[2] = 0.0f;
     center.TexCoords[0] = 0.5f; center.TexCoords[1] = 0.5f;
-    center.Tangent[0] = 1.0f; center.Tangent[1] = 0.0f; center.Tangent[2] = 0.0f;
     vertices.push_back(center);
     
     int firstRing = (int)vertices.size();
@@ -413,7 +384,6 @@ std::shared_ptr<Mesh> Primitives::CreateCone(int segments) {
         v.Normal[0] = 0.0f; v.Normal[1] = -1.0f; v.Normal[2] = 0.0f;
         v.TexCoords[0] = (cos(angle) + 1.0f) * 0.5f;
         v.TexCoords[1] = (sin(angle) + 1.0f) * 0.5f;
-        v.Tangent[0] = 1.0f; v.Tangent[1] = 0.0f; v.Tangent[2] = 0.0f;
         vertices.push_back(v);
     }
     
@@ -423,7 +393,7 @@ std::shared_ptr<Mesh> Primitives::CreateCone(int segments) {
         indices.push_back(firstRing + i + 1);
     }
     
-    return std::make_shared<Mesh>(vertices, indices);
+    return BuildMesh(vertices, indices, "builtin:cone:" + std::to_string(segments));
 }
 
 // ========== �������� ==========
@@ -459,7 +429,6 @@ std::shared_ptr<Mesh> Primitives::CreatePyramid() {
         vertex.Normal[2] = pyramidVertices[i + 5];
         vertex.TexCoords[0] = pyramidVertices[i + 6];
         vertex.TexCoords[1] = pyramidVertices[i + 7];
-        vertex.Tangent[0] = 0.0f; vertex.Tangent[1] = 0.0f; vertex.Tangent[2] = 0.0f;
         vertices.push_back(vertex);
     }
 
@@ -467,8 +436,7 @@ std::shared_ptr<Mesh> Primitives::CreatePyramid() {
         indices.push_back(pyramidIndices[i]);
     }
 
-    ComputeTangents(vertices, indices);
-    return std::make_shared<Mesh>(vertices, indices);
+    return BuildMesh(vertices, indices, "builtin:pyramid");
 }
 
 // ========== ��������� ==========
@@ -522,6 +490,7 @@ std::shared_ptr<Mesh> Primitives::CreateSkyboxSphere(int segments) {
             indices.push_back(first + 1);
         }
     }
+    MeshOptimizer::Optimize(vertices.data(), vertices.size(), indices.data(), indices.size());
     auto mesh = std::make_shared<Mesh>(vertices, indices);
     mesh->SetName("SkyboxSphere");
     return mesh;
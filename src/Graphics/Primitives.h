@@ -1,5 +1,6 @@
 #pragma once
 #include <memory>
+#include <string>
 #include "Graphics/Mesh.h"
 
 class Primitives {
@@ -12,4 +13,8 @@ public:
     static std::shared_ptr<Mesh> CreatePyramid();
     static std::shared_ptr<Mesh> CreatePlane();
     static std::shared_ptr<Mesh> CreateSkyboxSphere(int segments = 64);
+
+    // Меш по ключу Mesh::GetAssetPath вида "builtin:<имя>[:<параметр>]";
+    // nullptr — ключ не встроенного меша
+    static std::shared_ptr<Mesh> CreateFromAssetPath(const std::string& path);
 };
@@ -0,0 +1,164 @@
+#include "Graphics/RenderQueue.h"
+#include "Graphics/Mesh.h"
+#include "Graphics/Material.h"
+#include "Graphics/Shader.h"
+#include "Graphics/MaterialTable.h"
+#include <cstring>
+#include <algorithm>
+
+static_assert(RenderKey::kShaderBits + RenderKey::kTextureBits + RenderKey::kMaterialBits +
+              RenderKey::kMeshBits + 1 + RenderKey::kDepthBits == 62, "RenderKey layout must fill 62 bits");
+
+namespace {
+    uint64_t Field(uint32_t value, uint32_t bits) {
+        uint32_t maxValue = (1u << bits) - 1u;
+        return (uint64_t)(std::min)(value, maxValue);
+    }
+}
+
+namespace RenderKey {
+    uint32_t QuantizeDepth(float depth) {
+        if (!(depth > 0.0f)) return 0;      // заодно отбрасывает NaN
+        uint32_t bits;
+        memcpy(&bits, &depth, sizeof(bits));
+        // Для положительных float битовое представление монотонно;
+        // знак всегда 0, берём следующие kDepthBits бит
+        return (bits >> (31 - kDepthBits)) & ((1u << kDepthBits) - 1u);
+    }
+
+    uint64_t Make(RenderPass pass, uint32_t shader, uint32_t textures, uint32_t material,
+                  uint32_t mesh, bool receiveShadows, float depth) {
+        uint64_t key = (uint64_t)pass & 0x3;
+        key = (key << kShaderBits) | Field(shader, kShaderBits);
+        key = (key << kTextureBits) | Field(textures, kTextureBits);
+        key = (key << kMaterialBits) | Field(material, kMaterialBits);
+        key = (key << kMeshBits) | Field(mesh, kMeshBits);
+        key = (key << 1) | (receiveShadows ? 1u : 0u);
+        key = (key << kDepthBits) | QuantizeDepth(depth);
+        return key;
+    }
+}
+
+void RenderQueue::Sort() {
+    const size_t count = m_Items.size();
+    if (count < 2) return;
+    m_Scratch.resize(count);
+
+    // Гистограммы всех 8 байтов за один проход
+    uint32_t histograms[8][256];
+    memset(histograms, 0, sizeof(histograms));
+    for (const RenderItem& item : m_Items) {
+        uint64_t key = item.key;
+        for (int b = 0; b < 8; ++b) {
+            histograms[b][(key >> (b * 8)) & 0xFF]++;
+        }
+    }
+
+    RenderItem* src = m_Items.data();
+    RenderItem* dst = m_Scratch.data();
+    for (int b = 0; b < 8; ++b) {
+        uint32_t* histogram = histograms[b];
+        const int shift = b * 8;
+        // Все ключи имеют одинаковый байт — проход ничего не меняет
+        if (histogram[(src[0].key >> shift) & 0xFF] == count) continue;
+
+        uint32_t offset = 0;
+        for (int i = 0; i < 256; ++i) {
+            uint32_t c = histogram[i];
+            histogram[i] = offset;
+            offset += c;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            dst[histogram[(src[i].key >> shift) & 0xFF]++] = src[i];
+        }
+        std::swap(src, dst);
+    }
+    if (src != m_Items.data()) {
+        memcpy(m_Items.data(), src, count * sizeof(RenderItem));
+    }
+}
+
+static_assert(Material::kTextureSlotCount == 5, "RenderStateCache::kTextureSlots out of sync with Material");
+
+void RenderStateCache::Begin() {
+    m_Material = nullptr;
+    m_MaterialValid = false;
+    m_PoolSet = -1;
+    m_Mesh = nullptr;
+    // Юниты материала могли изменить другие проходы — считаем их пустыми и
+    // приводим к этому виду при первой же привязке
+    for (int i = 0; i < kTextureSlots; ++i) m_Textures[i] = 0;
+}
+
+void RenderStateCache::End() {
+    for (int i = 0; i < kTextureSlots; ++i) {
+        if (m_Textures[i] != 0) {
+            glActiveTexture(Material::GetTextureUnit(i));
+            glBindTexture(GL_TEXTURE_2D, 0);
+            m_Textures[i] = 0;
+        }
+    }
+    if (m_Mesh) glBindVertexArray(0);
+    m_Mesh = nullptr;
+    m_Material = nullptr;
+    m_MaterialValid = false;
+    m_PoolSet = -1;
+}
+
+void RenderStateCache::BindTexture(int slot, GLuint texture) {
+    if (m_Textures[slot] == texture) {
+        m_Counters.bindsSkipped++;
+        return;
+    }
+    glActiveTexture(Material::GetTextureUnit(slot));
+    glBindTexture(GL_TEXTURE_2D, texture);
+    m_Textures[slot] = texture;
+    m_Counters.bindsIssued++;
+}
+
+void RenderStateCache::BindMaterial(Shader& shader, const Material* material) {
+    if (m_MaterialValid && m_Material == material) {
+        // Параметры и все текстуры уже на месте
+        m_Counters.bindsSkipped += 1 + (material ? kTextureSlots : 0);
+        return;
+    }
+    m_Material = material;
+    m_MaterialValid = true;
+    m_Counters.bindsIssued++;
+
+    if (!material) {
+        // Шейдер не читает текстуры при has*Texture = false, оставляем их как есть
+        Material::ApplyDefaults(shader);
+        return;
+    }
+    material->ApplyParameters(shader);
+    for (int i = 0; i < kTextureSlots; ++i) {
+        GLuint texture = material->GetTexture(i);
+        // Пустой слот не трогаем: флаг has* в шейдере уже false
+        if (texture == 0) continue;
+        BindTexture(i, texture);
+    }
+}
+
+void RenderStateCache::BindPoolSet(const MaterialTable& table, uint32_t poolSet) {
+    // Uniform'ы материала в этом режиме не читаются, но следующему BindMaterial
+    // придётся выставить их заново
+    m_MaterialValid = false;
+    if (m_PoolSet == (int64_t)poolSet) {
+        m_Counters.bindsSkipped++;
+        return;
+    }
+    table.BindPoolSet(poolSet);
+    m_PoolSet = poolSet;
+    m_Counters.bindsIssued++;
+}
+
+void RenderStateCache::BindMesh(const Mesh* mesh) {
+    if (m_Mesh == mesh) {
+        m_Counters.bindsSkipped++;
+        return;
+    }
+    mesh->Bind();
+    m_Mesh = mesh;
+    m_Counters.bindsIssued++;
+}
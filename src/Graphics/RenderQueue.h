@@ -0,0 +1,92 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <GL/glew.h>
+
+class Mesh;
+class Material;
+class Shader;
+class MaterialTable;
+
+// Проходы в порядке исполнения (старшие биты ключа)
+enum RenderPass {
+    RP_SHADOW = 0,
+    RP_OPAQUE = 1
+};
+
+// 64-битный ключ сортировки, от старших битов к младшим:
+//   [63..62] проход | [61..56] шейдер | [55..44] набор текстур | [43..32] материал |
+//   [31..20] меш | [19] receiveShadows | [18..0] глубина (front-to-back)
+// Идентификаторы плотные и назначаются на кадр; при переполнении поля они
+// насыщаются — порядок становится менее удачным, но исполнитель сравнивает
+// реальные указатели, поэтому результат остаётся верным.
+namespace RenderKey {
+    const uint32_t kShaderBits = 6;
+    const uint32_t kTextureBits = 12;
+    const uint32_t kMaterialBits = 12;
+    const uint32_t kMeshBits = 12;
+    const uint32_t kDepthBits = 19;
+
+    uint64_t Make(RenderPass pass, uint32_t shader, uint32_t textures, uint32_t material,
+                  uint32_t mesh, bool receiveShadows, float depth);
+    // Неотрицательный float -> монотонное целое (старшие биты экспоненты и мантиссы)
+    uint32_t QuantizeDepth(float depth);
+}
+
+struct RenderItem {
+    uint64_t key;
+    uint32_t index;     // индекс в массиве вызывающего
+};
+
+// Очередь отрисовки: заполняется каждый кадр, сортируется LSD radix sort'ом
+// по байтам ключа (байты, одинаковые у всех элементов, пропускаются)
+class RenderQueue {
+public:
+    void Clear() { m_Items.clear(); }
+    void Reserve(size_t count) { m_Items.reserve(count); m_Scratch.reserve(count); }
+    void Push(uint64_t key, uint32_t index) { m_Items.push_back({ key, index }); }
+    void Sort();
+
+    const std::vector<RenderItem>& GetItems() const { return m_Items; }
+    size_t Size() const { return m_Items.size(); }
+    bool Empty() const { return m_Items.empty(); }
+
+private:
+    std::vector<RenderItem> m_Items;
+    std::vector<RenderItem> m_Scratch;
+};
+
+// Кэш состояния GL для исполнителя очереди: пропускает повторную привязку
+// материала, текстур и VAO, если они уже активны
+class RenderStateCache {
+public:
+    struct Counters {
+        int bindsIssued = 0;    // реальные вызовы (материал, текстура, VAO)
+        int bindsSkipped = 0;   // отброшенные как избыточные
+    };
+
+    // Начало прохода: состояние считается неизвестным
+    void Begin();
+    // Конец прохода: сбрасывает привязанные текстуры и VAO в 0
+    void End();
+
+    // Параметры материала (uniform'ы) + его текстуры; nullptr — значения по умолчанию
+    void BindMaterial(Shader& shader, const Material* material);
+    // Режим текстурных массивов: параметры берутся из таблицы, привязываются только пулы
+    void BindPoolSet(const MaterialTable& table, uint32_t poolSet);
+    void BindMesh(const Mesh* mesh);
+
+    const Counters& GetCounters() const { return m_Counters; }
+    void ResetCounters() { m_Counters = Counters(); }
+
+private:
+    static const int kTextureSlots = 5;
+    void BindTexture(int slot, GLuint texture);
+
+    const Material* m_Material = nullptr;
+    bool m_MaterialValid = false;
+    int64_t m_PoolSet = -1;
+    const Mesh* m_Mesh = nullptr;
+    GLuint m_Textures[kTextureSlots] = {};
+    Counters m_Counters;
+};
@@ -1,8 +1,33 @@
 #include "Graphics/Shader.h"
+#include "Graphics/UniformBuffer.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
 
+namespace {
+    // Таблица интернированных имён uniform (общая для всех шейдеров)
+    std::vector<std::string>& InternedNames() {
+        static std::vector<std::string> names;
+        return names;
+    }
+    std::unordered_map<std::string, int>& InternTable() {
+        static std::unordered_map<std::string, int> table;
+        return table;
+    }
+}
+
+Shader::UniformID Shader::Uniform(const std::string& name) {
+    auto& table = InternTable();
+    auto it = table.find(name);
+    if (it == table.end()) {
+        it = table.emplace(name, (int)InternedNames().size()).first;
+        InternedNames().push_back(name);
+    }
+    UniformID id;
+    id.index = it->second;
+    return id;
+}
+
 Shader::~Shader() {
     if (m_ID != 0)
         glDeleteProgram(m_ID);
@@ -49,6 +74,7 @@ bool Shader::Load(const std::string& vertexPath, const std::string& fragmentPath
     glCompileShader(fragment);
     CheckCompileErrors(fragment, "FRAGMENT");
 
+    if (m_ID != 0) glDeleteProgram(m_ID);
     m_ID = glCreateProgram();
     glAttachShader(m_ID, vertex);
     glAttachShader(m_ID, fragment);
@@ -58,6 +84,9 @@ bool Shader::Load(const std::string& vertexPath, const std::string& fragmentPath
     glDeleteShader(vertex);
     glDeleteShader(fragment);
 
+    BindUniformBlocks();
+    ReflectUniforms();
+
     std::cout << "Shader loaded successfully: " << vertexPath << ", " << fragmentPath << std::endl;
     return true;
 }
@@ -66,28 +95,116 @@ void Shader::Use() const {
     glUseProgram(m_ID);
 }
 
+void Shader::BindUniformBlocks() {
+    // Блоки, которых нет в программе, просто пропускаются
+    struct BlockBinding { const char* name; GLuint binding; };
+    const BlockBinding blocks[] = {
+        { "FrameConstants", UBO_FRAME_CONSTANTS },
+        { "Lights", UBO_LIGHTS },
+    };
+    for (const auto& block : blocks) {
+        GLuint index = glGetUniformBlockIndex(m_ID, block.name);
+        if (index != GL_INVALID_INDEX) {
+            glUniformBlockBinding(m_ID, index, block.binding);
+        }
+    }
+}
+
+void Shader::ReflectUniforms() {
+    m_Uniforms.clear();
+    m_Locations.clear();
+
+    GLint count = 0, maxLength = 0;
+    glGetProgramiv(m_ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(m_ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    std::vector<GLchar> nameBuffer((size_t)maxLength + 1);
+
+    for (GLint i = 0; i < count; ++i) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(m_ID, (GLuint)i, (GLsizei)nameBuffer.size(), &length, &size, &type, nameBuffer.data());
+        std::string name(nameBuffer.data(), length);
+        GLint location = glGetUniformLocation(m_ID, name.c_str());
+        if (location < 0) continue;  // uniform из блока
+
+        m_Uniforms[name] = location;
+        // Массивы приходят как "arr[0]": регистрируем и "arr", и все элементы
+        size_t bracket = name.rfind("[0]");
+        if (bracket != std::string::npos && bracket + 3 == name.size()) {
+            std::string base = name.substr(0, bracket);
+            m_Uniforms[base] = location;
+            for (GLint e = 1; e < size; ++e) {
+                std::string element = base + "[" + std::to_string(e) + "]";
+                m_Uniforms[element] = glGetUniformLocation(m_ID, element.c_str());
+            }
+        }
+    }
+}
+
+GLint Shader::GetLocation(const std::string& name) const {
+    auto it = m_Uniforms.find(name);
+    return it != m_Uniforms.end() ? it->second : -1;
+}
+
+GLint Shader::GetLocation(UniformID id) const {
+    if (id.index < 0) return -1;
+    if ((size_t)id.index >= m_Locations.size()) {
+        m_Locations.resize(InternedNames().size(), kUnresolved);
+    }
+    GLint& location = m_Locations[id.index];
+    if (location == kUnresolved) {
+        location = GetLocation(InternedNames()[id.index]);
+    }
+    return location;
+}
+
 void Shader::SetBool(const std::string& name, bool value) const {
-    glUniform1i(glGetUniformLocation(m_ID, name.c_str()), (int)value);
+    glUniform1i(GetLocation(name), (int)value);
 }
 
 void Shader::SetInt(const std::string& name, int value) const {
-    glUniform1i(glGetUniformLocation(m_ID, name.c_str()), value);
+    glUniform1i(GetLocation(name), value);
 }
 
 void Shader::SetFloat(const std::string& name, float value) const {
-    glUniform1f(glGetUniformLocation(m_ID, name.c_str()), value);
+    glUniform1f(GetLocation(name), value);
 }
 
 void Shader::SetVec2(const std::string& name, float x, float y) const {   // <-- реализация
-    glUniform2f(glGetUniformLocation(m_ID, name.c_str()), x, y);
+    glUniform2f(GetLocation(name), x, y);
 }
 
 void Shader::SetVec3(const std::string& name, float x, float y, float z) const {
-    glUniform3f(glGetUniformLocation(m_ID, name.c_str()), x, y, z);
+    glUniform3f(GetLocation(name), x, y, z);
 }
 
 void Shader::SetMat4(const std::string& name, const float* matrix) const {
-    glUniformMatrix4fv(glGetUniformLocation(m_ID, name.c_str()), 1, GL_FALSE, matrix);
+    glUniformMatrix4fv(GetLocation(name), 1, GL_FALSE, matrix);
+}
+
+void Shader::SetBool(UniformID id, bool value) const {
+    glUniform1i(GetLocation(id), (int)value);
+}
+
+void Shader::SetInt(UniformID id, int value) const {
+    glUniform1i(GetLocation(id), value);
+}
+
+void Shader::SetFloat(UniformID id, float value) const {
+    glUniform1f(GetLocation(id), value);
+}
+
+void Shader::SetVec2(UniformID id, float x, float y) const {
+    glUniform2f(GetLocation(id), x, y);
+}
+
+void Shader::SetVec3(UniformID id, float x, float y, float z) const {
+    glUniform3f(GetLocation(id), x, y, z);
+}
+
+void Shader::SetMat4(UniformID id, const float* matrix) const {
+    glUniformMatrix4fv(GetLocation(id), 1, GL_FALSE, matrix);
 }
 
 void Shader::CheckCompileErrors(GLuint shader, const std::string& type) {
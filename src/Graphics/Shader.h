@@ -1,14 +1,28 @@
 #pragma once
 #include <string>
+#include <vector>
+#include <unordered_map>
 #include <GL/glew.h>
 
 class Shader {
 public:
+    // Интернированное имя uniform: глобальный индекс, общий для всех шейдеров.
+    // Получается один раз (обычно в static), дальше Set* работают без строк.
+    struct UniformID {
+        int index = -1;
+    };
+    static UniformID Uniform(const std::string& name);
+
     Shader() = default;
     ~Shader();
 
     bool Load(const std::string& vertexPath, const std::string& fragmentPath);
     void Use() const;
+    GLuint GetID() const { return m_ID; }
+
+    // Локация из кеша (-1, если uniform не активен в программе)
+    GLint GetLocation(const std::string& name) const;
+    GLint GetLocation(UniformID id) const;
 
     // Uniform setters
     void SetBool(const std::string& name, bool value) const;
@@ -18,7 +32,23 @@ public:
     void SetVec3(const std::string& name, float x, float y, float z) const;
     void SetMat4(const std::string& name, const float* matrix) const;
 
+    // Те же setters по интернированному имени
+    void SetBool(UniformID id, bool value) const;
+    void SetInt(UniformID id, int value) const;
+    void SetFloat(UniformID id, float value) const;
+    void SetVec2(UniformID id, float x, float y) const;
+    void SetVec3(UniformID id, float x, float y, float z) const;
+    void SetMat4(UniformID id, const float* matrix) const;
+
 private:
     GLuint m_ID = 0;
+    // Все активные uniform после линковки (имя -> локация)
+    std::unordered_map<std::string, GLint> m_Uniforms;
+    // Кеш локаций по UniformID::index (kUnresolved — ещё не искали)
+    mutable std::vector<GLint> m_Locations;
+    static constexpr GLint kUnresolved = -2;
+
+    void BindUniformBlocks();
+    void ReflectUniforms();
     void CheckCompileErrors(GLuint shader, const std::string& type);
 };
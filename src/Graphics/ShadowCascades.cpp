@@ -0,0 +1,134 @@
+#include "Graphics/ShadowCascades.h"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <glm/gtc/matrix_transform.hpp>
+
+ShadowCascades::~ShadowCascades() {
+    Release();
+}
+
+void ShadowCascades::Release() {
+    if (m_FBO) glDeleteFramebuffers(1, &m_FBO);
+    if (m_Texture) glDeleteTextures(1, &m_Texture);
+    m_FBO = 0;
+    m_Texture = 0;
+}
+
+bool ShadowCascades::Initialize(int size, int cascadeCount) {
+    Release();
+    m_Size = size;
+    m_CascadeCount = (std::max)(1, (std::min)(cascadeCount, (int)kMaxCascades));
+
+    glGenTextures(1, &m_Texture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, m_Texture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT32F, m_Size, m_Size, m_CascadeCount,
+                 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    float borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, borderColor);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    glGenFramebuffers(1, &m_FBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_Texture, 0, 0);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (!complete) {
+        std::cerr << "[Shadows] Cascade framebuffer not complete!" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool ShadowCascades::Resize(int size, int cascadeCount) {
+    if (size == m_Size && cascadeCount == m_CascadeCount) return true;
+    return Initialize(size, cascadeCount);
+}
+
+void ShadowCascades::Update(const glm::mat4& view, float fovYRadians, float aspect, float zNear, float zFar,
+                            const glm::vec3& lightDirection, const AABB& sceneBounds) {
+    // Границы срезов: смесь логарифмического и равномерного разбиения
+    float splitNear[kMaxCascades];
+    float prev = zNear;
+    for (int i = 0; i < m_CascadeCount; ++i) {
+        float p = (float)(i + 1) / m_CascadeCount;
+        float logSplit = zNear * std::pow(zFar / zNear, p);
+        float uniformSplit = zNear + (zFar - zNear) * p;
+        splitNear[i] = prev;
+        m_Splits[i] = splitLambda * logSplit + (1.0f - splitLambda) * uniformSplit;
+        prev = m_Splits[i];
+    }
+
+    // Вид света с началом в нуле — снэп к текселям не зависит от позиции камеры
+    glm::vec3 dir = glm::normalize(lightDirection);
+    glm::vec3 up = std::fabs(dir.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+    glm::mat4 lightView = glm::lookAt(glm::vec3(0.0f), dir, up);
+
+    // Ближайшая к свету точка сцены — до неё тянется ближняя плоскость
+    float sceneMaxZ = -1e30f;
+    for (int c = 0; c < 8; ++c) {
+        glm::vec3 corner((c & 1) ? sceneBounds.max.x : sceneBounds.min.x,
+                         (c & 2) ? sceneBounds.max.y : sceneBounds.min.y,
+                         (c & 4) ? sceneBounds.max.z : sceneBounds.min.z);
+        float z = (lightView * glm::vec4(corner, 1.0f)).z;
+        sceneMaxZ = (std::max)(sceneMaxZ, z);
+    }
+
+    glm::mat4 invView = glm::inverse(view);
+    float tanY = std::tan(fovYRadians * 0.5f);
+    float tanX = tanY * aspect;
+
+    for (int i = 0; i < m_CascadeCount; ++i) {
+        // Углы среза в мировых координатах
+        glm::vec3 corners[8];
+        float depths[2] = { splitNear[i], m_Splits[i] };
+        for (int d = 0; d < 2; ++d) {
+            float z = depths[d];
+            corners[d * 4 + 0] = glm::vec3(invView * glm::vec4(-tanX * z, -tanY * z, -z, 1.0f));
+            corners[d * 4 + 1] = glm::vec3(invView * glm::vec4( tanX * z, -tanY * z, -z, 1.0f));
+            corners[d * 4 + 2] = glm::vec3(invView * glm::vec4(-tanX * z,  tanY * z, -z, 1.0f));
+            corners[d * 4 + 3] = glm::vec3(invView * glm::vec4( tanX * z,  tanY * z, -z, 1.0f));
+        }
+
+        // Ограничивающая сфера среза: размер не меняется при повороте камеры
+        glm::vec3 center(0.0f);
+        for (const auto& c : corners) center += c;
+        center /= 8.0f;
+        float radius = 0.0f;
+        for (const auto& c : corners) radius = (std::max)(radius, glm::length(c - center));
+        radius = std::ceil(radius * 16.0f) / 16.0f;
+
+        // Снэп центра к сетке текселей в пространстве света
+        glm::vec3 lightCenter = glm::vec3(lightView * glm::vec4(center, 1.0f));
+        float texelSize = 2.0f * radius / m_Size;
+        lightCenter.x = std::floor(lightCenter.x / texelSize) * texelSize;
+        lightCenter.y = std::floor(lightCenter.y / texelSize) * texelSize;
+
+        // Вид смотрит вдоль -Z: ближе к свету — большие z. Ближняя плоскость
+        // тянется до края сцены, дальняя — только до конца среза
+        float zMax = (std::max)(lightCenter.z + radius, sceneMaxZ);
+        float zMin = lightCenter.z - radius;
+        glm::mat4 lightProjection = glm::ortho(lightCenter.x - radius, lightCenter.x + radius,
+                                               lightCenter.y - radius, lightCenter.y + radius,
+                                               -zMax, -zMin);
+        m_Matrices[i] = lightProjection * lightView;
+    }
+}
+
+void ShadowCascades::BeginCascade(int cascade) const {
+    glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_Texture, 0, cascade);
+    glViewport(0, 0, m_Size, m_Size);
+    glClear(GL_DEPTH_BUFFER_BIT);
+}
+
+void ShadowCascades::BindTexture(int unit) const {
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, m_Texture);
+}
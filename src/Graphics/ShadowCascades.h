@@ -0,0 +1,48 @@
+#pragma once
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "Graphics/Bounds.h"
+
+// Каскадные карты теней для направленного света.
+// Пирамида камеры делится на срезы (смесь логарифмического и равномерного
+// разбиения), каждый срез покрывается своей ортографической проекцией.
+// Все каскады лежат в одном GL_TEXTURE_2D_ARRAY.
+class ShadowCascades {
+public:
+    static const int kMaxCascades = 4;
+
+    ShadowCascades() = default;
+    ~ShadowCascades();
+
+    bool Initialize(int size, int cascadeCount);
+    // Пересоздаёт текстуру при смене размера или числа каскадов
+    bool Resize(int size, int cascadeCount);
+
+    // sceneBounds — границы всех объектов: ближняя плоскость каскада
+    // отодвигается к свету, чтобы тени отбрасывали объекты вне среза
+    void Update(const glm::mat4& view, float fovYRadians, float aspect, float zNear, float zFar,
+                const glm::vec3& lightDirection, const AABB& sceneBounds);
+
+    // Привязывает FBO к слою каскада и выставляет viewport
+    void BeginCascade(int cascade) const;
+    void BindTexture(int unit) const;
+
+    int GetCascadeCount() const { return m_CascadeCount; }
+    int GetSize() const { return m_Size; }
+    const glm::mat4& GetMatrix(int cascade) const { return m_Matrices[cascade]; }
+    // Дальняя граница каскада в глубине вида
+    float GetSplit(int cascade) const { return m_Splits[cascade]; }
+
+    // Доля логарифмического разбиения (0 — равномерное, 1 — логарифмическое)
+    float splitLambda = 0.75f;
+
+private:
+    void Release();
+
+    GLuint m_FBO = 0;
+    GLuint m_Texture = 0;
+    int m_Size = 0;
+    int m_CascadeCount = 0;
+    glm::mat4 m_Matrices[kMaxCascades];
+    float m_Splits[kMaxCascades] = {};
+};
@@ -0,0 +1,288 @@
+#include "Graphics/TangentGenerator.h"
+#include "Core/Parallel.h"
+#include <vector>
+#include <cmath>
+#include <cfloat>
+#include <cstdint>
+#include <memory>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define BINAX_SSE 1
+#include <xmmintrin.h>
+#endif
+
+namespace {
+    const size_t kTrianglesPerJob = 8192;
+    const size_t kVerticesPerJob = 16384;
+
+    // Вклад угла треугольника в вершину: xyz — касательная треугольника в плоскости
+    // нормали вершины, умноженная на угол при вершине; w — угол со знаком развёртки,
+    // 0 — у треугольника нет касательной (вырожденная развёртка)
+    struct CornerTangent {
+        float x, y, z, w;
+    };
+
+    // Ядро ниже написано один раз для float (сборка без SSE) и для 4 float в регистре SSE
+    inline float Sqrt(float a) { return std::sqrt(a); }
+    inline float Abs(float a) { return std::fabs(a); }
+    inline float Min(float a, float b) { return a < b ? a : b; }
+    inline float Max(float a, float b) { return a > b ? a : b; }
+    // 1, если a > b, иначе 0 — маска для умножения
+    inline float Step(float a, float b) { return a > b ? 1.0f : 0.0f; }
+    inline float InverseSqrt(float a) { return 1.0f / std::sqrt(a); }
+
+#ifdef BINAX_SSE
+    struct Float4 {
+        __m128 m;
+        Float4() {}
+        Float4(__m128 v) : m(v) {}
+        Float4(float s) : m(_mm_set1_ps(s)) {}
+    };
+    inline Float4 operator+(Float4 a, Float4 b) { return _mm_add_ps(a.m, b.m); }
+    inline Float4 operator-(Float4 a, Float4 b) { return _mm_sub_ps(a.m, b.m); }
+    inline Float4 operator*(Float4 a, Float4 b) { return _mm_mul_ps(a.m, b.m); }
+    inline Float4 Sqrt(Float4 a) { return _mm_sqrt_ps(a.m); }
+    inline Float4 Abs(Float4 a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.m); }
+    inline Float4 Min(Float4 a, Float4 b) { return _mm_min_ps(a.m, b.m); }
+    inline Float4 Max(Float4 a, Float4 b) { return _mm_max_ps(a.m, b.m); }
+    inline Float4 Step(Float4 a, Float4 b) { return _mm_and_ps(_mm_cmpgt_ps(a.m, b.m), _mm_set1_ps(1.0f)); }
+    // rsqrt с одним шагом Ньютона: точность ~1e-7, в разы быстрее sqrt и деления
+    inline Float4 InverseSqrt(Float4 a) {
+        __m128 r = _mm_rsqrt_ps(a.m);
+        __m128 rr = _mm_mul_ps(_mm_mul_ps(a.m, r), r);
+        return _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), r), _mm_sub_ps(_mm_set1_ps(3.0f), rr));
+    }
+#endif
+
+    template <typename F>
+    struct Vec3T {
+        F x, y, z;
+    };
+    template <typename F>
+    inline Vec3T<F> operator-(const Vec3T<F>& a, const Vec3T<F>& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+    template <typename F>
+    inline Vec3T<F> operator*(const Vec3T<F>& a, F s) { return { a.x * s, a.y * s, a.z * s }; }
+    template <typename F>
+    inline F Dot(const Vec3T<F>& a, const Vec3T<F>& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+    // 1/sqrt(length2) или 1 для нулевой длины: нулевой вектор так и остаётся нулевым, как в MikkTSpace
+    template <typename F>
+    inline F InverseLength(F length2) {
+        F mask = Step(length2, F(FLT_MIN));
+        return mask * InverseSqrt(Max(length2, F(FLT_MIN))) + (F(1.0f) - mask);
+    }
+
+    // acos по Абрамовицу-Стигану (4.4.46), погрешность 2e-8: в SSE нет acos
+    template <typename F>
+    inline F Acos(F x) {
+        F a = Abs(x);
+        F poly = F(-0.0012624911f);
+        poly = poly * a + F(0.0066700901f);
+        poly = poly * a + F(-0.0170881256f);
+        poly = poly * a + F(0.0308918810f);
+        poly = poly * a + F(-0.0501743046f);
+        poly = poly * a + F(0.0889789874f);
+        poly = poly * a + F(-0.2145988016f);
+        poly = poly * a + F(1.5707963050f);
+        F r = Sqrt(Max(F(1.0f) - a, F(0.0f))) * poly;
+        F negative = Step(F(0.0f), x);
+        return r + negative * (F(3.14159265f) - r - r);
+    }
+
+    // Вклады трёх углов треугольника. Касательная треугольника — направление
+    // роста u (формулы 18-19 MikkTSpace); у зеркальной развёртки она домножена
+    // на -1, чтобы смотреть туда же, куда у соседей с прямой. Проекции на
+    // плоскость нормали не строятся: для v' = v - n(n·v) при |n| = 1
+    // |v'|² = |v|² - (n·v)², a'·b' = a·b - (n·a)(n·b)
+    template <typename F>
+    void TriangleCorners(const Vec3T<F> p[3], const Vec3T<F> n[3], const F u[3], const F v[3],
+                         Vec3T<F> tangent[3], F weight[3]) {
+        Vec3T<F> d1 = p[1] - p[0];
+        Vec3T<F> d2 = p[2] - p[0];
+        F t21x = u[1] - u[0], t21y = v[1] - v[0];
+        F t31x = u[2] - u[0], t31y = v[2] - v[0];
+        F area = t21x * t31y - t21y * t31x;
+        F orientation = Step(area, F(0.0f)) * F(2.0f) - F(1.0f);
+        Vec3T<F> os = (d1 * t31y - d2 * t21y) * orientation;
+        F osLength2 = Dot(os, os);
+        F valid = Step(Abs(area), F(FLT_MIN)) * Step(osLength2, F(FLT_MIN));
+
+        // Ребро k идёт из угла k в угол k + 1
+        Vec3T<F> edges[3] = { d1, p[2] - p[1], p[0] - p[2] };
+        F edgeLength2[3] = { Dot(edges[0], edges[0]), Dot(edges[1], edges[1]), Dot(edges[2], edges[2]) };
+        for (int k = 0; k < 3; ++k) {
+            // Угол между рёбрами к соседям: toNext и -fromPrev
+            const Vec3T<F>& toNext = edges[k];
+            const Vec3T<F>& fromPrev = edges[(k + 2) % 3];
+            F nNext = Dot(n[k], toNext), nPrev = Dot(n[k], fromPrev);
+            F nextLength2 = Max(edgeLength2[k] - nNext * nNext, F(0.0f));
+            F prevLength2 = Max(edgeLength2[(k + 2) % 3] - nPrev * nPrev, F(0.0f));
+            F dot = nNext * nPrev - Dot(toNext, fromPrev);
+            F cosine = dot * InverseLength(nextLength2) * InverseLength(prevLength2);
+            cosine = Min(Max(cosine, F(-1.0f)), F(1.0f));
+            F angle = Acos(cosine) * valid;
+
+            F nOs = Dot(n[k], os);
+            F scale = angle * InverseLength(Max(osLength2 - nOs * nOs, F(0.0f)));
+            tangent[k] = (os - n[k] * nOs) * scale;
+            weight[k] = angle * orientation;
+        }
+    }
+
+#ifdef BINAX_SSE
+    static_assert(offsetof(Vertex, Normal) == 12 && offsetof(Vertex, TexCoords) == 24,
+                  "ComputeBatch reads Vertex as two 16-byte rows");
+
+    // Четыре треугольника: дорожка i — треугольник triangles[i]. Каждая вершина
+    // читается двумя строками {pos, n.x} и {n.y, n.z, uv} и транспонируется
+    void ComputeBatch(const Vertex* vertices, const unsigned int* const triangles[4], CornerTangent* const out[4]) {
+        Vec3T<Float4> p[3], n[3], tangent[3];
+        Float4 u[3], v[3], weight[3];
+        for (int k = 0; k < 3; ++k) {
+            __m128 a[4], b[4];
+            for (int i = 0; i < 4; ++i) {
+                const float* vertex = vertices[triangles[i][k]].Position;
+                a[i] = _mm_loadu_ps(vertex);
+                b[i] = _mm_loadu_ps(vertex + 4);
+            }
+            _MM_TRANSPOSE4_PS(a[0], a[1], a[2], a[3]);
+            _MM_TRANSPOSE4_PS(b[0], b[1], b[2], b[3]);
+            p[k] = { a[0], a[1], a[2] };
+            n[k] = { a[3], b[0], b[1] };
+            u[k] = b[2];
+            v[k] = b[3];
+        }
+        TriangleCorners(p, n, u, v, tangent, weight);
+        for (int k = 0; k < 3; ++k) {
+            // Из «по компонентам» в «по углам»
+            __m128 x = tangent[k].x.m, y = tangent[k].y.m, z = tangent[k].z.m, w = weight[k].m;
+            _MM_TRANSPOSE4_PS(x, y, z, w);
+            _mm_storeu_ps(&out[0][k].x, x);
+            _mm_storeu_ps(&out[1][k].x, y);
+            _mm_storeu_ps(&out[2][k].x, z);
+            _mm_storeu_ps(&out[3][k].x, w);
+        }
+    }
+
+    // count треугольников подряд: пачками по 4, неполная пачка добивается
+    // повтором последнего треугольника — хвост считается той же пачкой
+    void ComputeCorners(const Vertex* vertices, const unsigned int* indices, size_t count, CornerTangent* corners) {
+        CornerTangent scratch[3];
+        for (size_t t = 0; t < count; t += 4) {
+            const unsigned int* triangles[4];
+            CornerTangent* out[4];
+            for (size_t i = 0; i < 4; ++i) {
+                bool inside = t + i < count;
+                size_t triangle = inside ? t + i : count - 1;
+                triangles[i] = indices + triangle * 3;
+                out[i] = inside ? corners + triangle * 3 : scratch;
+            }
+            ComputeBatch(vertices, triangles, out);
+        }
+    }
+#else
+    void ComputeCorners(const Vertex* vertices, const unsigned int* indices, size_t count, CornerTangent* corners) {
+        for (size_t t = 0; t < count; ++t) {
+            Vec3T<float> p[3], n[3], tangent[3];
+            float u[3], v[3], weight[3];
+            for (int k = 0; k < 3; ++k) {
+                const Vertex& vertex = vertices[indices[t * 3 + k]];
+                p[k] = { vertex.Position[0], vertex.Position[1], vertex.Position[2] };
+                n[k] = { vertex.Normal[0], vertex.Normal[1], vertex.Normal[2] };
+                u[k] = vertex.TexCoords[0];
+                v[k] = vertex.TexCoords[1];
+            }
+            TriangleCorners(p, n, u, v, tangent, weight);
+            for (int k = 0; k < 3; ++k) corners[t * 3 + k] = { tangent[k].x, tangent[k].y, tangent[k].z, weight[k] };
+        }
+    }
+#endif
+
+    // Сумма вкладов вершины отдельно по прямой [0] и зеркальной [1] развёртке
+    struct TangentSum {
+        glm::vec3 tangent[2] = { glm::vec3(0.0f), glm::vec3(0.0f) };
+        float angle[2] = { 0.0f, 0.0f };
+
+        void Add(const CornerTangent& corner) {
+            if (corner.w == 0.0f) return;
+            int group = corner.w > 0.0f ? 0 : 1;
+            tangent[group] += glm::vec3(corner.x, corner.y, corner.z);
+            angle[group] += std::fabs(corner.w);
+        }
+    };
+
+    // Любая касательная поперёк нормали — для вершин, где развёртка её не задаёт
+    glm::vec3 AnyTangent(const glm::vec3& n) {
+        glm::vec3 axis = std::fabs(n.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+        glm::vec3 t = axis - n * glm::dot(n, axis);
+        float length = glm::length(t);
+        return length > 0.0f ? t / length : glm::vec3(1.0f, 0.0f, 0.0f);
+    }
+
+    // Прямая и зеркальная развёртки в одной вершине дают разные касательные;
+    // MikkTSpace разделил бы такую вершину, здесь буфер уже готов — побеждает
+    // группа с большим суммарным углом
+    void StoreTangent(Vertex& vertex, const TangentSum& sum) {
+        int group = sum.angle[1] > sum.angle[0] ? 1 : 0;
+        glm::vec3 n(vertex.Normal[0], vertex.Normal[1], vertex.Normal[2]);
+        float length = glm::length(sum.tangent[group]);
+        glm::vec3 tangent = length > 0.0f ? sum.tangent[group] / length : AnyTangent(n);
+        vertex.Tangent[0] = tangent.x;
+        vertex.Tangent[1] = tangent.y;
+        vertex.Tangent[2] = tangent.z;
+        vertex.TangentSign = (length > 0.0f && group == 1) ? -1.0f : 1.0f;
+    }
+}
+
+void TangentGenerator::Generate(Vertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount,
+                                unsigned maxThreads) {
+    const size_t triangleCount = indexCount / 3;
+    const size_t cornerCount = triangleCount * 3;
+    const size_t triangleJobs = (triangleCount + kTrianglesPerJob - 1) / kTrianglesPerJob;
+    if (triangleCount < kParallelTriangles || std::thread::hardware_concurrency() <= 1) maxThreads = 1;
+
+    // Вклады каждой вершины складываются по возрастанию номера угла — в одном
+    // порядке на любом числе потоков, результат совпадает побитово.
+    // Один поток: вклады блока сразу прибавляются к суммам вершин
+    if (maxThreads == 1) {
+        std::vector<TangentSum> sums(vertexCount);
+        std::unique_ptr<CornerTangent[]> block(new CornerTangent[kTrianglesPerJob * 3]);
+        for (size_t job = 0; job < triangleJobs; ++job) {
+            size_t first = job * kTrianglesPerJob;
+            size_t count = (std::min)(kTrianglesPerJob, triangleCount - first);
+            const unsigned int* blockIndices = indices + first * 3;
+            ComputeCorners(vertices, blockIndices, count, block.get());
+            for (size_t c = 0; c < count * 3; ++c) sums[blockIndices[c]].Add(block[c]);
+        }
+        for (size_t v = 0; v < vertexCount; ++v) StoreTangent(vertices[v], sums[v]);
+        return;
+    }
+
+    // Несколько потоков: вклады всех углов параллельно, затем каждая вершина
+    // собирает свои углы по списку «вершина -> углы»
+    std::unique_ptr<CornerTangent[]> corners(new CornerTangent[cornerCount]);
+    ParallelFor(triangleJobs, [&](size_t job) {
+        size_t first = job * kTrianglesPerJob;
+        size_t count = (std::min)(kTrianglesPerJob, triangleCount - first);
+        ComputeCorners(vertices, indices + first * 3, count, corners.get() + first * 3);
+    }, maxThreads);
+
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (size_t c = 0; c < cornerCount; ++c) offsets[indices[c] + 1]++;
+    for (size_t v = 0; v < vertexCount; ++v) offsets[v + 1] += offsets[v];
+    std::unique_ptr<uint32_t[]> vertexCorners(new uint32_t[cornerCount]);
+    {
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t c = 0; c < cornerCount; ++c) vertexCorners[fill[indices[c]]++] = (uint32_t)c;
+    }
+
+    size_t vertexJobs = (vertexCount + kVerticesPerJob - 1) / kVerticesPerJob;
+    ParallelFor(vertexJobs, [&](size_t job) {
+        size_t end = (std::min)((job + 1) * kVerticesPerJob, vertexCount);
+        for (size_t v = job * kVerticesPerJob; v < end; ++v) {
+            TangentSum sum;
+            for (uint32_t i = offsets[v]; i < offsets[v + 1]; ++i) sum.Add(corners[vertexCorners[i]]);
+            StoreTangent(vertices[v], sum);
+        }
+    }, maxThreads);
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <cstddef>
+#include "Graphics/VertexFormat.h"
+
+// Касательные по правилам MikkTSpace — их ждут запекатели карт нормалей.
+// Касательная вершины — сумма касательных треугольников вокруг неё, спроецированных
+// на плоскость нормали и взвешенных углом при вершине; треугольники с зеркальной
+// развёрткой считаются отдельной группой, её знак уходит в TangentSign.
+// Вершины с одинаковыми атрибутами должны быть общими (JoinIdenticalVertices).
+// Треугольники считаются пачками по 4 (SSE), пачки — параллельно; сумма по
+// вершине идёт в порядке углов, поэтому результат не зависит от числа потоков.
+// Без GL — можно звать из потоков импорта
+class TangentGenerator {
+public:
+    // Меньше треугольников — всё в одном потоке
+    static const size_t kParallelTriangles = 16384;
+
+    static void Generate(Vertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount,
+                         unsigned maxThreads = 0);
+};
@@ -0,0 +1,154 @@
+#include "Graphics/TextureCache.h"
+#include "Core/Hash.h"
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+#include <cstdio>
+#include <system_error>
+#include <algorithm>
+
+namespace {
+    const uint32_t kVersion = 1;
+    const uint32_t kDdsMagic = 0x20534444;      // "DDS "
+    const uint32_t kFourCCDX10 = 0x30315844;    // "DX10"
+    const uint32_t kCacheTag = 0x43545842;      // "BXTC" — наш файл кэша
+
+    // Поля DDS_HEADER
+    const uint32_t DDSD_CAPS = 0x1, DDSD_HEIGHT = 0x2, DDSD_WIDTH = 0x4, DDSD_PIXELFORMAT = 0x1000;
+    const uint32_t DDSD_MIPMAPCOUNT = 0x20000, DDSD_LINEARSIZE = 0x80000;
+    const uint32_t DDPF_FOURCC = 0x4;
+    const uint32_t DDSCAPS_COMPLEX = 0x8, DDSCAPS_TEXTURE = 0x1000, DDSCAPS_MIPMAP = 0x400000;
+    const uint32_t kDimensionTexture2D = 3;
+
+    struct DdsHeader {
+        uint32_t magic = kDdsMagic;
+        uint32_t size = 124;
+        uint32_t flags = 0;
+        uint32_t height = 0;
+        uint32_t width = 0;
+        uint32_t linearSize = 0;
+        uint32_t depth = 0;
+        uint32_t mipMapCount = 0;
+        // reserved1: тег кэша, версия, ключ (2 слова), каналы исходника
+        uint32_t reserved1[11] = {};
+        uint32_t formatSize = 32;
+        uint32_t formatFlags = DDPF_FOURCC;
+        uint32_t fourCC = kFourCCDX10;
+        uint32_t rgbBitCount = 0;
+        uint32_t bitMasks[4] = {};
+        uint32_t caps = 0;
+        uint32_t caps2 = 0;
+        uint32_t caps3 = 0;
+        uint32_t caps4 = 0;
+        uint32_t reserved2 = 0;
+        // DDS_HEADER_DXT10
+        uint32_t dxgiFormat = 0;
+        uint32_t resourceDimension = kDimensionTexture2D;
+        uint32_t miscFlag = 0;
+        uint32_t arraySize = 1;
+        uint32_t miscFlags2 = 0;
+    };
+
+    static_assert(sizeof(DdsHeader) == 148, "DDS header layout changed");
+
+    // DXGI_FORMAT_BC1_UNORM, BC3_UNORM, BC4_UNORM, BC5_UNORM — по порядку BlockFormat
+    const uint32_t kDxgiFormats[4] = { 71, 77, 80, 83 };
+
+    bool FormatFromDxgi(uint32_t dxgiFormat, BlockFormat& format) {
+        for (int i = 0; i < 4; ++i) {
+            if (kDxgiFormats[i] == dxgiFormat) { format = (BlockFormat)i; return true; }
+        }
+        return false;
+    }
+}
+
+const char* TextureCache::kDirectory = "cache/textures";
+
+uint64_t TextureCache::MakeKey(const uint8_t* source, size_t size, uint32_t settings) {
+    return HashBytes(source, size, ((uint64_t)kVersion << 32) | settings);
+}
+
+std::string TextureCache::GetCachePath(uint64_t key) {
+    char name[17];
+    snprintf(name, sizeof(name), "%016llx", (unsigned long long)key);
+    return std::string(kDirectory) + "/" + name + ".dds";
+}
+
+bool TextureCache::Write(const std::string& cachePath, uint64_t key, const CompressedImage& image) {
+    if (!image.IsValid()) return false;
+
+    DdsHeader header;
+    header.flags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_LINEARSIZE;
+    if (image.levels.size() > 1) header.flags |= DDSD_MIPMAPCOUNT;
+    header.width = (uint32_t)image.width;
+    header.height = (uint32_t)image.height;
+    header.linearSize = (uint32_t)image.levels[0].size;
+    header.mipMapCount = (uint32_t)image.levels.size();
+    header.reserved1[0] = kCacheTag;
+    header.reserved1[1] = kVersion;
+    header.reserved1[2] = (uint32_t)key;
+    header.reserved1[3] = (uint32_t)(key >> 32);
+    header.reserved1[4] = (uint32_t)image.sourceChannels;
+    header.caps = DDSCAPS_TEXTURE;
+    if (image.levels.size() > 1) header.caps |= DDSCAPS_COMPLEX | DDSCAPS_MIPMAP;
+    header.dxgiFormat = kDxgiFormats[image.format];
+
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path(), error);
+    // Имя временного файла уникально для потока: одну текстуру могут сжимать двое
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), ".%p.tmp", (const void*)&image);
+    const std::string tempPath = cachePath + suffix;
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file) return false;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(image.GetBlocks()), (std::streamsize)image.GetSize());
+        if (!file) return false;
+    }
+    std::filesystem::rename(tempPath, cachePath, error);
+    if (error) {
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
+
+bool TextureCache::Open(const std::string& cachePath, uint64_t key, CompressedImage& image) {
+    image.Release();
+    if (!image.file.Open(cachePath)) return false;
+    const size_t size = image.file.GetSize();
+    DdsHeader header;
+    if (size < sizeof(header)) { image.file.Close(); return false; }
+    memcpy(&header, image.file.GetData(), sizeof(header));
+
+    BlockFormat format = BLOCK_BC1;
+    bool valid = header.magic == kDdsMagic && header.size == 124 && header.fourCC == kFourCCDX10 &&
+                 header.reserved1[0] == kCacheTag && header.reserved1[1] == kVersion &&
+                 header.reserved1[2] == (uint32_t)key && header.reserved1[3] == (uint32_t)(key >> 32) &&
+                 FormatFromDxgi(header.dxgiFormat, format) && header.width > 0 && header.height > 0 &&
+                 header.width <= 16384 && header.height <= 16384 && header.mipMapCount >= 1 &&
+                 (int)header.mipMapCount <= TextureCompressor::GetLevelCount((int)header.width, (int)header.height);
+    if (!valid) { image.file.Close(); return false; }
+
+    image.format = format;
+    image.width = (int)header.width;
+    image.height = (int)header.height;
+    image.sourceChannels = (int)header.reserved1[4];
+    image.fileOffset = sizeof(header);
+    image.levels.resize(header.mipMapCount);
+    size_t offset = 0;
+    for (size_t level = 0; level < image.levels.size(); ++level) {
+        CompressedImage::Level& info = image.levels[level];
+        info.width = (std::max)(1, image.width >> level);
+        info.height = (std::max)(1, image.height >> level);
+        info.offset = offset;
+        info.size = TextureCompressor::GetLevelBytes(format, info.width, info.height);
+        offset += info.size;
+    }
+    if (offset > size - sizeof(header)) {
+        image.Release();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "Graphics/TextureCompressor.h"
+
+// Кэш сжатых текстур на диске: cache/textures/<ключ>.dds. Ключ — хэш
+// содержимого исходной картинки и параметров сжатия. Файл — обычный DDS
+// (заголовок DX10), его открывают и сторонние просмотрщики; ключ и версия
+// лежат в зарезервированных полях заголовка.
+class TextureCache {
+public:
+    static const char* kDirectory;
+
+    // settings — всё, что влияет на результат (формат, переворот, мипы)
+    static uint64_t MakeKey(const uint8_t* source, size_t size, uint32_t settings);
+    static std::string GetCachePath(uint64_t key);
+
+    // Через временный файл: недописанный кэш никогда не читается
+    static bool Write(const std::string& cachePath, uint64_t key, const CompressedImage& image);
+    // Отображает файл в память; блоки не копируются. false — нет файла или он от другого ключа
+    static bool Open(const std::string& cachePath, uint64_t key, CompressedImage& image);
+};
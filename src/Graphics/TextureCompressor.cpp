@@ -0,0 +1,367 @@
+#include "Graphics/TextureCompressor.h"
+#include "Core/Parallel.h"
+#include <cmath>
+#include <cstring>
+#include <cfloat>
+#include <algorithm>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define BINAX_SSE 1
+#include <xmmintrin.h>
+#endif
+
+namespace {
+    // Строк блоков в одном задании ParallelFor: мелкие уровни идут одним куском
+    const int kBlockRowsPerJob = 4;
+
+    // Пиксели блока по каналам: [канал][пиксель], значения 0..255
+    typedef float BlockChannels[4][16];
+
+    // Ближайший цвет палитры для каждого из 16 пикселей (по channelCount первым
+    // каналам); возвращает суммарную квадратичную ошибку
+    float FindIndices(const float (*channels)[16], int channelCount, const float (*palette)[3], int paletteCount,
+                      uint8_t* indices) {
+        float error = 0.0f;
+#ifdef BINAX_SSE
+        for (int group = 0; group < 16; group += 4) {
+            __m128 values[3];
+            for (int c = 0; c < channelCount; ++c) values[c] = _mm_loadu_ps(channels[c] + group);
+            __m128 best = _mm_set1_ps(FLT_MAX);
+            __m128 bestIndex = _mm_setzero_ps();
+            for (int p = 0; p < paletteCount; ++p) {
+                __m128 dist = _mm_setzero_ps();
+                for (int c = 0; c < channelCount; ++c) {
+                    __m128 d = _mm_sub_ps(values[c], _mm_set1_ps(palette[p][c]));
+                    dist = _mm_add_ps(dist, _mm_mul_ps(d, d));
+                }
+                __m128 closer = _mm_cmplt_ps(dist, best);
+                best = _mm_min_ps(dist, best);
+                bestIndex = _mm_or_ps(_mm_and_ps(closer, _mm_set1_ps((float)p)), _mm_andnot_ps(closer, bestIndex));
+            }
+            float bestOut[4], indexOut[4];
+            _mm_storeu_ps(bestOut, best);
+            _mm_storeu_ps(indexOut, bestIndex);
+            for (int i = 0; i < 4; ++i) {
+                indices[group + i] = (uint8_t)indexOut[i];
+                error += bestOut[i];
+            }
+        }
+#else
+        for (int i = 0; i < 16; ++i) {
+            float best = FLT_MAX;
+            int bestIndex = 0;
+            for (int p = 0; p < paletteCount; ++p) {
+                float dist = 0.0f;
+                for (int c = 0; c < channelCount; ++c) {
+                    float d = channels[c][i] - palette[p][c];
+                    dist += d * d;
+                }
+                if (dist < best) { best = dist; bestIndex = p; }
+            }
+            indices[i] = (uint8_t)bestIndex;
+            error += best;
+        }
+#endif
+        return error;
+    }
+
+    uint16_t Quantize565(const float* color) {
+        int r = (int)std::lround(color[0] * 31.0f / 255.0f);
+        int g = (int)std::lround(color[1] * 63.0f / 255.0f);
+        int b = (int)std::lround(color[2] * 31.0f / 255.0f);
+        return (uint16_t)((r << 11) | (g << 5) | b);
+    }
+
+    void Expand565(uint16_t packed, float* color) {
+        int r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+        color[0] = (float)((r << 3) | (r >> 2));
+        color[1] = (float)((g << 2) | (g >> 4));
+        color[2] = (float)((b << 3) | (b >> 2));
+    }
+
+    // Квантует концы, строит палитру и индексы; c0 > c1 — режим четырёх цветов
+    float TryColorEndpoints(const BlockChannels& px, const float* e0, const float* e1,
+                            uint16_t& c0, uint16_t& c1, uint8_t* indices) {
+        c0 = Quantize565(e0);
+        c1 = Quantize565(e1);
+        if (c0 < c1) std::swap(c0, c1);
+        float palette[4][3];
+        Expand565(c0, palette[0]);
+        Expand565(c1, palette[1]);
+        if (c0 == c1) {
+            // Одинаковые концы дают режим трёх цветов: берём только индекс 0
+            return FindIndices(px, 3, palette, 1, indices);
+        }
+        for (int c = 0; c < 3; ++c) {
+            palette[2][c] = (2.0f * palette[0][c] + palette[1][c]) / 3.0f;
+            palette[3][c] = (palette[0][c] + 2.0f * palette[1][c]) / 3.0f;
+        }
+        return FindIndices(px, 3, palette, 4, indices);
+    }
+
+    void EncodeColorBlock(const BlockChannels& px, uint8_t* out) {
+        float mean[3] = {}, minColor[3], maxColor[3];
+        for (int c = 0; c < 3; ++c) {
+            minColor[c] = maxColor[c] = px[c][0];
+            for (int i = 0; i < 16; ++i) {
+                mean[c] += px[c][i];
+                minColor[c] = (std::min)(minColor[c], px[c][i]);
+                maxColor[c] = (std::max)(maxColor[c], px[c][i]);
+            }
+            mean[c] /= 16.0f;
+        }
+
+        // Ковариация и главная ось (степенной метод от диагонали разброса)
+        float cov[6] = {};
+        for (int i = 0; i < 16; ++i) {
+            float r = px[0][i] - mean[0], g = px[1][i] - mean[1], b = px[2][i] - mean[2];
+            cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+            cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+        }
+        float axis[3] = { maxColor[0] - minColor[0], maxColor[1] - minColor[1], maxColor[2] - minColor[2] };
+        for (int iteration = 0; iteration < 4; ++iteration) {
+            float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+            float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+            float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+            float scale = (std::max)((std::max)(std::fabs(x), std::fabs(y)), std::fabs(z));
+            if (scale <= 0.0f) break;
+            axis[0] = x / scale; axis[1] = y / scale; axis[2] = z / scale;
+        }
+        float axisLength = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+
+        float e0[3], e1[3];
+        if (axisLength < 1e-6f) {
+            // Однотонный блок
+            for (int c = 0; c < 3; ++c) e0[c] = e1[c] = mean[c];
+        } else {
+            float minT = FLT_MAX, maxT = -FLT_MAX;
+            for (int i = 0; i < 16; ++i) {
+                float t = ((px[0][i] - mean[0]) * axis[0] + (px[1][i] - mean[1]) * axis[1] +
+                           (px[2][i] - mean[2]) * axis[2]) / axisLength;
+                minT = (std::min)(minT, t);
+                maxT = (std::max)(maxT, t);
+            }
+            for (int c = 0; c < 3; ++c) {
+                e0[c] = (std::min)((std::max)(mean[c] + axis[c] * maxT, 0.0f), 255.0f);
+                e1[c] = (std::min)((std::max)(mean[c] + axis[c] * minT, 0.0f), 255.0f);
+            }
+        }
+
+        uint16_t c0, c1;
+        uint8_t indices[16];
+        float error = TryColorEndpoints(px, e0, e1, c0, c1, indices);
+
+        // Уточнение: концы по методу наименьших квадратов при найденных индексах
+        if (c0 != c1 && error > 0.0f) {
+            static const float kWeights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+            float aa = 0.0f, ab = 0.0f, bb = 0.0f, ax[3] = {}, bx[3] = {};
+            for (int i = 0; i < 16; ++i) {
+                float w = kWeights[indices[i]];
+                aa += w * w; ab += w * (1.0f - w); bb += (1.0f - w) * (1.0f - w);
+                for (int c = 0; c < 3; ++c) {
+                    ax[c] += w * px[c][i];
+                    bx[c] += (1.0f - w) * px[c][i];
+                }
+            }
+            float det = aa * bb - ab * ab;
+            if (std::fabs(det) > 1e-6f) {
+                float r0[3], r1[3];
+                for (int c = 0; c < 3; ++c) {
+                    r0[c] = (std::min)((std::max)((ax[c] * bb - bx[c] * ab) / det, 0.0f), 255.0f);
+                    r1[c] = (std::min)((std::max)((bx[c] * aa - ax[c] * ab) / det, 0.0f), 255.0f);
+                }
+                uint16_t refined0, refined1;
+                uint8_t refinedIndices[16];
+                float refinedError = TryColorEndpoints(px, r0, r1, refined0, refined1, refinedIndices);
+                if (refinedError < error) {
+                    c0 = refined0;
+                    c1 = refined1;
+                    memcpy(indices, refinedIndices, sizeof(indices));
+                }
+            }
+        }
+
+        uint32_t bits = 0;
+        for (int i = 0; i < 16; ++i) bits |= (uint32_t)indices[i] << (2 * i);
+        out[0] = (uint8_t)(c0 & 0xFF); out[1] = (uint8_t)(c0 >> 8);
+        out[2] = (uint8_t)(c1 & 0xFF); out[3] = (uint8_t)(c1 >> 8);
+        for (int i = 0; i < 4; ++i) out[4 + i] = (uint8_t)(bits >> (8 * i));
+    }
+
+    // Блок BC4 (он же альфа BC3 и каждый канал BC5): восемь значений между min и max
+    void EncodeChannelBlock(const float* values, uint8_t* out) {
+        float minValue = values[0], maxValue = values[0];
+        for (int i = 1; i < 16; ++i) {
+            minValue = (std::min)(minValue, values[i]);
+            maxValue = (std::max)(maxValue, values[i]);
+        }
+        int r0 = (int)std::lround(maxValue), r1 = (int)std::lround(minValue);
+        uint8_t indices[16] = {};
+        if (r0 != r1) {
+            float palette[8][3];
+            palette[0][0] = (float)r0;
+            palette[1][0] = (float)r1;
+            for (int i = 2; i < 8; ++i) palette[i][0] = ((8 - i) * r0 + (i - 1) * r1) / 7.0f;
+            const float (*channel)[16] = reinterpret_cast<const float (*)[16]>(values);
+            FindIndices(channel, 1, palette, 8, indices);
+        }
+        uint64_t bits = 0;
+        for (int i = 0; i < 16; ++i) bits |= (uint64_t)indices[i] << (3 * i);
+        out[0] = (uint8_t)r0;
+        out[1] = (uint8_t)r1;
+        for (int i = 0; i < 6; ++i) out[2 + i] = (uint8_t)(bits >> (8 * i));
+    }
+
+    // Уровень вдвое меньше: среднее 2x2 (нечётный край повторяется)
+    void Downsample(const uint8_t* source, int width, int height, uint8_t* target, bool normalMap) {
+        const int targetWidth = (std::max)(1, width / 2), targetHeight = (std::max)(1, height / 2);
+        for (int y = 0; y < targetHeight; ++y) {
+            const int y0 = (std::min)(2 * y, height - 1), y1 = (std::min)(2 * y + 1, height - 1);
+            for (int x = 0; x < targetWidth; ++x) {
+                const int x0 = (std::min)(2 * x, width - 1), x1 = (std::min)(2 * x + 1, width - 1);
+                const uint8_t* samples[4] = {
+                    source + ((size_t)y0 * width + x0) * 4, source + ((size_t)y0 * width + x1) * 4,
+                    source + ((size_t)y1 * width + x0) * 4, source + ((size_t)y1 * width + x1) * 4
+                };
+                uint8_t* pixel = target + ((size_t)y * targetWidth + x) * 4;
+                for (int c = 0; c < 4; ++c) {
+                    pixel[c] = (uint8_t)((samples[0][c] + samples[1][c] + samples[2][c] + samples[3][c] + 2) / 4);
+                }
+                if (!normalMap) continue;
+                // Нормали: среднее векторов, затем нормализация — иначе мипы «плоские»
+                float n[3] = {};
+                for (int s = 0; s < 4; ++s) {
+                    for (int c = 0; c < 3; ++c) n[c] += samples[s][c] / 127.5f - 1.0f;
+                }
+                float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+                if (length < 1e-6f) { n[0] = n[1] = 0.0f; n[2] = length = 1.0f; }
+                for (int c = 0; c < 3; ++c) {
+                    pixel[c] = (uint8_t)std::lround((std::min)((std::max)((n[c] / length + 1.0f) * 127.5f, 0.0f), 255.0f));
+                }
+            }
+        }
+    }
+}
+
+void CompressedImage::Release() {
+    levels.clear();
+    std::vector<uint8_t>().swap(blocks);
+    file.Close();
+    fileOffset = 0;
+}
+
+size_t TextureCompressor::GetBlockBytes(BlockFormat format) {
+    return (format == BLOCK_BC1 || format == BLOCK_BC4) ? 8 : 16;
+}
+
+size_t TextureCompressor::GetLevelBytes(BlockFormat format, int width, int height) {
+    return (size_t)((width + 3) / 4) * (size_t)((height + 3) / 4) * GetBlockBytes(format);
+}
+
+int TextureCompressor::GetLevelCount(int width, int height) {
+    int levels = 1;
+    for (int size = (std::max)(width, height); size > 1; size /= 2) levels++;
+    return levels;
+}
+
+const char* TextureCompressor::GetFormatName(BlockFormat format) {
+    switch (format) {
+        case BLOCK_BC1: return "BC1";
+        case BLOCK_BC3: return "BC3";
+        case BLOCK_BC4: return "BC4";
+        default: return "BC5";
+    }
+}
+
+bool TextureCompressor::HasTransparency(const unsigned char* rgba, size_t pixelCount) {
+    for (size_t i = 0; i < pixelCount; ++i) {
+        if (rgba[i * 4 + 3] != 255) return true;
+    }
+    return false;
+}
+
+void TextureCompressor::EncodeBlock(const unsigned char* pixels, BlockFormat format, uint8_t* out) {
+    BlockChannels px;
+    for (int i = 0; i < 16; ++i) {
+        for (int c = 0; c < 4; ++c) px[c][i] = (float)pixels[i * 4 + c];
+    }
+    switch (format) {
+        case BLOCK_BC1:
+            EncodeColorBlock(px, out);
+            break;
+        case BLOCK_BC3:
+            EncodeChannelBlock(px[3], out);
+            EncodeColorBlock(px, out + 8);
+            break;
+        case BLOCK_BC4:
+            EncodeChannelBlock(px[0], out);
+            break;
+        case BLOCK_BC5:
+            EncodeChannelBlock(px[0], out);
+            EncodeChannelBlock(px[1], out + 8);
+            break;
+    }
+}
+
+void TextureCompressor::Compress(const unsigned char* rgba, int width, int height, BlockFormat format,
+                                 bool generateMipmaps, CompressedImage& image) {
+    image.Release();
+    image.format = format;
+    image.width = width;
+    image.height = height;
+
+    // Цепочка мипов в RGBA8; уровень 0 — исходная картинка без копии
+    const int levelCount = generateMipmaps ? GetLevelCount(width, height) : 1;
+    std::vector<std::vector<uint8_t>> storage(levelCount);
+    std::vector<const uint8_t*> pixels(levelCount);
+    pixels[0] = rgba;
+    image.levels.resize(levelCount);
+    size_t offset = 0;
+    for (int level = 0; level < levelCount; ++level) {
+        CompressedImage::Level& info = image.levels[level];
+        info.width = (std::max)(1, width >> level);
+        info.height = (std::max)(1, height >> level);
+        info.offset = offset;
+        info.size = GetLevelBytes(format, info.width, info.height);
+        offset += info.size;
+        if (level > 0) {
+            const CompressedImage::Level& previous = image.levels[level - 1];
+            storage[level].resize((size_t)info.width * info.height * 4);
+            Downsample(pixels[level - 1], previous.width, previous.height, storage[level].data(), format == BLOCK_BC5);
+            pixels[level] = storage[level].data();
+        }
+    }
+    image.blocks.resize(offset);
+
+    // Задания — полосы строк блоков всех уровней сразу
+    struct Job { int level; int firstRow; };
+    std::vector<Job> jobs;
+    for (int level = 0; level < levelCount; ++level) {
+        const int rows = (image.levels[level].height + 3) / 4;
+        for (int row = 0; row < rows; row += kBlockRowsPerJob) jobs.push_back({ level, row });
+    }
+
+    const size_t blockBytes = GetBlockBytes(format);
+    ParallelFor(jobs.size(), [&](size_t j) {
+        const Job& job = jobs[j];
+        const CompressedImage::Level& info = image.levels[job.level];
+        const uint8_t* source = pixels[job.level];
+        const int blocksX = (info.width + 3) / 4, blocksY = (info.height + 3) / 4;
+        const int lastRow = (std::min)(job.firstRow + kBlockRowsPerJob, blocksY);
+        uint8_t block[16 * 4];
+        for (int by = job.firstRow; by < lastRow; ++by) {
+            uint8_t* out = image.blocks.data() + info.offset + (size_t)by * blocksX * blockBytes;
+            for (int bx = 0; bx < blocksX; ++bx, out += blockBytes) {
+                // Блок за краем картинки дополняется повтором крайних пикселей
+                for (int y = 0; y < 4; ++y) {
+                    const int sy = (std::min)(by * 4 + y, info.height - 1);
+                    for (int x = 0; x < 4; ++x) {
+                        const int sx = (std::min)(bx * 4 + x, info.width - 1);
+                        memcpy(block + (y * 4 + x) * 4, source + ((size_t)sy * info.width + sx) * 4, 4);
+                    }
+                }
+                EncodeBlock(block, format, out);
+            }
+        }
+    });
+}
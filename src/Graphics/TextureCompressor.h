@@ -0,0 +1,61 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Core/MappedFile.h"
+
+// Форматы блочного сжатия (блок 4x4)
+enum BlockFormat {
+    BLOCK_BC1,      // RGB, 8 байт — непрозрачный цвет
+    BLOCK_BC3,      // RGBA, 16 байт — цвет с альфой
+    BLOCK_BC4,      // R, 8 байт — roughness, metallic, AO
+    BLOCK_BC5       // RG, 16 байт — карты нормалей (Z восстанавливает шейдер)
+};
+
+// Сжатая текстура с цепочкой мипов: уровни лежат подряд, от большего к меньшему.
+// Блоки — либо в собственном буфере (только что сжата), либо в отображённом
+// файле кэша (без копирования)
+struct CompressedImage {
+    struct Level {
+        int width = 0;
+        int height = 0;
+        size_t offset = 0;      // от начала блоков
+        size_t size = 0;
+    };
+
+    BlockFormat format = BLOCK_BC1;
+    int width = 0;
+    int height = 0;
+    int sourceChannels = 0;     // каналов в исходной картинке — для статистики
+    std::vector<Level> levels;
+    std::vector<uint8_t> blocks;
+    MappedFile file;
+    size_t fileOffset = 0;
+
+    bool IsValid() const { return !levels.empty(); }
+    const uint8_t* GetBlocks() const { return file.IsOpen() ? file.GetData() + fileOffset : blocks.data(); }
+    size_t GetSize() const { return levels.empty() ? 0 : levels.back().offset + levels.back().size; }
+    void Release();
+};
+
+// CPU-кодировщик BC1/BC3/BC4/BC5. Конечные точки — по главной оси цветов блока
+// с уточнением методом наименьших квадратов, индексы — ближайший цвет палитры
+// (SSE, если доступно). Блоки всех уровней кодируются параллельно.
+class TextureCompressor {
+public:
+    // rgba — 4 байта на пиксель. Мипы строятся на CPU (2x2 среднее; для
+    // нормалей — среднее векторов с нормализацией)
+    static void Compress(const unsigned char* rgba, int width, int height, BlockFormat format,
+                         bool generateMipmaps, CompressedImage& image);
+
+    // Есть ли пиксели с альфой < 255 (выбор между BC1 и BC3)
+    static bool HasTransparency(const unsigned char* rgba, size_t pixelCount);
+
+    static size_t GetBlockBytes(BlockFormat format);
+    static size_t GetLevelBytes(BlockFormat format, int width, int height);
+    static int GetLevelCount(int width, int height);
+    static const char* GetFormatName(BlockFormat format);
+
+    // Один блок: 16 пикселей RGBA построчно
+    static void EncodeBlock(const unsigned char* pixels, BlockFormat format, uint8_t* out);
+};
@@ -0,0 +1,363 @@
+#include "Graphics/TextureManager.h"
+#include "Graphics/TextureCache.h"
+#include "Core/ThreadPool.h"
+#include <iostream>
+#include <chrono>
+#include <filesystem>
+#include <algorithm>
+#include <cctype>
+#include <stb_image.h>
+
+namespace {
+    std::string MakeKey(const std::string& canonicalPath, const TextureOptions& options) {
+        std::string key = canonicalPath;
+        key += options.flipVertically ? "|f" : "|-";
+        key += options.generateMipmaps ? 'm' : '-';
+        key += options.repeat ? 'r' : '-';
+        key += (char)('0' + options.compression);
+        return key;
+    }
+
+    bool IsCompressionSupported(TextureCompression compression) {
+        // RGTC (BC4/BC5) — в ядре GL 3.0; S3TC (BC1/BC3) — расширение, есть у всех десктопных драйверов
+        return compression != TEXTURE_COMPRESS_COLOR || GLEW_EXT_texture_compression_s3tc;
+    }
+
+    size_t UncompressedBytes(int width, int height, int channels, bool mipmaps) {
+        size_t bytes = (size_t)width * height * channels;
+        return mipmaps ? bytes * 4 / 3 : bytes;
+    }
+
+    GLuint CreateTexture(const TextureImage& image, const TextureOptions& options) {
+        GLuint textureID = 0;
+        glGenTextures(1, &textureID);
+        if (textureID == 0) {
+            std::cerr << "[TextureManager] Failed to generate texture ID" << std::endl;
+            return 0;
+        }
+
+        // Одно- и двухканальные картинки разворачиваются в серый (и альфу) swizzle'ом
+        static const GLenum formats[5] = { 0, GL_RED, GL_RG, GL_RGB, GL_RGBA };
+        GLenum format = formats[(std::min)((std::max)(image.channels, 1), 4)];
+        glBindTexture(GL_TEXTURE_2D, textureID);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);     // строки RGB/RED не выровнены на 4
+        glTexImage2D(GL_TEXTURE_2D, 0, format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, image.pixels);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        if (image.channels == 1) {
+            GLint swizzle[4] = { GL_RED, GL_RED, GL_RED, GL_ONE };
+            glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+        } else if (image.channels == 2) {
+            GLint swizzle[4] = { GL_RED, GL_RED, GL_RED, GL_GREEN };
+            glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+        }
+        if (options.generateMipmaps) glGenerateMipmap(GL_TEXTURE_2D);
+        GLint wrap = options.repeat ? GL_REPEAT : GL_CLAMP_TO_EDGE;
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, options.generateMipmaps ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        return textureID;
+    }
+
+    GLuint CreateCompressedTexture(const CompressedImage& image, const TextureOptions& options, GLenum& format) {
+        GLuint textureID = 0;
+        glGenTextures(1, &textureID);
+        if (textureID == 0) {
+            std::cerr << "[TextureManager] Failed to generate texture ID" << std::endl;
+            return 0;
+        }
+
+        // По порядку BlockFormat
+        static const GLenum formats[4] = {
+            GL_COMPRESSED_RGB_S3TC_DXT1_EXT, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,
+            GL_COMPRESSED_RED_RGTC1, GL_COMPRESSED_RG_RGTC2
+        };
+        format = formats[image.format];
+        glBindTexture(GL_TEXTURE_2D, textureID);
+        const uint8_t* blocks = image.GetBlocks();
+        for (size_t level = 0; level < image.levels.size(); ++level) {
+            const CompressedImage::Level& info = image.levels[level];
+            glCompressedTexImage2D(GL_TEXTURE_2D, (GLint)level, format, info.width, info.height, 0,
+                                   (GLsizei)info.size, blocks + info.offset);
+        }
+        // Мипы готовые, из кэша: glGenerateMipmap для сжатых форматов не работает
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)image.levels.size() - 1);
+        if (image.format == BLOCK_BC4) {
+            GLint swizzle[4] = { GL_RED, GL_RED, GL_RED, GL_ONE };
+            glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+        }
+        GLint wrap = options.repeat ? GL_REPEAT : GL_CLAMP_TO_EDGE;
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, image.levels.size() > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        return textureID;
+    }
+
+    float ElapsedMs(std::chrono::high_resolution_clock::time_point start) {
+        return std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+}
+
+Texture::~Texture() {
+    if (m_ID) glDeleteTextures(1, &m_ID);
+}
+
+TextureManager::TextureManager() = default;
+TextureManager::~TextureManager() = default;
+
+TextureHandle TextureManager::Load(const std::string& path, const TextureOptions& options) {
+    return Request(path, options, Callback(), true);
+}
+
+TextureHandle TextureManager::LoadAsync(const std::string& path, const TextureOptions& options, Callback onReady) {
+    return Request(path, options, std::move(onReady), false);
+}
+
+TextureHandle TextureManager::Request(const std::string& path, const TextureOptions& options, Callback onReady, bool wait) {
+    m_Stats.requests++;
+    TextureOptions effective = options;
+    if (!IsCompressionSupported(effective.compression)) effective.compression = TEXTURE_COMPRESS_NONE;
+    const std::string key = MakeKey(CanonicalPath(path), effective);
+
+    // Уже грузится: присоединяемся к той же загрузке
+    auto pendingIt = m_Pending.find(key);
+    if (pendingIt != m_Pending.end()) {
+        m_Stats.dedupHits++;
+        PendingPtr load = pendingIt->second;
+        if (onReady) load->callbacks.push_back(std::move(onReady));
+        if (wait) {
+            if (!load->claimed.exchange(true)) {
+                Decode(*load);      // пул до неё ещё не дошёл — декодируем сами
+            } else {
+                std::unique_lock<std::mutex> lock(m_DecodedMutex);
+                m_DecodedCondition.wait(lock, [&load] { return load->decoded.load(); });
+            }
+            Complete(load);
+        }
+        return load->texture;
+    }
+
+    // Уже загружена (неудачные попытки не кэшируются — файл могли исправить)
+    auto it = m_Textures.find(key);
+    if (it != m_Textures.end()) {
+        TextureHandle texture = it->second.lock();
+        if (texture && texture->GetID()) {
+            m_Stats.dedupHits++;
+            if (onReady) onReady(texture);
+            return texture;
+        }
+    }
+
+    PendingPtr load = std::make_shared<PendingLoad>();
+    load->texture = TextureHandle(new Texture(path));
+    load->key = key;
+    load->path = path;
+    load->options = effective;
+    if (onReady) load->callbacks.push_back(std::move(onReady));
+    m_Textures[key] = load->texture;
+    m_Pending[key] = load;
+
+    if (wait) {
+        load->claimed = true;
+        Decode(*load);
+        Complete(load);
+        return load->texture;
+    }
+
+    EnsurePool();
+    m_Pool->Submit([this, load]() {
+        if (load->claimed.exchange(true)) return;   // её уже забрал синхронный Load
+        Decode(*load);
+        {
+            std::lock_guard<std::mutex> lock(m_DecodedMutex);
+            m_Decoded.push_back(load);
+        }
+        m_DecodedCondition.notify_all();
+    });
+    return load->texture;
+}
+
+void TextureManager::Decode(PendingLoad& load) {
+    auto start = std::chrono::high_resolution_clock::now();
+    if (load.options.compression != TEXTURE_COMPRESS_NONE) {
+        DecodeCompressed(load);
+    } else if (!DecodeImage(load.path, load.options.flipVertically, load.image)) {
+        load.error = stbi_failure_reason() ? stbi_failure_reason() : "unknown error";
+    }
+    load.decodeMs = ElapsedMs(start) - load.compressMs;
+    // Флаг — под мьютексом: иначе ожидающий Load может пропустить уведомление
+    std::lock_guard<std::mutex> lock(m_DecodedMutex);
+    load.decoded = true;
+}
+
+bool TextureManager::DecodeCompressed(PendingLoad& load) {
+    const TextureOptions& options = load.options;
+    MappedFile source;
+    if (!source.Open(load.path)) {
+        load.error = "can't open file";
+        return false;
+    }
+    const uint32_t settings = (uint32_t)options.compression | (options.flipVertically ? 0x10u : 0u) |
+                              (options.generateMipmaps ? 0x20u : 0u);
+    const uint64_t key = TextureCache::MakeKey(source.GetData(), source.GetSize(), settings);
+    const std::string cachePath = TextureCache::GetCachePath(key);
+    if (TextureCache::Open(cachePath, key, load.compressed)) {
+        load.fromCache = true;
+        return true;
+    }
+
+    // Промах: картинка декодируется из уже отображённого файла, всегда в RGBA
+    TextureImage image;
+    stbi_set_flip_vertically_on_load_thread(options.flipVertically ? 1 : 0);
+    image.pixels = stbi_load_from_memory(source.GetData(), (int)source.GetSize(),
+                                         &image.width, &image.height, &image.channels, 4);
+    if (!image.pixels) {
+        load.error = stbi_failure_reason() ? stbi_failure_reason() : "unknown error";
+        return false;
+    }
+
+    BlockFormat format = BLOCK_BC4;
+    if (options.compression == TEXTURE_COMPRESS_COLOR) {
+        format = TextureCompressor::HasTransparency(image.pixels, (size_t)image.width * image.height) ? BLOCK_BC3 : BLOCK_BC1;
+    } else if (options.compression == TEXTURE_COMPRESS_NORMAL_MAP) {
+        format = BLOCK_BC5;
+    }
+    auto start = std::chrono::high_resolution_clock::now();
+    TextureCompressor::Compress(image.pixels, image.width, image.height, format, options.generateMipmaps, load.compressed);
+    load.compressed.sourceChannels = image.channels;
+    load.compressMs = ElapsedMs(start);
+    FreeImage(image);
+
+    if (!TextureCache::Write(cachePath, key, load.compressed)) {
+        std::cerr << "[TextureManager] Failed to write cache " << cachePath << std::endl;
+    }
+    return true;
+}
+
+void TextureManager::Complete(const PendingPtr& load) {
+    Texture& texture = *load->texture;
+    if (!texture.m_Pending) return;     // уже завершена синхронным Load
+
+    auto start = std::chrono::high_resolution_clock::now();
+    if (load->compressed.IsValid()) {
+        const CompressedImage& image = load->compressed;
+        texture.m_ID = CreateCompressedTexture(image, load->options, texture.m_Format);
+        texture.m_Width = image.width;
+        texture.m_Height = image.height;
+        texture.m_LevelCount = (int)image.levels.size();
+        texture.m_Compressed = true;
+        texture.m_GpuBytes = image.GetSize();
+        texture.m_UncompressedBytes = UncompressedBytes(image.width, image.height, image.sourceChannels, image.levels.size() > 1);
+        m_Stats.decoded++;
+        if (load->fromCache) {
+            m_Stats.cacheHits++;
+        } else {
+            std::cout << "[TextureManager] Compressed " << load->path << ": " << TextureCompressor::GetFormatName(image.format)
+                      << " " << image.width << "x" << image.height << ", " << image.levels.size() << " levels, "
+                      << texture.m_UncompressedBytes / 1024 << " KB -> " << texture.m_GpuBytes / 1024 << " KB, "
+                      << load->compressMs << " ms" << std::endl;
+        }
+    } else if (load->image.pixels) {
+        const TextureImage& image = load->image;
+        texture.m_ID = CreateTexture(image, load->options);
+        texture.m_Width = image.width;
+        texture.m_Height = image.height;
+        static const GLenum formats[5] = { 0, GL_R8, GL_RG8, GL_RGB8, GL_RGBA8 };
+        texture.m_Format = formats[(std::min)((std::max)(image.channels, 1), 4)];
+        texture.m_GpuBytes = texture.m_UncompressedBytes =
+            UncompressedBytes(image.width, image.height, image.channels, load->options.generateMipmaps);
+        m_Stats.decoded++;
+    } else {
+        std::cerr << "[TextureManager] Failed to load texture: " << load->path << " - " << load->error << std::endl;
+        m_Stats.failed++;
+    }
+    texture.m_Pending = false;
+    FreeImage(load->image);
+    load->compressed.Release();
+    m_Stats.decodeMs += load->decodeMs;
+    m_Stats.compressMs += load->compressMs;
+    m_Stats.uploadMs += ElapsedMs(start);
+
+    auto it = m_Pending.find(load->key);
+    if (it != m_Pending.end() && it->second == load) m_Pending.erase(it);
+
+    std::vector<Callback> callbacks;
+    callbacks.swap(load->callbacks);
+    for (auto& callback : callbacks) callback(load->texture);
+}
+
+void TextureManager::Update(float budgetMs) {
+    {
+        std::lock_guard<std::mutex> lock(m_DecodedMutex);
+        m_Ready.insert(m_Ready.end(), m_Decoded.begin(), m_Decoded.end());
+        m_Decoded.clear();
+    }
+
+    // Хотя бы одна текстура за кадр, дальше — пока укладываемся в бюджет
+    auto start = std::chrono::high_resolution_clock::now();
+    while (!m_Ready.empty()) {
+        PendingPtr load = m_Ready.front();
+        m_Ready.pop_front();
+        Complete(load);
+        if (ElapsedMs(start) >= budgetMs) break;
+    }
+}
+
+void TextureManager::Shutdown() {
+    m_Pool.reset();
+    for (auto& entry : m_Pending) {
+        FreeImage(entry.second->image);
+        entry.second->compressed.Release();
+    }
+    m_Pending.clear();
+    m_Ready.clear();
+    m_Decoded.clear();
+}
+
+void TextureManager::EnsurePool() {
+    if (!m_Pool) m_Pool = std::make_unique<ThreadPool>();
+}
+
+bool TextureManager::DecodeImage(const std::string& path, bool flipVertically, TextureImage& image) {
+    // Флаг переворота — свой у каждого потока (stb_image >= 2.26)
+    stbi_set_flip_vertically_on_load_thread(flipVertically ? 1 : 0);
+    image.pixels = stbi_load(path.c_str(), &image.width, &image.height, &image.channels, 0);
+    return image.pixels != nullptr;
+}
+
+void TextureManager::FreeImage(TextureImage& image) {
+    if (image.pixels) stbi_image_free(image.pixels);
+    image.pixels = nullptr;
+}
+
+std::string TextureManager::CanonicalPath(const std::string& path) {
+    std::error_code error;
+    std::filesystem::path canonical = std::filesystem::weakly_canonical(path, error);
+    if (error) canonical = std::filesystem::path(path).lexically_normal();
+    std::string result = canonical.generic_string();
+#ifdef _WIN32
+    // Регистр в путях Windows не различается
+    std::transform(result.begin(), result.end(), result.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+#endif
+    return result;
+}
+
+TextureManager::Stats TextureManager::GetStats() const {
+    Stats stats = m_Stats;
+    stats.pending = (uint32_t)m_Pending.size();
+    for (const auto& entry : m_Textures) {
+        TextureHandle texture = entry.second.lock();
+        if (!texture) continue;
+        stats.liveTextures++;
+        stats.gpuBytes += texture->GetGpuBytes();
+        if (texture->IsCompressed()) {
+            stats.compressedTextures++;
+            stats.compressedBytes += texture->GetGpuBytes();
+            stats.compressedSourceBytes += texture->GetUncompressedBytes();
+        }
+    }
+    return stats;
+}
@@ -0,0 +1,175 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <GL/glew.h>
+#include "Graphics/TextureCompressor.h"
+
+class ThreadPool;
+
+// Картинка, декодированная stb_image. Декодирование не трогает GL и может
+// идти в любом потоке; текстуру из неё создаёт основной поток
+struct TextureImage {
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    unsigned char* pixels = nullptr;
+};
+
+// Блочное сжатие по назначению текстуры. Сжатые текстуры (с мипами) лежат
+// в кэше на диске, повторная загрузка берёт их оттуда без декодирования
+enum TextureCompression {
+    TEXTURE_COMPRESS_NONE,
+    TEXTURE_COMPRESS_COLOR,         // BC1, с прозрачностью — BC3
+    TEXTURE_COMPRESS_GRAYSCALE,     // BC4 по красному каналу
+    TEXTURE_COMPRESS_NORMAL_MAP     // BC5: только XY
+};
+
+// Параметры загрузки — часть ключа: один файл с разными параметрами
+// даёт разные текстуры
+struct TextureOptions {
+    bool flipVertically = true;
+    bool generateMipmaps = true;
+    bool repeat = true;             // GL_REPEAT, иначе GL_CLAMP_TO_EDGE
+    TextureCompression compression = TEXTURE_COMPRESS_NONE;
+};
+
+// 2D-текстура, общая для всех, кто загрузил тот же файл с теми же параметрами.
+// GL-объект удаляется вместе с последней ссылкой.
+class Texture {
+public:
+    Texture(const Texture&) = delete;
+    Texture& operator=(const Texture&) = delete;
+    ~Texture();
+
+    // 0, пока текстура не загружена (или если файл не прочитался)
+    GLuint GetID() const { return m_ID; }
+    bool IsPending() const { return m_Pending; }
+    const std::string& GetPath() const { return m_Path; }
+    int GetWidth() const { return m_Width; }
+    int GetHeight() const { return m_Height; }
+    // Внутренний формат GL и число уровней, загруженных явно (без glGenerateMipmap — 1)
+    GLenum GetFormat() const { return m_Format; }
+    int GetLevelCount() const { return m_LevelCount; }
+    bool IsCompressed() const { return m_Compressed; }
+    // Память GPU со всеми мипами; для сжатой — и сколько заняла бы несжатая
+    size_t GetGpuBytes() const { return m_GpuBytes; }
+    size_t GetUncompressedBytes() const { return m_UncompressedBytes; }
+
+private:
+    friend class TextureManager;
+    explicit Texture(const std::string& path) : m_Path(path) {}
+
+    GLuint m_ID = 0;
+    bool m_Pending = true;
+    std::string m_Path;
+    int m_Width = 0;
+    int m_Height = 0;
+    GLenum m_Format = 0;
+    int m_LevelCount = 1;
+    bool m_Compressed = false;
+    size_t m_GpuBytes = 0;
+    size_t m_UncompressedBytes = 0;
+};
+
+typedef std::shared_ptr<Texture> TextureHandle;
+
+// Единая точка загрузки 2D-текстур. Повторный запрос того же файла (путь
+// приводится к каноническому виду) отдаёт уже существующую текстуру.
+// Декодирование (и сжатие) идёт в пуле потоков, загрузка в GL — в основном
+// потоке: сразу (Load) или порциями в Update (LoadAsync).
+class TextureManager {
+public:
+    static TextureManager& Get() {
+        // Не разрушается при выходе: текстуры глобальных объектов сцены
+        // освобождаются позже статических объектов
+        static TextureManager* manager = new TextureManager();
+        return *manager;
+    }
+
+    // Вызывается в основном потоке после загрузки; текстура может оказаться
+    // пустой (GetID() == 0), если файл не прочитался
+    typedef std::function<void(const TextureHandle&)> Callback;
+
+    // Синхронно: при промахе декодирует на месте, ожидающую фоновую загрузку
+    // доводит до конца. Не nullptr, но GetID() == 0 при ошибке
+    TextureHandle Load(const std::string& path, const TextureOptions& options = TextureOptions());
+    // Сразу возвращает ручку; onReady (если задан) — из Update или Load,
+    // когда текстура готова. Без колбэка — предзагрузка для будущего Load
+    TextureHandle LoadAsync(const std::string& path, const TextureOptions& options = TextureOptions(),
+                            Callback onReady = Callback());
+
+    // Раз в кадр: готовые картинки в GL, пока не исчерпан бюджет
+    void Update(float budgetMs);
+    // Останавливает пул; незавершённые загрузки отбрасываются
+    void Shutdown();
+
+    static bool DecodeImage(const std::string& path, bool flipVertically, TextureImage& image);
+    static void FreeImage(TextureImage& image);
+    static std::string CanonicalPath(const std::string& path);
+
+    struct Stats {
+        uint32_t requests = 0;
+        uint32_t dedupHits = 0;         // запрос отдал уже существующую или ожидающую текстуру
+        uint32_t decoded = 0;
+        uint32_t failed = 0;
+        float decodeMs = 0.0f;          // сумма по потокам
+        float uploadMs = 0.0f;
+        uint32_t pending = 0;
+        uint32_t liveTextures = 0;
+        uint32_t cacheHits = 0;         // сжатая текстура прочитана из кэша
+        float compressMs = 0.0f;        // сумма по потокам
+        // По живым текстурам
+        uint32_t compressedTextures = 0;
+        size_t gpuBytes = 0;
+        size_t compressedBytes = 0;
+        size_t compressedSourceBytes = 0;   // те же текстуры без сжатия (с мипами)
+    };
+    Stats GetStats() const;
+
+private:
+    TextureManager();
+    ~TextureManager();
+
+    struct PendingLoad {
+        TextureHandle texture;
+        std::string key;
+        std::string path;
+        TextureOptions options;
+        TextureImage image;
+        CompressedImage compressed;     // вместо image, если текстура сжимается
+        bool fromCache = false;
+        std::string error;
+        float decodeMs = 0.0f;
+        float compressMs = 0.0f;
+        std::atomic<bool> claimed{ false };     // кто-то (пул или Load) уже декодирует
+        std::atomic<bool> decoded{ false };
+        std::vector<Callback> callbacks;
+    };
+    typedef std::shared_ptr<PendingLoad> PendingPtr;
+
+    TextureHandle Request(const std::string& path, const TextureOptions& options, Callback onReady, bool wait);
+    void Decode(PendingLoad& load);
+    // Сжатая текстура из кэша или картинка, сжатая и записанная в кэш
+    static bool DecodeCompressed(PendingLoad& load);
+    // Основной поток: GL-текстура из картинки, колбэки
+    void Complete(const PendingPtr& load);
+    void EnsurePool();
+
+    std::unordered_map<std::string, std::weak_ptr<Texture>> m_Textures;
+    std::unordered_map<std::string, PendingPtr> m_Pending;
+    std::deque<PendingPtr> m_Ready;         // декодированы, ждут Update (только основной поток)
+
+    std::unique_ptr<ThreadPool> m_Pool;
+    std::mutex m_DecodedMutex;
+    std::condition_variable m_DecodedCondition;
+    std::vector<PendingPtr> m_Decoded;      // пишут рабочие потоки
+
+    Stats m_Stats;
+};
@@ -0,0 +1,28 @@
+#include "Graphics/UniformBuffer.h"
+#include <iostream>
+
+UniformBuffer::~UniformBuffer() {
+    if (m_ID) glDeleteBuffers(1, &m_ID);
+}
+
+void UniformBuffer::Create(size_t size, GLuint binding) {
+    if (m_ID) glDeleteBuffers(1, &m_ID);
+    m_Size = size;
+    glGenBuffers(1, &m_ID);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_ID);
+    glBufferData(GL_UNIFORM_BUFFER, m_Size, NULL, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, binding, m_ID);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void UniformBuffer::Update(const void* data, size_t size) {
+    if (!m_ID) return;
+    if (size > m_Size) {
+        std::cerr << "[UniformBuffer] Update size " << size << " exceeds buffer size " << m_Size << std::endl;
+        return;
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, m_ID);
+    glBufferData(GL_UNIFORM_BUFFER, m_Size, NULL, GL_DYNAMIC_DRAW);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, size, data);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstddef>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+// Фиксированные точки привязки UBO, общие для всех шейдеров.
+// Shader::Load сам связывает блоки с этими точками после линковки.
+enum UniformBlockBinding {
+    UBO_FRAME_CONSTANTS = 0,
+    UBO_LIGHTS = 1
+};
+
+// Направленные источники идут в UBO, точечные и прожекторы — в кластеры
+const int MAX_DIRECTIONAL_LIGHTS = 4;
+
+// Зеркало блока FrameConstants (std140) из шейдеров
+struct FrameConstants {
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::mat4 invView;
+    glm::mat4 invProjection;
+    glm::mat4 lightSpaceMatrices[4];    // по каскадам теней
+    glm::vec4 cascadeSplits;    // дальняя граница каждого каскада (глубина вида)
+    glm::vec4 viewPos;          // xyz — позиция камеры
+    int   shadowsEnabled;
+    float shadowBias;
+    float shadowSoftness;
+    int   shadowSamples;
+    float ambientStrength;
+    int   fogEnabled;
+    int   fogType;
+    float fogDensity;
+    glm::vec4 fogColor;         // rgb
+    float fogStart;
+    float fogEnd;
+    int   cascadeCount;
+    float _pad;
+};
+static_assert(sizeof(FrameConstants) == 608, "FrameConstants must match std140 layout");
+
+// Один источник света, упакованный в vec4 (std140 без сюрпризов с vec3)
+struct LightData {
+    glm::vec4 positionType;     // xyz — позиция, w — тип (LightType)
+    glm::vec4 directionRange;   // xyz — направление, w — радиус
+    glm::vec4 colorIntensity;   // rgb — цвет, w — интенсивность
+    glm::vec4 spotAngle;        // x — угол конуса в радианах
+};
+
+// Зеркало блока Lights (std140)
+struct LightsBlock {
+    glm::ivec4 clusterGrid;     // xyz — размер сетки кластеров, w — число направленных источников
+    glm::vec4 clusterParams;    // x, y — масштаб и смещение среза по log(глубины), zw — размер тайла в пикселях
+    LightData directionalLights[MAX_DIRECTIONAL_LIGHTS];
+};
+static_assert(sizeof(LightsBlock) == 32 + 64 * MAX_DIRECTIONAL_LIGHTS, "LightsBlock must match std140 layout");
+
+class UniformBuffer {
+public:
+    UniformBuffer() = default;
+    ~UniformBuffer();
+
+    void Create(size_t size, GLuint binding);
+    // Полная перезапись раз в кадр (с orphaning старого хранилища)
+    void Update(const void* data, size_t size);
+
+    template <typename T>
+    void Update(const T& data) { Update(&data, sizeof(T)); }
+
+private:
+    GLuint m_ID = 0;
+    size_t m_Size = 0;
+};
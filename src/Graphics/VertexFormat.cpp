@@ -0,0 +1,240 @@
+#include "Graphics/VertexFormat.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+    uint16_t ToUnorm16(float value) {
+        float v = (std::min)((std::max)(value, 0.0f), 1.0f);
+        return (uint16_t)(v * 65535.0f + 0.5f);
+    }
+
+    int16_t ToSnorm16(float value) {
+        float v = (std::min)((std::max)(value, -1.0f), 1.0f) * 32767.0f;
+        return (int16_t)(v + (v >= 0.0f ? 0.5f : -0.5f));
+    }
+
+    uint32_t ToSnorm10(float value) {
+        float v = (std::min)((std::max)(value, -1.0f), 1.0f) * 511.0f;
+        return (uint32_t)(int32_t)(v + (v >= 0.0f ? 0.5f : -0.5f)) & 0x3FF;
+    }
+
+    // GL_INT_2_10_10_10_REV: x — младшие биты, w — два старших
+    uint32_t Pack2101010(const float* v, float w) {
+        uint32_t sign = w < 0.0f ? 0x3u : 0x1u;    // -1 или +1 в двух битах
+        return ToSnorm10(v[0]) | (ToSnorm10(v[1]) << 10) | (ToSnorm10(v[2]) << 20) | (sign << 30);
+    }
+
+    // Нормализация snorm по правилам GL: -32768 и -512 дают -1
+    float FromSnorm16(int16_t value) {
+        return (std::max)((float)value / 32767.0f, -1.0f);
+    }
+
+    float FromSnorm10(uint32_t bits) {
+        int32_t value = (int32_t)(bits << 22) >> 22;
+        return (std::max)((float)value / 511.0f, -1.0f);
+    }
+
+    // Возвращает w (знак битангенса)
+    float Unpack2101010(uint32_t packed, float* v) {
+        v[0] = FromSnorm10(packed);
+        v[1] = FromSnorm10(packed >> 10);
+        v[2] = FromSnorm10(packed >> 20);
+        return (packed >> 30) == 0x3u ? -1.0f : 1.0f;
+    }
+}
+
+VertexQuantization VertexQuantization::FromBounds(const AABB& bounds) {
+    VertexQuantization quantization;
+    quantization.bias = bounds.min;
+    // Атрибут нормализован (0..1), так что scale — полный размах
+    quantization.scale = bounds.max - bounds.min;
+    return quantization;
+}
+
+uint16_t VertexPacker::FloatToHalf(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000;
+    uint32_t exponent = (bits >> 23) & 0xFF;
+    uint32_t mantissa = bits & 0x7FFFFF;
+
+    if (exponent == 0xFF) return (uint16_t)(sign | 0x7C00 | (mantissa ? 0x200 : 0));  // inf, NaN
+    int halfExponent = (int)exponent - 127 + 15;
+    if (halfExponent >= 31) return (uint16_t)(sign | 0x7C00);
+    if (halfExponent <= 0) {
+        // Денормали half; совсем малые — ноль со знаком
+        if (halfExponent < -10) return (uint16_t)sign;
+        mantissa |= 0x800000;
+        int shift = 14 - halfExponent;
+        uint32_t half = mantissa >> shift;
+        if ((mantissa >> (shift - 1)) & 1) half++;
+        return (uint16_t)(sign | half);
+    }
+    uint32_t half = sign | ((uint32_t)halfExponent << 10) | (mantissa >> 13);
+    // Округление к ближайшему; перенос в порядок корректен
+    if (mantissa & 0x1000) half++;
+    return (uint16_t)half;
+}
+
+float VertexPacker::HalfToFloat(uint16_t value) {
+    uint32_t sign = (uint32_t)(value & 0x8000) << 16;
+    uint32_t exponent = (value >> 10) & 0x1F;
+    uint32_t mantissa = value & 0x3FF;
+    uint32_t bits;
+    if (exponent == 0x1F) {
+        bits = sign | 0x7F800000 | (mantissa << 13);
+    } else if (exponent == 0) {
+        // Денормаль half — нормальное число float
+        float magnitude = (float)mantissa * (1.0f / 16777216.0f);
+        return sign ? -magnitude : magnitude;
+    } else {
+        bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+    }
+    float result;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+void VertexPacker::EncodeOctahedral(const float* v, float& x, float& y) {
+    float length = std::fabs(v[0]) + std::fabs(v[1]) + std::fabs(v[2]);
+    if (length <= 0.0f) {
+        x = y = 0.0f;
+        return;
+    }
+    x = v[0] / length;
+    y = v[1] / length;
+    if (v[2] < 0.0f) {
+        // Нижняя полусфера отражается в углы квадрата
+        float fx = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        float fy = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = fx;
+        y = fy;
+    }
+}
+
+void VertexPacker::DecodeOctahedral(float x, float y, float* v) {
+    float z = 1.0f - std::fabs(x) - std::fabs(y);
+    if (z < 0.0f) {
+        float fx = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        float fy = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = fx;
+        y = fy;
+    }
+    float length = std::sqrt(x * x + y * y + z * z);
+    float inv = length > 0.0f ? 1.0f / length : 0.0f;
+    v[0] = x * inv;
+    v[1] = y * inv;
+    v[2] = z * inv;
+}
+
+void VertexPacker::Pack(const Vertex* vertices, size_t count, const VertexFormat& format,
+                        const VertexQuantization& quantization, uint8_t* out) {
+    const size_t stride = format.GetStride();
+    const size_t normalOffset = format.GetNormalOffset();
+    const size_t texCoordOffset = format.GetTexCoordOffset();
+    const size_t tangentOffset = format.GetTangentOffset();
+    // Нулевой размах по оси (плоскость) — все вершины в bias
+    float invScale[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        float scale = quantization.scale[axis];
+        invScale[axis] = scale > 0.0f ? 1.0f / scale : 0.0f;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        const Vertex& v = vertices[i];
+        uint8_t* dst = out + i * stride;
+
+        if (format.position == VERTEX_POSITION_FLOAT) {
+            memcpy(dst, v.Position, sizeof(v.Position));
+        } else {
+            uint16_t q[4] = { 0, 0, 0, 0 };
+            for (int axis = 0; axis < 3; ++axis) {
+                q[axis] = ToUnorm16((v.Position[axis] - quantization.bias[axis]) * invScale[axis]);
+            }
+            memcpy(dst, q, sizeof(q));
+        }
+
+        if (format.normal == VERTEX_NORMAL_FLOAT) {
+            memcpy(dst + normalOffset, v.Normal, sizeof(v.Normal));
+            memcpy(dst + tangentOffset, v.Tangent, sizeof(v.Tangent));
+            memcpy(dst + tangentOffset + sizeof(v.Tangent), &v.TangentSign, sizeof(float));
+        } else if (format.normal == VERTEX_NORMAL_OCTAHEDRAL) {
+            float nx, ny, tx, ty;
+            EncodeOctahedral(v.Normal, nx, ny);
+            EncodeOctahedral(v.Tangent, tx, ty);
+            // Знак битангенса — знаком y касательной: |y| в [0.5, 1] несёт
+            // саму координату, шейдер восстанавливает её как |y| * 4 - 3
+            ty = (v.TangentSign < 0.0f ? -1.0f : 1.0f) * (0.75f + 0.25f * ty);
+            int16_t normal[2] = { ToSnorm16(nx), ToSnorm16(ny) };
+            int16_t tangent[2] = { ToSnorm16(tx), ToSnorm16(ty) };
+            memcpy(dst + normalOffset, normal, sizeof(normal));
+            memcpy(dst + tangentOffset, tangent, sizeof(tangent));
+        } else {
+            uint32_t normal = Pack2101010(v.Normal, 1.0f);
+            uint32_t tangent = Pack2101010(v.Tangent, v.TangentSign);
+            memcpy(dst + normalOffset, &normal, sizeof(normal));
+            memcpy(dst + tangentOffset, &tangent, sizeof(tangent));
+        }
+
+        if (format.texCoords == VERTEX_TEXCOORD_FLOAT) {
+            memcpy(dst + texCoordOffset, v.TexCoords, sizeof(v.TexCoords));
+        } else {
+            uint16_t uv[2] = { FloatToHalf(v.TexCoords[0]), FloatToHalf(v.TexCoords[1]) };
+            memcpy(dst + texCoordOffset, uv, sizeof(uv));
+        }
+    }
+}
+
+void VertexPacker::Unpack(const uint8_t* in, size_t count, const VertexFormat& format,
+                          const VertexQuantization& quantization, Vertex* vertices) {
+    const size_t stride = format.GetStride();
+    const size_t normalOffset = format.GetNormalOffset();
+    const size_t texCoordOffset = format.GetTexCoordOffset();
+    const size_t tangentOffset = format.GetTangentOffset();
+
+    for (size_t i = 0; i < count; ++i) {
+        const uint8_t* src = in + i * stride;
+        Vertex& v = vertices[i];
+
+        if (format.position == VERTEX_POSITION_FLOAT) {
+            memcpy(v.Position, src, sizeof(v.Position));
+        } else {
+            uint16_t q[3];
+            memcpy(q, src, sizeof(q));
+            for (int axis = 0; axis < 3; ++axis) {
+                v.Position[axis] = (float)q[axis] / 65535.0f * quantization.scale[axis] + quantization.bias[axis];
+            }
+        }
+
+        if (format.normal == VERTEX_NORMAL_FLOAT) {
+            memcpy(v.Normal, src + normalOffset, sizeof(v.Normal));
+            memcpy(v.Tangent, src + tangentOffset, sizeof(v.Tangent));
+            memcpy(&v.TangentSign, src + tangentOffset + sizeof(v.Tangent), sizeof(float));
+        } else if (format.normal == VERTEX_NORMAL_OCTAHEDRAL) {
+            int16_t normal[2], tangent[2];
+            memcpy(normal, src + normalOffset, sizeof(normal));
+            memcpy(tangent, src + tangentOffset, sizeof(tangent));
+            DecodeOctahedral(FromSnorm16(normal[0]), FromSnorm16(normal[1]), v.Normal);
+            // Как в шейдере: знак — знак y, координата — |y| * 4 - 3
+            float ty = FromSnorm16(tangent[1]);
+            v.TangentSign = ty < 0.0f ? -1.0f : 1.0f;
+            DecodeOctahedral(FromSnorm16(tangent[0]), std::fabs(ty) * 4.0f - 3.0f, v.Tangent);
+        } else {
+            uint32_t normal, tangent;
+            memcpy(&normal, src + normalOffset, sizeof(normal));
+            memcpy(&tangent, src + tangentOffset, sizeof(tangent));
+            Unpack2101010(normal, v.Normal);
+            v.TangentSign = Unpack2101010(tangent, v.Tangent);
+        }
+
+        if (format.texCoords == VERTEX_TEXCOORD_FLOAT) {
+            memcpy(v.TexCoords, src + texCoordOffset, sizeof(v.TexCoords));
+        } else {
+            uint16_t uv[2];
+            memcpy(uv, src + texCoordOffset, sizeof(uv));
+            v.TexCoords[0] = HalfToFloat(uv[0]);
+            v.TexCoords[1] = HalfToFloat(uv[1]);
+        }
+    }
+}
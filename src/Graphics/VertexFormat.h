@@ -0,0 +1,86 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "Graphics/Bounds.h"
+
+struct Vertex {
+    float Position[3];
+    float Normal[3];
+    float TexCoords[2];
+    float Tangent[3];
+    // Знак битангенса: B = cross(N, T) * TangentSign; -1 — зеркальная развёртка
+    float TangentSign = 1.0f;
+};
+
+// Хранение позиции в буфере вершин
+enum VertexPositionEncoding {
+    VERTEX_POSITION_FLOAT,          // 3 x float, 12 байт
+    VERTEX_POSITION_UNORM16         // 3 x uint16 в границах меша + выравнивание, 8 байт
+};
+
+// Хранение нормали и касательной (вместе со знаком битангенса)
+enum VertexNormalEncoding {
+    VERTEX_NORMAL_FLOAT,            // 3 + 4 x float, 28 байт
+    VERTEX_NORMAL_OCTAHEDRAL,       // 2 + 2 x int16 (октаэдр), знак — в касательной, 8 байт
+    VERTEX_NORMAL_INT_2_10_10_10    // по GL_INT_2_10_10_10_REV, знак — в w касательной, 8 байт
+};
+
+enum VertexTexCoordEncoding {
+    VERTEX_TEXCOORD_FLOAT,          // 2 x float, 8 байт
+    VERTEX_TEXCOORD_HALF            // 2 x half, 4 байта
+};
+
+// Раскладка вершины в VBO. Порядок атрибутов — как в Vertex: позиция, нормаль,
+// UV, касательная; Float() совпадает с Vertex байт в байт
+struct VertexFormat {
+    VertexPositionEncoding position = VERTEX_POSITION_FLOAT;
+    VertexNormalEncoding normal = VERTEX_NORMAL_FLOAT;
+    VertexTexCoordEncoding texCoords = VERTEX_TEXCOORD_FLOAT;
+
+    static VertexFormat Float() { return VertexFormat(); }
+    // 20 байт: квантованная позиция, октаэдрические нормали, half UV
+    static VertexFormat Packed(VertexNormalEncoding normal = VERTEX_NORMAL_OCTAHEDRAL) {
+        VertexFormat format;
+        format.position = VERTEX_POSITION_UNORM16;
+        format.normal = normal;
+        format.texCoords = VERTEX_TEXCOORD_HALF;
+        return format;
+    }
+
+    bool IsFloat() const {
+        return position == VERTEX_POSITION_FLOAT && normal == VERTEX_NORMAL_FLOAT &&
+               texCoords == VERTEX_TEXCOORD_FLOAT;
+    }
+
+    size_t GetNormalOffset() const { return position == VERTEX_POSITION_FLOAT ? 12 : 8; }
+    size_t GetTexCoordOffset() const { return GetNormalOffset() + (normal == VERTEX_NORMAL_FLOAT ? 12 : 4); }
+    size_t GetTangentOffset() const { return GetTexCoordOffset() + (texCoords == VERTEX_TEXCOORD_FLOAT ? 8 : 4); }
+    size_t GetStride() const { return GetTangentOffset() + (normal == VERTEX_NORMAL_FLOAT ? 16 : 4); }
+};
+
+// Позиция в шейдере: aPos * scale + bias. Для float-позиций — единичная
+struct VertexQuantization {
+    glm::vec3 scale = glm::vec3(1.0f);
+    glm::vec3 bias = glm::vec3(0.0f);
+
+    // 16-битная решётка по AABB меша
+    static VertexQuantization FromBounds(const AABB& bounds);
+};
+
+// Кодирование Vertex в раскладку VertexFormat (без GL — можно из любого потока)
+class VertexPacker {
+public:
+    // out — count * format.GetStride() байт
+    static void Pack(const Vertex* vertices, size_t count, const VertexFormat& format,
+                     const VertexQuantization& quantization, uint8_t* out);
+
+    // Обратно в Vertex (с точностью раскладки) — для запекания уже загруженных мешей
+    static void Unpack(const uint8_t* in, size_t count, const VertexFormat& format,
+                       const VertexQuantization& quantization, Vertex* vertices);
+
+    static uint16_t FloatToHalf(float value);
+    static float HalfToFloat(uint16_t value);
+    // Единичный вектор -> точка квадрата [-1, 1]^2
+    static void EncodeOctahedral(const float* v, float& x, float& y);
+    static void DecodeOctahedral(float x, float y, float* v);
+};
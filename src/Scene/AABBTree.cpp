@@ -0,0 +1,296 @@
+#include "Scene/AABBTree.h"
+#include <algorithm>
+
+namespace {
+    AABB Combine(const AABB& a, const AABB& b) {
+        AABB result = a;
+        result.Expand(b);
+        return result;
+    }
+
+    float SurfaceArea(const AABB& box) {
+        glm::vec3 d = box.max - box.min;
+        return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+
+    bool Contains(const AABB& outer, const AABB& inner) {
+        return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+               inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+    }
+}
+
+AABBTree::AABBTree() {
+    m_Nodes.reserve(64);
+}
+
+void AABBTree::Clear() {
+    m_Nodes.clear();
+    m_Root = kNullNode;
+    m_FreeList = kNullNode;
+    m_NodeCount = 0;
+    m_ProxyCount = 0;
+}
+
+int AABBTree::AllocateNode() {
+    if (m_FreeList == kNullNode) {
+        m_Nodes.emplace_back();
+        m_FreeList = (int)m_Nodes.size() - 1;
+        m_Nodes[m_FreeList].parent = kNullNode;
+    }
+    int nodeId = m_FreeList;
+    Node& node = m_Nodes[nodeId];
+    m_FreeList = node.parent;
+    node.parent = kNullNode;
+    node.child1 = kNullNode;
+    node.child2 = kNullNode;
+    node.height = 0;
+    node.userData = nullptr;
+    m_NodeCount++;
+    return nodeId;
+}
+
+void AABBTree::FreeNode(int nodeId) {
+    Node& node = m_Nodes[nodeId];
+    node.parent = m_FreeList;
+    node.height = -1;
+    node.userData = nullptr;
+    m_FreeList = nodeId;
+    m_NodeCount--;
+}
+
+int AABBTree::CreateProxy(const AABB& bounds, GameObject* userData) {
+    int proxyId = AllocateNode();
+    Node& node = m_Nodes[proxyId];
+    node.box.min = bounds.min - glm::vec3(kMargin);
+    node.box.max = bounds.max + glm::vec3(kMargin);
+    node.userData = userData;
+    node.height = 0;
+    InsertLeaf(proxyId);
+    m_ProxyCount++;
+    return proxyId;
+}
+
+void AABBTree::DestroyProxy(int proxyId) {
+    if (proxyId < 0 || proxyId >= (int)m_Nodes.size() || !m_Nodes[proxyId].IsLeaf()) return;
+    RemoveLeaf(proxyId);
+    FreeNode(proxyId);
+    m_ProxyCount--;
+}
+
+bool AABBTree::MoveProxy(int proxyId, const AABB& bounds) {
+    if (Contains(m_Nodes[proxyId].box, bounds)) {
+        // Всё ещё внутри толстого AABB, но не стоит держать слишком раздутый
+        AABB huge;
+        huge.min = bounds.min - glm::vec3(4.0f * kMargin);
+        huge.max = bounds.max + glm::vec3(4.0f * kMargin);
+        if (Contains(huge, m_Nodes[proxyId].box)) return false;
+    }
+
+    RemoveLeaf(proxyId);
+    m_Nodes[proxyId].box.min = bounds.min - glm::vec3(kMargin);
+    m_Nodes[proxyId].box.max = bounds.max + glm::vec3(kMargin);
+    InsertLeaf(proxyId);
+    return true;
+}
+
+void AABBTree::InsertLeaf(int leaf) {
+    if (m_Root == kNullNode) {
+        m_Root = leaf;
+        m_Nodes[m_Root].parent = kNullNode;
+        return;
+    }
+
+    // Поиск лучшего соседа по эвристике площади поверхности
+    AABB leafBox = m_Nodes[leaf].box;
+    int index = m_Root;
+    while (!m_Nodes[index].IsLeaf()) {
+        int child1 = m_Nodes[index].child1;
+        int child2 = m_Nodes[index].child2;
+
+        float area = SurfaceArea(m_Nodes[index].box);
+        float combinedArea = SurfaceArea(Combine(m_Nodes[index].box, leafBox));
+
+        // Цена создания нового родителя для этого узла и листа
+        float cost = 2.0f * combinedArea;
+        // Минимальная цена спуска ниже
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        auto descendCost = [&](int child) {
+            float newArea = SurfaceArea(Combine(leafBox, m_Nodes[child].box));
+            if (m_Nodes[child].IsLeaf()) return newArea + inheritanceCost;
+            return (newArea - SurfaceArea(m_Nodes[child].box)) + inheritanceCost;
+        };
+        float cost1 = descendCost(child1);
+        float cost2 = descendCost(child2);
+
+        if (cost < cost1 && cost < cost2) break;
+        index = cost1 < cost2 ? child1 : child2;
+    }
+
+    int sibling = index;
+    int oldParent = m_Nodes[sibling].parent;
+    int newParent = AllocateNode();     // может перераспределить m_Nodes
+    m_Nodes[newParent].parent = oldParent;
+    m_Nodes[newParent].box = Combine(leafBox, m_Nodes[sibling].box);
+    m_Nodes[newParent].height = m_Nodes[sibling].height + 1;
+
+    if (oldParent != kNullNode) {
+        if (m_Nodes[oldParent].child1 == sibling) m_Nodes[oldParent].child1 = newParent;
+        else m_Nodes[oldParent].child2 = newParent;
+    } else {
+        m_Root = newParent;
+    }
+    m_Nodes[newParent].child1 = sibling;
+    m_Nodes[newParent].child2 = leaf;
+    m_Nodes[sibling].parent = newParent;
+    m_Nodes[leaf].parent = newParent;
+
+    Refit(m_Nodes[leaf].parent);
+}
+
+void AABBTree::RemoveLeaf(int leaf) {
+    if (leaf == m_Root) {
+        m_Root = kNullNode;
+        return;
+    }
+
+    int parent = m_Nodes[leaf].parent;
+    int grandParent = m_Nodes[parent].parent;
+    int sibling = m_Nodes[parent].child1 == leaf ? m_Nodes[parent].child2 : m_Nodes[parent].child1;
+
+    if (grandParent != kNullNode) {
+        // Родитель удаляется, сосед занимает его место
+        if (m_Nodes[grandParent].child1 == parent) m_Nodes[grandParent].child1 = sibling;
+        else m_Nodes[grandParent].child2 = sibling;
+        m_Nodes[sibling].parent = grandParent;
+        FreeNode(parent);
+        Refit(grandParent);
+    } else {
+        m_Root = sibling;
+        m_Nodes[sibling].parent = kNullNode;
+        FreeNode(parent);
+    }
+}
+
+void AABBTree::Refit(int index) {
+    // Подъём к корню: балансировка и пересчёт границ и высоты
+    while (index != kNullNode) {
+        index = Balance(index);
+        Node& node = m_Nodes[index];
+        const Node& child1 = m_Nodes[node.child1];
+        const Node& child2 = m_Nodes[node.child2];
+        node.height = 1 + (std::max)(child1.height, child2.height);
+        node.box = Combine(child1.box, child2.box);
+        index = node.parent;
+    }
+}
+
+// Поворот, если поддеревья A различаются по высоте больше чем на 1.
+// Возвращает новый корень поддерева.
+int AABBTree::Balance(int iA) {
+    Node* A = &m_Nodes[iA];
+    if (A->IsLeaf() || A->height < 2) return iA;
+
+    int iB = A->child1;
+    int iC = A->child2;
+    Node* B = &m_Nodes[iB];
+    Node* C = &m_Nodes[iC];
+    int balance = C->height - B->height;
+
+    // Поднимаем C
+    if (balance > 1) {
+        int iF = C->child1;
+        int iG = C->child2;
+        Node* F = &m_Nodes[iF];
+        Node* G = &m_Nodes[iG];
+
+        C->child1 = iA;
+        C->parent = A->parent;
+        A->parent = iC;
+        if (C->parent != kNullNode) {
+            if (m_Nodes[C->parent].child1 == iA) m_Nodes[C->parent].child1 = iC;
+            else m_Nodes[C->parent].child2 = iC;
+        } else {
+            m_Root = iC;
+        }
+
+        if (F->height > G->height) {
+            C->child2 = iF;
+            A->child2 = iG;
+            G->parent = iA;
+            A->box = Combine(B->box, G->box);
+            C->box = Combine(A->box, F->box);
+            A->height = 1 + (std::max)(B->height, G->height);
+            C->height = 1 + (std::max)(A->height, F->height);
+        } else {
+            C->child2 = iG;
+            A->child2 = iF;
+            F->parent = iA;
+            A->box = Combine(B->box, F->box);
+            C->box = Combine(A->box, G->box);
+            A->height = 1 + (std::max)(B->height, F->height);
+            C->height = 1 + (std::max)(A->height, G->height);
+        }
+        return iC;
+    }
+
+    // Поднимаем B
+    if (balance < -1) {
+        int iD = B->child1;
+        int iE = B->child2;
+        Node* D = &m_Nodes[iD];
+        Node* E = &m_Nodes[iE];
+
+        B->child1 = iA;
+        B->parent = A->parent;
+        A->parent = iB;
+        if (B->parent != kNullNode) {
+            if (m_Nodes[B->parent].child1 == iA) m_Nodes[B->parent].child1 = iB;
+            else m_Nodes[B->parent].child2 = iB;
+        } else {
+            m_Root = iB;
+        }
+
+        if (D->height > E->height) {
+            B->child2 = iD;
+            A->child1 = iE;
+            E->parent = iA;
+            A->box = Combine(C->box, E->box);
+            B->box = Combine(A->box, D->box);
+            A->height = 1 + (std::max)(C->height, E->height);
+            B->height = 1 + (std::max)(A->height, D->height);
+        } else {
+            B->child2 = iE;
+            A->child1 = iD;
+            D->parent = iA;
+            A->box = Combine(C->box, D->box);
+            B->box = Combine(A->box, E->box);
+            A->height = 1 + (std::max)(C->height, D->height);
+            B->height = 1 + (std::max)(A->height, E->height);
+        }
+        return iB;
+    }
+
+    return iA;
+}
+
+float AABBTree::RayIntersectAABB(const glm::vec3& origin, const glm::vec3& direction,
+                                 const AABB& box, float maxDistance) {
+    // Вход не раньше начала луча: изнутри коробки попадание на t = 0
+    float enter = 0.0f;
+    float exit = maxDistance;
+    for (int axis = 0; axis < 3; ++axis) {
+        if (direction[axis] == 0.0f) {
+            // Луч параллелен плитам: 0 * inf дал бы NaN, проверяем начало напрямую
+            if (origin[axis] < box.min[axis] || origin[axis] > box.max[axis]) return -1.0f;
+            continue;
+        }
+        float inv = 1.0f / direction[axis];
+        float t1 = (box.min[axis] - origin[axis]) * inv;
+        float t2 = (box.max[axis] - origin[axis]) * inv;
+        enter = (std::max)(enter, (std::min)(t1, t2));
+        exit = (std::min)(exit, (std::max)(t1, t2));
+        if (enter > exit) return -1.0f;
+    }
+    return enter;
+}
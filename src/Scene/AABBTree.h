@@ -0,0 +1,159 @@
+#pragma once
+#include <vector>
+#include <glm/glm.hpp>
+#include "Graphics/Bounds.h"
+
+class GameObject;
+
+// Динамическое дерево AABB (по мотивам b2DynamicTree из Box2D).
+// Листья хранят "толстые" AABB с запасом, поэтому мелкие перемещения
+// не требуют перестановки листа. Вставка — по эвристике площади
+// поверхности, после изменений дерево балансируется поворотами.
+// Идентификатор прокси — индекс узла, он стабилен до DestroyProxy.
+class AABBTree {
+public:
+    static const int kNullNode = -1;
+
+    AABBTree();
+
+    int CreateProxy(const AABB& bounds, GameObject* userData);
+    void DestroyProxy(int proxyId);
+    // Возвращает true, если лист был переставлен (bounds вышли за толстый AABB)
+    bool MoveProxy(int proxyId, const AABB& bounds);
+    void Clear();
+
+    GameObject* GetUserData(int proxyId) const { return m_Nodes[proxyId].userData; }
+    const AABB& GetFatAABB(int proxyId) const { return m_Nodes[proxyId].box; }
+
+    // Все запросы вызывают callback(proxyId) для листьев, чей толстый AABB
+    // пересекает область; точную проверку делает вызывающий
+    template <typename Callback> void QueryAABB(const AABB& box, Callback&& callback) const;
+    template <typename Callback> void QuerySphere(const BoundingSphere& sphere, Callback&& callback) const;
+    template <typename Callback> void QueryFrustum(const Frustum& frustum, Callback&& callback) const;
+    // callback(proxyId, maxDistance) возвращает новую дальность луча,
+    // отрицательное — оставить прежнюю. Дальность 0 (начало луча внутри
+    // попадания) обход не прерывает: коробки вокруг начала ещё проверяются
+    template <typename Callback> void RayCast(const glm::vec3& origin, const glm::vec3& direction,
+                                              float maxDistance, Callback&& callback) const;
+
+    // Пересечение луча с AABB (slab test); -1, если промах или дальше maxDistance.
+    // Начало внутри коробки — 0; нулевые компоненты направления разбираются отдельно
+    static float RayIntersectAABB(const glm::vec3& origin, const glm::vec3& direction,
+                                  const AABB& box, float maxDistance);
+
+    // Толстый AABB корня — границы всей сцены
+    AABB GetRootBounds() const { return m_Root == kNullNode ? AABB() : m_Nodes[m_Root].box; }
+    int GetHeight() const { return m_Root == kNullNode ? 0 : m_Nodes[m_Root].height; }
+    int GetProxyCount() const { return m_ProxyCount; }
+    int GetNodeCount() const { return m_NodeCount; }
+
+private:
+    struct Node {
+        AABB box;
+        GameObject* userData = nullptr;
+        int parent = kNullNode;     // для свободного узла — следующий в списке
+        int child1 = kNullNode;
+        int child2 = kNullNode;
+        int height = -1;            // лист = 0, свободный узел = -1
+        bool IsLeaf() const { return child1 == kNullNode; }
+    };
+
+    // Запас толстого AABB
+    static constexpr float kMargin = 0.1f;
+
+    int AllocateNode();
+    void FreeNode(int nodeId);
+    void InsertLeaf(int leaf);
+    void RemoveLeaf(int leaf);
+    int Balance(int index);
+    void Refit(int index);
+
+    std::vector<Node> m_Nodes;
+    int m_Root = kNullNode;
+    int m_FreeList = kNullNode;
+    int m_NodeCount = 0;
+    int m_ProxyCount = 0;
+    mutable std::vector<int> m_Stack;
+};
+
+template <typename Callback>
+void AABBTree::QueryAABB(const AABB& box, Callback&& callback) const {
+    if (m_Root == kNullNode) return;
+    m_Stack.clear();
+    m_Stack.push_back(m_Root);
+    while (!m_Stack.empty()) {
+        int id = m_Stack.back();
+        m_Stack.pop_back();
+        const Node& node = m_Nodes[id];
+        if (!node.box.Overlaps(box)) continue;
+        if (node.IsLeaf()) {
+            callback(id);
+        } else {
+            m_Stack.push_back(node.child1);
+            m_Stack.push_back(node.child2);
+        }
+    }
+}
+
+template <typename Callback>
+void AABBTree::QuerySphere(const BoundingSphere& sphere, Callback&& callback) const {
+    if (m_Root == kNullNode) return;
+    float radius2 = sphere.radius * sphere.radius;
+    m_Stack.clear();
+    m_Stack.push_back(m_Root);
+    while (!m_Stack.empty()) {
+        int id = m_Stack.back();
+        m_Stack.pop_back();
+        const Node& node = m_Nodes[id];
+        // Расстояние от центра до ближайшей точки AABB
+        glm::vec3 closest = glm::clamp(sphere.center, node.box.min, node.box.max);
+        glm::vec3 d = closest - sphere.center;
+        if (glm::dot(d, d) > radius2) continue;
+        if (node.IsLeaf()) {
+            callback(id);
+        } else {
+            m_Stack.push_back(node.child1);
+            m_Stack.push_back(node.child2);
+        }
+    }
+}
+
+template <typename Callback>
+void AABBTree::QueryFrustum(const Frustum& frustum, Callback&& callback) const {
+    if (m_Root == kNullNode) return;
+    m_Stack.clear();
+    m_Stack.push_back(m_Root);
+    while (!m_Stack.empty()) {
+        int id = m_Stack.back();
+        m_Stack.pop_back();
+        const Node& node = m_Nodes[id];
+        if (!frustum.IntersectsAABB(node.box)) continue;
+        if (node.IsLeaf()) {
+            callback(id);
+        } else {
+            m_Stack.push_back(node.child1);
+            m_Stack.push_back(node.child2);
+        }
+    }
+}
+
+template <typename Callback>
+void AABBTree::RayCast(const glm::vec3& origin, const glm::vec3& direction,
+                       float maxDistance, Callback&& callback) const {
+    if (m_Root == kNullNode) return;
+    m_Stack.clear();
+    m_Stack.push_back(m_Root);
+    while (!m_Stack.empty()) {
+        int id = m_Stack.back();
+        m_Stack.pop_back();
+        const Node& node = m_Nodes[id];
+        if (RayIntersectAABB(origin, direction, node.box, maxDistance) < 0.0f) continue;
+        if (node.IsLeaf()) {
+            float value = callback(id, maxDistance);
+            if (value >= 0.0f) maxDistance = value;
+        } else {
+            m_Stack.push_back(node.child1);
+            m_Stack.push_back(node.child2);
+        }
+    }
+}
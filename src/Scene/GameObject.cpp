@@ -4,11 +4,21 @@
 #include <glm/gtx/matrix_decompose.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
+#include <algorithm>
 #include "Physics/PhysicsWorld.h"
 #include <btBulletDynamicsCommon.h>
 
+namespace {
+    const Shader::UniformID u_Model = Shader::Uniform("model");
+    const Shader::UniformID u_ReceiveShadows = Shader::Uniform("receiveShadows");
+    const Shader::UniformID u_ObjectColor = Shader::Uniform("objectColor");
+}
+
+uint32_t GameObject::s_HierarchyVersion = 0;
+
 GameObject::GameObject(const std::string& name)
     : m_Name(name) {
+    m_Entity = Registry().CreateEntity(this);
 }
 
 GameObject::~GameObject() {
@@ -19,7 +29,10 @@ GameObject::~GameObject() {
     // Обнуляем родителя у своих детей
     for (auto& child : m_Children) {
         child->m_Parent = nullptr;
+        child->MarkWorldDirty();
     }
+    s_HierarchyVersion++;
+    Registry().DestroyEntity(m_Entity);
 }
 
 void GameObject::AddChild(std::shared_ptr<GameObject> child) {
@@ -33,123 +46,230 @@ void GameObject::AddChild(std::shared_ptr<GameObject> child) {
     }
 
     child->m_Parent = this;
+    child->m_IndexInParent = (uint32_t)m_Children.size();
     m_Children.push_back(child);
-    std::cout << "AddChild SUCCESS: " << child->GetName() << " added to " << m_Name 
-              << ", children count = " << m_Children.size() << std::endl;
-    std::cout << "DEBUG: AddChild выполнен, теперь у " << m_Name 
-    << " детей = " << m_Children.size() << std::endl;
+    child->MarkWorldDirty();
+    s_HierarchyVersion++;
 }
 
 void GameObject::RemoveChild(GameObject* child) {
-    auto it = std::find_if(m_Children.begin(), m_Children.end(),
-        [child](const std::shared_ptr<GameObject>& ptr) { return ptr.get() == child; });
-    if (it != m_Children.end()) {
-        (*it)->m_Parent = nullptr;
-        m_Children.erase(it);
-        std::cout << "Removed child: " << child->GetName() << " from " << m_Name << std::endl;
+    // O(1): ребёнок знает свой индекс, на его место встаёт последний
+    if (!child || child->m_Parent != this) return;
+    uint32_t index = child->m_IndexInParent;
+    if (index >= m_Children.size() || m_Children[index].get() != child) return;
+    std::shared_ptr<GameObject> removed = std::move(m_Children[index]);   // живёт до конца функции
+    if (index + 1 != m_Children.size()) {
+        m_Children[index] = std::move(m_Children.back());
+        m_Children[index]->m_IndexInParent = index;
     }
+    m_Children.pop_back();
+    child->m_Parent = nullptr;
+    child->MarkWorldDirty();
+    s_HierarchyVersion++;
 }
 
 glm::vec3 GameObject::GetWorldPosition() const {
-    if (m_Parent) {
-        return m_Parent->GetWorldPosition() + m_Position;
+    // Трансляция мировой матрицы: учитывает поворот и масштаб родителей
+    return glm::vec3(GetTransformMatrix()[3]);
+}
+
+const glm::mat4& GameObject::GetLocalMatrix() const {
+    TransformPool& transforms = Registry().transforms;
+    uint32_t index = TransformIndex();
+    if (transforms.flags[index] & TransformPool::kLocalDirty) {
+        transforms.locals[index] = TransformPool::ComposeLocal(
+            transforms.positions[index], transforms.rotations[index], transforms.scales[index]);
+        transforms.flags[index] &= ~TransformPool::kLocalDirty;
     }
-    return m_Position;
-}
-
-glm::mat4 GameObject::GetTransformMatrix() const {
-    glm::mat4 transform = glm::mat4(1.0f);
-    transform = glm::translate(transform, m_Position);
-    glm::mat4 rotation = glm::eulerAngleYXZ(
-        glm::radians(m_Rotation.y),
-        glm::radians(m_Rotation.x),
-        glm::radians(m_Rotation.z)
-    );
-    transform = transform * rotation;
-    transform = glm::scale(transform, m_Scale);
-    if (m_Parent) {
-        transform = m_Parent->GetTransformMatrix() * transform;
+    return transforms.locals[index];
+}
+
+const glm::mat4& GameObject::GetTransformMatrix() const {
+    TransformPool& transforms = Registry().transforms;
+    uint32_t index = TransformIndex();
+    if (transforms.flags[index] & TransformPool::kWorldDirty) {
+        // Рекурсия только по грязным предкам; в линейном проходе SceneManager их нет
+        glm::mat4 world = m_Parent ? m_Parent->GetTransformMatrix() * GetLocalMatrix() : GetLocalMatrix();
+        transforms.worlds[index] = world;
+        transforms.flags[index] &= ~TransformPool::kWorldDirty;
+    }
+    return transforms.worlds[index];
+}
+
+void GameObject::MarkTransformDirty() {
+    Registry().transforms.flags[TransformIndex()] |= TransformPool::kLocalDirty;
+    MarkWorldDirty();
+}
+
+void GameObject::MarkWorldDirty() {
+    uint8_t& flags = Registry().transforms.flags[TransformIndex()];
+    if (flags & TransformPool::kWorldDirty) return;   // потомки уже помечены
+    flags |= TransformPool::kWorldDirty | TransformPool::kBoundsDirty;
+    NotifyChanged(CHANGE_TRANSFORM);
+    for (auto& child : m_Children) {
+        child->MarkWorldDirty();
+    }
+}
+
+namespace {
+    const MeshRendererComponent s_DefaultRenderer;
+    const LightComponent s_DefaultLight;
+    const CameraComponent s_DefaultCamera;
+    const FogComponent s_DefaultFog;
+    const RigidBodyComponent s_DefaultBody;
+}
+
+const MeshRendererComponent& GameObject::RendererOrDefault() const {
+    const MeshRendererComponent* renderer = Registry().renderers.Get(m_Entity);
+    return renderer ? *renderer : s_DefaultRenderer;
+}
+
+const LightComponent& GameObject::LightOrDefault() const {
+    const LightComponent* light = Registry().lights.Get(m_Entity);
+    return light ? *light : s_DefaultLight;
+}
+
+const CameraComponent& GameObject::CameraOrDefault() const {
+    const CameraComponent* camera = Registry().cameras.Get(m_Entity);
+    return camera ? *camera : s_DefaultCamera;
+}
+
+const FogComponent& GameObject::FogOrDefault() const {
+    const FogComponent* fog = Registry().fogs.Get(m_Entity);
+    return fog ? *fog : s_DefaultFog;
+}
+
+const RigidBodyComponent& GameObject::BodyOrDefault() const {
+    const RigidBodyComponent* body = Registry().bodies.Get(m_Entity);
+    return body ? *body : s_DefaultBody;
+}
+
+void GameObject::SetMesh(std::shared_ptr<Mesh> mesh) {
+    Renderer().mesh = mesh;
+    Registry().transforms.flags[TransformIndex()] |= TransformPool::kBoundsDirty;
+    NotifyChanged(CHANGE_RENDERER);
+}
+
+void GameObject::SetLightType(int type) {
+    NotifyChanged(CHANGE_LIGHT);
+    if (type == LT_NONE) {
+        Registry().lights.Remove(m_Entity);
+        return;
     }
-    return transform;
+    Registry().lights.Add(m_Entity).type = type;
+}
+
+void GameObject::SetIsCamera(bool isCamera) {
+    if (isCamera) Registry().cameras.Add(m_Entity);
+    else Registry().cameras.Remove(m_Entity);
+    NotifyChanged(CHANGE_CAMERA);
+}
+
+void GameObject::SetIsFog(bool fog) {
+    if (fog) Registry().fogs.Add(m_Entity);
+    else Registry().fogs.Remove(m_Entity);
+    NotifyChanged(CHANGE_FOG);
+}
+
+AABB GameObject::GetWorldBounds() const {
+    const Mesh* mesh = GetMeshPtr();
+    if (!mesh) {
+        AABB point;
+        point.min = point.max = GetWorldPosition();
+        return point;
+    }
+    return mesh->GetBoundingBox().Transformed(GetTransformMatrix());
+}
+
+BoundingSphere GameObject::GetWorldBoundingSphere() const {
+    BoundingSphere sphere;
+    const Mesh* mesh = GetMeshPtr();
+    if (!mesh) {
+        sphere.center = GetWorldPosition();
+        return sphere;
+    }
+    glm::mat4 transform = GetTransformMatrix();
+    const BoundingSphere& local = mesh->GetBoundingSphere();
+    sphere.center = glm::vec3(transform * glm::vec4(local.center, 1.0f));
+    // Радиус масштабируется по наибольшей оси
+    float scale = (std::max)(glm::length(glm::vec3(transform[0])),
+                  (std::max)(glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2]))));
+    sphere.radius = local.radius * scale;
+    return sphere;
 }
 
 void GameObject::SetPosition(const glm::vec3& position) {
-    m_Position = position;
+    Registry().transforms.positions[TransformIndex()] = position;
+    MarkTransformDirty();
 }
 
 void GameObject::SetRotation(const glm::vec3& rotation) {
-    m_PreviousRotation = m_Rotation;
-    m_Rotation = rotation;
+    glm::vec3& value = Registry().transforms.rotations[TransformIndex()];
+    value = rotation;
     auto normalize = [](float angle) {
         while (angle > 180.0f) angle -= 360.0f;
         while (angle < -180.0f) angle += 360.0f;
         return angle;
     };
-    m_Rotation.x = normalize(m_Rotation.x);
-    m_Rotation.y = normalize(m_Rotation.y);
-    m_Rotation.z = normalize(m_Rotation.z);
+    value.x = normalize(value.x);
+    value.y = normalize(value.y);
+    value.z = normalize(value.z);
+    MarkTransformDirty();
 }
 
 void GameObject::SetScale(const glm::vec3& scale) {
-    m_Scale = scale;
-    if (m_Scale.x == 0.0f) m_Scale.x = 0.001f;
-    if (m_Scale.y == 0.0f) m_Scale.y = 0.001f;
-    if (m_Scale.z == 0.0f) m_Scale.z = 0.001f;
+    glm::vec3& value = Registry().transforms.scales[TransformIndex()];
+    value = scale;
+    if (value.x == 0.0f) value.x = 0.001f;
+    if (value.y == 0.0f) value.y = 0.001f;
+    if (value.z == 0.0f) value.z = 0.001f;
+    MarkTransformDirty();
     
     // Если есть коллайдер, пересоздаём его с новым масштабом
-    if (m_colliderType != COLLIDER_NONE) {
-        SetColliderType(m_colliderType);  // пересоздаст коллайдер и вызовет UpdatePhysicsBody
+    ColliderType collider = GetColliderType();
+    if (collider != COLLIDER_NONE) {
+        SetColliderType(collider);  // пересоздаст коллайдер и вызовет UpdatePhysicsBody
     }
 }
 
 void GameObject::Draw(Shader& shader) const {
-    if (!m_Visible || !m_Mesh) return;
+    const MeshRendererComponent& renderer = RendererOrDefault();
+    if (!renderer.visible || !renderer.mesh) return;
 
     glm::mat4 transform = GetTransformMatrix();
-    shader.SetMat4("model", glm::value_ptr(transform));
-    shader.SetBool("receiveShadows", m_ReceiveShadows);
-    shader.SetVec3("objectColor", m_Color.x, m_Color.y, m_Color.z);
-
-    // Выбираем материал: сначала свой, потом из меша
-    std::shared_ptr<Material> mat = m_Material;
-    if (!mat && m_Mesh) {
-        mat = m_Mesh->GetMaterial();
-    }
+    shader.SetMat4(u_Model, glm::value_ptr(transform));
+    shader.SetBool(u_ReceiveShadows, renderer.receiveShadows);
+    shader.SetVec3(u_ObjectColor, renderer.color.x, renderer.color.y, renderer.color.z);
 
+    std::shared_ptr<Material> mat = GetRenderMaterial();
     if (mat) {
-        shader.SetBool("hasDiffuseTexture", mat->HasDiffuse());
-        shader.SetBool("hasNormalMap", mat->HasNormal());
-        shader.SetFloat("metallic", mat->metallic);
-        shader.SetFloat("roughness", mat->roughness);
-        shader.SetVec2("uvScale", mat->uvScale.x, mat->uvScale.y);
-        shader.SetFloat("normalStrength", mat->normalStrength);
-        shader.SetBool("useWorldUV", mat->useWorldUV);
-        shader.SetVec3("emissionColor", mat->emissionColor.x, mat->emissionColor.y, mat->emissionColor.z);
-        shader.SetFloat("emissionIntensity", mat->emissionIntensity);
-
-        mat->BindTextures();
-        shader.SetInt("diffuseTexture", 0);
-        shader.SetInt("normalMap", 1);
-        shader.SetBool("hasRoughnessTexture", mat->HasRoughness());
-        shader.SetBool("hasMetallicTexture", mat->HasMetallic());
-        shader.SetBool("hasAOTexture", mat->HasAO());
-        shader.SetInt("roughnessTexture", 3);
-        shader.SetInt("metallicTexture", 4);
-        shader.SetInt("aoTexture", 5);
+        mat->Apply(shader);
     } else {
-        shader.SetBool("hasDiffuseTexture", false);
-        shader.SetBool("hasNormalMap", false);
-        shader.SetVec3("emissionColor", 0.0f, 0.0f, 0.0f);
-        shader.SetFloat("emissionIntensity", 0.0f);
+        Material::ApplyDefaults(shader);
     }
 
-    m_Mesh->Draw();
+    renderer.mesh->Draw();
 
     if (mat) {
         mat->UnbindTextures();
     }
 }
 
+std::shared_ptr<Material> GameObject::GetRenderMaterial() const {
+    // Выбираем материал: сначала свой, потом из меша
+    const MeshRendererComponent& renderer = RendererOrDefault();
+    if (renderer.material) return renderer.material;
+    if (renderer.mesh) return renderer.mesh->GetMaterial();
+    return nullptr;
+}
+
+const Material* GameObject::GetRenderMaterialPtr() const {
+    const MeshRendererComponent& renderer = RendererOrDefault();
+    if (renderer.material) return renderer.material.get();
+    if (renderer.mesh) return renderer.mesh->GetMaterial().get();
+    return nullptr;
+}
+
 glm::mat4 GameObject::GetCameraViewMatrix() const {
     glm::vec3 pos = GetWorldPosition();
     glm::mat4 transform = GetTransformMatrix();
@@ -160,7 +280,8 @@ glm::mat4 GameObject::GetCameraViewMatrix() const {
 }
 
 glm::mat4 GameObject::GetCameraProjectionMatrix(float aspectRatio) const {
-    return glm::perspective(glm::radians(m_CameraFOV), aspectRatio, m_CameraNear, m_CameraFar);
+    const CameraComponent& camera = CameraOrDefault();
+    return glm::perspective(glm::radians(camera.fov), aspectRatio, camera.nearPlane, camera.farPlane);
 }
 
 void GameObject::AddRigidBody(float mass) {
@@ -169,13 +290,13 @@ void GameObject::AddRigidBody(float mass) {
     return;
 }
     if (mass <= 0.0f) mass = 1.0f;
-    m_mass = mass;
+    Body().mass = mass;
     UpdatePhysicsBody();   // создаст динамическое тело
-    std::cout << "[Physics] " << m_Name << " became dynamic, mass=" << m_mass << std::endl;
+    std::cout << "[Physics] " << m_Name << " became dynamic, mass=" << mass << std::endl;
 }
 
 void GameObject::RemoveRigidBody() {
-    m_mass = 0.0f;          // статическое тело
+    Body().mass = 0.0f;     // статическое тело
     UpdatePhysicsBody();    // пересоздаст тело как статическое
     std::cout << "[Physics] " << m_Name << " became static" << std::endl;
 }
@@ -185,23 +306,25 @@ void GameObject::SetColliderType(ColliderType type) {
     std::cerr << "[Physics] Cannot set collider on '" << m_Name << "' because it has parent or children!" << std::endl;
     return;
 }
-    if (m_collisionShape) delete m_collisionShape;
-    m_colliderType = type;
+    RigidBodyComponent& body = Body();
+    NotifyChanged(CHANGE_BODY);
+    if (body.shape) delete body.shape;
+    body.collider = type;
     glm::vec3 scale = GetScale();
     std::cout << "SetColliderType: " << type << " scale=(" << scale.x << "," << scale.y << "," << scale.z << ")" << std::endl;
     
     switch (type) {
         case COLLIDER_BOX:
-            m_collisionShape = new btBoxShape(btVector3(scale.x * 0.5f, scale.y * 0.5f, scale.z * 0.5f));
+            body.shape = new btBoxShape(btVector3(scale.x * 0.5f, scale.y * 0.5f, scale.z * 0.5f));
             break;
         case COLLIDER_SPHERE:
-            m_collisionShape = new btSphereShape(scale.x * 0.5f);
+            body.shape = new btSphereShape(scale.x * 0.5f);
             break;
         case COLLIDER_CAPSULE:
-            m_collisionShape = new btCapsuleShape(scale.x * 0.5f, scale.y - scale.x);
+            body.shape = new btCapsuleShape(scale.x * 0.5f, scale.y - scale.x);
             break;
         default:
-            m_collisionShape = nullptr;
+            body.shape = nullptr;
             break;
     }
     
@@ -210,89 +333,105 @@ void GameObject::SetColliderType(ColliderType type) {
 }
 
 void GameObject::SetFriction(float friction) {
-    m_friction = friction;
-    if (m_rigidBody) {
-        m_rigidBody->setFriction(m_friction);
+    RigidBodyComponent& body = Body();
+    NotifyChanged(CHANGE_BODY);
+    body.friction = friction;
+    if (body.rigidBody) {
+        body.rigidBody->setFriction(body.friction);
     }
 }
 
 void GameObject::SetRestitution(float restitution) {
-    m_restitution = restitution;
-    if (m_rigidBody) {
-        m_rigidBody->setRestitution(m_restitution);
+    RigidBodyComponent& body = Body();
+    NotifyChanged(CHANGE_BODY);
+    body.restitution = restitution;
+    if (body.rigidBody) {
+        body.rigidBody->setRestitution(body.restitution);
     }
 }
 
 void GameObject::SetRollingFriction(float rollingFriction) {
-    m_rollingFriction = rollingFriction;
-    if (m_rigidBody) {
-        m_rigidBody->setRollingFriction(m_rollingFriction);
+    RigidBodyComponent& body = Body();
+    NotifyChanged(CHANGE_BODY);
+    body.rollingFriction = rollingFriction;
+    if (body.rigidBody) {
+        body.rigidBody->setRollingFriction(body.rollingFriction);
     }
 }
 
 void GameObject::SetLinearDamping(float damping) {
-    m_linearDamping = damping;
-    if (m_rigidBody) {
-        m_rigidBody->setDamping(m_linearDamping, m_angularDamping);
+    RigidBodyComponent& body = Body();
+    NotifyChanged(CHANGE_BODY);
+    body.linearDamping = damping;
+    if (body.rigidBody) {
+        body.rigidBody->setDamping(body.linearDamping, body.angularDamping);
     }
 }
 
 void GameObject::SetAngularDamping(float damping) {
-    m_angularDamping = damping;
-    if (m_rigidBody) {
-        m_rigidBody->setDamping(m_linearDamping, m_angularDamping);
+    RigidBodyComponent& body = Body();
+    NotifyChanged(CHANGE_BODY);
+    body.angularDamping = damping;
+    if (body.rigidBody) {
+        body.rigidBody->setDamping(body.linearDamping, body.angularDamping);
     }
 }
 
 void GameObject::SyncTransformToPhysics() {
-    if (!m_rigidBody) return;
+    btRigidBody* rigidBody = BodyOrDefault().rigidBody;
+    if (!rigidBody) return;
     btTransform trans;
-    m_rigidBody->getMotionState()->getWorldTransform(trans);
+    rigidBody->getMotionState()->getWorldTransform(trans);
     btVector3 pos = trans.getOrigin();
-    SetPosition(glm::vec3(pos.x(), pos.y(), pos.z()));
-    std::cout << "SyncTransformToPhysics: y = " << pos.y() << std::endl;
+    glm::vec3 position(pos.x(), pos.y(), pos.z());
+    // Та же позиция — без уведомления об изменении
+    if (position == GetPosition()) return;
+    SetPosition(position);
 }
 
 void GameObject::SyncPhysicsToTransform() {
-    if (!m_rigidBody) return;
+    btRigidBody* rigidBody = BodyOrDefault().rigidBody;
+    if (!rigidBody) return;
     btTransform trans;
     trans.setIdentity();
     glm::vec3 pos = GetWorldPosition();
     trans.setOrigin(btVector3(pos.x, pos.y, pos.z));
     glm::vec3 rot = GetRotation();
     trans.setRotation(btQuaternion(glm::radians(rot.y), glm::radians(rot.x), glm::radians(rot.z)));
-    m_rigidBody->getMotionState()->setWorldTransform(trans);
-    m_rigidBody->setCenterOfMassTransform(trans);
+    rigidBody->getMotionState()->setWorldTransform(trans);
+    rigidBody->setCenterOfMassTransform(trans);
+}
+
+void GameObject::DestroyPhysicsBody(RigidBodyComponent& body) {
+    if (!body.rigidBody) return;
+    PhysicsWorld::GetInstance().RemoveRigidBody(body.rigidBody);
+    delete body.rigidBody->getMotionState();
+    delete body.rigidBody;
+    body.rigidBody = nullptr;
+}
+
+void GameObject::ReleasePhysicsBody() {
+    if (RigidBodyComponent* body = Registry().bodies.Get(m_Entity)) {
+        if (body->rigidBody) NotifyChanged(CHANGE_BODY);
+        DestroyPhysicsBody(*body);
+    }
 }
 
 void GameObject::UpdatePhysicsBody() {
+    RigidBodyComponent& body = Body();
+    NotifyChanged(CHANGE_BODY);
     if (!CanHavePhysics()) {
-    if (m_rigidBody) {
-        PhysicsWorld::GetInstance().RemoveRigidBody(m_rigidBody);
-        delete m_rigidBody->getMotionState();
-        delete m_rigidBody;
-        m_rigidBody = nullptr;
+        DestroyPhysicsBody(body);
+        return;
     }
-    return;
-}
-    if (!m_collisionShape) {
+    if (!body.shape) {
         // Нет коллайдера — удаляем тело из мира, если оно было
-        if (m_rigidBody) {
-            PhysicsWorld::GetInstance().RemoveRigidBody(m_rigidBody);
-            delete m_rigidBody->getMotionState();
-            delete m_rigidBody;
-            m_rigidBody = nullptr;
-        }
+        DestroyPhysicsBody(body);
         return;
     }
 
     // Удаляем существующее тело, если есть
-    if (m_rigidBody) {
-        PhysicsWorld::GetInstance().RemoveRigidBody(m_rigidBody);
-        delete m_rigidBody->getMotionState();
-        delete m_rigidBody;
-        m_rigidBody = nullptr;
-    }
+    DestroyPhysicsBody(body);
 
     // Создаём новое тело (статическое или динамическое)
     btTransform startTransform;
@@ -304,29 +443,35 @@ void GameObject::UpdatePhysicsBody() {
 
     btDefaultMotionState* motionState = new btDefaultMotionState(startTransform);
     btVector3 inertia(0,0,0);
-    if (m_mass != 0.0f) {
-        m_collisionShape->calculateLocalInertia(m_mass, inertia);
+    if (body.mass != 0.0f) {
+        body.shape->calculateLocalInertia(body.mass, inertia);
     }
-    btRigidBody::btRigidBodyConstructionInfo rbInfo(m_mass, motionState, m_collisionShape, inertia);
-    m_rigidBody = new btRigidBody(rbInfo);
-    PhysicsWorld::GetInstance().AddRigidBody(m_rigidBody);
+    btRigidBody::btRigidBodyConstructionInfo rbInfo(body.mass, motionState, body.shape, inertia);
+    body.rigidBody = new btRigidBody(rbInfo);
+    PhysicsWorld::GetInstance().AddRigidBody(body.rigidBody);
     
     std::cout << "[Physics] UpdatePhysicsBody for " << m_Name 
-              << ", mass=" << m_mass 
-              << ", collider=" << (m_collisionShape ? "yes" : "no") 
+              << ", mass=" << body.mass 
+              << ", collider=" << (body.shape ? "yes" : "no") 
               << std::endl;
 
-    m_rigidBody->setFriction(m_friction);
-    m_rigidBody->setRestitution(m_restitution);
-    m_rigidBody->setRollingFriction(m_rollingFriction);
-    m_rigidBody->setDamping(m_linearDamping, m_angularDamping);          
+    body.rigidBody->setFriction(body.friction);
+    body.rigidBody->setRestitution(body.restitution);
+    body.rigidBody->setRollingFriction(body.rollingFriction);
+    body.rigidBody->setDamping(body.linearDamping, body.angularDamping);          
 }
 
 void GameObject::SetParent(std::shared_ptr<GameObject> newParent, bool keepWorldPosition) {
-    if (newParent.get() == this) return;
-    if (newParent && newParent.get() == m_Parent) return;
+    if (!AttachToParent(newParent.get(), keepWorldPosition)) return;
+    std::cout << "SetParent: " << GetName() << " parent is " << (m_Parent ? m_Parent->GetName() : "null") << std::endl;
+}
 
-    glm::mat4 worldMat = GetTransformMatrix();
+bool GameObject::AttachToParent(GameObject* newParent, bool keepWorldPosition) {
+    if (newParent == this) return false;
+    if (newParent && newParent == m_Parent) return false;
+
+    // Мировая матрица нужна только для сохранения мировой позиции
+    glm::mat4 worldMat = keepWorldPosition ? GetTransformMatrix() : glm::mat4(1.0f);
 
     // Открепляемся от старого родителя
     if (m_Parent) {
@@ -336,13 +481,15 @@ void GameObject::SetParent(std::shared_ptr<GameObject> newParent, bool keepWorld
 
     // Прикрепляемся к новому
     if (newParent) {
-        m_Parent = newParent.get();
+        m_Parent = newParent;
         // Прямое добавление в вектор (обход AddChild)
+        m_IndexInParent = (uint32_t)newParent->m_Children.size();
         newParent->m_Children.push_back(shared_from_this());
-        std::cout << "DIRECT ADD: parent " << newParent->GetName() 
-                  << " now has " << newParent->m_Children.size() << " children" << std::endl;
+        s_HierarchyVersion++;
     }
 
+    MarkWorldDirty();
+
     // Если нужно сохранить мировую позицию, пересчитываем локальную
     if (keepWorldPosition && m_Parent) {
         glm::mat4 parentInv = glm::inverse(m_Parent->GetTransformMatrix());
@@ -355,8 +502,7 @@ void GameObject::SetParent(std::shared_ptr<GameObject> newParent, bool keepWorld
         SetRotation(glm::degrees(glm::eulerAngles(rot)));
         SetScale(scale);
     }
-
-   std::cout << "SetParent: " << GetName() << " parent is " << (m_Parent ? m_Parent->GetName() : "null") << std::endl;
+    return true;
 }
 
 bool GameObject::CanHavePhysics() const {
@@ -383,7 +529,7 @@ void GameObject::Unparent() {
     SetScale(scale);
 
     // Если была физика – удаляем (на всякий случай)
-    if (!CanHavePhysics() && m_rigidBody) {
+    if (!CanHavePhysics() && HasRigidBody()) {
         RemoveRigidBody();
     }
 }
@@ -398,9 +544,9 @@ void GameObject::ResetToInitialTransform() {
     SetPosition(m_initialPosition);
     SetRotation(m_initialRotation);
     SetScale(m_initialScale);
-    if (m_rigidBody) {
+    if (btRigidBody* rigidBody = BodyOrDefault().rigidBody) {
         SyncPhysicsToTransform();
-        m_rigidBody->setLinearVelocity(btVector3(0,0,0));
-        m_rigidBody->setAngularVelocity(btVector3(0,0,0));
+        rigidBody->setLinearVelocity(btVector3(0,0,0));
+        rigidBody->setAngularVelocity(btVector3(0,0,0));
     }
 }
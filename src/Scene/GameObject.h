@@ -6,6 +6,7 @@
 #include "Graphics/Shader.h"
 #include "Graphics/Mesh.h"
 #include "Graphics/Material.h"   
+#include "Scene/SceneRegistry.h"
 #include <glm/gtc/quaternion.hpp>
 
 class btRigidBody;
@@ -32,6 +33,7 @@ public:
 
     // Иерархия
     void AddChild(std::shared_ptr<GameObject> child);
+    // O(1), порядок остальных детей может измениться (на место удалённого встаёт последний)
     void RemoveChild(GameObject* child);
     GameObject* GetParent() const { return m_Parent; }
     const std::vector<std::shared_ptr<GameObject>>& GetChildren() const { return m_Children; }
@@ -42,156 +44,172 @@ public:
     // Управление иерархией
     void Unparent();  // открепить от родителя, сохранив мировую трансформацию
     void SetParent(std::shared_ptr<GameObject> newParent, bool keepWorldPosition = true);
+    // То же без вывода в лог (пакетные операции SceneManager); false — ничего не изменилось.
+    // Циклы не проверяются — это делает вызывающий.
+    bool AttachToParent(GameObject* newParent, bool keepWorldPosition);
 
     // Трансформация
     void SetPosition(const glm::vec3& position);
     void SetRotation(const glm::vec3& rotation);
     void SetScale(const glm::vec3& scale);
-    glm::vec3 GetPosition() const { return m_Position; }
-    glm::vec3 GetRotation() const { return m_Rotation; }
-    glm::vec3 GetScale() const { return m_Scale; }
+    glm::vec3 GetPosition() const { return Registry().transforms.positions[TransformIndex()]; }
+    glm::vec3 GetRotation() const { return Registry().transforms.rotations[TransformIndex()]; }
+    glm::vec3 GetScale() const { return Registry().transforms.scales[TransformIndex()]; }
     glm::vec3 GetWorldPosition() const;
-    glm::mat4 GetTransformMatrix() const;
-
-    // Меш и видимость
-    void SetMesh(std::shared_ptr<Mesh> mesh) { m_Mesh = mesh; }
-    std::shared_ptr<Mesh> GetMesh() const { return m_Mesh; }
-    void SetVisible(bool visible) { m_Visible = visible; }
-    bool IsVisible() const { return m_Visible; }
+    // Локальная и мировая матрицы кэшируются в TransformPool и пересчитываются
+    // только после изменения своей трансформации или трансформации предка.
+    // Ссылка действительна до создания/удаления сущностей и перестройки порядка пула.
+    const glm::mat4& GetLocalMatrix() const;
+    const glm::mat4& GetTransformMatrix() const;
+    // Мировые границы изменились с последнего обновления пространственного индекса
+    bool IsBoundsDirty() const { return (Registry().transforms.flags[TransformIndex()] & TransformPool::kBoundsDirty) != 0; }
+    void ClearBoundsDirty() { Registry().transforms.flags[TransformIndex()] &= ~TransformPool::kBoundsDirty; }
+    // Меняется при любом изменении иерархии (для кэша порядка обхода)
+    static uint32_t GetHierarchyVersion() { return s_HierarchyVersion; }
+    // Сущность в SceneRegistry (данные компонентов)
+    Entity GetEntity() const { return m_Entity; }
+    // Ссылка, которая перестаёт резолвиться после удаления объекта
+    EntityHandle GetHandle() const { return Registry().GetHandle(m_Entity); }
+
+    // Меш и видимость (компонент MeshRenderer)
+    void SetMesh(std::shared_ptr<Mesh> mesh);
+    std::shared_ptr<Mesh> GetMesh() const { return RendererOrDefault().mesh; }
+    // Без копирования shared_ptr — для горячих циклов
+    Mesh* GetMeshPtr() const { return RendererOrDefault().mesh.get(); }
+    void SetVisible(bool visible) { Renderer().visible = visible; NotifyChanged(CHANGE_RENDERER); }
+    bool IsVisible() const { return RendererOrDefault().visible; }
+    // Мировые границы меша (по GetTransformMatrix); без меша — точка в позиции
+    AABB GetWorldBounds() const;
+    BoundingSphere GetWorldBoundingSphere() const;
+    // Прокси в пространственном индексе SceneManager (-1 — не зарегистрирован)
+    int GetSpatialProxy() const { return Registry().transforms.spatialProxies[TransformIndex()]; }
+    void SetSpatialProxy(int proxy) { Registry().transforms.spatialProxies[TransformIndex()] = proxy; }
 
     // Имя и цвет
     void SetName(const std::string& name) { m_Name = name; }
     std::string GetName() const { return m_Name; }
-    void SetColor(const glm::vec3& color) { m_Color = color; }
-    glm::vec3 GetColor() const { return m_Color; }
+    void SetColor(const glm::vec3& color) { Renderer().color = color; NotifyChanged(CHANGE_RENDERER); }
+    glm::vec3 GetColor() const { return RendererOrDefault().color; }
 
     // Материал
-    void SetMaterial(std::shared_ptr<Material> mat) { m_Material = mat; }
-    std::shared_ptr<Material> GetMaterial() const { return m_Material; }
+    void SetMaterial(std::shared_ptr<Material> mat) { Renderer().material = mat; NotifyChanged(CHANGE_RENDERER); }
+    std::shared_ptr<Material> GetMaterial() const { return RendererOrDefault().material; }
+    // Материал, с которым объект реально рисуется (свой или из меша)
+    std::shared_ptr<Material> GetRenderMaterial() const;
+    const Material* GetRenderMaterialPtr() const;
 
     // Отрисовка
     void Draw(Shader& shader) const;
     
-    void SetCastShadows(bool cast) { m_CastShadows = cast; }
-    bool CastShadows() const { return m_CastShadows; }
-    void SetReceiveShadows(bool receive) { m_ReceiveShadows = receive; }
-    bool ReceiveShadows() const { return m_ReceiveShadows; }
-
-    // Light
-    void SetLightType(int type) { m_LightType = type; }
-    int GetLightType() const { return m_LightType; }
-    void SetLightColor(const glm::vec3& color) { m_LightColor = color; }
-    glm::vec3 GetLightColor() const { return m_LightColor; }
-    void SetLightIntensity(float intensity) { m_LightIntensity = intensity; }
-    float GetLightIntensity() const { return m_LightIntensity; }
-    void SetLightRange(float range) { m_LightRange = range; }
-    float GetLightRange() const { return m_LightRange; }
-    void SetLightAngle(float angleDeg) { m_LightAngle = glm::radians(angleDeg); }
-    float GetLightAngleDeg() const { return glm::degrees(m_LightAngle); }
-    void SetLightDirection(const glm::vec3& dir) { m_LightDirection = glm::normalize(dir); }
-    glm::vec3 GetLightDirection() const { return m_LightDirection; }
-
-    // Camera
-    bool IsCamera() const { return m_IsCamera; }
-    void SetIsCamera(bool isCamera) { m_IsCamera = isCamera; }
-    float GetCameraFOV() const { return m_CameraFOV; }
-    void SetCameraFOV(float fov) { m_CameraFOV = fov; }
-    float GetCameraNear() const { return m_CameraNear; }
-    void SetCameraNear(float nearVal) { m_CameraNear = nearVal; }
-    float GetCameraFar() const { return m_CameraFar; }
-    void SetCameraFar(float farVal) { m_CameraFar = farVal; }
+    void SetCastShadows(bool cast) { Renderer().castShadows = cast; NotifyChanged(CHANGE_RENDERER); }
+    bool CastShadows() const { return RendererOrDefault().castShadows; }
+    void SetReceiveShadows(bool receive) { Renderer().receiveShadows = receive; NotifyChanged(CHANGE_RENDERER); }
+    bool ReceiveShadows() const { return RendererOrDefault().receiveShadows; }
+    // Уровень детализации выбирает рендер каждый кадр: не изменение сцены
+    void SetLod(int lod) { Renderer().lod = (uint8_t)lod; }
+    int GetLod() const { return RendererOrDefault().lod; }
+
+    // Light (компонент есть, пока тип не LT_NONE; без него сеттеры ничего не делают)
+    void SetLightType(int type);
+    int GetLightType() const { return LightOrDefault().type; }
+    void SetLightColor(const glm::vec3& color) { if (LightComponent* l = Light()) { l->color = color; NotifyChanged(CHANGE_LIGHT); } }
+    glm::vec3 GetLightColor() const { return LightOrDefault().color; }
+    void SetLightIntensity(float intensity) { if (LightComponent* l = Light()) { l->intensity = intensity; NotifyChanged(CHANGE_LIGHT); } }
+    float GetLightIntensity() const { return LightOrDefault().intensity; }
+    void SetLightRange(float range) { if (LightComponent* l = Light()) { l->range = range; NotifyChanged(CHANGE_LIGHT); } }
+    float GetLightRange() const { return LightOrDefault().range; }
+    void SetLightAngle(float angleDeg) { if (LightComponent* l = Light()) { l->angle = glm::radians(angleDeg); NotifyChanged(CHANGE_LIGHT); } }
+    float GetLightAngleDeg() const { return glm::degrees(LightOrDefault().angle); }
+    void SetLightDirection(const glm::vec3& dir) { if (LightComponent* l = Light()) { l->direction = glm::normalize(dir); NotifyChanged(CHANGE_LIGHT); } }
+    glm::vec3 GetLightDirection() const { return LightOrDefault().direction; }
+
+    // Camera (компонент есть, пока IsCamera)
+    bool IsCamera() const { return Registry().cameras.Has(m_Entity); }
+    void SetIsCamera(bool isCamera);
+    float GetCameraFOV() const { return CameraOrDefault().fov; }
+    void SetCameraFOV(float fov) { if (CameraComponent* c = Camera()) { c->fov = fov; NotifyChanged(CHANGE_CAMERA); } }
+    float GetCameraNear() const { return CameraOrDefault().nearPlane; }
+    void SetCameraNear(float nearVal) { if (CameraComponent* c = Camera()) { c->nearPlane = nearVal; NotifyChanged(CHANGE_CAMERA); } }
+    float GetCameraFar() const { return CameraOrDefault().farPlane; }
+    void SetCameraFar(float farVal) { if (CameraComponent* c = Camera()) { c->farPlane = farVal; NotifyChanged(CHANGE_CAMERA); } }
     glm::mat4 GetCameraViewMatrix() const;
     glm::mat4 GetCameraProjectionMatrix(float aspectRatio) const;
 
-    // Physics
+    // Physics (компонент RigidBody создаётся при первой записи)
     void AddRigidBody(float mass = 1.0f);
     void RemoveRigidBody();
-    bool HasRigidBody() const { return m_rigidBody != nullptr; }
-    float GetMass() const { return m_mass; }
-    void SetMass(float mass) { m_mass = mass; }
+    bool HasRigidBody() const { return BodyOrDefault().rigidBody != nullptr; }
+    float GetMass() const { return BodyOrDefault().mass; }
+    void SetMass(float mass) { Body().mass = mass; NotifyChanged(CHANGE_BODY); }
     void SetColliderType(ColliderType type);
-    ColliderType GetColliderType() const { return m_colliderType; }
+    ColliderType GetColliderType() const { return (ColliderType)BodyOrDefault().collider; }
     void SyncTransformToPhysics();
     void SyncPhysicsToTransform();
     void SaveInitialTransform();
     void ResetToInitialTransform();
     void SetFriction(float friction);
-    float GetFriction() const { return m_friction; }
+    float GetFriction() const { return BodyOrDefault().friction; }
     void SetRestitution(float restitution);
-    float GetRestitution() const { return m_restitution; }
+    float GetRestitution() const { return BodyOrDefault().restitution; }
     void SetRollingFriction(float rollingFriction);
-    float GetRollingFriction() const { return m_rollingFriction; }
+    float GetRollingFriction() const { return BodyOrDefault().rollingFriction; }
     void SetLinearDamping(float damping);
-    float GetLinearDamping() const { return m_linearDamping; }
+    float GetLinearDamping() const { return BodyOrDefault().linearDamping; }
     void SetAngularDamping(float damping);
-    float GetAngularDamping() const { return m_angularDamping; }
-    btRigidBody* GetRigidBody() { return m_rigidBody; }
+    float GetAngularDamping() const { return BodyOrDefault().angularDamping; }
+    btRigidBody* GetRigidBody() { return BodyOrDefault().rigidBody; }
     void UpdatePhysicsBody();
-
-    // В public секцию
-    void SetIsFog(bool fog) { m_IsFog = fog; }
-    bool IsFog() const { return m_IsFog; }
-
-    void SetFogEnabled(bool enabled) { m_FogEnabled = enabled; }
-    bool GetFogEnabled() const { return m_FogEnabled; }
-    void SetFogType(int type) { m_FogType = type; }
-    int GetFogType() const { return m_FogType; }
-    void SetFogColor(const glm::vec3& color) { m_FogColor = color; }
-    glm::vec3 GetFogColor() const { return m_FogColor; }
-    void SetFogDensity(float density) { m_FogDensity = density; }
-    float GetFogDensity() const { return m_FogDensity; }
-    void SetFogLinearStart(float start) { m_FogLinearStart = start; }
-    float GetFogLinearStart() const { return m_FogLinearStart; }
-    void SetFogLinearEnd(float end) { m_FogLinearEnd = end; }
-    float GetFogLinearEnd() const { return m_FogLinearEnd; }
+    // Убирает тело из мира физики; коллайдер и параметры остаются
+    void ReleasePhysicsBody();
+
+    // Fog (компонент есть, пока IsFog)
+    void SetIsFog(bool fog);
+    bool IsFog() const { return Registry().fogs.Has(m_Entity); }
+
+    void SetFogEnabled(bool enabled) { if (FogComponent* f = Fog()) { f->enabled = enabled; NotifyChanged(CHANGE_FOG); } }
+    bool GetFogEnabled() const { return FogOrDefault().enabled; }
+    void SetFogType(int type) { if (FogComponent* f = Fog()) { f->type = type; NotifyChanged(CHANGE_FOG); } }
+    int GetFogType() const { return FogOrDefault().type; }
+    void SetFogColor(const glm::vec3& color) { if (FogComponent* f = Fog()) { f->color = color; NotifyChanged(CHANGE_FOG); } }
+    glm::vec3 GetFogColor() const { return FogOrDefault().color; }
+    void SetFogDensity(float density) { if (FogComponent* f = Fog()) { f->density = density; NotifyChanged(CHANGE_FOG); } }
+    float GetFogDensity() const { return FogOrDefault().density; }
+    void SetFogLinearStart(float start) { if (FogComponent* f = Fog()) { f->linearStart = start; NotifyChanged(CHANGE_FOG); } }
+    float GetFogLinearStart() const { return FogOrDefault().linearStart; }
+    void SetFogLinearEnd(float end) { if (FogComponent* f = Fog()) { f->linearEnd = end; NotifyChanged(CHANGE_FOG); } }
+    float GetFogLinearEnd() const { return FogOrDefault().linearEnd; }
 
 private:
+    // Данные компонентов живут в SceneRegistry; здесь — только имя и иерархия
+    Entity m_Entity = kNullEntity;
     std::string m_Name;
     GameObject* m_Parent = nullptr;
+    uint32_t m_IndexInParent = 0;       // позиция в m_Parent->m_Children
     std::vector<std::shared_ptr<GameObject>> m_Children;
 
-    glm::vec3 m_Position = glm::vec3(0.0f);
-    glm::vec3 m_Rotation = glm::vec3(0.0f);
-    glm::vec3 m_Scale = glm::vec3(1.0f);
-    std::shared_ptr<Mesh> m_Mesh;
-    glm::vec3 m_Color = glm::vec3(1.0f);
-    bool m_Visible = true;
-    bool m_CastShadows = true;
-    bool m_ReceiveShadows = true;
-    std::shared_ptr<Material> m_Material;
-    glm::vec3 m_PreviousRotation = glm::vec3(0.0f);
-
-    int m_LightType = LT_NONE;
-    glm::vec3 m_LightColor = glm::vec3(1.0f);
-    float m_LightIntensity = 1.0f;
-    float m_LightRange = 10.0f;
-    float m_LightAngle = glm::radians(45.0f);
-    glm::vec3 m_LightDirection = glm::vec3(0.0f, -1.0f, 0.0f);
-
-    bool m_IsCamera = false;
-    float m_CameraFOV = 45.0f;
-    float m_CameraNear = 0.1f;
-    float m_CameraFar = 100.0f;
-
-    btRigidBody* m_rigidBody = nullptr;
-    btCollisionShape* m_collisionShape = nullptr;
-    ColliderType m_colliderType = COLLIDER_NONE;
-    float m_mass = 0.0f;
-
-    float m_friction = 0.5f;
-    float m_restitution = 0.5f;
-    float m_rollingFriction = 0.1f;
-    float m_linearDamping = 0.0f;
-    float m_angularDamping = 0.0f;
-
-    // В private секцию (в конец списка полей)
-    bool m_IsFog = false;
-    bool m_FogEnabled = false;
-    int m_FogType = 1;          // 1=Linear, 2=Exponential, 3=Exponential Squared
-    glm::vec3 m_FogColor = glm::vec3(0.5f, 0.6f, 0.7f);
-    float m_FogDensity = 0.04f;
-    float m_FogLinearStart = 10.0f;
-    float m_FogLinearEnd = 50.0f;
+    static SceneRegistry& Registry() { return SceneRegistry::Get(); }
+    void NotifyChanged(uint32_t flags) const { Registry().NotifyChanged(m_Entity, flags); }
+    uint32_t TransformIndex() const { return Registry().transforms.Index(m_Entity); }
+    // Инвариант кэша: если мировая матрица грязная, то грязные и у всех
+    // потомков — поэтому распространение останавливается на первом таком узле
+    static uint32_t s_HierarchyVersion;
+    void MarkTransformDirty();
+    void MarkWorldDirty();
+
+    // Доступ к компонентам: *OrDefault — для чтения (значения по умолчанию без
+    // компонента), Renderer()/Body() создают компонент, Light()/Camera()/Fog() — нет
+    const MeshRendererComponent& RendererOrDefault() const;
+    MeshRendererComponent& Renderer() { return Registry().renderers.Add(m_Entity); }
+    const LightComponent& LightOrDefault() const;
+    LightComponent* Light() { return Registry().lights.Get(m_Entity); }
+    const CameraComponent& CameraOrDefault() const;
+    CameraComponent* Camera() { return Registry().cameras.Get(m_Entity); }
+    const FogComponent& FogOrDefault() const;
+    FogComponent* Fog() { return Registry().fogs.Get(m_Entity); }
+    const RigidBodyComponent& BodyOrDefault() const;
+    RigidBodyComponent& Body() { return Registry().bodies.Add(m_Entity); }
+    // Убирает тело из мира физики и удаляет его (форма остаётся)
+    static void DestroyPhysicsBody(RigidBodyComponent& body);
 
     glm::vec3 m_initialPosition;
     glm::vec3 m_initialRotation;
@@ -1,13 +1,34 @@
 #include "Scene/SceneManager.h"
+#include "Scene/SceneSerializer.h"
 #include "Graphics/Primitives.h"
+#include "Graphics/MeshRegistry.h"
 #include "Graphics/Material.h"
+#include "Core/Parallel.h"
 #include <iostream>
 #include <fstream>
 #include <memory>
+#include <cstring>
+#include <chrono>
+#include <algorithm>
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include "Physics/PhysicsWorld.h"
 
+namespace {
+    const Shader::UniformID u_Model = Shader::Uniform("model");
+    const Shader::UniformID u_UseInstancing = Shader::Uniform("useInstancing");
+    const Shader::UniformID u_ReceiveShadows = Shader::Uniform("receiveShadows");
+    const Shader::UniformID u_ObjectColor = Shader::Uniform("objectColor");
+    const Shader::UniformID u_UseMaterialTable = Shader::Uniform("useMaterialTable");
+    const Shader::UniformID u_MaterialIndex = Shader::Uniform("materialIndex");
+
+    enum MeshletVisibility : uint8_t {
+        MESHLET_FRUSTUM_CULLED,
+        MESHLET_VISIBLE,
+        MESHLET_BACKFACE_CULLED
+    };
+}
+
 SceneManager::SceneManager() {
     m_Initialized = false;
 }
@@ -23,6 +44,7 @@ void SceneManager::Initialize() {
     std::cout << "Initializing SceneManager..." << std::endl;
 
     m_GridMesh = Primitives::CreateGrid(500);   // 500x500 юнитов
+    m_MaterialTable.Initialize();
 
     auto light = CreateGameObject("DirectionalLight");
     light->SetLightType(LT_DIRECTIONAL);        
@@ -32,13 +54,17 @@ void SceneManager::Initialize() {
     light->SetPosition(glm::vec3(2.0f, 4.0f, 2.0f)); // позиция не важна для directional, но для визуализации ок
     light->SetColor(glm::vec3(1.0f, 1.0f, 1.0f));
     light->SetScale(glm::vec3(0.3f));
-    light->SetMesh(Primitives::CreateCube());
+    light->SetMesh(MeshRegistry::Get().GetPrimitive(PRIMITIVE_CUBE));
     light->SetLightDirection(glm::normalize(glm::vec3(-1.0f, -2.0f, -1.0f)));
 
     SetSelectedObject(light);
+    CreateDefaultCamera();
+
     m_Initialized = true;
     std::cout << "SceneManager initialized with " << m_Objects.size() << " objects" << std::endl;
+}
 
+void SceneManager::CreateDefaultCamera() {
     auto mainCamera = CreateGameObject("Scene Camera");
     mainCamera->SetIsCamera(true);
     mainCamera->SetPosition(glm::vec3(0.0f, 2.0f, 5.0f));
@@ -47,8 +73,13 @@ void SceneManager::Initialize() {
     mainCamera->SetCameraNear(0.1f);
     mainCamera->SetCameraFar(100.0f);
     SetActiveCamera(mainCamera);
+}
 
-    m_Initialized = true;
+void SceneManager::SetTextureArraysEnabled(bool enabled) {
+    if (m_TextureArrays == enabled) return;
+    m_TextureArrays = enabled;
+    // Пулы дублируют текстуры материалов — при выключении освобождаем память
+    if (!enabled) m_MaterialTable.Clear();
 }
 
 void SceneManager::SetSelectedObject(std::shared_ptr<GameObject> object) {
@@ -57,83 +88,923 @@ void SceneManager::SetSelectedObject(std::shared_ptr<GameObject> object) {
 
 std::shared_ptr<GameObject> SceneManager::CreateGameObject(const std::string& name) {
     auto obj = std::make_shared<GameObject>(name);
+    Entity e = obj->GetEntity();
+    if (e >= m_ObjectSlots.size()) m_ObjectSlots.resize((size_t)e + 1, kNoSlot);
+    m_ObjectSlots[e] = (uint32_t)m_Objects.size();
     m_Objects.push_back(obj);
+    SceneRegistry::Get().SetInScene(e, true);
+    m_TransformOrderDirty = true;
     return obj;
 }
 
+int SceneManager::GetObjectSlot(const GameObject* object) const {
+    if (!object) return -1;
+    Entity e = object->GetEntity();
+    if (e >= m_ObjectSlots.size() || m_ObjectSlots[e] == kNoSlot) return -1;
+    uint32_t slot = m_ObjectSlots[e];
+    // Сущность могла быть переиспользована другим объектом
+    return m_Objects[slot].get() == object ? (int)slot : -1;
+}
+
+std::shared_ptr<GameObject> SceneManager::FindGameObjectByPtr(GameObject* ptr) {
+    int slot = GetObjectSlot(ptr);
+    return slot >= 0 ? m_Objects[slot] : nullptr;
+}
+
+std::shared_ptr<GameObject> SceneManager::FindGameObject(EntityHandle handle) const {
+    if (!SceneRegistry::Get().IsAlive(handle) || handle.id >= m_ObjectSlots.size()) return nullptr;
+    uint32_t slot = m_ObjectSlots[handle.id];
+    return slot != kNoSlot ? m_Objects[slot] : nullptr;
+}
+
 void SceneManager::DeleteGameObject(GameObject* object) {
     if (!object) return;
+    DeleteGameObjects({ object });
+}
 
-    // Если удаляемый объект является выбранным, сбрасываем выделение
-    if (m_SelectedObject.get() == object) {
-        m_SelectedObject.reset();
-    }
+void SceneManager::DeleteGameObjects(const std::vector<GameObject*>& objects) {
+    auto start = std::chrono::high_resolution_clock::now();
 
-    // Если объект имеет родителя, открепляем его
-    if (object->GetParent()) {
-        object->GetParent()->RemoveChild(object);
+    // Собираем удаляемые поддеревья без повторов: объект, выбранный вместе со
+    // своим предком, встретится один раз. Отметки — по слоту в m_Objects.
+    std::vector<uint8_t> marked(m_Objects.size(), 0);
+    std::vector<GameObject*> doomed;
+    std::vector<GameObject*> detachRoots;
+    std::vector<GameObject*> stack;
+    for (GameObject* object : objects) {
+        int slot = GetObjectSlot(object);
+        if (slot < 0 || marked[slot]) continue;
+        stack.push_back(object);
+        while (!stack.empty()) {
+            GameObject* node = stack.back();
+            stack.pop_back();
+            int nodeSlot = GetObjectSlot(node);
+            if (nodeSlot < 0 || marked[nodeSlot]) continue;
+            marked[nodeSlot] = 1;
+            doomed.push_back(node);
+            for (const auto& child : node->GetChildren()) stack.push_back(child.get());
+        }
+    }
+    if (doomed.empty()) return;
+    // Открепляются только корни поддеревьев; внутренние связи уйдут вместе с объектами
+    for (GameObject* node : doomed) {
+        GameObject* parent = node->GetParent();
+        if (!parent) continue;
+        int parentSlot = GetObjectSlot(parent);
+        if (parentSlot < 0 || !marked[parentSlot]) detachRoots.push_back(node);
     }
+    for (GameObject* node : detachRoots) node->GetParent()->RemoveChild(node);
+
+    SceneRegistry& registry = SceneRegistry::Get();
+    std::vector<std::shared_ptr<GameObject>> released;
+    released.reserve(doomed.size());
+    for (GameObject* node : doomed) {
+        if (node->GetSpatialProxy() != AABBTree::kNullNode) {
+            m_SpatialTree.DestroyProxy(node->GetSpatialProxy());
+            node->SetSpatialProxy(AABBTree::kNullNode);
+        }
+        // Если удаляемый объект является выбранным, сбрасываем выделение
+        if (m_SelectedObject.get() == node) {
+            m_SelectedObject.reset();
+        }
+        registry.SetInScene(node->GetEntity(), false);
+        // Удалённый объект не должен оставаться в симуляции
+        node->ReleasePhysicsBody();
 
-    // Рекурсивно удаляем всех детей (они уже будут удалены из списков родителей)
-    for (auto& child : object->GetChildren()) {
-        DeleteGameObject(child.get());
+        // swap-and-pop: на место удалённого встаёт последний объект
+        uint32_t slot = m_ObjectSlots[node->GetEntity()];
+        uint32_t last = (uint32_t)m_Objects.size() - 1;
+        released.push_back(std::move(m_Objects[slot]));
+        if (slot != last) {
+            m_Objects[slot] = std::move(m_Objects[last]);
+            m_ObjectSlots[m_Objects[slot]->GetEntity()] = slot;
+        }
+        m_Objects.pop_back();
+        m_ObjectSlots[node->GetEntity()] = kNoSlot;
     }
+    m_TransformOrderDirty = true;
+    size_t count = released.size();
+    released.clear();   // здесь разрушаются объекты, на которые больше никто не ссылается
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "[Scene] Deleted " << count << " objects in "
+              << std::chrono::duration<float, std::milli>(end - start).count() << " ms" << std::endl;
+}
 
-    // Удаляем из общего списка
-    auto it = std::find_if(m_Objects.begin(), m_Objects.end(),
-        [object](const std::shared_ptr<GameObject>& ptr) { return ptr.get() == object; });
-    if (it != m_Objects.end()) {
-        m_Objects.erase(it);
+std::vector<std::shared_ptr<GameObject>> SceneManager::DuplicateGameObjects(const std::vector<GameObject*>& objects,
+                                                                            const glm::vec3& offset) {
+    std::vector<std::shared_ptr<GameObject>> copies;
+    copies.reserve(objects.size());
+    m_Objects.reserve(m_Objects.size() + objects.size());
+    for (GameObject* source : objects) {
+        if (GetObjectSlot(source) < 0) continue;
+        // Запрещаем дублировать направленный свет (можно и другие типы разрешить)
+        if (source->GetLightType() == LT_DIRECTIONAL) {
+            std::cerr << "Cannot duplicate Directional Light" << std::endl;
+            continue;
+        }
+        auto newObj = CreateGameObject(source->GetName() + " (Copy)");
+        newObj->SetMesh(source->GetMesh());
+        newObj->SetPosition(source->GetPosition() + offset);
+        newObj->SetRotation(source->GetRotation());
+        newObj->SetScale(source->GetScale());
+        newObj->SetColor(source->GetColor());
+        if (source->GetMaterial()) {
+            newObj->SetMaterial(source->GetMaterial());
+        }
+        // Копируем параметры света
+        newObj->SetLightType(source->GetLightType());
+        newObj->SetLightColor(source->GetLightColor());
+        newObj->SetLightIntensity(source->GetLightIntensity());
+        newObj->SetLightRange(source->GetLightRange());
+        newObj->SetLightAngle(source->GetLightAngleDeg());
+        newObj->SetLightDirection(source->GetLightDirection());
+        // Копия — соседка оригинала, локальная трансформация та же
+        if (source->GetParent()) newObj->AttachToParent(source->GetParent(), false);
+        copies.push_back(newObj);
     }
+    return copies;
 }
 
 void SceneManager::DuplicateSelectedObject() {
     if (!m_SelectedObject) return;
-    // Запрещаем дублировать DirectionalLight (можно и другие типы разрешить)
-    if (m_SelectedObject->GetName() == "DirectionalLight") {
-        std::cerr << "Cannot duplicate Directional Light" << std::endl;
-        return;
+    auto copies = DuplicateGameObjects({ m_SelectedObject.get() }, glm::vec3(1.0f, 0.0f, 0.0f));
+    if (!copies.empty()) SetSelectedObject(copies.front());
+}
+
+int SceneManager::ReparentGameObjects(const std::vector<GameObject*>& objects, GameObject* newParent,
+                                      bool keepWorldPosition) {
+    if (newParent && GetObjectSlot(newParent) < 0) return 0;
+    int moved = 0;
+    for (GameObject* object : objects) {
+        if (GetObjectSlot(object) < 0) continue;
+        // Нельзя сделать объект ребёнком собственного потомка
+        bool cycle = false;
+        for (GameObject* p = newParent; p; p = p->GetParent()) {
+            if (p == object) { cycle = true; break; }
+        }
+        if (cycle) continue;
+        if (object->AttachToParent(newParent, keepWorldPosition)) moved++;
+    }
+    std::cout << "[Scene] Reparented " << moved << " objects to "
+              << (newParent ? newParent->GetName() : "root") << std::endl;
+    return moved;
+}
+
+void SceneManager::Update(float deltaTime) {
+    ProcessChanges();
+    UpdateTransforms();
+    UpdateSpatialIndex();
+}
+
+void SceneManager::SceneChanges::Clear() {
+    added.clear();
+    removed.clear();
+    transforms.clear();
+    renderers.clear();
+    lights.clear();
+    cameras.clear();
+    fogs.clear();
+    bodies.clear();
+}
+
+void SceneManager::ProcessChanges() {
+    auto start = std::chrono::high_resolution_clock::now();
+    SceneRegistry& registry = SceneRegistry::Get();
+    m_FrameChanges.Clear();
+
+    // Работа пропорциональна числу изменившихся сущностей, а не размеру сцены
+    const std::vector<Entity>& changed = registry.GetChangedEntities();
+    for (Entity e : changed) {
+        uint32_t mask = registry.GetChangeMask(e);
+        bool inScene = registry.GetOwner(e) && registry.IsInScene(e);
+        // Любое изменение статического объекта возвращает его из пакета
+        if (m_StaticBatcher.IsBatched(e)) m_StaticBatcher.Release(e);
+
+        // Вход/выход из сцены; id мог освободиться и достаться новому объекту
+        if (mask & CHANGE_SCENE) {
+            bool wasTracked = m_SceneEntities.Contains(e);
+            uint32_t generation = registry.GetHandle(e).generation;
+            bool reused = wasTracked && inScene && m_TrackedGenerations[e] != generation;
+            if (wasTracked && (!inScene || reused)) m_FrameChanges.removed.push_back(e);
+            if (inScene && (!wasTracked || reused)) {
+                m_FrameChanges.added.push_back(e);
+                if (e >= m_TrackedGenerations.size()) m_TrackedGenerations.resize((size_t)e + 1, 0);
+                m_TrackedGenerations[e] = generation;
+            }
+            m_SceneEntities.Set(e, inScene);
+        }
+        if (!inScene) {
+            for (EntitySet& lights : m_LightsByType) lights.Erase(e);
+            m_Cameras.Erase(e);
+            m_Fogs.Erase(e);
+            m_Renderables.Erase(e);
+            m_ShadowCasters.Erase(e);
+            continue;
+        }
+
+        // Новая в сцене сущность проверяется по всем реестрам
+        if (mask & CHANGE_SCENE) mask |= CHANGE_TRANSFORM | CHANGE_RENDERER | CHANGE_LIGHT | CHANGE_CAMERA | CHANGE_FOG;
+        if (mask & CHANGE_LIGHT) {
+            const LightComponent* light = registry.lights.Get(e);
+            for (int type = 0; type < 3; ++type) m_LightsByType[type].Set(e, light && light->type == type);
+            m_FrameChanges.lights.push_back(e);
+        }
+        if (mask & CHANGE_CAMERA) {
+            m_Cameras.Set(e, registry.cameras.Has(e));
+            m_FrameChanges.cameras.push_back(e);
+        }
+        if (mask & CHANGE_FOG) {
+            m_Fogs.Set(e, registry.fogs.Has(e));
+            m_FrameChanges.fogs.push_back(e);
+        }
+        if (mask & CHANGE_RENDERER) {
+            const MeshRendererComponent* renderer = registry.renderers.Get(e);
+            bool renderable = renderer && renderer->visible && renderer->mesh;
+            m_Renderables.Set(e, renderable);
+            m_ShadowCasters.Set(e, renderable && renderer->castShadows);
+            m_FrameChanges.renderers.push_back(e);
+        }
+        if (mask & CHANGE_TRANSFORM) m_FrameChanges.transforms.push_back(e);
+        if (mask & CHANGE_BODY) m_FrameChanges.bodies.push_back(e);
+    }
+    m_Stats.changedEntities = (int)changed.size();
+    registry.ClearChanges();
+
+    auto end = std::chrono::high_resolution_clock::now();
+    m_Stats.changesMs = std::chrono::duration<float, std::milli>(end - start).count();
+}
+
+void SceneManager::RebuildTransformOrder() {
+    // Обход в глубину от корней: родитель всегда раньше своих детей.
+    // Плотные массивы TransformPool переставляются в этот порядок, и дальше
+    // пересчёт мировых матриц — линейный проход по индексам родителей.
+    std::vector<Entity> order, parentOf;
+    order.reserve(m_Objects.size());
+    parentOf.reserve(m_Objects.size());
+    std::vector<GameObject*> stack;
+    for (const auto& obj : m_Objects) {
+        if (obj->GetParent()) continue;
+        stack.push_back(obj.get());
+        while (!stack.empty()) {
+            GameObject* node = stack.back();
+            stack.pop_back();
+            order.push_back(node->GetEntity());
+            parentOf.push_back(node->GetParent() ? node->GetParent()->GetEntity() : kNullEntity);
+            const auto& children = node->GetChildren();
+            for (auto it = children.rbegin(); it != children.rend(); ++it) {
+                stack.push_back(it->get());
+            }
+        }
+    }
+    TransformPool& transforms = SceneRegistry::Get().transforms;
+    transforms.Reorder(order, parentOf);
+    m_OrderedCount = order.size();
+    m_TransformOrderVersion = GameObject::GetHierarchyVersion();
+    m_TransformLayoutVersion = transforms.GetLayoutVersion();
+    m_TransformOrderDirty = false;
+}
+
+void SceneManager::UpdateTransforms() {
+    auto start = std::chrono::high_resolution_clock::now();
+    SceneRegistry& registry = SceneRegistry::Get();
+    TransformPool& transforms = registry.transforms;
+    bool reordered = false;
+    if (m_TransformOrderDirty || m_TransformOrderVersion != GameObject::GetHierarchyVersion() ||
+        m_TransformLayoutVersion != transforms.GetLayoutVersion()) {
+        RebuildTransformOrder();
+        reordered = true;
+    }
+
+    int updated = 0;
+    m_BoundsDirtyObjects.clear();
+    // Кандидаты из шины изменений: грязная мировая матрица или новые границы
+    // (смена меша). Все грязные узлы сцены в шине есть — пометка сообщает о себе.
+    const std::vector<Entity>& moved = m_FrameChanges.transforms;
+    const std::vector<Entity>& remeshed = m_FrameChanges.renderers;
+    size_t candidates = moved.size() + remeshed.size();
+    if (!reordered && candidates * 4 < m_OrderedCount) {
+        // Мало изменений: только кандидаты, предки досчитываются рекурсией по грязным
+        auto visit = [&](Entity e) {
+            uint32_t index = transforms.Index(e);
+            GameObject* obj = registry.GetOwner(e);
+            if (transforms.flags[index] & TransformPool::kWorldDirty) {
+                obj->GetTransformMatrix();
+                updated++;
+            }
+            // Повтор (сущность в обоих списках) отбросит UpdateSpatialIndex
+            if (transforms.flags[index] & TransformPool::kBoundsDirty) m_BoundsDirtyObjects.push_back(obj);
+        };
+        for (Entity e : moved) visit(e);
+        for (Entity e : remeshed) visit(e);
+    } else {
+        // Один линейный проход по SoA-массивам: мировые матрицы пересчитываются
+        // только у грязных узлов, родитель (меньший индекс) к этому моменту уже
+        // актуален. Заодно собираем объекты с изменёнными границами.
+        const uint8_t clearMask = (uint8_t)~(TransformPool::kLocalDirty | TransformPool::kWorldDirty);
+        for (size_t i = 0; i < m_OrderedCount; ++i) {
+            uint8_t flags = transforms.flags[i];
+            if (flags & TransformPool::kLocalDirty) {
+                transforms.locals[i] = TransformPool::ComposeLocal(transforms.positions[i], transforms.rotations[i],
+                                                                   transforms.scales[i]);
+            }
+            if (flags & TransformPool::kWorldDirty) {
+                int32_t parent = transforms.parents[i];
+                transforms.worlds[i] = parent < 0 ? transforms.locals[i] : transforms.worlds[parent] * transforms.locals[i];
+                updated++;
+            }
+            transforms.flags[i] = flags & clearMask;
+            if (flags & TransformPool::kBoundsDirty) {
+                m_BoundsDirtyObjects.push_back(registry.GetOwner(transforms.entities[i]));
+            }
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    m_Stats.transformsUpdated = updated;
+    m_Stats.transformUpdateMs = std::chrono::duration<float, std::milli>(end - start).count();
+}
+
+void SceneManager::UpdateSpatialIndex() {
+    auto start = std::chrono::high_resolution_clock::now();
+    // Регистрируются все объекты: у объектов без меша границы — точка,
+    // это нужно для запросов вроде "источники света рядом с точкой".
+    // Обходим только объекты с изменёнными границами (новые тоже грязные).
+    int moved = 0;
+    for (GameObject* obj : m_BoundsDirtyObjects) {
+        if (!obj->IsBoundsDirty()) continue;
+        AABB bounds = obj->GetWorldBounds();
+        int proxy = obj->GetSpatialProxy();
+        if (proxy == AABBTree::kNullNode) {
+            obj->SetSpatialProxy(m_SpatialTree.CreateProxy(bounds, obj));
+            moved++;
+        } else if (m_SpatialTree.MoveProxy(proxy, bounds)) {
+            moved++;
+        }
+        obj->ClearBoundsDirty();
+    }
+    m_BoundsDirtyObjects.clear();
+    auto end = std::chrono::high_resolution_clock::now();
+    m_Stats.spatialMoved = moved;
+    m_Stats.spatialHeight = m_SpatialTree.GetHeight();
+    m_Stats.spatialUpdateMs = std::chrono::duration<float, std::milli>(end - start).count();
+}
+
+void SceneManager::QueryFrustum(const Frustum& frustum, std::vector<GameObject*>& result) const {
+    m_SpatialTree.QueryFrustum(frustum, [&](int proxyId) {
+        result.push_back(m_SpatialTree.GetUserData(proxyId));
+    });
+}
+
+void SceneManager::QueryBox(const AABB& box, std::vector<GameObject*>& result) const {
+    m_SpatialTree.QueryAABB(box, [&](int proxyId) {
+        GameObject* obj = m_SpatialTree.GetUserData(proxyId);
+        if (obj->GetWorldBounds().Overlaps(box)) result.push_back(obj);
+    });
+}
+
+void SceneManager::QuerySphere(const glm::vec3& center, float radius, std::vector<GameObject*>& result) const {
+    BoundingSphere sphere;
+    sphere.center = center;
+    sphere.radius = radius;
+    m_SpatialTree.QuerySphere(sphere, [&](int proxyId) {
+        GameObject* obj = m_SpatialTree.GetUserData(proxyId);
+        AABB bounds = obj->GetWorldBounds();
+        glm::vec3 d = glm::clamp(center, bounds.min, bounds.max) - center;
+        if (glm::dot(d, d) <= radius * radius) result.push_back(obj);
+    });
+}
+
+GameObject* SceneManager::Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                                  float* hitDistance) const {
+    GameObject* closest = nullptr;
+    float closestDistance = maxDistance;
+    m_SpatialTree.RayCast(origin, direction, maxDistance, [&](int proxyId, float currentMax) -> float {
+        GameObject* obj = m_SpatialTree.GetUserData(proxyId);
+        if (!obj->IsVisible() || !obj->GetMesh()) return -1.0f;
+        float t = AABBTree::RayIntersectAABB(origin, direction, obj->GetWorldBounds(), currentMax);
+        if (t < 0.0f) return -1.0f;
+        closest = obj;
+        closestDistance = t;
+        return t;   // дальше ищем только ближе
+    });
+    if (closest && hitDistance) *hitDistance = closestDistance;
+    return closest;
+}
+
+void SceneManager::BuildRenderQueue(bool shadowPass) {
+    // Кандидаты: из дерева по пирамиде (толстые AABB), без отсечения — все объекты.
+    // Затем точные мировые AABB проверяются одним пакетным SIMD-вызовом.
+    m_CullCandidates.clear();
+    m_CullBounds.clear();
+    if (m_FrustumCulling) {
+        const Frustum& frustum = shadowPass ? m_ShadowFrustum : m_CameraFrustum;
+        QueryFrustum(frustum, m_CullCandidates);
+        size_t kept = 0;
+        for (GameObject* obj : m_CullCandidates) {
+            if (!obj->IsVisible() || !obj->GetMesh()) continue;
+            if (shadowPass && !obj->CastShadows()) continue;
+            if (m_StaticBatcher.IsBatched(obj->GetEntity())) continue;
+            m_CullCandidates[kept++] = obj;
+            m_CullBounds.push_back(obj->GetWorldBounds());
+        }
+        m_CullCandidates.resize(kept);
+    } else {
+        // Реестр уже отфильтрован: видимые с мешем (и отбрасывающие тень)
+        const SceneRegistry& registry = SceneRegistry::Get();
+        const EntitySet& candidates = shadowPass ? m_ShadowCasters : m_Renderables;
+        for (Entity e : candidates.GetItems()) {
+            if (!m_StaticBatcher.IsBatched(e)) m_CullCandidates.push_back(registry.GetOwner(e));
+        }
+    }
+    m_CullVisible.assign(m_CullCandidates.size(), 1);
+    if (m_FrustumCulling && !m_CullCandidates.empty()) {
+        const Frustum& frustum = shadowPass ? m_ShadowFrustum : m_CameraFrustum;
+        frustum.CullAABBs(m_CullBounds.data(), m_CullBounds.size(), m_CullVisible.data());
+    }
+
+    // Плотные идентификаторы на кадр: 0 — "нет материала/текстур"
+    m_DrawEntries.clear();
+    m_RenderQueue.Clear();
+    m_MaterialIds.clear();
+    m_MeshIds.clear();
+    m_TextureSetIds.clear();
+    m_RenderQueue.Reserve(m_CullCandidates.size());
+    const Frustum& depthFrustum = shadowPass ? m_ShadowFrustum : m_CameraFrustum;
+    const RenderPass pass = shadowPass ? RP_SHADOW : RP_OPAQUE;
+
+    int visible = 0;
+    for (size_t i = 0; i < m_CullCandidates.size(); ++i) {
+        if (!m_CullVisible[i]) continue;
+        GameObject* obj = m_CullCandidates[i];
+        visible++;
+
+        DrawEntry entry;
+        entry.object = obj;
+        entry.mesh = obj->GetMeshPtr();
+        // Для теней важен только меш
+        entry.material = shadowPass ? nullptr : obj->GetRenderMaterialPtr();
+        entry.receiveShadows = shadowPass ? false : obj->ReceiveShadows();
+
+        MaterialSlot slot;
+        if (entry.material) {
+            slot = AcquireMaterialSlot(entry.material, shadowPass);
+            entry.tableIndex = slot.tableIndex;
+            entry.poolSet = slot.poolSet;
+        }
+        if (m_LodEnabled && entry.mesh->GetLodCount() > 1) {
+            AABB bounds = m_CullBounds.empty() ? obj->GetWorldBounds() : m_CullBounds[i];
+            int lod = SelectLod(entry.mesh, bounds, obj->GetLod());
+            // Тени грубее, но выбор с гистерезисом хранит только основной проход
+            if (shadowPass) {
+                entry.lod = entry.mesh->ClampLod(lod + m_ShadowLodBias);
+            } else {
+                entry.lod = lod;
+                if (lod != obj->GetLod()) obj->SetLod(lod);
+            }
+        }
+        // Кластеры только у уровня 0 и только в основном проходе: тени — на грубом LOD
+        entry.clustered = !shadowPass && m_MeshletCulling && entry.lod == 0 && !entry.mesh->GetMeshlets().empty();
+        auto meshIt = m_MeshIds.emplace(entry.mesh, (uint32_t)m_MeshIds.size()).first;
+        uint32_t meshId = meshIt->second * Mesh::kMaxLods + (uint32_t)entry.lod;
+
+        // Front-to-back: расстояние центра от ближней плоскости пирамиды
+        glm::vec3 center = m_CullBounds.empty() ? glm::vec3(obj->GetTransformMatrix()[3])
+                                                : m_CullBounds[i].GetCenter();
+        float depth = depthFrustum.DistanceToNear(center);
+
+        // Шейдер один на проход, поле ключа пока всегда 0
+        uint64_t key = RenderKey::Make(pass, 0, slot.textureId, slot.materialId, meshId,
+                                       entry.receiveShadows, depth);
+        m_RenderQueue.Push(key, (uint32_t)m_DrawEntries.size());
+        m_DrawEntries.push_back(entry);
+    }
+    int batched = PushBatchEntries(shadowPass);
+    visible += batched;
+    if (!shadowPass) m_Stats.staticObjects = batched;
+    m_RenderQueue.Sort();
+
+    int eligible = (int)(shadowPass ? m_ShadowCasters.Size() : m_Renderables.Size());
+    int culled = (std::max)(eligible - visible, 0);
+    if (shadowPass) {
+        m_Stats.shadowCasters += visible;
+        m_Stats.shadowCulled += culled;
+    } else {
+        m_Stats.visibleObjects = visible;
+        m_Stats.culledObjects = culled;
+    }
+}
+
+SceneManager::MaterialSlot SceneManager::AcquireMaterialSlot(const Material* material, bool shadowPass) {
+    auto it = m_MaterialIds.find(material);
+    if (it != m_MaterialIds.end()) return it->second;
+
+    MaterialSlot slot;
+    int tableIndex = (m_TextureArrays && !shadowPass) ? m_MaterialTable.Acquire(material) : -1;
+    if (tableIndex >= 0) {
+        // Материалы одного набора пулов сливаются в ключе: дальше сортировка по мешу.
+        // Старший бит поля текстур отделяет наборы пулов от обычных наборов текстур.
+        slot.tableIndex = tableIndex;
+        slot.poolSet = m_MaterialTable.GetPoolSet(tableIndex);
+        slot.textureId = 0x800 | (std::min)(slot.poolSet, 0x7FFu);
+        m_MaterialTable.UpdateParameters(tableIndex, material);
+    } else {
+        std::array<GLuint, Material::kTextureSlotCount> textures;
+        for (int t = 0; t < Material::kTextureSlotCount; ++t) textures[t] = material->GetTexture(t);
+        uint32_t nextTexture = (std::min)((uint32_t)m_TextureSetIds.size() + 1, 0x7FFu);
+        slot.textureId = m_TextureSetIds.emplace(textures, nextTexture).first->second;
+        slot.materialId = (uint32_t)m_MaterialIds.size() + 1;
+    }
+    m_MaterialIds.emplace(material, slot);
+    return slot;
+}
+
+int SceneManager::PushBatchEntries(bool shadowPass) {
+    m_BatchCounts.clear();
+    m_BatchOffsets.clear();
+    const Frustum& frustum = shadowPass ? m_ShadowFrustum : m_CameraFrustum;
+    const RenderPass pass = shadowPass ? RP_SHADOW : RP_OPAQUE;
+
+    int visible = 0;
+    for (const StaticBatcher::Chunk& chunk : m_StaticBatcher.GetChunks()) {
+        if (chunk.activeRanges == 0 || (shadowPass && !chunk.castShadows)) continue;
+        if (m_FrustumCulling && !frustum.IntersectsAABB(chunk.bounds)) continue;
+        m_RangeVisible.assign(chunk.ranges.size(), 1);
+        if (m_FrustumCulling) {
+            m_RangeBounds.clear();
+            for (const StaticBatcher::Range& range : chunk.ranges) m_RangeBounds.push_back(range.bounds);
+            frustum.CullAABBs(m_RangeBounds.data(), m_RangeBounds.size(), m_RangeVisible.data());
+        }
+
+        DrawEntry entry;
+        entry.batch = &chunk;
+        entry.mesh = chunk.mesh.get();
+        entry.material = shadowPass ? nullptr : chunk.material.get();
+        entry.receiveShadows = shadowPass ? false : chunk.receiveShadows;
+        entry.rangeFirst = (uint32_t)m_BatchCounts.size();
+
+        // Отсечённые и вынутые из пакета объекты выпадают, соседние диапазоны сливаются
+        const size_t indexSize = entry.mesh->GetIndexSize();
+        uint32_t rangeEnd = 0;
+        int objects = 0;
+        for (size_t r = 0; r < chunk.ranges.size(); ++r) {
+            const StaticBatcher::Range& range = chunk.ranges[r];
+            if (!range.active || !m_RangeVisible[r]) continue;
+            if (m_BatchCounts.size() > entry.rangeFirst && rangeEnd == range.firstIndex) {
+                m_BatchCounts.back() += (GLsizei)range.indexCount;
+            } else {
+                m_BatchCounts.push_back((GLsizei)range.indexCount);
+                m_BatchOffsets.push_back((const void*)(range.firstIndex * indexSize));
+            }
+            rangeEnd = range.firstIndex + range.indexCount;
+            entry.batchTriangles += range.indexCount / 3;
+            objects++;
+        }
+        if (objects == 0) continue;
+        entry.rangeCount = (uint32_t)m_BatchCounts.size() - entry.rangeFirst;
+        visible += objects;
+
+        MaterialSlot slot;
+        if (entry.material) {
+            slot = AcquireMaterialSlot(entry.material, shadowPass);
+            entry.tableIndex = slot.tableIndex;
+            entry.poolSet = slot.poolSet;
+        }
+        auto meshIt = m_MeshIds.emplace(entry.mesh, (uint32_t)m_MeshIds.size()).first;
+        float depth = frustum.DistanceToNear(chunk.bounds.GetCenter());
+        uint64_t key = RenderKey::Make(pass, 0, slot.textureId, slot.materialId, meshIt->second * Mesh::kMaxLods,
+                                       entry.receiveShadows, depth);
+        m_RenderQueue.Push(key, (uint32_t)m_DrawEntries.size());
+        m_DrawEntries.push_back(entry);
+    }
+    return visible;
+}
+
+int SceneManager::SelectLod(const Mesh* mesh, const AABB& worldBounds, int current) const {
+    // Порог доли высоты экрана для уровней 1..3 и запас гистерезиса вокруг него:
+    // объект на границе не переключается каждый кадр
+    static const float kLodScreenSize[Mesh::kMaxLods] = { 1.0f, 0.25f, 0.12f, 0.06f };
+    const float kHysteresis = 0.15f;
+    if (m_LodProjectionScale <= 0.0f) return 0;
+
+    float radius = glm::length(worldBounds.GetExtents());
+    float distance = glm::length(worldBounds.GetCenter() - m_LodCameraPosition);
+    if (distance <= radius) return 0;
+    // Диаметр сферы в долях высоты экрана: 2r / (2 * d * tan(fov / 2))
+    float coverage = radius * m_LodProjectionScale / distance;
+
+    int lod = 0;
+    for (int level = 1; level < mesh->GetLodCount(); ++level) {
+        // Уже выбранный уровень держится до порога с запасом, новый берётся после запаса
+        float threshold = kLodScreenSize[level] * (level <= current ? 1.0f + kHysteresis : 1.0f - kHysteresis);
+        if (coverage >= threshold) break;
+        lod = level;
     }
-    auto newObj = CreateGameObject(m_SelectedObject->GetName() + " (Copy)");
-    newObj->SetMesh(m_SelectedObject->GetMesh());
-    newObj->SetPosition(m_SelectedObject->GetPosition() + glm::vec3(1.0f, 0.0f, 0.0f));
-    newObj->SetRotation(m_SelectedObject->GetRotation());
-    newObj->SetScale(m_SelectedObject->GetScale());
-    newObj->SetColor(m_SelectedObject->GetColor());
-    if (m_SelectedObject->GetMaterial()) {
-        newObj->SetMaterial(m_SelectedObject->GetMaterial());
+    return lod;
+}
+
+size_t SceneManager::CountSubmittedTriangles(const glm::mat4& view, const glm::mat4& projection) {
+    SetCameraFrustum(projection * view);
+    SetLodCamera(glm::vec3(glm::inverse(view)[3]), projection[1][1]);
+    BuildRenderQueue(false);
+    CullMeshlets();
+    size_t triangles = 0;
+    for (const DrawEntry& entry : m_DrawEntries) {
+        if (entry.batch) {
+            triangles += entry.batchTriangles;
+        } else {
+            triangles += entry.clustered ? GatherMeshletRanges(entry) : entry.mesh->GetLod(entry.lod).indexCount / 3;
+        }
     }
-    // Копируем параметры света
-    newObj->SetLightType(m_SelectedObject->GetLightType());
-    newObj->SetLightColor(m_SelectedObject->GetLightColor());
-    newObj->SetLightIntensity(m_SelectedObject->GetLightIntensity());
-    newObj->SetLightRange(m_SelectedObject->GetLightRange());
-    newObj->SetLightAngle(m_SelectedObject->GetLightAngleDeg());
-    newObj->SetLightDirection(m_SelectedObject->GetLightDirection());
+    return triangles;
+}
 
-    SetSelectedObject(newObj);
+int SceneManager::CountSubmittedDraws(const glm::mat4& view, const glm::mat4& projection) {
+    SetCameraFrustum(projection * view);
+    SetLodCamera(glm::vec3(glm::inverse(view)[3]), projection[1][1]);
+    BuildRenderQueue(false);
+    CullMeshlets();
+    // Серии и пропуски — как в Render
+    const std::vector<RenderItem>& items = m_RenderQueue.GetItems();
+    int draws = 0;
+    for (size_t i = 0; i < items.size();) {
+        size_t count = FindDrawRun(i);
+        const DrawEntry& head = m_DrawEntries[items[i].index];
+        if (head.clustered) {
+            GatherMeshletRanges(head);
+            if (!m_MeshletCounts.empty()) draws++;
+        } else {
+            draws += count < kMinInstanceBatch ? (int)count : 1;
+        }
+        i += count;
+    }
+    return draws;
 }
 
-void SceneManager::Update(float deltaTime) {}
+void SceneManager::CullMeshlets() {
+    m_MeshletJobs.clear();
+    m_MeshletChunks.clear();
+    size_t total = 0;
+    for (size_t e = 0; e < m_DrawEntries.size(); ++e) {
+        DrawEntry& entry = m_DrawEntries[e];
+        if (!entry.clustered) continue;
+        entry.meshletFirst = (uint32_t)total;
+
+        MeshletJob job;
+        job.entry = (uint32_t)e;
+        job.model = entry.object->GetTransformMatrix();
+        glm::vec3 scale(glm::length(glm::vec3(job.model[0])), glm::length(glm::vec3(job.model[1])),
+                        glm::length(glm::vec3(job.model[2])));
+        job.scale = (std::max)((std::max)(scale.x, scale.y), scale.z);
+        float minScale = (std::min)((std::min)(scale.x, scale.y), scale.z);
+        // Конус нормалей переживает поворот и равномерный масштаб, но не растяжение
+        job.backface = m_MeshletBackfaceCulling && m_LodProjectionScale > 0.0f && minScale > 0.99f * job.scale;
+        if (job.backface) job.camera = glm::vec3(glm::inverse(job.model) * glm::vec4(m_LodCameraPosition, 1.0f));
+
+        size_t count = entry.mesh->GetMeshlets().size();
+        for (size_t begin = 0; begin < count; begin += kMeshletChunk) {
+            size_t end = (std::min)(begin + kMeshletChunk, count);
+            m_MeshletChunks.push_back({ (uint32_t)m_MeshletJobs.size(), (uint32_t)begin, (uint32_t)end });
+        }
+        m_MeshletJobs.push_back(job);
+        total += count;
+    }
+    m_MeshletVisible.resize(total);
+    if (total == 0) return;
+
+    ParallelFor(m_MeshletChunks.size(), [this](size_t c) {
+        const MeshletChunk& chunk = m_MeshletChunks[c];
+        const MeshletJob& job = m_MeshletJobs[chunk.job];
+        const DrawEntry& entry = m_DrawEntries[job.entry];
+        const std::vector<Meshlet>& meshlets = entry.mesh->GetMeshlets();
+        uint8_t* visible = m_MeshletVisible.data() + entry.meshletFirst;
+        for (uint32_t i = chunk.begin; i < chunk.end; ++i) {
+            const Meshlet& meshlet = meshlets[i];
+            BoundingSphere sphere;
+            sphere.center = glm::vec3(job.model * glm::vec4(meshlet.sphere.center, 1.0f));
+            sphere.radius = meshlet.sphere.radius * job.scale;
+            if (m_FrustumCulling && !m_CameraFrustum.IntersectsSphere(sphere)) {
+                visible[i] = MESHLET_FRUSTUM_CULLED;
+            } else if (job.backface && MeshletBuilder::IsBackfacing(meshlet, job.camera)) {
+                visible[i] = MESHLET_BACKFACE_CULLED;
+            } else {
+                visible[i] = MESHLET_VISIBLE;
+            }
+        }
+    }, total < kMinParallelMeshlets ? 1 : 0);
+}
+
+size_t SceneManager::GatherMeshletRanges(const DrawEntry& entry) {
+    m_MeshletCounts.clear();
+    m_MeshletOffsets.clear();
+    const std::vector<Meshlet>& meshlets = entry.mesh->GetMeshlets();
+    const uint8_t* visible = m_MeshletVisible.data() + entry.meshletFirst;
+    const size_t indexSize = entry.mesh->GetIndexSize();
+    size_t indices = 0;
+    uint32_t rangeEnd = 0;
+    for (size_t i = 0; i < meshlets.size(); ++i) {
+        if (visible[i] != MESHLET_VISIBLE) continue;
+        const Meshlet& meshlet = meshlets[i];
+        // Соседние видимые кластеры лежат в EBO подряд — один диапазон
+        if (!m_MeshletCounts.empty() && rangeEnd == meshlet.firstIndex) {
+            m_MeshletCounts.back() += (GLsizei)meshlet.indexCount;
+        } else {
+            m_MeshletCounts.push_back((GLsizei)meshlet.indexCount);
+            m_MeshletOffsets.push_back((const void*)(meshlet.firstIndex * indexSize));
+        }
+        rangeEnd = meshlet.firstIndex + meshlet.indexCount;
+        indices += meshlet.indexCount;
+    }
+    return indices / 3;
+}
+
+size_t SceneManager::FindDrawRun(size_t first) const {
+    const std::vector<RenderItem>& items = m_RenderQueue.GetItems();
+    const DrawEntry& head = m_DrawEntries[items[first].index];
+    if (head.clustered || head.batch) return 1;
+    size_t last = first + 1;
+    // Сравниваем реальные указатели: id в ключе могут насыщаться
+    while (last < items.size()) {
+        const DrawEntry& e = m_DrawEntries[items[last].index];
+        if (e.mesh != head.mesh || e.lod != head.lod || e.clustered || e.receiveShadows != head.receiveShadows) break;
+        // Разные материалы совместимы, если оба в таблице и их текстуры в тех же пулах
+        bool sameMaterial = e.material == head.material ||
+                            (e.tableIndex >= 0 && head.tableIndex >= 0 && e.poolSet == head.poolSet);
+        if (!sameMaterial) break;
+        ++last;
+    }
+    return last - first;
+}
+
+void SceneManager::FillInstanceData(size_t first, size_t count) {
+    const std::vector<RenderItem>& items = m_RenderQueue.GetItems();
+    m_InstanceData.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        const DrawEntry& entry = m_DrawEntries[items[first + i].index];
+        const GameObject* obj = entry.object;
+        const glm::mat4& model = obj->GetTransformMatrix();
+        glm::vec3 color = obj->GetColor();
+        InstanceData& inst = m_InstanceData[i];
+        memcpy(inst.Model, glm::value_ptr(model), sizeof(inst.Model));
+        inst.Color[0] = color.x;
+        inst.Color[1] = color.y;
+        inst.Color[2] = color.z;
+        inst.MaterialIndex = (std::max)(entry.tableIndex, 0);
+    }
+}
 
 void SceneManager::Render(Shader& shader) {
     if (!m_Initialized) return;
-    for (const auto& obj : m_Objects) {
-        if (obj->IsVisible()) {
-            obj->Draw(shader);
+    auto start = std::chrono::high_resolution_clock::now();
+    m_Stats.drawCalls = 0;
+    m_Stats.instancedBatches = 0;
+    m_Stats.instancedObjects = 0;
+    m_Stats.triangles = 0;
+    m_Stats.staticBatches = 0;
+
+    BuildRenderQueue(false);
+    auto sorted = std::chrono::high_resolution_clock::now();
+    m_Stats.sortMs = std::chrono::duration<float, std::milli>(sorted - start).count();
+
+    CullMeshlets();
+    m_Stats.meshletsTested = (int)m_MeshletVisible.size();
+    m_Stats.meshletsFrustumCulled = (int)std::count(m_MeshletVisible.begin(), m_MeshletVisible.end(),
+                                                    (uint8_t)MESHLET_FRUSTUM_CULLED);
+    m_Stats.meshletsBackfaceCulled = (int)std::count(m_MeshletVisible.begin(), m_MeshletVisible.end(),
+                                                     (uint8_t)MESHLET_BACKFACE_CULLED);
+    m_Stats.meshletRanges = 0;
+    m_Stats.meshletCullMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() -
+                                                                    sorted).count();
+
+    const std::vector<RenderItem>& items = m_RenderQueue.GetItems();
+    const glm::mat4 identity(1.0f);
+    if (m_TextureArrays) {
+        m_MaterialTable.Upload();
+        m_MaterialTable.BindTable();
+    }
+    m_StateCache.ResetCounters();
+    m_StateCache.Begin();
+    for (size_t i = 0; i < items.size();) {
+        size_t count = FindDrawRun(i);
+        const DrawEntry& head = m_DrawEntries[items[i].index];
+        bool useTable = head.tableIndex >= 0;
+        shader.SetBool(u_UseMaterialTable, useTable);
+        if (useTable) {
+            m_StateCache.BindPoolSet(m_MaterialTable, head.poolSet);
+        } else {
+            m_StateCache.BindMaterial(shader, head.material);
         }
+        m_StateCache.BindMesh(head.mesh);
+
+        if (count < kMinInstanceBatch) {
+            shader.SetBool(u_UseInstancing, false);
+            for (size_t j = i; j < i + count; ++j) {
+                const DrawEntry& entry = m_DrawEntries[items[j].index];
+                if (useTable) shader.SetInt(u_MaterialIndex, entry.tableIndex);
+                if (entry.batch) {
+                    // Вершины пакета уже в мировых координатах
+                    glm::vec3 color = entry.batch->color;
+                    shader.SetMat4(u_Model, glm::value_ptr(identity));
+                    shader.SetBool(u_ReceiveShadows, entry.receiveShadows);
+                    shader.SetVec3(u_ObjectColor, color.x, color.y, color.z);
+                    head.mesh->DrawRangesBound(m_BatchCounts.data() + entry.rangeFirst,
+                                               m_BatchOffsets.data() + entry.rangeFirst, entry.rangeCount);
+                    m_Stats.triangles += entry.batchTriangles;
+                    m_Stats.staticBatches++;
+                    m_Stats.drawCalls++;
+                    continue;
+                }
+                const GameObject* obj = entry.object;
+                const glm::mat4& model = obj->GetTransformMatrix();
+                glm::vec3 color = obj->GetColor();
+                shader.SetMat4(u_Model, glm::value_ptr(model));
+                shader.SetBool(u_ReceiveShadows, obj->ReceiveShadows());
+                shader.SetVec3(u_ObjectColor, color.x, color.y, color.z);
+                if (entry.clustered) {
+                    // Только видимые кластеры: диапазоны того же EBO одним вызовом
+                    m_Stats.triangles += GatherMeshletRanges(entry);
+                    if (m_MeshletCounts.empty()) continue;
+                    head.mesh->DrawRangesBound(m_MeshletCounts.data(), m_MeshletOffsets.data(), m_MeshletCounts.size());
+                    m_Stats.meshletRanges += (int)m_MeshletCounts.size();
+                } else {
+                    head.mesh->DrawBound(head.lod);
+                }
+                m_Stats.drawCalls++;
+            }
+        } else {
+            shader.SetBool(u_UseInstancing, true);
+            shader.SetBool(u_ReceiveShadows, head.receiveShadows);
+            FillInstanceData(i, count);
+            head.mesh->DrawInstancedBound(m_InstanceData, head.lod);
+            m_Stats.drawCalls++;
+            m_Stats.instancedBatches++;
+            m_Stats.instancedObjects += (int)count;
+        }
+        if (!head.clustered && !head.batch) m_Stats.triangles += head.mesh->GetLod(head.lod).indexCount / 3 * count;
+        i += count;
     }
+    m_StateCache.End();
+    shader.SetBool(u_UseInstancing, false);
+    shader.SetBool(u_UseMaterialTable, false);
+    m_Stats.bindsIssued = m_StateCache.GetCounters().bindsIssued;
+    m_Stats.bindsSkipped = m_StateCache.GetCounters().bindsSkipped;
+
+    auto end = std::chrono::high_resolution_clock::now();
+    m_Stats.renderCpuMs = std::chrono::duration<float, std::milli>(end - start).count();
 }
 
-void SceneManager::RenderDepth(Shader& depthShader) {
+void SceneManager::RenderDepth(Shader& depthShader, int cascade) {
     if (!m_Initialized) return;
-    for (const auto& obj : m_Objects) {
-        if (obj->IsVisible() && obj->GetMesh() && obj->CastShadows()) {
-            glm::mat4 model = obj->GetTransformMatrix();
-            depthShader.SetMat4("model", glm::value_ptr(model));
-            obj->GetMesh()->Draw();
+    auto start = std::chrono::high_resolution_clock::now();
+    if (cascade == 0) {
+        m_Stats.shadowDrawCalls = 0;
+        m_Stats.shadowTriangles = 0;
+        m_Stats.shadowCasters = 0;
+        m_Stats.shadowCulled = 0;
+        m_Stats.shadowBindsIssued = 0;
+        m_Stats.shadowBindsSkipped = 0;
+        m_Stats.depthCpuMs = 0.0f;
+    }
+
+    BuildRenderQueue(true);
+    const std::vector<RenderItem>& items = m_RenderQueue.GetItems();
+    const glm::mat4 identity(1.0f);
+    m_StateCache.ResetCounters();
+    m_StateCache.Begin();
+    for (size_t i = 0; i < items.size();) {
+        size_t count = FindDrawRun(i);
+        const DrawEntry& head = m_DrawEntries[items[i].index];
+        m_StateCache.BindMesh(head.mesh);
+
+        if (count < kMinInstanceBatch) {
+            depthShader.SetBool(u_UseInstancing, false);
+            for (size_t j = i; j < i + count; ++j) {
+                const DrawEntry& entry = m_DrawEntries[items[j].index];
+                if (entry.batch) {
+                    depthShader.SetMat4(u_Model, glm::value_ptr(identity));
+                    head.mesh->DrawRangesBound(m_BatchCounts.data() + entry.rangeFirst,
+                                               m_BatchOffsets.data() + entry.rangeFirst, entry.rangeCount);
+                } else {
+                    depthShader.SetMat4(u_Model, glm::value_ptr(entry.object->GetTransformMatrix()));
+                    head.mesh->DrawBound(head.lod);
+                }
+                m_Stats.shadowDrawCalls++;
+            }
+        } else {
+            depthShader.SetBool(u_UseInstancing, true);
+            FillInstanceData(i, count);
+            head.mesh->DrawInstancedBound(m_InstanceData, head.lod);
+            m_Stats.shadowDrawCalls++;
         }
+        m_Stats.shadowTriangles += head.batch ? head.batchTriangles : head.mesh->GetLod(head.lod).indexCount / 3 * count;
+        i += count;
     }
+    m_StateCache.End();
+    depthShader.SetBool(u_UseInstancing, false);
+    m_Stats.shadowBindsIssued += m_StateCache.GetCounters().bindsIssued;
+    m_Stats.shadowBindsSkipped += m_StateCache.GetCounters().bindsSkipped;
+
+    auto end = std::chrono::high_resolution_clock::now();
+    m_Stats.depthCpuMs += std::chrono::duration<float, std::milli>(end - start).count();
 }
 
 void SceneManager::RenderOutline(Shader& outlineShader, const glm::mat4& view, const glm::mat4& projection, 
@@ -175,15 +1046,6 @@ void SceneManager::RenderOutline(Shader& outlineShader, const glm::mat4& view, c
     if (depthTestEnabled) glEnable(GL_DEPTH_TEST);
 }
 
-bool SceneManager::HasDirectionalLight() const {
-    for (const auto& obj : m_Objects) {
-        if (obj->GetName() == "DirectionalLight") {
-            return true;
-        }
-    }
-    return false;
-}
-
 void SceneManager::SetActiveCamera(std::shared_ptr<GameObject> camera) {
     if (camera && camera->IsCamera()) {
         m_ActiveCamera = camera;
@@ -241,11 +1103,10 @@ void SceneManager::RotateActiveCamera(float yawDelta, float pitchDelta) {
     m_CameraPitch = pitch;
 }
 
-void SceneManager::RenderGrid(Shader& shader, const glm::mat4& view, const glm::mat4& projection) {
+void SceneManager::RenderGrid(Shader& shader) {
     if (!m_GridMesh) return;
     shader.Use();
-    shader.SetMat4("view", glm::value_ptr(view));
-    shader.SetMat4("projection", glm::value_ptr(projection));
+    // view/projection приходят из UBO FrameConstants
     glm::mat4 model = glm::mat4(1.0f);
     shader.SetMat4("model", glm::value_ptr(model));
     glEnable(GL_BLEND);
@@ -266,12 +1127,18 @@ void SceneManager::InitializePhysics() {
 
 void SceneManager::UpdatePhysics(float deltaTime) {
     PhysicsWorld::GetInstance().Update(deltaTime);
-    for (auto& obj : m_Objects) {
-        if (obj->HasRigidBody()) {
-            obj->SyncTransformToPhysics();
-            // отладочный вывод
-            std::cout << "Syncing " << obj->GetName() << std::endl;
-        }
+    // Линейный проход по пулу RigidBody
+    const SceneRegistry& registry = SceneRegistry::Get();
+    const std::vector<Entity>& entities = registry.bodies.GetEntities();
+    const std::vector<RigidBodyComponent>& bodies = registry.bodies.GetData();
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        if (!bodies[i].rigidBody || !registry.IsInScene(entities[i])) continue;
+        // Статические, кинематические и уснувшие тела физика не двигает: без
+        // синхронизации они не шлют CHANGE_TRANSFORM и остаются в статических пакетах
+        const btRigidBody* rigidBody = bodies[i].rigidBody;
+        if (rigidBody->isStaticOrKinematicObject() || !rigidBody->isActive()) continue;
+        GameObject* obj = registry.GetOwner(entities[i]);
+        obj->SyncTransformToPhysics();
     }
 }
 
@@ -280,18 +1147,9 @@ void SceneManager::SetPhysicsActive(bool active) {
     PhysicsWorld::GetInstance().SetSimulationActive(active);
 }
 
-std::shared_ptr<GameObject> SceneManager::FindGameObjectByPtr(GameObject* ptr) {
-    for (auto& obj : m_Objects) {
-        if (obj.get() == ptr) return obj;
-    }
-    return nullptr;
-}
-
 std::shared_ptr<GameObject> SceneManager::GetActiveFog() const {
-    for (const auto& obj : m_Objects) {
-        if (obj->IsFog()) return obj;
-    }
-    return nullptr;
+    if (m_Fogs.Empty()) return nullptr;
+    return SceneRegistry::Get().GetOwner(m_Fogs.GetItems().front())->shared_from_this();
 }
 
 void SceneManager::ResetPhysics() {
@@ -302,10 +1160,46 @@ void SceneManager::RegisterForPhysicsReset(GameObject* obj) {
     PhysicsWorld::GetInstance().RegisterGameObject(obj);
 }
 
-void SceneManager::SaveScene(const std::string& filename) {
-    std::cout << "Saving scene to: " << filename << std::endl;
+bool SceneManager::SaveScene(const std::string& filename) {
+    return SceneSerializer::Save(*this, filename);
+}
+
+bool SceneManager::LoadScene(const std::string& filename) {
+    if (!SceneSerializer::Load(*this, filename)) return false;
+    if (!m_ActiveCamera) {
+        // Без активной камеры кадр не рисуется вовсе
+        std::cerr << "[Scene] " << filename << " has no active camera, adding the default one" << std::endl;
+        CreateDefaultCamera();
+    }
+    return true;
+}
+
+void SceneManager::ClearScene() {
+    m_StaticBatcher.Clear();
+    std::vector<GameObject*> roots;
+    for (const auto& object : m_Objects) {
+        if (!object->GetParent()) roots.push_back(object.get());
+    }
+    DeleteGameObjects(roots);
+    m_SelectedObject.reset();
+    m_ActiveCamera.reset();
+    m_Fog = FogSettings();
+}
+
+size_t SceneManager::BakeStaticBatches() {
+    // Сначала разбираем накопленные изменения: иначе следующий Update сразу
+    // вернул бы из пакетов только что созданные или сдвинутые объекты
+    Update(0.0f);
+    std::vector<GameObject*> objects;
+    objects.reserve(m_Objects.size());
+    for (const auto& object : m_Objects) objects.push_back(object.get());
+    return m_StaticBatcher.Bake(objects);
+}
+
+void SceneManager::ClearStaticBatches() {
+    m_StaticBatcher.Clear();
 }
 
-void SceneManager::LoadScene(const std::string& filename) {
-    std::cout << "Loading scene from: " << filename << std::endl;
+void SceneManager::ReserveObjects(size_t count) {
+    m_Objects.reserve(m_Objects.size() + count);
 }
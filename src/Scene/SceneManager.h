@@ -2,9 +2,17 @@
 #include <vector>
 #include <memory>
 #include <string>
+#include <map>
+#include <array>
+#include <unordered_map>
 #include <glm/glm.hpp>
 #include "GameObject.h"
 #include "Graphics/Shader.h"
+#include "Graphics/Bounds.h"
+#include "Graphics/RenderQueue.h"
+#include "Graphics/MaterialTable.h"
+#include "Scene/AABBTree.h"
+#include "Scene/StaticBatcher.h"
 
 // ===== ТИПЫ ТУМАНА (глобально, чтобы использовать без SceneManager::) =====
 enum FogType {
@@ -22,22 +30,119 @@ public:
     void Initialize();
     void Update(float deltaTime);
     void Render(Shader& shader);
-    void RenderDepth(Shader& depthShader);
+    // Каскад 0 сбрасывает теневую статистику, остальные накапливают
+    void RenderDepth(Shader& depthShader, int cascade = 0);
+
+    // Отсечение по пирамиде видимости: камера для Render, свет для RenderDepth
+    void SetCameraFrustum(const glm::mat4& viewProjection) { m_CameraFrustum.Extract(viewProjection); }
+    void SetShadowFrustum(const glm::mat4& lightSpaceMatrix) { m_ShadowFrustum.Extract(lightSpaceMatrix); }
+    void SetFrustumCullingEnabled(bool enabled) { m_FrustumCulling = enabled; }
+    bool IsFrustumCullingEnabled() const { return m_FrustumCulling; }
+    // Уровни детализации: по доле высоты экрана, которую занимает ограничивающая
+    // сфера объекта. projectionScale — projection[1][1] камеры
+    void SetLodCamera(const glm::vec3& position, float projectionScale) {
+        m_LodCameraPosition = position;
+        m_LodProjectionScale = projectionScale;
+    }
+    void SetLodEnabled(bool enabled) { m_LodEnabled = enabled; }
+    bool IsLodEnabled() const { return m_LodEnabled; }
+    // Тени рисуются на столько уровней грубее основного прохода
+    void SetShadowLodBias(int bias) { m_ShadowLodBias = bias; }
+    int GetShadowLodBias() const { return m_ShadowLodBias; }
+    // Кластеры больших мешей (MeshletBuilder) отсекаются пирамидой и конусом
+    // нормалей на нескольких потоках, выжившие рисуются одним glMultiDrawElements.
+    // Отсечение по конусу считает геометрию односторонней, как GL_CULL_FACE. Движок
+    // рисует обе стороны (плоскости, листва, стены изнутри), поэтому оно выключено,
+    // пока его не включат явно
+    void SetMeshletCullingEnabled(bool enabled) { m_MeshletCulling = enabled; }
+    bool IsMeshletCullingEnabled() const { return m_MeshletCulling; }
+    void SetMeshletBackfaceCullingEnabled(bool enabled) { m_MeshletBackfaceCulling = enabled; }
+    bool IsMeshletBackfaceCullingEnabled() const { return m_MeshletBackfaceCulling; }
+    // Треугольники, которые отправил бы Render с этой камеры: очередь строится, но
+    // не рисуется. Для бенчмарков; пирамиду и камеру LOD кадра переписывает
+    size_t CountSubmittedTriangles(const glm::mat4& view, const glm::mat4& projection);
+    // То же для числа вызовов отрисовки основного прохода
+    int CountSubmittedDraws(const glm::mat4& view, const glm::mat4& projection);
+    // Режим текстурных массивов: материалы из одних пулов рисуются одним вызовом
+    void SetTextureArraysEnabled(bool enabled);
+    bool IsTextureArraysEnabled() const { return m_TextureArrays; }
+    MaterialTable::Stats GetMaterialTableStats() const { return m_MaterialTable.GetStats(); }
+    // Статические пакеты (см. StaticBatcher): неподвижные объекты сцены сливаются
+    // по материалу. Любое изменение объекта (движение, меш, материал, тело,
+    // удаление) в следующем Update возвращает его из пакета. Возвращает число
+    // объектов в пакетах
+    size_t BakeStaticBatches();
+    void ClearStaticBatches();
+    StaticBatcher::Stats GetStaticBatchStats() const { return m_StaticBatcher.GetStats(); }
+
+    // ===== ПРОСТРАНСТВЕННЫЕ ЗАПРОСЫ (через AABB-дерево) =====
+    // Пересчёт грязных мировых матриц плоским проходом (вызывается в Update)
+    void UpdateTransforms();
+    // Обновляет прокси объектов, чьи мировые границы изменились (вызывается в Update)
+    void UpdateSpatialIndex();
+    AABB GetSceneBounds() const { return m_SpatialTree.GetRootBounds(); }
+    void QueryFrustum(const Frustum& frustum, std::vector<GameObject*>& result) const;
+    void QueryBox(const AABB& box, std::vector<GameObject*>& result) const;
+    void QuerySphere(const glm::vec3& center, float radius, std::vector<GameObject*>& result) const;
+    // Ближайший видимый объект с мешем на луче; nullptr, если промах
+    GameObject* Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                        float* hitDistance = nullptr) const;
     void RenderOutline(Shader& outlineShader, const glm::mat4& view, const glm::mat4& projection, 
                        const glm::vec3& color, int mode, float pointSize, float fillAlpha);
 
     std::shared_ptr<GameObject> CreateGameObject(const std::string& name);
+    // Удаляет объект вместе с потомками
     void DeleteGameObject(GameObject* object);
     void DuplicateSelectedObject();
 
+    // ===== ПАКЕТНЫЕ ОПЕРАЦИИ =====
+    // Удаление поддеревьев за O(N): каждый объект убирается из списка swap-and-pop'ом
+    // (порядок GetObjects() при этом меняется)
+    void DeleteGameObjects(const std::vector<GameObject*>& objects);
+    // Копии без детей, у того же родителя; DirectionalLight не копируется
+    std::vector<std::shared_ptr<GameObject>> DuplicateGameObjects(const std::vector<GameObject*>& objects,
+                                                                  const glm::vec3& offset);
+    // nullptr — в корень; объекты, для которых newParent — потомок, пропускаются.
+    // Возвращает число перемещённых
+    int ReparentGameObjects(const std::vector<GameObject*>& objects, GameObject* newParent,
+                            bool keepWorldPosition = true);
+
     void SetSelectedObject(std::shared_ptr<GameObject> object);
     std::shared_ptr<GameObject> GetSelectedObject() const { return m_SelectedObject; }
 
     const std::vector<std::shared_ptr<GameObject>>& GetObjects() const { return m_Objects; }
 
-    void SaveScene(const std::string& filename);
-    void LoadScene(const std::string& filename);
-    bool HasDirectionalLight() const;
+    // Формат .binax — см. SceneSerializer. Загрузка заменяет всю сцену;
+    // без камеры в файле создаётся камера по умолчанию
+    bool SaveScene(const std::string& filename);
+    bool LoadScene(const std::string& filename);
+    // Удаляет все объекты и сбрасывает глобальный туман
+    void ClearScene();
+    // Резерв под массовое создание объектов (загрузка сцены)
+    void ReserveObjects(size_t count);
+    bool HasDirectionalLight() const { return !m_LightsByType[LT_DIRECTIONAL].Empty(); }
+
+    // ===== ТИПИЗИРОВАННЫЕ РЕЕСТРЫ =====
+    // Поддерживаются по уведомлениям SceneRegistry (ProcessChanges в начале Update),
+    // содержат только сущности сцены
+    const std::vector<Entity>& GetLights(LightType type) const { return m_LightsByType[type].GetItems(); }
+    const std::vector<Entity>& GetCameras() const { return m_Cameras.GetItems(); }
+    const std::vector<Entity>& GetFogVolumes() const { return m_Fogs.GetItems(); }
+    const std::vector<Entity>& GetShadowCasters() const { return m_ShadowCasters.GetItems(); }
+
+    // Изменения за кадр (до следующего Update): для рендера, физики, сериализации
+    struct SceneChanges {
+        std::vector<Entity> added;          // появились в сцене
+        std::vector<Entity> removed;        // ушли из сцены (id мог быть переиспользован)
+        std::vector<Entity> transforms;     // мировая матрица изменилась
+        std::vector<Entity> renderers;
+        std::vector<Entity> lights;
+        std::vector<Entity> cameras;
+        std::vector<Entity> fogs;
+        std::vector<Entity> bodies;
+        void Clear();
+    };
+    const SceneChanges& GetFrameChanges() const { return m_FrameChanges; }
 
     void SetActiveCamera(std::shared_ptr<GameObject> camera);
     std::shared_ptr<GameObject> GetActiveCamera() const { return m_ActiveCamera; }
@@ -47,7 +152,7 @@ public:
     void RotateActiveCamera(float yawDelta, float pitchDelta);
     void UpdateActiveCamera(float deltaTime); // для плавности
 
-    void RenderGrid(Shader& shader, const glm::mat4& view, const glm::mat4& projection);
+    void RenderGrid(Shader& shader);
     std::shared_ptr<Mesh> m_GridMesh;
 
     // Physics
@@ -57,8 +162,10 @@ public:
     void ResetPhysics();
     void RegisterForPhysicsReset(GameObject* obj);
 
-    // Поиск shared_ptr по сырому указателю
+    // Поиск shared_ptr по сырому указателю, O(1)
     std::shared_ptr<GameObject> FindGameObjectByPtr(GameObject* ptr);
+    // nullptr, если объект по ссылке уже удалён
+    std::shared_ptr<GameObject> FindGameObject(EntityHandle handle) const;
 
     // ===== НАСТРОЙКИ ТУМАНА =====
     struct FogSettings {
@@ -74,12 +181,174 @@ public:
     // В public секцию
     std::shared_ptr<GameObject> GetActiveFog() const;
 
+    // ===== СТАТИСТИКА РЕНДЕРА =====
+    struct RenderStats {
+        int drawCalls = 0;          // основной проход
+        int instancedBatches = 0;   // из них инстансированных
+        int instancedObjects = 0;   // объектов, нарисованных через инстансинг
+        int bindsIssued = 0;        // привязок состояния в основном проходе
+        int bindsSkipped = 0;       // пропущено как избыточные
+        int shadowBindsIssued = 0;
+        int shadowBindsSkipped = 0;
+        float sortMs = 0.0f;        // построение и сортировка очереди (основной проход)
+        int shadowDrawCalls = 0;    // проход теней (все каскады)
+        size_t triangles = 0;       // треугольников отправлено в основном проходе
+        size_t shadowTriangles = 0; // в проходе теней (все каскады)
+        int meshletsTested = 0;     // кластеров проверено в основном проходе
+        int meshletsFrustumCulled = 0;
+        int meshletsBackfaceCulled = 0;
+        int meshletRanges = 0;      // диапазонов в glMultiDrawElements после слияния соседних
+        float meshletCullMs = 0.0f;
+        int staticBatches = 0;      // статических пакетов нарисовано в основном проходе
+        int staticObjects = 0;      // объектов в них (после отсечения по диапазонам)
+        int visibleObjects = 0;     // прошли отсечение камерой
+        int culledObjects = 0;      // отсечены камерой
+        int shadowCasters = 0;      // прошли отсечение светом (сумма по каскадам)
+        int shadowCulled = 0;       // отсечены светом (сумма по каскадам)
+        int spatialMoved = 0;       // листьев дерева переставлено за кадр
+        int spatialHeight = 0;      // высота дерева
+        float spatialUpdateMs = 0.0f;
+        int transformsUpdated = 0; // мировых матриц пересчитано за кадр
+        int changedEntities = 0;    // сущностей в шине изменений за кадр
+        float changesMs = 0.0f;     // разбор шины изменений
+        float transformUpdateMs = 0.0f;
+        float renderCpuMs = 0.0f;   // время CPU в Render
+        float depthCpuMs = 0.0f;    // время CPU в RenderDepth
+    };
+    const RenderStats& GetRenderStats() const { return m_Stats; }
+
 private:
     bool m_Initialized;
+    void CreateDefaultCamera();
     std::vector<std::shared_ptr<GameObject>> m_Objects;
+    // Слот-карта: сущность -> индекс в m_Objects
+    static constexpr uint32_t kNoSlot = 0xFFFFFFFFu;
+    std::vector<uint32_t> m_ObjectSlots;
+    int GetObjectSlot(const GameObject* object) const;   // -1 — не в сцене
     std::shared_ptr<GameObject> m_SelectedObject;
     std::shared_ptr<GameObject> m_ActiveCamera;
     float m_CameraYaw = -90.0f;
     float m_CameraPitch = 0.0f;
     FogSettings m_Fog;
+
+    // ===== ОЧЕРЕДЬ ОТРИСОВКИ =====
+    // Видимые объекты сортируются по ключу (материал -> меш -> глубина);
+    // подряд идущие с одинаковыми (Mesh, LOD, Material, receiveShadows) рисуются
+    // одним инстансированным вызовом
+    struct DrawEntry {
+        GameObject* object = nullptr;
+        Mesh* mesh = nullptr;
+        int lod = 0;
+        bool clustered = false;     // рисуется видимыми кластерами, всегда отдельным вызовом
+        uint32_t meshletFirst = 0;  // начало флагов его кластеров в m_MeshletVisible
+        const Material* material = nullptr;
+        bool receiveShadows = true;
+        int tableIndex = -1;        // строка MaterialTable; -1 — обычные 2D-текстуры
+        uint32_t poolSet = 0;
+        // Статический пакет: object == nullptr, вершины уже в мировых координатах,
+        // видимые диапазоны — m_BatchCounts/m_BatchOffsets[rangeFirst, +rangeCount)
+        const StaticBatcher::Chunk* batch = nullptr;
+        uint32_t rangeFirst = 0;
+        uint32_t rangeCount = 0;
+        size_t batchTriangles = 0;
+    };
+    // Идентификаторы материала на кадр (для ключа) и его место в MaterialTable
+    struct MaterialSlot {
+        uint32_t materialId = 0;
+        uint32_t textureId = 0;
+        int tableIndex = -1;
+        uint32_t poolSet = 0;
+    };
+    static const size_t kMinInstanceBatch = 2;  // меньше — обычный вызов
+    void BuildRenderQueue(bool shadowPass);
+    MaterialSlot AcquireMaterialSlot(const Material* material, bool shadowPass);
+    // Видимые пакеты в очередь: пирамида по границам пакета, затем по диапазонам
+    // объектов; возвращает число видимых объектов в них
+    int PushBatchEntries(bool shadowPass);
+    // Уровень по размеру на экране; current — выбор прошлого кадра (гистерезис)
+    int SelectLod(const Mesh* mesh, const AABB& worldBounds, int current) const;
+    // Флаги видимости кластеров всех clustered-записей очереди
+    void CullMeshlets();
+    // Видимые кластеры записи -> m_MeshletCounts/m_MeshletOffsets; возвращает треугольники
+    size_t GatherMeshletRanges(const DrawEntry& entry);
+    // Длина серии одинаковых вызовов, начиная с items[first]
+    size_t FindDrawRun(size_t first) const;
+    void FillInstanceData(size_t first, size_t count);
+    std::vector<DrawEntry> m_DrawEntries;
+    RenderQueue m_RenderQueue;
+    RenderStateCache m_StateCache;
+    std::unordered_map<const Material*, MaterialSlot> m_MaterialIds;
+    std::unordered_map<const Mesh*, uint32_t> m_MeshIds;
+    std::map<std::array<GLuint, Material::kTextureSlotCount>, uint32_t> m_TextureSetIds;
+    std::vector<InstanceData> m_InstanceData;
+    StaticBatcher m_StaticBatcher;
+    std::vector<GLsizei> m_BatchCounts;
+    std::vector<const void*> m_BatchOffsets;
+    std::vector<AABB> m_RangeBounds;
+    std::vector<uint8_t> m_RangeVisible;
+    MaterialTable m_MaterialTable;
+    bool m_TextureArrays = false;
+    RenderStats m_Stats;
+
+    // ===== ОТСЕЧЕНИЕ =====
+    Frustum m_CameraFrustum;
+    Frustum m_ShadowFrustum;
+    bool m_FrustumCulling = true;
+
+    // ===== LOD =====
+    bool m_LodEnabled = true;
+    int m_ShadowLodBias = 1;
+    glm::vec3 m_LodCameraPosition = glm::vec3(0.0f);
+    float m_LodProjectionScale = 0.0f;      // 0 — камера не задана, всегда LOD 0
+
+    // ===== КЛАСТЕРЫ =====
+    // Задание на объект: матрица и камера в координатах его меша
+    struct MeshletJob {
+        uint32_t entry = 0;
+        glm::mat4 model = glm::mat4(1.0f);
+        glm::vec3 camera = glm::vec3(0.0f);
+        float scale = 1.0f;
+        bool backface = false;
+    };
+    // Кусок кластеров одного объекта — единица работы потоков
+    struct MeshletChunk {
+        uint32_t job;
+        uint32_t begin;
+        uint32_t end;
+    };
+    static const size_t kMeshletChunk = 256;
+    static const size_t kMinParallelMeshlets = 2048;    // меньше — в одном потоке
+    bool m_MeshletCulling = true;
+    bool m_MeshletBackfaceCulling = false;
+    std::vector<MeshletJob> m_MeshletJobs;
+    std::vector<MeshletChunk> m_MeshletChunks;
+    std::vector<uint8_t> m_MeshletVisible;
+    std::vector<GLsizei> m_MeshletCounts;
+    std::vector<const void*> m_MeshletOffsets;
+    std::vector<GameObject*> m_CullCandidates;
+    std::vector<AABB> m_CullBounds;
+    std::vector<uint8_t> m_CullVisible;
+    AABBTree m_SpatialTree;
+
+    // ===== ТРАНСФОРМАЦИИ =====
+    // Порядок "родитель раньше детей" в TransformPool; перестраивается при
+    // изменении иерархии или состава пула. Сцена — первые m_OrderedCount записей.
+    void RebuildTransformOrder();
+    size_t m_OrderedCount = 0;
+    uint32_t m_TransformOrderVersion = 0;
+    uint32_t m_TransformLayoutVersion = 0;
+    bool m_TransformOrderDirty = true;
+    std::vector<GameObject*> m_BoundsDirtyObjects;
+
+    // ===== РЕЕСТРЫ ПО ТИПАМ (см. ProcessChanges) =====
+    // Разбирает уведомления SceneRegistry: обновляет реестры и m_FrameChanges
+    void ProcessChanges();
+    EntitySet m_LightsByType[3];    // по LightType
+    EntitySet m_Cameras;
+    EntitySet m_Fogs;
+    EntitySet m_Renderables;        // видимые с мешем
+    EntitySet m_ShadowCasters;      // из них отбрасывающие тень
+    SceneChanges m_FrameChanges;
+    EntitySet m_SceneEntities;              // для added/removed
+    std::vector<uint32_t> m_TrackedGenerations;
 };
@@ -0,0 +1,146 @@
+#include "Scene/SceneRegistry.h"
+#include "Scene/GameObject.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtx/euler_angles.hpp>
+
+glm::mat4 TransformPool::ComposeLocal(const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale) {
+    glm::mat4 transform = glm::translate(glm::mat4(1.0f), position);
+    transform = transform * glm::eulerAngleYXZ(
+        glm::radians(rotation.y),
+        glm::radians(rotation.x),
+        glm::radians(rotation.z)
+    );
+    return glm::scale(transform, scale);
+}
+
+uint32_t TransformPool::Add(Entity e) {
+    if (e >= m_Sparse.size()) m_Sparse.resize((size_t)e + 1, 0xFFFFFFFFu);
+    uint32_t index = (uint32_t)entities.size();
+    m_Sparse[e] = index;
+    entities.push_back(e);
+    parents.push_back(-1);
+    positions.push_back(glm::vec3(0.0f));
+    rotations.push_back(glm::vec3(0.0f));
+    scales.push_back(glm::vec3(1.0f));
+    locals.push_back(glm::mat4(1.0f));
+    worlds.push_back(glm::mat4(1.0f));
+    flags.push_back(kLocalDirty | kWorldDirty | kBoundsDirty);
+    spatialProxies.push_back(-1);
+    m_LayoutVersion++;
+    return index;
+}
+
+void TransformPool::Remove(Entity e) {
+    uint32_t index = m_Sparse[e];
+    uint32_t last = (uint32_t)entities.size() - 1;
+    if (index != last) {
+        entities[index] = entities[last];
+        parents[index] = parents[last];
+        positions[index] = positions[last];
+        rotations[index] = rotations[last];
+        scales[index] = scales[last];
+        locals[index] = locals[last];
+        worlds[index] = worlds[last];
+        flags[index] = flags[last];
+        spatialProxies[index] = spatialProxies[last];
+        m_Sparse[entities[index]] = index;
+    }
+    entities.pop_back();
+    parents.pop_back();
+    positions.pop_back();
+    rotations.pop_back();
+    scales.pop_back();
+    locals.pop_back();
+    worlds.pop_back();
+    flags.pop_back();
+    spatialProxies.pop_back();
+    m_Sparse[e] = 0xFFFFFFFFu;
+    m_LayoutVersion++;
+}
+
+void TransformPool::Reorder(const std::vector<Entity>& order, const std::vector<Entity>& parentOf) {
+    // Порядок может не покрывать все сущности (например, без владельца в сцене) —
+    // они остаются в хвосте в прежнем порядке
+    const size_t count = entities.size();
+    std::vector<uint32_t> source;
+    source.reserve(count);
+    std::vector<uint8_t> placed(count, 0);
+    for (Entity e : order) {
+        uint32_t index = m_Sparse[e];
+        source.push_back(index);
+        placed[index] = 1;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        if (!placed[i]) source.push_back(i);
+    }
+
+    auto permute = [&](auto& values) {
+        typename std::decay<decltype(values)>::type sorted(count);
+        for (size_t i = 0; i < count; ++i) sorted[i] = values[source[i]];
+        values.swap(sorted);
+    };
+    permute(entities);
+    permute(positions);
+    permute(rotations);
+    permute(scales);
+    permute(locals);
+    permute(worlds);
+    permute(flags);
+    permute(spatialProxies);
+    for (uint32_t i = 0; i < count; ++i) m_Sparse[entities[i]] = i;
+
+    for (size_t i = 0; i < count; ++i) {
+        Entity parent = i < parentOf.size() ? parentOf[i] : kNullEntity;
+        parents[i] = parent == kNullEntity ? -1 : (int32_t)m_Sparse[parent];
+    }
+}
+
+Entity SceneRegistry::CreateEntity(GameObject* owner) {
+    Entity e;
+    if (!m_FreeEntities.empty()) {
+        e = m_FreeEntities.back();
+        m_FreeEntities.pop_back();
+        m_Owners[e] = owner;
+    } else {
+        e = (Entity)m_Owners.size();
+        m_Owners.push_back(owner);
+        m_Generations.push_back(0);
+    }
+    transforms.Add(e);
+    NotifyChanged(e, CHANGE_SCENE | CHANGE_TRANSFORM);
+    return e;
+}
+
+void SceneRegistry::DestroyEntity(Entity e) {
+    if (e >= m_Owners.size() || !m_Owners[e]) return;
+    transforms.Remove(e);
+    renderers.Remove(e);
+    lights.Remove(e);
+    cameras.Remove(e);
+    fogs.Remove(e);
+    bodies.Remove(e);
+    m_Owners[e] = nullptr;
+    m_Generations[e]++;
+    NotifyChanged(e, CHANGE_SCENE);
+    m_FreeEntities.push_back(e);
+}
+
+void SceneRegistry::SetInScene(Entity e, bool inScene) {
+    uint8_t& flags = transforms.flags[transforms.Index(e)];
+    if (inScene) flags |= TransformPool::kInScene;
+    else flags &= ~TransformPool::kInScene;
+    NotifyChanged(e, CHANGE_SCENE);
+}
+
+void SceneRegistry::ClearChanges() {
+    for (Entity e : m_Changed) m_ChangeMasks[e] = 0;
+    m_Changed.clear();
+}
+
+const glm::mat4& SceneRegistry::GetWorldMatrix(Entity e) const {
+    uint32_t index = transforms.Index(e);
+    if (transforms.flags[index] & TransformPool::kWorldDirty) {
+        return m_Owners[e]->GetTransformMatrix();
+    }
+    return transforms.worlds[index];
+}
@@ -0,0 +1,253 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+class GameObject;
+class Mesh;
+class Material;
+class btRigidBody;
+class btCollisionShape;
+
+// Идентификатор сущности: индекс во всех пулах компонентов
+typedef uint32_t Entity;
+const Entity kNullEntity = 0xFFFFFFFFu;
+
+// Поколенческая ссылка: id переиспользуются, поколение растёт при каждом
+// уничтожении, поэтому старая ссылка на переиспользованный id невалидна
+struct EntityHandle {
+    Entity id = kNullEntity;
+    uint32_t generation = 0;
+
+    bool operator==(const EntityHandle& other) const { return id == other.id && generation == other.generation; }
+    bool operator!=(const EntityHandle& other) const { return !(*this == other); }
+};
+
+// ===== КОМПОНЕНТЫ =====
+// Только данные; поведение — в системах SceneManager и в фасаде GameObject
+
+struct MeshRendererComponent {
+    std::shared_ptr<Mesh> mesh;
+    std::shared_ptr<Material> material;
+    glm::vec3 color = glm::vec3(1.0f);
+    bool visible = true;
+    bool castShadows = true;
+    bool receiveShadows = true;
+    uint8_t lod = 0;                // выбранный уровень детализации (для гистерезиса, не сохраняется)
+};
+
+struct LightComponent {
+    int type = -1;                  // LightType
+    glm::vec3 color = glm::vec3(1.0f);
+    float intensity = 1.0f;
+    float range = 10.0f;
+    float angle = 0.785398f;        // радианы (45°)
+    glm::vec3 direction = glm::vec3(0.0f, -1.0f, 0.0f);
+};
+
+struct CameraComponent {
+    float fov = 45.0f;
+    float nearPlane = 0.1f;
+    float farPlane = 100.0f;
+};
+
+struct FogComponent {
+    bool enabled = false;
+    int type = 1;                   // 1=Linear, 2=Exponential, 3=Exponential Squared
+    glm::vec3 color = glm::vec3(0.5f, 0.6f, 0.7f);
+    float density = 0.04f;
+    float linearStart = 10.0f;
+    float linearEnd = 50.0f;
+};
+
+struct RigidBodyComponent {
+    btRigidBody* rigidBody = nullptr;
+    btCollisionShape* shape = nullptr;
+    int collider = 0;               // ColliderType
+    float mass = 0.0f;
+    float friction = 0.5f;
+    float restitution = 0.5f;
+    float rollingFriction = 0.1f;
+    float linearDamping = 0.0f;
+    float angularDamping = 0.0f;
+};
+
+// Разреженное множество: sparse[entity] -> индекс в плотных массивах.
+// Системы проходят плотные массивы линейно; удаление — swap-and-pop.
+template <typename T>
+class ComponentPool {
+public:
+    bool Has(Entity e) const { return e < m_Sparse.size() && m_Sparse[e] != kNone; }
+    T* Get(Entity e) { return Has(e) ? &m_Data[m_Sparse[e]] : nullptr; }
+    const T* Get(Entity e) const { return Has(e) ? &m_Data[m_Sparse[e]] : nullptr; }
+
+    T& Add(Entity e) {
+        if (Has(e)) return m_Data[m_Sparse[e]];
+        if (e >= m_Sparse.size()) m_Sparse.resize((size_t)e + 1, kNone);
+        m_Sparse[e] = (uint32_t)m_Data.size();
+        m_Entities.push_back(e);
+        m_Data.emplace_back();
+        return m_Data.back();
+    }
+
+    void Remove(Entity e) {
+        if (!Has(e)) return;
+        uint32_t index = m_Sparse[e];
+        uint32_t last = (uint32_t)m_Data.size() - 1;
+        if (index != last) {
+            m_Data[index] = std::move(m_Data[last]);
+            m_Entities[index] = m_Entities[last];
+            m_Sparse[m_Entities[index]] = index;
+        }
+        m_Data.pop_back();
+        m_Entities.pop_back();
+        m_Sparse[e] = kNone;
+    }
+
+    size_t Size() const { return m_Data.size(); }
+    std::vector<T>& GetData() { return m_Data; }
+    const std::vector<T>& GetData() const { return m_Data; }
+    const std::vector<Entity>& GetEntities() const { return m_Entities; }
+
+private:
+    static constexpr uint32_t kNone = 0xFFFFFFFFu;
+    std::vector<uint32_t> m_Sparse;
+    std::vector<Entity> m_Entities;
+    std::vector<T> m_Data;
+};
+
+// Множество сущностей с O(1) вставкой, удалением и проверкой (тот же sparse set)
+class EntitySet {
+public:
+    bool Contains(Entity e) const { return e < m_Sparse.size() && m_Sparse[e] != kNone; }
+    void Insert(Entity e) {
+        if (Contains(e)) return;
+        if (e >= m_Sparse.size()) m_Sparse.resize((size_t)e + 1, kNone);
+        m_Sparse[e] = (uint32_t)m_Items.size();
+        m_Items.push_back(e);
+    }
+    void Erase(Entity e) {
+        if (!Contains(e)) return;
+        uint32_t index = m_Sparse[e];
+        m_Items[index] = m_Items.back();
+        m_Sparse[m_Items[index]] = index;
+        m_Items.pop_back();
+        m_Sparse[e] = kNone;
+    }
+    void Set(Entity e, bool present) { if (present) Insert(e); else Erase(e); }
+    size_t Size() const { return m_Items.size(); }
+    bool Empty() const { return m_Items.empty(); }
+    const std::vector<Entity>& GetItems() const { return m_Items; }
+
+private:
+    static constexpr uint32_t kNone = 0xFFFFFFFFu;
+    std::vector<uint32_t> m_Sparse;
+    std::vector<Entity> m_Items;
+};
+
+// Трансформации — у каждой сущности, хранятся по полям (SoA). Порядок плотных
+// массивов SceneManager держит "родитель раньше детей" (Reorder), поэтому
+// пересчёт мировых матриц — один линейный проход по parents[].
+class TransformPool {
+public:
+    enum Flags : uint8_t {
+        kLocalDirty = 1 << 0,
+        kWorldDirty = 1 << 1,
+        kBoundsDirty = 1 << 2,   // мировые границы изменились (для пространственного индекса)
+        kInScene = 1 << 3        // сущность в списке объектов SceneManager (не удалена из сцены)
+    };
+
+    uint32_t Add(Entity e);
+    void Remove(Entity e);
+    uint32_t Index(Entity e) const { return m_Sparse[e]; }
+    size_t Size() const { return entities.size(); }
+    // Меняется при Add/Remove: порядок "родитель раньше детей" надо строить заново
+    uint32_t GetLayoutVersion() const { return m_LayoutVersion; }
+
+    // Локальная матрица: translate * eulerYXZ(градусы) * scale
+    static glm::mat4 ComposeLocal(const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale);
+
+    // Переставляет плотные массивы в заданный порядок сущностей;
+    // parentOf[i] — сущность-родитель order[i] (kNullEntity у корней)
+    void Reorder(const std::vector<Entity>& order, const std::vector<Entity>& parentOf);
+
+    std::vector<Entity> entities;
+    std::vector<int32_t> parents;       // плотный индекс родителя, -1 у корня (валиден после Reorder)
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> rotations;   // градусы, порядок YXZ
+    std::vector<glm::vec3> scales;
+    std::vector<glm::mat4> locals;
+    std::vector<glm::mat4> worlds;
+    std::vector<uint8_t> flags;
+    std::vector<int32_t> spatialProxies;
+
+private:
+    std::vector<uint32_t> m_Sparse;
+    uint32_t m_LayoutVersion = 0;
+};
+
+// Что изменилось у сущности (маска уведомления)
+enum ChangeFlags : uint32_t {
+    CHANGE_TRANSFORM = 1 << 0,      // мировая матрица стала грязной
+    CHANGE_RENDERER = 1 << 1,
+    CHANGE_LIGHT = 1 << 2,
+    CHANGE_CAMERA = 1 << 3,
+    CHANGE_FOG = 1 << 4,
+    CHANGE_BODY = 1 << 5,
+    CHANGE_SCENE = 1 << 6           // добавлена в сцену / удалена из неё / уничтожена
+};
+
+// Хранилище компонентов всех сущностей сцены. GameObject — фасад над ним:
+// сущность создаётся в конструкторе и уничтожается в деструкторе.
+class SceneRegistry {
+public:
+    static SceneRegistry& Get() {
+        // Не разрушается при выходе: глобальные GameObject (сцена в main.cpp)
+        // удаляются позже статических объектов и обращаются к реестру в деструкторе
+        static SceneRegistry* registry = new SceneRegistry();
+        return *registry;
+    }
+
+    Entity CreateEntity(GameObject* owner);
+    void DestroyEntity(Entity e);
+    GameObject* GetOwner(Entity e) const { return e < m_Owners.size() ? m_Owners[e] : nullptr; }
+    EntityHandle GetHandle(Entity e) const { return { e, m_Generations[e] }; }
+    bool IsAlive(EntityHandle handle) const {
+        return handle.id < m_Owners.size() && m_Owners[handle.id] && m_Generations[handle.id] == handle.generation;
+    }
+    GameObject* GetOwner(EntityHandle handle) const { return IsAlive(handle) ? m_Owners[handle.id] : nullptr; }
+    size_t GetEntityCount() const { return transforms.Size(); }
+    // Системы обходят только сущности сцены: удалённый объект может ещё жить в shared_ptr
+    bool IsInScene(Entity e) const { return (transforms.flags[transforms.Index(e)] & TransformPool::kInScene) != 0; }
+    void SetInScene(Entity e, bool inScene);
+
+    // Актуальная мировая матрица (при грязном кэше — пересчёт через фасад)
+    const glm::mat4& GetWorldMatrix(Entity e) const;
+
+    // Шина изменений: фасад GameObject сообщает о каждой правке компонента,
+    // SceneManager раз в кадр разбирает накопленное. Сущность попадает в список
+    // один раз, маски объединяются.
+    void NotifyChanged(Entity e, uint32_t flags) {
+        if (e >= m_ChangeMasks.size()) m_ChangeMasks.resize((size_t)e + 1, 0);
+        if (m_ChangeMasks[e] == 0) m_Changed.push_back(e);
+        m_ChangeMasks[e] |= flags;
+    }
+    const std::vector<Entity>& GetChangedEntities() const { return m_Changed; }
+    uint32_t GetChangeMask(Entity e) const { return m_ChangeMasks[e]; }
+    void ClearChanges();
+
+    TransformPool transforms;
+    ComponentPool<MeshRendererComponent> renderers;
+    ComponentPool<LightComponent> lights;
+    ComponentPool<CameraComponent> cameras;
+    ComponentPool<FogComponent> fogs;
+    ComponentPool<RigidBodyComponent> bodies;
+
+private:
+    std::vector<GameObject*> m_Owners;
+    std::vector<uint32_t> m_Generations;
+    std::vector<Entity> m_Changed;
+    std::vector<uint32_t> m_ChangeMasks;
+    std::vector<Entity> m_FreeEntities;
+};
@@ -0,0 +1,704 @@
+#include "Scene/SceneSerializer.h"
+#include "Scene/SceneManager.h"
+#include "Core/MappedFile.h"
+#include "Graphics/MeshRegistry.h"
+#include "Graphics/Model.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+#include <chrono>
+#include <unordered_map>
+#include <type_traits>
+
+namespace {
+    using namespace Binax;
+
+    // ===== ЗАПИСИ ЧАНКОВ =====
+    // Поля компонентов один в один; новые поля — только в конец записи
+
+    struct StringRef {
+        uint32_t offset = 0;        // в чанке STRD
+        uint32_t length = 0;
+    };
+
+    enum ObjectFlags : uint32_t {
+        OBJECT_ACTIVE_CAMERA = 1 << 0,
+        OBJECT_SELECTED = 1 << 1
+    };
+
+    struct ObjectRecord {
+        uint32_t name = kNoString;
+        int32_t parent = -1;        // индекс объекта, всегда меньше собственного
+        uint32_t flags = 0;
+    };
+
+    struct TransformRecord {
+        glm::vec3 position = glm::vec3(0.0f);
+        glm::vec3 rotation = glm::vec3(0.0f);
+        glm::vec3 scale = glm::vec3(1.0f);
+    };
+
+    struct MeshRecord {
+        uint32_t assetPath = kNoString;     // Mesh::GetAssetPath
+    };
+
+    struct MaterialRecord {
+        glm::vec3 albedo = glm::vec3(1.0f);
+        float metallic = 0.0f;
+        float roughness = 0.5f;
+        float ao = 1.0f;
+        glm::vec2 uvScale = glm::vec2(1.0f);
+        float normalStrength = 1.0f;
+        uint32_t useWorldUV = 0;
+        glm::vec3 emissionColor = glm::vec3(0.0f);
+        float emissionIntensity = 0.0f;
+        uint32_t textures[Material::kTextureSlotCount] = { kNoString, kNoString, kNoString, kNoString, kNoString };
+    };
+
+    enum RendererFlags : uint32_t {
+        RENDERER_VISIBLE = 1 << 0,
+        RENDERER_CAST_SHADOWS = 1 << 1,
+        RENDERER_RECEIVE_SHADOWS = 1 << 2,
+        RENDERER_MESH_MATERIAL = 1 << 3     // материал принадлежит мешу (модель): берётся из загруженного меша
+    };
+
+    struct RendererRecord {
+        uint32_t object = 0;
+        int32_t mesh = -1;
+        int32_t material = -1;
+        uint32_t flags = RENDERER_VISIBLE | RENDERER_CAST_SHADOWS | RENDERER_RECEIVE_SHADOWS;
+        glm::vec3 color = glm::vec3(1.0f);
+    };
+
+    struct LightRecord {
+        uint32_t object = 0;
+        int32_t type = -1;
+        glm::vec3 color = glm::vec3(1.0f);
+        float intensity = 1.0f;
+        float range = 10.0f;
+        float angle = 0.785398f;            // радианы, как в LightComponent
+        glm::vec3 direction = glm::vec3(0.0f, -1.0f, 0.0f);
+    };
+
+    struct CameraRecord {
+        uint32_t object = 0;
+        float fov = 45.0f;
+        float nearPlane = 0.1f;
+        float farPlane = 100.0f;
+    };
+
+    struct FogRecord {
+        uint32_t object = 0;
+        uint32_t enabled = 0;
+        int32_t type = 1;
+        glm::vec3 color = glm::vec3(0.5f, 0.6f, 0.7f);
+        float density = 0.04f;
+        float linearStart = 10.0f;
+        float linearEnd = 50.0f;
+    };
+
+    struct BodyRecord {
+        uint32_t object = 0;
+        int32_t collider = 0;
+        float mass = 0.0f;
+        float friction = 0.5f;
+        float restitution = 0.5f;
+        float rollingFriction = 0.1f;
+        float linearDamping = 0.0f;
+        float angularDamping = 0.0f;
+    };
+
+    struct SettingsRecord {
+        uint32_t fogEnabled = 0;
+        int32_t fogType = FOG_LINEAR;
+        glm::vec3 fogColor = glm::vec3(0.5f, 0.6f, 0.7f);
+        float fogDensity = 0.04f;
+        float fogLinearStart = 10.0f;
+        float fogLinearEnd = 50.0f;
+    };
+
+    static_assert(sizeof(Binax::FileHeader) == 16 && sizeof(Binax::ChunkEntry) == 32, ".binax header layout changed");
+    static_assert(sizeof(TransformRecord) == 36 && sizeof(RendererRecord) == 28 && sizeof(MaterialRecord) == 76,
+                  ".binax record layout changed");
+    static_assert(std::is_trivially_copyable<MaterialRecord>::value && std::is_trivially_copyable<RendererRecord>::value,
+                  ".binax records must be memcpy-able");
+
+    const size_t kChunkAlignment = 16;
+
+    size_t AlignUp(size_t value) {
+        return (value + kChunkAlignment - 1) & ~(kChunkAlignment - 1);
+    }
+
+    // ===== ЗАПИСЬ =====
+
+    class StringTable {
+    public:
+        uint32_t Intern(const std::string& text) {
+            auto it = m_Index.find(text);
+            if (it != m_Index.end()) return it->second;
+            uint32_t index = (uint32_t)m_Refs.size();
+            m_Refs.push_back({ (uint32_t)m_Data.size(), (uint32_t)text.size() });
+            m_Data.insert(m_Data.end(), text.begin(), text.end());
+            m_Index.emplace(text, index);
+            return index;
+        }
+        uint32_t InternOptional(const std::string& text) { return text.empty() ? kNoString : Intern(text); }
+        const std::vector<StringRef>& GetRefs() const { return m_Refs; }
+        const std::vector<char>& GetData() const { return m_Data; }
+
+    private:
+        std::unordered_map<std::string, uint32_t> m_Index;
+        std::vector<StringRef> m_Refs;
+        std::vector<char> m_Data;
+    };
+
+    // Собирает файл целиком в памяти и пишет одним вызовом
+    class ChunkWriter {
+    public:
+        template <typename T>
+        void Add(uint32_t id, const std::vector<T>& records) {
+            static_assert(std::is_trivially_copyable<T>::value, "chunk records must be trivially copyable");
+            if (records.empty()) return;
+            ChunkEntry entry;
+            entry.id = id;
+            entry.elementSize = (uint32_t)sizeof(T);
+            entry.count = (uint32_t)records.size();
+            entry.size = (uint64_t)sizeof(T) * records.size();
+            m_Entries.push_back(entry);
+            m_Payloads.push_back(records.data());
+        }
+
+        bool Write(const std::string& filename, uint32_t objectCount, size_t& bytesWritten) {
+            FileHeader header;
+            header.chunkCount = (uint32_t)m_Entries.size();
+            header.objectCount = objectCount;
+
+            size_t offset = AlignUp(sizeof(FileHeader) + sizeof(ChunkEntry) * m_Entries.size());
+            for (ChunkEntry& entry : m_Entries) {
+                entry.offset = offset;
+                offset = AlignUp(offset + (size_t)entry.size);
+            }
+            std::vector<char> buffer(offset, 0);
+            memcpy(buffer.data(), &header, sizeof(header));
+            if (!m_Entries.empty()) {
+                memcpy(buffer.data() + sizeof(header), m_Entries.data(), sizeof(ChunkEntry) * m_Entries.size());
+            }
+            for (size_t i = 0; i < m_Entries.size(); ++i) {
+                memcpy(buffer.data() + m_Entries[i].offset, m_Payloads[i], (size_t)m_Entries[i].size);
+            }
+
+            // Через временный файл: оборванная запись не портит прошлое сохранение
+            const std::string tempPath = filename + ".tmp";
+            {
+                std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+                if (!file) return false;
+                file.write(buffer.data(), (std::streamsize)buffer.size());
+                if (!file) return false;
+            }
+            std::error_code error;
+            std::filesystem::rename(tempPath, filename, error);
+            if (error) {
+                std::filesystem::remove(tempPath, error);
+                return false;
+            }
+            bytesWritten = buffer.size();
+            return true;
+        }
+
+    private:
+        std::vector<ChunkEntry> m_Entries;
+        std::vector<const void*> m_Payloads;
+    };
+
+    // ===== ЧТЕНИЕ =====
+
+    // Записи чанка: указатель прямо в отображённый файл, если размер записи
+    // совпадает с нашим; иначе (другая версия записи) — копия с общим префиксом
+    template <typename T>
+    struct RecordSpan {
+        const T* data = nullptr;
+        size_t count = 0;
+        std::vector<T> converted;
+
+        const T& operator[](size_t i) const { return data[i]; }
+    };
+
+    class ChunkReader {
+    public:
+        bool Open(const MappedFile& file) {
+            m_Data = file.GetData();
+            m_Size = file.GetSize();
+            if (m_Size < sizeof(FileHeader)) return false;
+            memcpy(&m_Header, m_Data, sizeof(m_Header));
+            if (m_Header.magic != kMagic || m_Header.version == 0 || m_Header.version > kVersion) return false;
+            if (m_Header.chunkCount > (m_Size - sizeof(FileHeader)) / sizeof(ChunkEntry)) return false;
+            m_Entries = reinterpret_cast<const ChunkEntry*>(m_Data + sizeof(FileHeader));
+            for (uint32_t i = 0; i < m_Header.chunkCount; ++i) {
+                const ChunkEntry& entry = m_Entries[i];
+                if (entry.elementSize == 0 || entry.offset > m_Size || entry.size > m_Size - entry.offset ||
+                    (uint64_t)entry.elementSize * entry.count != entry.size) return false;
+            }
+            return true;
+        }
+
+        const FileHeader& GetHeader() const { return m_Header; }
+
+        // Отсутствующий чанк — пустой массив
+        template <typename T>
+        void Read(uint32_t id, RecordSpan<T>& span) const {
+            const ChunkEntry* entry = Find(id);
+            span.data = nullptr;
+            span.count = 0;
+            if (!entry || entry->count == 0) return;
+            const uint8_t* source = m_Data + entry->offset;
+            span.count = entry->count;
+            if (entry->elementSize == sizeof(T) && entry->offset % alignof(T) == 0) {
+                span.data = reinterpret_cast<const T*>(source);
+                return;
+            }
+            span.converted.assign(entry->count, T());
+            size_t common = (std::min)((size_t)entry->elementSize, sizeof(T));
+            for (size_t i = 0; i < entry->count; ++i) {
+                memcpy(&span.converted[i], source + i * entry->elementSize, common);
+            }
+            span.data = span.converted.data();
+        }
+
+    private:
+        const ChunkEntry* Find(uint32_t id) const {
+            for (uint32_t i = 0; i < m_Header.chunkCount; ++i) {
+                if (m_Entries[i].id == id) return &m_Entries[i];
+            }
+            return nullptr;
+        }
+
+        const uint8_t* m_Data = nullptr;
+        size_t m_Size = 0;
+        FileHeader m_Header;
+        const ChunkEntry* m_Entries = nullptr;
+    };
+
+    class StringView {
+    public:
+        StringView(const RecordSpan<StringRef>& refs, const RecordSpan<char>& data) : m_Refs(refs), m_Data(data) {}
+
+        bool IsValid(uint32_t index) const { return index == kNoString || index < m_Refs.count; }
+        std::string Get(uint32_t index) const {
+            if (index == kNoString || m_Refs[index].length == 0) return std::string();
+            return std::string(m_Data.data + m_Refs[index].offset, m_Refs[index].length);
+        }
+        bool Validate() const {
+            for (size_t i = 0; i < m_Refs.count; ++i) {
+                if (m_Refs[i].offset > m_Data.count || m_Refs[i].length > m_Data.count - m_Refs[i].offset) return false;
+            }
+            return true;
+        }
+
+    private:
+        const RecordSpan<StringRef>& m_Refs;
+        const RecordSpan<char>& m_Data;
+    };
+
+    // Меш по ключу ассета: общий примитив, уже загруженный меш модели или меш
+    // из файла модели. Модель загружается один раз на всю сцену.
+    std::shared_ptr<Mesh> ResolveMesh(const std::string& assetPath,
+                                      std::unordered_map<std::string, std::shared_ptr<Model>>& models) {
+        if (std::shared_ptr<Mesh> shared = MeshRegistry::Get().Find(assetPath)) return shared;
+        size_t hash = assetPath.rfind('#');
+        if (hash == std::string::npos) return nullptr;
+        std::string modelPath = assetPath.substr(0, hash);
+        size_t meshIndex = (size_t)std::strtoul(assetPath.c_str() + hash + 1, nullptr, 10);
+        std::shared_ptr<Model>& model = models[modelPath];
+        if (!model) model = std::make_shared<Model>(modelPath);
+        const auto& meshes = model->GetMeshes();
+        return meshIndex < meshes.size() ? meshes[meshIndex] : nullptr;
+    }
+
+    void ApplyMaterial(const MaterialRecord& record, const StringView& strings, Material& material) {
+        material.albedo = record.albedo;
+        material.metallic = record.metallic;
+        material.roughness = record.roughness;
+        material.ao = record.ao;
+        material.uvScale = record.uvScale;
+        material.normalStrength = record.normalStrength;
+        material.useWorldUV = record.useWorldUV != 0;
+        material.emissionColor = record.emissionColor;
+        material.emissionIntensity = record.emissionIntensity;
+        // Текстуры грузятся заново, только если файл отличается от уже загруженного
+        for (int slot = 0; slot < Material::kTextureSlotCount; ++slot) {
+            std::string path = strings.Get(record.textures[slot]);
+            if (path == material.GetTexturePath(slot)) continue;
+            if (path.empty()) material.ClearTextureSlot(slot);
+            else material.LoadTextureSlot(slot, path);
+        }
+    }
+
+    MaterialRecord MakeMaterialRecord(const Material& material, StringTable& strings) {
+        MaterialRecord record;
+        record.albedo = material.albedo;
+        record.metallic = material.metallic;
+        record.roughness = material.roughness;
+        record.ao = material.ao;
+        record.uvScale = material.uvScale;
+        record.normalStrength = material.normalStrength;
+        record.useWorldUV = material.useWorldUV ? 1u : 0u;
+        record.emissionColor = material.emissionColor;
+        record.emissionIntensity = material.emissionIntensity;
+        for (int slot = 0; slot < Material::kTextureSlotCount; ++slot) {
+            record.textures[slot] = strings.InternOptional(material.GetTexturePath(slot));
+        }
+        return record;
+    }
+}
+
+bool SceneSerializer::Save(SceneManager& scene, const std::string& filename) {
+    auto start = std::chrono::high_resolution_clock::now();
+    SceneRegistry& registry = SceneRegistry::Get();
+    const TransformPool& transforms = registry.transforms;
+    const auto& sceneObjects = scene.GetObjects();
+
+    // Порядок "родитель раньше детей": обход в глубину от корней
+    std::vector<GameObject*> order;
+    order.reserve(sceneObjects.size());
+    std::vector<GameObject*> stack;
+    for (const auto& object : sceneObjects) {
+        if (object->GetParent()) continue;
+        stack.push_back(object.get());
+        while (!stack.empty()) {
+            GameObject* node = stack.back();
+            stack.pop_back();
+            order.push_back(node);
+            const auto& children = node->GetChildren();
+            for (auto it = children.rbegin(); it != children.rend(); ++it) {
+                if (registry.IsInScene((*it)->GetEntity())) stack.push_back(it->get());
+            }
+        }
+    }
+
+    Entity maxEntity = 0;
+    for (GameObject* object : order) maxEntity = (std::max)(maxEntity, object->GetEntity());
+    std::vector<int32_t> fileIndex(order.empty() ? 0 : (size_t)maxEntity + 1, -1);
+
+    StringTable strings;
+    std::vector<ObjectRecord> objects(order.size());
+    std::vector<TransformRecord> transformRecords(order.size());
+    std::vector<MeshRecord> meshes;
+    std::vector<MaterialRecord> materials;
+    std::vector<RendererRecord> renderers;
+    std::vector<LightRecord> lights;
+    std::vector<CameraRecord> cameras;
+    std::vector<FogRecord> fogs;
+    std::vector<BodyRecord> bodies;
+    std::unordered_map<const Mesh*, int32_t> meshIds;
+    std::unordered_map<const Material*, int32_t> materialIds;
+    size_t unsavedMeshes = 0;
+    const GameObject* activeCamera = scene.GetActiveCamera().get();
+    const GameObject* selected = scene.GetSelectedObject().get();
+
+    for (size_t i = 0; i < order.size(); ++i) {
+        GameObject* object = order[i];
+        Entity e = object->GetEntity();
+        fileIndex[e] = (int32_t)i;
+
+        ObjectRecord& record = objects[i];
+        record.name = strings.Intern(object->GetName());
+        record.parent = object->GetParent() ? fileIndex[object->GetParent()->GetEntity()] : -1;
+        if (object == activeCamera) record.flags |= OBJECT_ACTIVE_CAMERA;
+        if (object == selected) record.flags |= OBJECT_SELECTED;
+
+        uint32_t index = transforms.Index(e);
+        transformRecords[i].position = transforms.positions[index];
+        transformRecords[i].rotation = transforms.rotations[index];
+        transformRecords[i].scale = transforms.scales[index];
+
+        if (const MeshRendererComponent* renderer = registry.renderers.Get(e)) {
+            RendererRecord r;
+            r.object = (uint32_t)i;
+            r.color = renderer->color;
+            r.flags = (renderer->visible ? RENDERER_VISIBLE : 0u) |
+                      (renderer->castShadows ? RENDERER_CAST_SHADOWS : 0u) |
+                      (renderer->receiveShadows ? RENDERER_RECEIVE_SHADOWS : 0u);
+            const Mesh* mesh = renderer->mesh.get();
+            if (mesh && !mesh->GetAssetPath().empty()) {
+                auto inserted = meshIds.emplace(mesh, (int32_t)meshes.size());
+                if (inserted.second) meshes.push_back({ strings.Intern(mesh->GetAssetPath()) });
+                r.mesh = inserted.first->second;
+                if (renderer->material && renderer->material == mesh->GetMaterial()) r.flags |= RENDERER_MESH_MATERIAL;
+            } else if (mesh) {
+                unsavedMeshes++;
+            }
+            if (const Material* material = renderer->material.get()) {
+                auto inserted = materialIds.emplace(material, (int32_t)materials.size());
+                if (inserted.second) materials.push_back(MakeMaterialRecord(*material, strings));
+                r.material = inserted.first->second;
+            }
+            renderers.push_back(r);
+        }
+        if (const LightComponent* light = registry.lights.Get(e)) {
+            LightRecord r;
+            r.object = (uint32_t)i;
+            r.type = light->type;
+            r.color = light->color;
+            r.intensity = light->intensity;
+            r.range = light->range;
+            r.angle = light->angle;
+            r.direction = light->direction;
+            lights.push_back(r);
+        }
+        if (const CameraComponent* camera = registry.cameras.Get(e)) {
+            cameras.push_back({ (uint32_t)i, camera->fov, camera->nearPlane, camera->farPlane });
+        }
+        if (const FogComponent* fog = registry.fogs.Get(e)) {
+            FogRecord r;
+            r.object = (uint32_t)i;
+            r.enabled = fog->enabled ? 1u : 0u;
+            r.type = fog->type;
+            r.color = fog->color;
+            r.density = fog->density;
+            r.linearStart = fog->linearStart;
+            r.linearEnd = fog->linearEnd;
+            fogs.push_back(r);
+        }
+        if (const RigidBodyComponent* body = registry.bodies.Get(e)) {
+            BodyRecord r;
+            r.object = (uint32_t)i;
+            r.collider = body->collider;
+            r.mass = body->mass;
+            r.friction = body->friction;
+            r.restitution = body->restitution;
+            r.rollingFriction = body->rollingFriction;
+            r.linearDamping = body->linearDamping;
+            r.angularDamping = body->angularDamping;
+            bodies.push_back(r);
+        }
+    }
+
+    const SceneManager::FogSettings& fog = scene.GetFogSettings();
+    SettingsRecord settings;
+    settings.fogEnabled = fog.enabled ? 1u : 0u;
+    settings.fogType = fog.type;
+    settings.fogColor = fog.color;
+    settings.fogDensity = fog.density;
+    settings.fogLinearStart = fog.linearStart;
+    settings.fogLinearEnd = fog.linearEnd;
+
+    ChunkWriter writer;
+    writer.Add(CHUNK_STRING_REFS, strings.GetRefs());
+    writer.Add(CHUNK_STRING_DATA, strings.GetData());
+    writer.Add(CHUNK_OBJECTS, objects);
+    writer.Add(CHUNK_TRANSFORMS, transformRecords);
+    writer.Add(CHUNK_MESHES, meshes);
+    writer.Add(CHUNK_MATERIALS, materials);
+    writer.Add(CHUNK_RENDERERS, renderers);
+    writer.Add(CHUNK_LIGHTS, lights);
+    writer.Add(CHUNK_CAMERAS, cameras);
+    writer.Add(CHUNK_FOGS, fogs);
+    writer.Add(CHUNK_BODIES, bodies);
+    std::vector<SettingsRecord> settingsChunk(1, settings);
+    writer.Add(CHUNK_SETTINGS, settingsChunk);
+
+    size_t bytes = 0;
+    if (!writer.Write(filename, (uint32_t)objects.size(), bytes)) {
+        std::cerr << "[Scene] Cannot write " << filename << std::endl;
+        return false;
+    }
+    if (unsavedMeshes > 0) {
+        std::cerr << "[Scene] " << unsavedMeshes << " objects use meshes without an asset path; saved without mesh" << std::endl;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "[Scene] Saved " << objects.size() << " objects to " << filename << " (" << bytes / 1024 << " KB) in "
+              << std::chrono::duration<float, std::milli>(end - start).count() << " ms" << std::endl;
+    return true;
+}
+
+bool SceneSerializer::Load(SceneManager& scene, const std::string& filename) {
+    auto start = std::chrono::high_resolution_clock::now();
+    MappedFile file;
+    if (!file.Open(filename)) {
+        std::cerr << "[Scene] Cannot open " << filename << std::endl;
+        return false;
+    }
+    ChunkReader reader;
+    if (!reader.Open(file)) {
+        std::cerr << "[Scene] " << filename << " is not a .binax scene or has an unsupported version" << std::endl;
+        return false;
+    }
+
+    RecordSpan<StringRef> stringRefs;
+    RecordSpan<char> stringData;
+    RecordSpan<ObjectRecord> objects;
+    RecordSpan<TransformRecord> transformRecords;
+    RecordSpan<MeshRecord> meshRecords;
+    RecordSpan<MaterialRecord> materialRecords;
+    RecordSpan<RendererRecord> renderers;
+    RecordSpan<LightRecord> lights;
+    RecordSpan<CameraRecord> cameras;
+    RecordSpan<FogRecord> fogs;
+    RecordSpan<BodyRecord> bodies;
+    RecordSpan<SettingsRecord> settings;
+    reader.Read(CHUNK_STRING_REFS, stringRefs);
+    reader.Read(CHUNK_STRING_DATA, stringData);
+    reader.Read(CHUNK_OBJECTS, objects);
+    reader.Read(CHUNK_TRANSFORMS, transformRecords);
+    reader.Read(CHUNK_MESHES, meshRecords);
+    reader.Read(CHUNK_MATERIALS, materialRecords);
+    reader.Read(CHUNK_RENDERERS, renderers);
+    reader.Read(CHUNK_LIGHTS, lights);
+    reader.Read(CHUNK_CAMERAS, cameras);
+    reader.Read(CHUNK_FOGS, fogs);
+    reader.Read(CHUNK_BODIES, bodies);
+    reader.Read(CHUNK_SETTINGS, settings);
+    StringView strings(stringRefs, stringData);
+
+    // Проверяем все ссылки до того, как трогать сцену
+    const size_t objectCount = objects.count;
+    bool valid = strings.Validate() && transformRecords.count == objectCount;
+    for (size_t i = 0; valid && i < objectCount; ++i) {
+        valid = strings.IsValid(objects[i].name) && objects[i].parent < (int32_t)i;
+    }
+    for (size_t i = 0; valid && i < meshRecords.count; ++i) valid = strings.IsValid(meshRecords[i].assetPath);
+    for (size_t i = 0; valid && i < materialRecords.count; ++i) {
+        for (int slot = 0; valid && slot < Material::kTextureSlotCount; ++slot) {
+            valid = strings.IsValid(materialRecords[i].textures[slot]);
+        }
+    }
+    for (size_t i = 0; valid && i < renderers.count; ++i) {
+        const RendererRecord& r = renderers[i];
+        valid = r.object < objectCount && r.mesh < (int32_t)meshRecords.count && r.material < (int32_t)materialRecords.count;
+    }
+    for (size_t i = 0; valid && i < lights.count; ++i) valid = lights[i].object < objectCount;
+    for (size_t i = 0; valid && i < cameras.count; ++i) valid = cameras[i].object < objectCount;
+    for (size_t i = 0; valid && i < fogs.count; ++i) valid = fogs[i].object < objectCount;
+    for (size_t i = 0; valid && i < bodies.count; ++i) {
+        valid = bodies[i].object < objectCount && bodies[i].collider >= COLLIDER_NONE &&
+                bodies[i].collider <= COLLIDER_CAPSULE;
+    }
+    if (!valid) {
+        std::cerr << "[Scene] " << filename << " is corrupted" << std::endl;
+        return false;
+    }
+
+    // Ассеты — до очистки сцены, чтобы одинаковые примитивы не пересоздавались лишний раз
+    std::unordered_map<std::string, std::shared_ptr<Model>> models;
+    std::vector<std::shared_ptr<Mesh>> meshes(meshRecords.count);
+    for (size_t i = 0; i < meshRecords.count; ++i) {
+        std::string assetPath = strings.Get(meshRecords[i].assetPath);
+        meshes[i] = ResolveMesh(assetPath, models);
+        if (!meshes[i]) std::cerr << "[Scene] Missing mesh asset: " << assetPath << std::endl;
+    }
+    std::vector<std::shared_ptr<Material>> materials(materialRecords.count);
+
+    scene.ClearScene();
+    scene.ReserveObjects(objectCount);
+    SceneRegistry& registry = SceneRegistry::Get();
+    TransformPool& transforms = registry.transforms;
+
+    std::vector<std::shared_ptr<GameObject>> created(objectCount);
+    for (size_t i = 0; i < objectCount; ++i) {
+        std::shared_ptr<GameObject> object = scene.CreateGameObject(strings.Get(objects[i].name));
+        // Сущность только что создана: кэш матриц и границ уже помечен грязным,
+        // поэтому трансформация пишется прямо в пул
+        uint32_t index = transforms.Index(object->GetEntity());
+        transforms.positions[index] = transformRecords[i].position;
+        transforms.rotations[index] = transformRecords[i].rotation;
+        transforms.scales[index] = transformRecords[i].scale;
+        if (objects[i].parent >= 0) object->AttachToParent(created[objects[i].parent].get(), false);
+        created[i] = std::move(object);
+    }
+
+    for (size_t i = 0; i < renderers.count; ++i) {
+        const RendererRecord& r = renderers[i];
+        Entity e = created[r.object]->GetEntity();
+        MeshRendererComponent& renderer = registry.renderers.Add(e);
+        renderer.mesh = r.mesh >= 0 ? meshes[r.mesh] : nullptr;
+        renderer.color = r.color;
+        renderer.visible = (r.flags & RENDERER_VISIBLE) != 0;
+        renderer.castShadows = (r.flags & RENDERER_CAST_SHADOWS) != 0;
+        renderer.receiveShadows = (r.flags & RENDERER_RECEIVE_SHADOWS) != 0;
+        if (r.material >= 0) {
+            std::shared_ptr<Material>& material = materials[r.material];
+            if (!material) {
+                // Материал модели уже создан вместе с мешем — правим его, а не плодим копию
+                if ((r.flags & RENDERER_MESH_MATERIAL) && renderer.mesh && renderer.mesh->GetMaterial()) {
+                    material = renderer.mesh->GetMaterial();
+                } else {
+                    material = std::make_shared<Material>();
+                }
+                ApplyMaterial(materialRecords[r.material], strings, *material);
+            }
+            renderer.material = material;
+        }
+        registry.NotifyChanged(e, CHANGE_RENDERER);
+    }
+    for (size_t i = 0; i < lights.count; ++i) {
+        const LightRecord& r = lights[i];
+        if (r.type == LT_NONE) continue;
+        Entity e = created[r.object]->GetEntity();
+        LightComponent& light = registry.lights.Add(e);
+        light.type = r.type;
+        light.color = r.color;
+        light.intensity = r.intensity;
+        light.range = r.range;
+        light.angle = r.angle;
+        light.direction = r.direction;
+        registry.NotifyChanged(e, CHANGE_LIGHT);
+    }
+    for (size_t i = 0; i < cameras.count; ++i) {
+        const CameraRecord& r = cameras[i];
+        Entity e = created[r.object]->GetEntity();
+        CameraComponent& camera = registry.cameras.Add(e);
+        camera.fov = r.fov;
+        camera.nearPlane = r.nearPlane;
+        camera.farPlane = r.farPlane;
+        registry.NotifyChanged(e, CHANGE_CAMERA);
+    }
+    for (size_t i = 0; i < fogs.count; ++i) {
+        const FogRecord& r = fogs[i];
+        Entity e = created[r.object]->GetEntity();
+        FogComponent& fog = registry.fogs.Add(e);
+        fog.enabled = r.enabled != 0;
+        fog.type = r.type;
+        fog.color = r.color;
+        fog.density = r.density;
+        fog.linearStart = r.linearStart;
+        fog.linearEnd = r.linearEnd;
+        registry.NotifyChanged(e, CHANGE_FOG);
+    }
+    for (size_t i = 0; i < bodies.count; ++i) {
+        const BodyRecord& r = bodies[i];
+        GameObject& object = *created[r.object];
+        RigidBodyComponent& body = registry.bodies.Add(object.GetEntity());
+        body.mass = r.mass;
+        body.friction = r.friction;
+        body.restitution = r.restitution;
+        body.rollingFriction = r.rollingFriction;
+        body.linearDamping = r.linearDamping;
+        body.angularDamping = r.angularDamping;
+        registry.NotifyChanged(object.GetEntity(), CHANGE_BODY);
+        // Тело Bullet создаётся заново по коллайдеру и массе
+        if (r.collider != COLLIDER_NONE) {
+            object.SetColliderType((ColliderType)r.collider);
+            object.SaveInitialTransform();
+        }
+    }
+
+    for (size_t i = 0; i < objectCount; ++i) {
+        if (objects[i].flags & OBJECT_ACTIVE_CAMERA) scene.SetActiveCamera(created[i]);
+        if (objects[i].flags & OBJECT_SELECTED) scene.SetSelectedObject(created[i]);
+    }
+    if (settings.count > 0) {
+        SceneManager::FogSettings& fog = scene.GetFogSettings();
+        fog.enabled = settings[0].fogEnabled != 0;
+        fog.type = settings[0].fogType;
+        fog.color = settings[0].fogColor;
+        fog.density = settings[0].fogDensity;
+        fog.linearStart = settings[0].fogLinearStart;
+        fog.linearEnd = settings[0].fogLinearEnd;
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "[Scene] Loaded " << objectCount << " objects from " << filename << " in "
+              << std::chrono::duration<float, std::milli>(end - start).count() << " ms" << std::endl;
+    return true;
+}
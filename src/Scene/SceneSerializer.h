@@ -0,0 +1,63 @@
+#pragma once
+#include <string>
+#include <cstdint>
+
+class SceneManager;
+
+// Бинарный формат сцены .binax (little-endian):
+//   FileHeader | ChunkEntry[chunkCount] | данные чанков (каждый выровнен на 16 байт)
+// Чанк — плотный массив POD-записей одного типа. elementSize в таблице чанков
+// позволяет дописывать поля в конец записи без смены версии: загрузчик берёт
+// общий префикс, остальное — значения по умолчанию. Неизвестные чанки пропускаются.
+// Объекты лежат в порядке "родитель раньше детей"; индекс объекта — номер записи
+// в чанке OBJS, компоненты ссылаются на него. Меши и материалы — ссылки на
+// ассеты (Mesh::GetAssetPath, Material::GetTexturePath), не данные.
+namespace Binax {
+    const uint32_t kMagic = 0x53584E42;     // "BNXS"
+    const uint32_t kVersion = 1;
+    const uint32_t kNoString = 0xFFFFFFFFu;
+
+    constexpr uint32_t FourCC(char a, char b, char c, char d) {
+        return (uint32_t)(uint8_t)a | ((uint32_t)(uint8_t)b << 8) | ((uint32_t)(uint8_t)c << 16) | ((uint32_t)(uint8_t)d << 24);
+    }
+
+    enum ChunkId : uint32_t {
+        CHUNK_STRING_REFS = FourCC('S', 'T', 'R', 'I'),  // StringRef
+        CHUNK_STRING_DATA = FourCC('S', 'T', 'R', 'D'),  // символы всех строк подряд
+        CHUNK_OBJECTS = FourCC('O', 'B', 'J', 'S'),      // ObjectRecord (имя, родитель)
+        CHUNK_TRANSFORMS = FourCC('X', 'F', 'R', 'M'),   // TransformRecord, параллельно OBJS
+        CHUNK_MESHES = FourCC('M', 'E', 'S', 'H'),       // MeshRecord
+        CHUNK_MATERIALS = FourCC('M', 'A', 'T', 'L'),    // MaterialRecord
+        CHUNK_RENDERERS = FourCC('R', 'E', 'N', 'D'),
+        CHUNK_LIGHTS = FourCC('L', 'I', 'T', 'E'),
+        CHUNK_CAMERAS = FourCC('C', 'A', 'M', 'R'),
+        CHUNK_FOGS = FourCC('F', 'O', 'G', 'V'),
+        CHUNK_BODIES = FourCC('B', 'O', 'D', 'Y'),
+        CHUNK_SETTINGS = FourCC('S', 'E', 'T', 'T')      // глобальный туман SceneManager
+    };
+
+    struct FileHeader {
+        uint32_t magic = kMagic;
+        uint32_t version = kVersion;
+        uint32_t chunkCount = 0;
+        uint32_t objectCount = 0;
+    };
+
+    struct ChunkEntry {
+        uint32_t id = 0;
+        uint32_t elementSize = 0;
+        uint32_t count = 0;
+        uint32_t reserved = 0;
+        uint64_t offset = 0;        // от начала файла
+        uint64_t size = 0;          // байт (elementSize * count)
+    };
+}
+
+// Сохранение и загрузка сцены. Загрузка отображает файл в память и раскладывает
+// чанки прямо в пулы SceneRegistry, без разбора по полям.
+class SceneSerializer {
+public:
+    static bool Save(SceneManager& scene, const std::string& filename);
+    // Заменяет содержимое сцены; при ошибке формата сцена не трогается
+    static bool Load(SceneManager& scene, const std::string& filename);
+};
@@ -0,0 +1,189 @@
+#include "Scene/StaticBatcher.h"
+#include "Scene/GameObject.h"
+#include "Graphics/Mesh.h"
+#include "Graphics/Material.h"
+#include <iostream>
+#include <map>
+#include <unordered_map>
+#include <chrono>
+#include <cmath>
+#include <tuple>
+
+namespace {
+    // Объекты одного пакета неразличимы для шейдера: материал, цвет, флаги теней
+    // и ячейка пространства
+    struct BatchKey {
+        const Material* material;
+        glm::vec3 color;
+        bool receiveShadows;
+        bool castShadows;
+        glm::ivec3 cell;
+
+        bool operator<(const BatchKey& other) const {
+            return std::tie(material, color.x, color.y, color.z, receiveShadows, castShadows, cell.x, cell.y, cell.z) <
+                   std::tie(other.material, other.color.x, other.color.y, other.color.z, other.receiveShadows,
+                            other.castShadows, other.cell.x, other.cell.y, other.cell.z);
+        }
+    };
+
+    struct SourceGeometry {
+        std::vector<Vertex> vertices;
+        std::vector<unsigned int> indices;
+    };
+
+    glm::vec3 Normalized(const glm::vec3& v) {
+        float length = glm::length(v);
+        return length > 0.0f ? v / length : v;
+    }
+
+    // Вершины в мировые координаты: нормали — обратной транспонированной,
+    // касательные — самой матрицей; зеркальная матрица переворачивает знак битангенса
+    void AppendTransformed(const SourceGeometry& source, const glm::mat4& model,
+                           std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+        glm::mat3 linear(model);
+        glm::mat3 normalMatrix = glm::transpose(glm::inverse(linear));
+        float handedness = glm::determinant(linear) < 0.0f ? -1.0f : 1.0f;
+        unsigned int base = (unsigned int)vertices.size();
+
+        for (const Vertex& src : source.vertices) {
+            Vertex v = src;
+            glm::vec3 position = glm::vec3(model * glm::vec4(src.Position[0], src.Position[1], src.Position[2], 1.0f));
+            glm::vec3 normal = Normalized(normalMatrix * glm::vec3(src.Normal[0], src.Normal[1], src.Normal[2]));
+            glm::vec3 tangent = Normalized(linear * glm::vec3(src.Tangent[0], src.Tangent[1], src.Tangent[2]));
+            for (int axis = 0; axis < 3; ++axis) {
+                v.Position[axis] = position[axis];
+                v.Normal[axis] = normal[axis];
+                v.Tangent[axis] = tangent[axis];
+            }
+            v.TangentSign = src.TangentSign * handedness;
+            vertices.push_back(v);
+        }
+        for (unsigned int index : source.indices) indices.push_back(base + index);
+    }
+}
+
+bool StaticBatcher::CanBatch(const GameObject* object) {
+    if (!object->IsVisible() || !object->GetMesh()) return false;
+    // Большие меши отсекаются по кластерам — в пакете это потерялось бы
+    if (!object->GetMesh()->GetMeshlets().empty()) return false;
+    if (object->HasRigidBody() && object->GetMass() > 0.0f) return false;
+    // Нулевой масштаб: нормали не перенести
+    if (glm::determinant(glm::mat3(object->GetTransformMatrix())) == 0.0f) return false;
+    return object->GetLightType() == LT_NONE && !object->IsCamera() && !object->IsFog();
+}
+
+size_t StaticBatcher::Bake(const std::vector<GameObject*>& objects) {
+    auto start = std::chrono::high_resolution_clock::now();
+    Clear();
+
+    std::map<BatchKey, std::vector<GameObject*>> groups;
+    for (GameObject* object : objects) {
+        if (!CanBatch(object)) continue;
+        glm::vec3 center = object->GetWorldBounds().GetCenter();
+        BatchKey key;
+        key.material = object->GetRenderMaterialPtr();
+        key.color = object->GetColor();
+        key.receiveShadows = object->ReceiveShadows();
+        key.castShadows = object->CastShadows();
+        key.cell = glm::ivec3(glm::floor(center / kCellSize));
+        groups[key].push_back(object);
+    }
+
+    // Каждый исходный меш читается из GPU один раз на запекание
+    std::unordered_map<const Mesh*, SourceGeometry> sources;
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    std::vector<GameObject*> members;
+
+    auto flush = [&]() {
+        // Пакет из одного объекта не экономит вызовов, зато теряет LOD и инстансинг
+        if (members.size() >= 2) {
+            Chunk chunk;
+            chunk.mesh = std::make_shared<Mesh>(vertices.data(), vertices.size(), indices.data(), indices.size());
+            chunk.mesh->SetName("StaticBatch");
+            chunk.bounds = chunk.mesh->GetBoundingBox();
+            GameObject* first = members.front();
+            chunk.material = first->GetRenderMaterial();
+            chunk.color = first->GetColor();
+            chunk.receiveShadows = first->ReceiveShadows();
+            chunk.castShadows = first->CastShadows();
+
+            uint32_t firstIndex = 0;
+            for (GameObject* object : members) {
+                Range range;
+                range.entity = object->GetEntity();
+                range.firstIndex = firstIndex;
+                range.indexCount = (uint32_t)sources[object->GetMeshPtr()].indices.size();
+                range.bounds = object->GetWorldBounds();
+                firstIndex += range.indexCount;
+
+                Entity e = range.entity;
+                if (e >= m_Locations.size()) m_Locations.resize((size_t)e + 1);
+                m_Locations[e] = { (uint32_t)m_Chunks.size(), (uint32_t)chunk.ranges.size() };
+                m_Batched.Insert(e);
+                chunk.ranges.push_back(range);
+            }
+            chunk.activeRanges = chunk.ranges.size();
+            m_Chunks.push_back(std::move(chunk));
+        }
+        vertices.clear();
+        indices.clear();
+        members.clear();
+    };
+
+    for (auto& group : groups) {
+        for (GameObject* object : group.second) {
+            const Mesh* mesh = object->GetMeshPtr();
+            auto it = sources.find(mesh);
+            if (it == sources.end()) {
+                it = sources.emplace(mesh, SourceGeometry()).first;
+                mesh->ReadBack(it->second.vertices, it->second.indices);
+            }
+            const SourceGeometry& source = it->second;
+            if (source.indices.empty() || source.vertices.size() > kMaxChunkVertices) continue;
+            if (vertices.size() + source.vertices.size() > kMaxChunkVertices) flush();
+            AppendTransformed(source, object->GetTransformMatrix(), vertices, indices);
+            members.push_back(object);
+        }
+        flush();
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    m_BakeMs = std::chrono::duration<float, std::milli>(end - start).count();
+    std::cout << "[StaticBatch] " << m_Batched.Size() << " objects baked into " << m_Chunks.size()
+              << " batches (" << sources.size() << " source meshes) in " << m_BakeMs << " ms" << std::endl;
+    return m_Batched.Size();
+}
+
+void StaticBatcher::Clear() {
+    m_Chunks.clear();
+    m_Batched = EntitySet();
+    m_Locations.clear();
+}
+
+void StaticBatcher::Release(Entity entity) {
+    if (!m_Batched.Contains(entity)) return;
+    m_Batched.Erase(entity);
+    const Location& location = m_Locations[entity];
+    Chunk& chunk = m_Chunks[location.chunk];
+    Range& range = chunk.ranges[location.range];
+    if (!range.active) return;
+    range.active = false;
+    // Пустой пакет больше не нужен — освобождаем буферы сразу
+    if (--chunk.activeRanges == 0) chunk.mesh.reset();
+}
+
+StaticBatcher::Stats StaticBatcher::GetStats() const {
+    Stats stats;
+    stats.objects = m_Batched.Size();
+    stats.bakeMs = m_BakeMs;
+    for (const Chunk& chunk : m_Chunks) {
+        if (chunk.activeRanges == 0) continue;
+        stats.chunks++;
+        stats.vertices += chunk.mesh->GetVertexCount();
+        for (const Range& range : chunk.ranges) {
+            if (range.active) stats.triangles += range.indexCount / 3;
+        }
+    }
+    return stats;
+}
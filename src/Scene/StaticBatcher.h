@@ -0,0 +1,77 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "Graphics/Bounds.h"
+#include "Scene/SceneRegistry.h"
+
+class GameObject;
+class Mesh;
+class Material;
+
+// Статические пакеты: неподвижные объекты с общим материалом (и цветом, флагами
+// теней) сливаются в один меш с уже применёнными мировыми матрицами. Пакет режется
+// по ячейкам пространства и по 65535 вершин — индексы остаются 16-битными.
+// Каждый объект — свой диапазон EBO: диапазоны отсекаются по отдельности и
+// рисуются одним glMultiDrawElements на пакет. Объект в пакете остаётся в сцене
+// (выделение, raycast, дерево), только не рисуется сам; Release возвращает его
+// обратно, диапазон при этом выпадает из пакета
+class StaticBatcher {
+public:
+    static const size_t kMaxChunkVertices = 65535;
+    static constexpr float kCellSize = 64.0f;
+
+    // Видимый, с мешем без кластеров, без динамического тела, с невырожденной
+    // матрицей; не свет, камера или туман
+    static bool CanBatch(const GameObject* object);
+
+    struct Range {
+        Entity entity = 0;
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+        AABB bounds;                // мировые границы объекта на момент запекания
+        bool active = true;
+    };
+
+    struct Chunk {
+        std::shared_ptr<Mesh> mesh;             // сбрасывается, когда пакет опустел
+        std::shared_ptr<Material> material;
+        glm::vec3 color = glm::vec3(1.0f);
+        bool receiveShadows = true;
+        bool castShadows = true;
+        AABB bounds;
+        std::vector<Range> ranges;              // по возрастанию firstIndex
+        size_t activeRanges = 0;
+    };
+
+    struct Stats {
+        size_t chunks = 0;          // непустых пакетов
+        size_t objects = 0;         // объектов в пакетах
+        size_t vertices = 0;
+        size_t triangles = 0;
+        float bakeMs = 0.0f;
+    };
+
+    // Прежние пакеты распускаются. Объекты без пары по ключу остаются как есть.
+    // Нужен GL-контекст: исходные меши читаются обратно из буферов.
+    // Возвращает число объектов в пакетах
+    size_t Bake(const std::vector<GameObject*>& objects);
+    void Clear();
+    // Объект снова рисуется сам
+    void Release(Entity entity);
+    bool IsBatched(Entity entity) const { return m_Batched.Contains(entity); }
+
+    const std::vector<Chunk>& GetChunks() const { return m_Chunks; }
+    Stats GetStats() const;
+
+private:
+    struct Location {
+        uint32_t chunk;
+        uint32_t range;
+    };
+    std::vector<Chunk> m_Chunks;
+    EntitySet m_Batched;
+    std::vector<Location> m_Locations;      // по сущности, для m_Batched
+    float m_BakeMs = 0.0f;
+};
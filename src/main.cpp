@@ -7,6 +7,11 @@
 #include <glm/gtc/type_ptr.hpp>
 #include "Graphics/Shader.h"
 #include "Graphics/Skybox.h"
+#include "Graphics/UniformBuffer.h"
+#include "Graphics/LightClusters.h"
+#include "Graphics/ShadowCascades.h"
+#include "Graphics/MaterialTable.h"
+#include "Graphics/TextureManager.h"
 #include "Graphics/Primitives.h"
 #include "Scene/SceneManager.h"
 #include "Editor/EditorUI.h"
@@ -31,11 +36,16 @@ Shader screenFogShader;  // шейдер для пост-эффекта тума
 
 Skybox skybox;
 
-// Карта теней
-unsigned int depthMapFBO;
-unsigned int depthMap;
-unsigned int SHADOW_WIDTH = 2048;
-unsigned int SHADOW_HEIGHT = 2048;
+// Общие UBO: данные кадра и источники света (std140, фиксированные точки привязки)
+UniformBuffer frameUBO;
+UniformBuffer lightsUBO;
+
+// Кластерное освещение для точечных источников и прожекторов
+LightClusters lightClusters;
+std::vector<LightData> lightScratch;
+
+// Каскадные карты теней
+ShadowCascades shadowCascades;
 
 // Для пост-эффектов
 unsigned int framebuffer;
@@ -50,7 +60,6 @@ void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
 bool initShaders();
 bool initShadowMap();
-glm::mat4 calculateLightSpaceMatrix(const glm::vec3& lightPos, const glm::vec3& center = glm::vec3(0.0f));
 void initPostProcessing(int width, int height);
 void renderFullScreenQuad();
 
@@ -152,6 +161,11 @@ int main() {
     if (!initShaders()) return -1;
     if (!initShadowMap()) return -1;
 
+    frameUBO.Create(sizeof(FrameConstants), UBO_FRAME_CONSTANTS);
+    lightsUBO.Create(sizeof(LightsBlock), UBO_LIGHTS);
+    lightClusters.Initialize();
+    g_EditorUI.SetLightClusters(&lightClusters);
+
     initPostProcessing(SCR_WIDTH, SCR_HEIGHT);
 
     skybox.Load(
@@ -173,17 +187,14 @@ int main() {
 
         auto& settings = g_EditorUI.GetSettings();
 
-        static unsigned int lastShadowMapSize = SHADOW_WIDTH;
-        if (settings.shadowMapSize != lastShadowMapSize) {
-            lastShadowMapSize = settings.shadowMapSize;
-            SHADOW_WIDTH = settings.shadowMapSize;
-            SHADOW_HEIGHT = settings.shadowMapSize;
-            glDeleteFramebuffers(1, &depthMapFBO);
-            glDeleteTextures(1, &depthMap);
-            initShadowMap();
-        }
+        // Пересоздаётся только при смене размера или числа каскадов
+        shadowCascades.Resize(settings.shadowMapSize, settings.shadowCascades);
+
+        // Декодированные в фоне текстуры — в GL, не дольше бюджета кадра
+        TextureManager::Get().Update(4.0f);
 
         g_SceneManager.UpdatePhysics(deltaTime);
+        g_SceneManager.Update(deltaTime);
 
         auto activeCamera = g_SceneManager.GetActiveCamera();
         if (!activeCamera) {
@@ -196,25 +207,98 @@ int main() {
         glm::mat4 projection = activeCamera->GetCameraProjectionMatrix(aspect);
         glm::mat4 view = activeCamera->GetCameraViewMatrix();
 
-        // --- Находим направленный свет для карты теней ---
-        glm::vec3 directionalLightPos(2.0f, 4.0f, 2.0f);
+        // --- Находим направленный свет для карты теней (реестр сцены по типу, без обхода объектов) ---
+        SceneRegistry& registry = SceneRegistry::Get();
+        const std::vector<Entity>& directionalLights = g_SceneManager.GetLights(LT_DIRECTIONAL);
         glm::vec3 directionalLightDir = glm::vec3(-1.0f, -1.0f, 0.0f);
-        for (const auto& obj : g_SceneManager.GetObjects()) {
-            if (obj->GetLightType() == LT_DIRECTIONAL) {
-                directionalLightPos = obj->GetWorldPosition();
-                directionalLightDir = obj->GetLightDirection();
-                break;
-            }
+        if (!directionalLights.empty()) {
+            directionalLightDir = registry.lights.Get(directionalLights.front())->direction;
         }
-        glm::mat4 lightSpaceMatrix = calculateLightSpaceMatrix(directionalLightPos);
-
-        // --- Рендер карты теней ---
-        glViewport(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT);
-        glBindFramebuffer(GL_FRAMEBUFFER, depthMapFBO);
-        glClear(GL_DEPTH_BUFFER_BIT);
+        // Каскады по срезам пирамиды камеры, в направлении того же света, что и в освещении
+        shadowCascades.splitLambda = settings.cascadeSplitLambda;
+        shadowCascades.Update(view, glm::radians(activeCamera->GetCameraFOV()), aspect,
+                              activeCamera->GetCameraNear(), activeCamera->GetCameraFar(),
+                              directionalLightDir, g_SceneManager.GetSceneBounds());
+
+        // --- Данные кадра: один раз в UBO для всех шейдеров ---
+        FrameConstants frame = {};
+        frame.view = view;
+        frame.projection = projection;
+        frame.invView = glm::inverse(view);
+        frame.invProjection = glm::inverse(projection);
+        frame.cascadeCount = shadowCascades.GetCascadeCount();
+        for (int i = 0; i < frame.cascadeCount; ++i) {
+            frame.lightSpaceMatrices[i] = shadowCascades.GetMatrix(i);
+            frame.cascadeSplits[i] = shadowCascades.GetSplit(i);
+        }
+        frame.viewPos = glm::vec4(activeCamera->GetWorldPosition(), 1.0f);
+        frame.shadowsEnabled = settings.shadows_enabled ? 1 : 0;
+        frame.shadowBias = settings.shadow_bias;
+        frame.shadowSoftness = settings.shadowSoftness;
+        frame.shadowSamples = settings.shadowSamples;
+        frame.ambientStrength = settings.ambientStrength;
+        auto fogObj = g_SceneManager.GetActiveFog();
+        if (fogObj && fogObj->GetFogEnabled()) {
+            frame.fogEnabled = 1;
+            frame.fogType = fogObj->GetFogType();
+            frame.fogDensity = fogObj->GetFogDensity();
+            frame.fogColor = glm::vec4(fogObj->GetFogColor(), 1.0f);
+            frame.fogStart = fogObj->GetFogLinearStart();
+            frame.fogEnd = fogObj->GetFogLinearEnd();
+        }
+        frameUBO.Update(frame);
+
+        // --- Источники света ---
+        // Направленные — в UBO, точечные и прожекторы — в кластерную сетку без лимита
+        LightsBlock lightsBlock = {};
+        std::vector<LightData>& clusteredLights = lightScratch;
+        clusteredLights.clear();
+        for (Entity e : directionalLights) {
+            if (lightsBlock.clusterGrid.w >= MAX_DIRECTIONAL_LIGHTS) break;
+            const LightComponent& light = *registry.lights.Get(e);
+            LightData ld = {};
+            ld.colorIntensity = glm::vec4(light.color, light.intensity);
+            ld.positionType = glm::vec4(0.0f, 0.0f, 0.0f, (float)LT_DIRECTIONAL);
+            ld.directionRange = glm::vec4(light.direction, 0.0f);
+            lightsBlock.directionalLights[lightsBlock.clusterGrid.w++] = ld;
+        }
+        // Позиции — из кэша мировых матриц
+        for (Entity e : g_SceneManager.GetLights(LT_POINT)) {
+            const LightComponent& light = *registry.lights.Get(e);
+            LightData ld = {};
+            ld.colorIntensity = glm::vec4(light.color, light.intensity);
+            ld.positionType = glm::vec4(glm::vec3(registry.GetWorldMatrix(e)[3]), (float)LT_POINT);
+            ld.directionRange = glm::vec4(0.0f, 0.0f, 0.0f, light.range);
+            clusteredLights.push_back(ld);
+        }
+        for (Entity e : g_SceneManager.GetLights(LT_SPOT)) {
+            const LightComponent& light = *registry.lights.Get(e);
+            LightData ld = {};
+            ld.colorIntensity = glm::vec4(light.color, light.intensity);
+            ld.positionType = glm::vec4(glm::vec3(registry.GetWorldMatrix(e)[3]), (float)LT_SPOT);
+            ld.directionRange = glm::vec4(light.direction, light.range);
+            ld.spotAngle = glm::vec4(light.angle, 0.0f, 0.0f, 0.0f);
+            clusteredLights.push_back(ld);
+        }
+        lightClusters.Build(clusteredLights, view, glm::radians(activeCamera->GetCameraFOV()), aspect,
+                            activeCamera->GetCameraNear(), activeCamera->GetCameraFar(),
+                            SCR_WIDTH, SCR_HEIGHT);
+        glm::ivec4 grid = lightClusters.GetGridSize();
+        lightsBlock.clusterGrid = glm::ivec4(grid.x, grid.y, grid.z, lightsBlock.clusterGrid.w);
+        lightsBlock.clusterParams = lightClusters.GetClusterParams();
+        lightsUBO.Update(lightsBlock);
+
+        g_SceneManager.SetCameraFrustum(projection * view);
+        g_SceneManager.SetLodCamera(activeCamera->GetWorldPosition(), projection[1][1]);
+
+        // --- Рендер каскадов теней: у каждого своё отсечение ---
         depthShader.Use();
-        depthShader.SetMat4("lightSpaceMatrix", glm::value_ptr(lightSpaceMatrix));
-        g_SceneManager.RenderDepth(depthShader);
+        for (int i = 0; i < shadowCascades.GetCascadeCount(); ++i) {
+            shadowCascades.BeginCascade(i);
+            g_SceneManager.SetShadowFrustum(shadowCascades.GetMatrix(i));
+            depthShader.SetInt("cascadeIndex", i);
+            g_SceneManager.RenderDepth(depthShader, i);
+        }
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
         // --- Рендер сцены в текстуру (FBO) ---
@@ -226,91 +310,22 @@ int main() {
         // Скайбокс
         glDepthMask(GL_FALSE);
         skyboxShader.Use();
-        glm::mat4 viewNoTranslation = glm::mat4(glm::mat3(view));
-        skyboxShader.SetMat4("view", glm::value_ptr(viewNoTranslation));
-        skyboxShader.SetMat4("projection", glm::value_ptr(projection));
         skybox.Draw();
         glDepthMask(GL_TRUE);
 
         // Сетка
         if (settings.grid_enabled) {
-            gridShader.Use();
-            gridShader.SetMat4("view", glm::value_ptr(view));
-            gridShader.SetMat4("projection", glm::value_ptr(projection));
-            gridShader.SetVec3("viewPos", activeCamera->GetWorldPosition().x,
-                                         activeCamera->GetWorldPosition().y,
-                                         activeCamera->GetWorldPosition().z);
-            g_SceneManager.RenderGrid(gridShader, view, projection);
+            g_SceneManager.RenderGrid(gridShader);
         }
 
         // Основные объекты
         shader.Use();
-        shader.SetMat4("projection", glm::value_ptr(projection));
-        shader.SetMat4("view", glm::value_ptr(view));
-        shader.SetVec3("viewPos", activeCamera->GetWorldPosition().x,
-                                 activeCamera->GetWorldPosition().y,
-                                 activeCamera->GetWorldPosition().z);
+        // Значения по умолчанию для объектов без материала
         shader.SetFloat("shininess", settings.shininess);
         shader.SetFloat("metallic", settings.metallic);
         shader.SetFloat("roughness", settings.roughness);
-        shader.SetFloat("ambientStrength", settings.ambientStrength);
-        shader.SetBool("shadowsEnabled", settings.shadows_enabled);
-        shader.SetFloat("shadowBias", settings.shadow_bias);
-        shader.SetFloat("shadowSoftness", settings.shadowSoftness);
-        shader.SetInt("shadowSamples", settings.shadowSamples);
-        shader.SetMat4("lightSpaceMatrix", glm::value_ptr(lightSpaceMatrix));
-        glActiveTexture(GL_TEXTURE2);
-        glBindTexture(GL_TEXTURE_2D, depthMap);
-        shader.SetInt("shadowMap", 2);
-
-        // Передача источников света
-        struct LightUniform {
-            int type;
-            glm::vec3 position;
-            glm::vec3 direction;
-            glm::vec3 color;
-            float intensity;
-            float range;
-            float angle;
-        };
-        std::vector<LightUniform> lightUniforms;
-        for (const auto& obj : g_SceneManager.GetObjects()) {
-            int type = obj->GetLightType();
-            if (type == LT_NONE) continue;
-            LightUniform lu;
-            lu.type = type;
-            lu.color = obj->GetLightColor();
-            lu.intensity = obj->GetLightIntensity();
-            if (type == LT_DIRECTIONAL) {
-                lu.direction = obj->GetLightDirection();
-                lu.position = glm::vec3(0.0f);
-                lu.range = 0.0f;
-                lu.angle = 0.0f;
-            } else if (type == LT_POINT) {
-                lu.position = obj->GetWorldPosition();
-                lu.range = obj->GetLightRange();
-                lu.direction = glm::vec3(0.0f);
-                lu.angle = 0.0f;
-            } else if (type == LT_SPOT) {
-                lu.position = obj->GetWorldPosition();
-                lu.direction = obj->GetLightDirection();
-                lu.range = obj->GetLightRange();
-                lu.angle = obj->GetLightAngleDeg() * 3.14159265f / 180.0f;
-            }
-            lightUniforms.push_back(lu);
-            if (lightUniforms.size() >= 8) break;
-        }
-        shader.SetInt("numLights", (int)lightUniforms.size());
-        for (size_t i = 0; i < lightUniforms.size(); ++i) {
-            std::string prefix = "lights[" + std::to_string(i) + "].";
-            shader.SetInt(prefix + "type", lightUniforms[i].type);
-            shader.SetVec3(prefix + "position", lightUniforms[i].position.x, lightUniforms[i].position.y, lightUniforms[i].position.z);
-            shader.SetVec3(prefix + "direction", lightUniforms[i].direction.x, lightUniforms[i].direction.y, lightUniforms[i].direction.z);
-            shader.SetVec3(prefix + "color", lightUniforms[i].color.x, lightUniforms[i].color.y, lightUniforms[i].color.z);
-            shader.SetFloat(prefix + "intensity", lightUniforms[i].intensity);
-            shader.SetFloat(prefix + "range", lightUniforms[i].range);
-            shader.SetFloat(prefix + "angle", lightUniforms[i].angle);
-        }
+        shadowCascades.BindTexture(2);
+        lightClusters.Bind();
 
         if (settings.wireframe_mode)
             glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
@@ -335,28 +350,8 @@ int main() {
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
         glClear(GL_DEPTH_BUFFER_BIT); // очищаем только глубину
 
+        // Параметры тумана и обратные матрицы уже в FrameConstants
         screenFogShader.Use();
-        screenFogShader.SetInt("sceneTexture", 0);
-        screenFogShader.SetInt("depthTexture", 1);
-        screenFogShader.SetMat4("invProjection", glm::value_ptr(glm::inverse(projection)));
-        screenFogShader.SetMat4("invView", glm::value_ptr(glm::inverse(view)));
-        screenFogShader.SetVec3("viewPos", activeCamera->GetWorldPosition().x,
-                                            activeCamera->GetWorldPosition().y,
-                                            activeCamera->GetWorldPosition().z);
-
-        // Параметры тумана из SceneManager
-auto fogObj = g_SceneManager.GetActiveFog();
-if (fogObj && fogObj->GetFogEnabled()) {
-    screenFogShader.SetBool("fogEnabled", true);
-    screenFogShader.SetVec3("fogColor", fogObj->GetFogColor().x, fogObj->GetFogColor().y, fogObj->GetFogColor().z);
-    screenFogShader.SetInt("fogType", fogObj->GetFogType());
-    screenFogShader.SetFloat("fogDensity", fogObj->GetFogDensity());
-    screenFogShader.SetFloat("fogStart", fogObj->GetFogLinearStart());
-    screenFogShader.SetFloat("fogEnd", fogObj->GetFogLinearEnd());
-} else {
-    screenFogShader.SetBool("fogEnabled", false);
-}
-
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, sceneTexture);
         glActiveTexture(GL_TEXTURE1);
@@ -374,6 +369,7 @@ if (fogObj && fogObj->GetFogEnabled()) {
     }
 
     g_EditorUI.Shutdown();
+    TextureManager::Get().Shutdown();
     glfwDestroyWindow(window);
     glfwTerminate();
     std::cout << "Binax Engine shutdown successfully." << std::endl;
@@ -463,36 +459,28 @@ bool initShaders() {
         std::cerr << "ERROR: Failed to load shaders!" << std::endl;
         return false;
     }
+
+    // Сэмплеры привязаны к фиксированным текстурным юнитам — задаём один раз
+    shader.Use();
+    shader.SetInt("shadowMap", 2);
+    shader.SetInt("clusterGridBuffer", LightClusters::kGridUnit);
+    shader.SetInt("clusterIndexBuffer", LightClusters::kIndexUnit);
+    shader.SetInt("lightDataBuffer", LightClusters::kLightUnit);
+    shader.SetInt("materialTable", MaterialTable::kTableUnit);
+    shader.SetInt("diffuseArray", MaterialTable::kArrayUnitBase + 0);
+    shader.SetInt("normalArray", MaterialTable::kArrayUnitBase + 1);
+    shader.SetInt("roughnessArray", MaterialTable::kArrayUnitBase + 2);
+    shader.SetInt("metallicArray", MaterialTable::kArrayUnitBase + 3);
+    shader.SetInt("aoArray", MaterialTable::kArrayUnitBase + 4);
+    screenFogShader.Use();
+    screenFogShader.SetInt("sceneTexture", 0);
+    screenFogShader.SetInt("depthTexture", 1);
+
     std::cout << "All shaders loaded successfully!" << std::endl;
     return true;
 }
 
 bool initShadowMap() {
-    glGenFramebuffers(1, &depthMapFBO);
-    glGenTextures(1, &depthMap);
-    glBindTexture(GL_TEXTURE_2D, depthMap);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, SHADOW_WIDTH, SHADOW_HEIGHT, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
-    float borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
-    glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
-    glBindFramebuffer(GL_FRAMEBUFFER, depthMapFBO);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthMap, 0);
-    glDrawBuffer(GL_NONE);
-    glReadBuffer(GL_NONE);
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
-        std::cerr << "Framebuffer not complete!" << std::endl;
-        return false;
-    }
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    return true;
-}
-
-glm::mat4 calculateLightSpaceMatrix(const glm::vec3& lightPos, const glm::vec3& center) {
-    float near_plane = 1.0f, far_plane = 10.0f;
-    glm::mat4 lightProjection = glm::ortho(-5.0f, 5.0f, -5.0f, 5.0f, near_plane, far_plane);
-    glm::mat4 lightView = glm::lookAt(lightPos, center, glm::vec3(0.0f, 1.0f, 0.0f));
-    return lightProjection * lightView;
+    const auto& settings = g_EditorUI.GetSettings();
+    return shadowCascades.Initialize(settings.shadowMapSize, settings.shadowCascades);
 }